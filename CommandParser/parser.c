@@ -147,9 +147,11 @@ task_invoke_appln_cbk_handler(param_t *param,
 		   get_serialize_buffer_size(tlv_buff));
 	unified_cli_data->enable_or_disable = enable_or_disable;
 
-	task_create_new_job_synchronous((void *)unified_cli_data,
+	/* CLI is interactive, it goes ahead of any background work */
+	task_create_new_job_synchronous_in_domain((void *)unified_cli_data,
 						task_cbk_handler_internal,
-						TASK_ONE_SHOT);						
+						TASK_ONE_SHOT,
+						TASK_PRIORITY_HIGH, NULL);
 }
 #endif
 
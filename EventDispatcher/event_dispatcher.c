@@ -21,72 +21,385 @@
 #include <memory.h>
 #include <assert.h>
 #include <unistd.h>
+#include <time.h>
 #include "event_dispatcher.h"
 
 static event_dispatcher_t ev_dis;
 bool static debug = false;
 
 
+/* Worker a thread is, NULL for application threads */
+static __thread ev_dis_worker_t *ev_dis_curr_worker = NULL;
+static __thread task_t *ev_dis_curr_task = NULL;
+
+/* Order in which priority classes are served */
+static const task_priority_t ev_dis_priority_order[TASK_PRIORITY_MAX] = {
+
+	TASK_PRIORITY_HIGH,
+	TASK_PRIORITY_MEDIUM,
+	TASK_PRIORITY_LOW
+};
+
+static inline uint32_t
+ev_dis_priority_rank(task_priority_t priority){
+
+	switch(priority){
+		case TASK_PRIORITY_HIGH:
+			return 2;
+		case TASK_PRIORITY_MEDIUM:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static void
+ev_dis_fifo_init(ev_dis_fifo_t *fifo){
+
+	init_glthread(&fifo->head);
+	fifo->tail = NULL;
+	fifo->count = 0;
+}
+
+static void
+ev_dis_fifo_push_back(ev_dis_fifo_t *fifo, glthread_t *glthread){
+
+	if(fifo->tail)
+		glthread_add_next(fifo->tail, glthread);
+	else
+		glthread_add_next(&fifo->head, glthread);
+	fifo->tail = glthread;
+	/* count is peeked without the lock by thieves */
+	__atomic_fetch_add(&fifo->count, 1, __ATOMIC_RELAXED);
+}
+
+static void
+ev_dis_fifo_remove(ev_dis_fifo_t *fifo, glthread_t *glthread){
+
+	if(fifo->tail == glthread){
+		fifo->tail = (glthread->left == &fifo->head) ?
+			NULL : glthread->left;
+	}
+	remove_glthread(glthread);
+	__atomic_fetch_sub(&fifo->count, 1, __ATOMIC_RELAXED);
+}
+
+static glthread_t *
+ev_dis_fifo_pop_front(ev_dis_fifo_t *fifo){
+
+	glthread_t *glthread = fifo->head.right;
+	if(!glthread) return NULL;
+	ev_dis_fifo_remove(fifo, glthread);
+	return glthread;
+}
+
+static glthread_t *
+ev_dis_fifo_pop_back(ev_dis_fifo_t *fifo){
+
+	glthread_t *glthread = fifo->tail;
+	if(!glthread) return NULL;
+	ev_dis_fifo_remove(fifo, glthread);
+	return glthread;
+}
+
+void
+ev_dis_domain_init(ev_dis_domain_t *domain, const char *name){
+
+	task_priority_t priority;
+
+	memset(domain, 0, sizeof(ev_dis_domain_t));
+	strncpy(domain->name, name, sizeof(domain->name) - 1);
+	pthread_mutex_init(&domain->domain_mutex, NULL);
+	for(priority = 0; priority < TASK_PRIORITY_MAX; priority++){
+		ev_dis_fifo_init(&domain->task_q[priority]);
+	}
+	domain->state = EV_DIS_DOMAIN_IDLE;
+	init_glthread(&domain->glue);
+}
+
+static void
+ev_dis_timer_wheel_init(ev_dis_timer_wheel_t *wheel);
+
+static void *
+ev_dis_timer_wheel_thread(void *arg);
+
 void
 event_dispatcher_init(){
 
+	uint32_t i;
+	task_priority_t priority;
+	ev_dis_worker_t *worker;
+
 	pthread_mutex_init(&ev_dis.ev_dis_mutex, NULL);
-	init_glthread(&ev_dis.task_array_head);
-	ev_dis.pending_task_count = 0;
+	pthread_cond_init(&ev_dis.ev_dis_cond_wait, NULL);
+	ev_dis.n_idle_workers = 0;
+	ev_dis.n_runnable_domains = 0;
 	
-	ev_dis.ev_dis_state = EV_DIS_IDLE;
+	ev_dis_domain_init(&ev_dis.default_domain, "default");
+
+	for(i = 0; i < EV_DIS_MAX_WORKERS; i++){
+		worker = &ev_dis.workers[i];
+		worker->worker_id = i;
+		pthread_mutex_init(&worker->deque_mutex, NULL);
+		for(priority = 0; priority < TASK_PRIORITY_MAX; priority++){
+			ev_dis_fifo_init(&worker->deque[priority]);
+		}
+	}
+	ev_dis.n_workers = 1;
+	ev_dis.next_worker = 0;
+	ev_dis.running = false;
 
-	pthread_cond_init(&ev_dis.ev_dis_cond_wait, NULL);
-	ev_dis.thread = NULL;
-	ev_dis.signal_sent = false;
-	ev_dis.current_task = NULL;
+	ev_dis_timer_wheel_init(&ev_dis.timer_wheel);
+}
+
+void
+event_dispatcher_set_n_workers(uint32_t n_workers){
+
+	assert(!ev_dis.running);
+	assert(n_workers >= 1 && n_workers <= EV_DIS_MAX_WORKERS);
+	ev_dis.n_workers = n_workers;
+}
+
+uint32_t
+event_dispatcher_get_n_workers(){
+
+	return ev_dis.n_workers;
+}
+
+void
+event_dispatcher_get_stats(ev_dis_stats_t *stats){
+
+	uint32_t i;
+	glthread_t *curr;
+	pkt_q_t *pkt_q;
+
+	memset(stats, 0, sizeof(ev_dis_stats_t));
+	stats->n_workers = ev_dis.n_workers;
+	stats->n_runnable_domains =
+		__atomic_load_n(&ev_dis.n_runnable_domains, __ATOMIC_RELAXED);
+	for(i = 0; i < ev_dis.n_workers; i++){
+		stats->n_tasks_run[i] = ev_dis.workers[i].n_tasks_run;
+		stats->n_steals[i] = ev_dis.workers[i].n_steals;
+	}
+
+	pthread_mutex_lock(&ev_dis.timer_wheel.wheel_mutex);
+	stats->n_timers_armed = ev_dis.timer_wheel.n_armed;
+	stats->n_timers_expired = ev_dis.timer_wheel.n_expired;
+	pthread_mutex_unlock(&ev_dis.timer_wheel.wheel_mutex);
+
+	EV_DIS_LOCK(&ev_dis);
+	stats->n_idle_workers = ev_dis.n_idle_workers;
+	ITERATE_GLTHREAD_BEGIN(&ev_dis.pkt_queue_head, curr){
+		pkt_q = glue_to_pkt_q(curr);
+		stats->n_pkt_queues++;
+		stats->n_pkt_drops +=
+			__atomic_load_n(&pkt_q->ring.n_drops, __ATOMIC_RELAXED);
+	} ITERATE_GLTHREAD_END(&ev_dis.pkt_queue_head, curr);
+	EV_DIS_UNLOCK(&ev_dis);
+}
+
+static ev_dis_worker_t *
+event_dispatcher_pick_worker(){
+
+	uint32_t i;
+
+	/* Keep work forked by a task on the worker which forked it */
+	if(ev_dis_curr_worker) return ev_dis_curr_worker;
+
+	i = __atomic_fetch_add(&ev_dis.next_worker, 1, __ATOMIC_RELAXED);
+	return &ev_dis.workers[i % ev_dis.n_workers];
+}
+
+static void
+event_dispatcher_wake_up_worker(){
+
+	EV_DIS_LOCK(&ev_dis);
+	if(ev_dis.n_idle_workers){
+		pthread_cond_signal(&ev_dis.ev_dis_cond_wait);
+		ev_dis.signal_sent_cnt++;
+		if(debug) printf("signal sent to dispatcher\n");
+	}
+	EV_DIS_UNLOCK(&ev_dis);
+}
+
+/* Called with domain locked */
+static void
+ev_dis_domain_push(ev_dis_domain_t *domain,
+				   ev_dis_worker_t *worker,
+				   task_priority_t priority){
+
+	pthread_mutex_lock(&worker->deque_mutex);
+	ev_dis_fifo_push_back(&worker->deque[priority], &domain->glue);
+	pthread_mutex_unlock(&worker->deque_mutex);
+	domain->worker = worker;
+	domain->sched_priority = priority;
+	domain->state = EV_DIS_DOMAIN_QUEUED;
+	__atomic_fetch_add(&ev_dis.n_runnable_domains, 1, __ATOMIC_SEQ_CST);
+}
+
+/* Called with domain locked, a domain waiting behind lower priority
+ * work is moved up when a higher priority task joins it */
+static void
+ev_dis_domain_reprioritize(ev_dis_domain_t *domain,
+						   task_priority_t priority){
+
+	ev_dis_worker_t *worker = domain->worker;
+
+	pthread_mutex_lock(&worker->deque_mutex);
+	/* The domain may just have been taken off by a worker */
+	if(!IS_GLTHREAD_LIST_EMPTY(&domain->glue)){
+		ev_dis_fifo_remove(&worker->deque[domain->sched_priority],
+						   &domain->glue);
+		ev_dis_fifo_push_back(&worker->deque[priority], &domain->glue);
+		domain->sched_priority = priority;
+	}
+	pthread_mutex_unlock(&worker->deque_mutex);
+}
+
+/* Called with domain locked */
+static task_priority_t
+ev_dis_domain_top_priority(ev_dis_domain_t *domain){
+
+	uint32_t i;
+
+	for(i = 0; i < TASK_PRIORITY_MAX; i++){
+		if(domain->task_q[ev_dis_priority_order[i]].count)
+			return ev_dis_priority_order[i];
+	}
+	return TASK_PRIORITY_LOW;
+}
+
+/* Called with domain locked */
+static task_t *
+ev_dis_domain_dequeue_task(ev_dis_domain_t *domain){
+
+	uint32_t i;
+	glthread_t *curr;
+
+	for(i = 0; i < TASK_PRIORITY_MAX; i++){
+		curr = ev_dis_fifo_pop_front(&domain->task_q[ev_dis_priority_order[i]]);
+		if(curr){
+			domain->pending_task_count--;
+			return glue_to_task(curr);
+		}
+	}
+	return NULL;
 }
 
 static void
 event_dispatcher_schedule_task(task_t *task){
 
+	bool wake_up = false;
+	ev_dis_domain_t *domain = task->domain;
+
+	pthread_mutex_lock(&domain->domain_mutex);
+
 	/* TASK_PKT_Q_JOB could be scheduled again because of
  	 * enque-ing of more pkts via external thread while
  	 * the dispatcher mmay have removed it already from
- 	 * its task_array_head Queue for processing.
+ 	 * its domain Queue for processing. Likewise a timer
+ 	 * may expire again before its last expiry has run.
  	 */
-	if (task->task_type == TASK_PKT_Q_JOB && 
+	if ((task->task_type == TASK_PKT_Q_JOB ||
+		 task->task_type == TASK_TIMER_JOB) && 
 		!IS_GLTHREAD_LIST_EMPTY(&task->glue)) {
+		pthread_mutex_unlock(&domain->domain_mutex);
 		return;
 	}
 
 	assert(IS_GLTHREAD_LIST_EMPTY(&task->glue));
 
-	EV_DIS_LOCK(&ev_dis);
-
-	glthread_add_last(&ev_dis.task_array_head, &task->glue);
-	
-	if(debug) printf("Task Added to Dispatcher's Queue\n");
+	ev_dis_fifo_push_back(&domain->task_q[task->priority], &task->glue);
+	domain->pending_task_count++;
 	
-	ev_dis.pending_task_count++;
+	if(debug) printf("Task Added to domain %s Queue\n", domain->name);
 
-	if (ev_dis.ev_dis_state == EV_DIS_IDLE &&
-		ev_dis.signal_sent == false) {
+	switch(domain->state){
 
-		pthread_cond_signal(&ev_dis.ev_dis_cond_wait);
-		ev_dis.signal_sent = true;
-		if(debug) printf("signal sent to dispatcher\n");
-		ev_dis.signal_sent_cnt++;
+		case EV_DIS_DOMAIN_IDLE:
+			ev_dis_domain_push(domain, event_dispatcher_pick_worker(),
+							   task->priority);
+			wake_up = true;
+			break;
+		case EV_DIS_DOMAIN_QUEUED:
+			if(ev_dis_priority_rank(task->priority) >
+			   ev_dis_priority_rank(domain->sched_priority)){
+				ev_dis_domain_reprioritize(domain, task->priority);
+			}
+			break;
+		case EV_DIS_DOMAIN_RUNNING:
+			/* The worker running the domain queues it again
+ 			 * once the current task returns */
+			break;
 	}
+	pthread_mutex_unlock(&domain->domain_mutex);
+
+	if(wake_up) event_dispatcher_wake_up_worker();
+}
 
-	if (task->app_cond_var) {
+/* MPSC ring */
 
-		if(debug) printf("Syn Task Waiting to return\n");
-		pthread_cond_wait(task->app_cond_var,
-						  &ev_dis.ev_dis_mutex);
-		EV_DIS_UNLOCK(&ev_dis);
-		if(debug) printf("Syn Task Returned\n");
-		/* Task finished, free now */
-		free(task->app_cond_var);
-		free(task);
+static bool
+pkt_q_ring_enqueue(pkt_q_ring_t *ring, char *pkt, uint32_t pkt_size){
+
+	int64_t diff;
+	uint64_t pos, seq;
+	pkt_q_ring_cell_t *cell;
+
+	if(pkt_size > ring->max_pkt_size){
+		__atomic_fetch_add(&ring->n_drops, 1, __ATOMIC_RELAXED);
+		return false;
 	}
-	else {
-		EV_DIS_UNLOCK(&ev_dis);
+
+	pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+	while(1){
+
+		cell = &ring->cells[pos & ring->mask];
+		seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		diff = (int64_t)(seq - pos);
+
+		if(diff == 0){
+			/* Cell is free, claim it. pos is reloaded on failure */
+			if(__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1,
+					true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if(diff < 0){
+			/* Consumer has not released this cell since the last lap */
+			__atomic_fetch_add(&ring->n_drops, 1, __ATOMIC_RELAXED);
+			return false;
+		}
+		else{
+			/* Another producer claimed it */
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(cell->pkt, pkt, pkt_size);
+	cell->pkt_size = pkt_size;
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/* Consumer only */
+static pkt_q_ring_cell_t *
+pkt_q_ring_peek(pkt_q_ring_t *ring, uint64_t pos){
+
+	pkt_q_ring_cell_t *cell = &ring->cells[pos & ring->mask];
+
+	if(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + 1)
+		return NULL;
+	return cell;
+}
+
+/* Consumer only */
+static void
+pkt_q_ring_release_held(pkt_q_ring_t *ring){
+
+	for( ; ring->n_held; ring->n_held--, ring->head++){
+		__atomic_store_n(&ring->cells[ring->head & ring->mask].seq,
+				ring->head + ring->size, __ATOMIC_RELEASE);
 	}
 }
 
@@ -103,7 +416,10 @@ eve_dis_process_task_post_call(task_t *task){
 					/* We will free the task when it will be
  					 * unlocked, dont free here */
 					if(debug) printf("Dispatcher sent Signal Syn Task\n");
+					EV_DIS_LOCK(&ev_dis);
+					task->done = true;
 					pthread_cond_signal(task->app_cond_var);
+					EV_DIS_UNLOCK(&ev_dis);
 				}
 				else {
 					free(task);
@@ -121,6 +437,23 @@ eve_dis_process_task_post_call(task_t *task){
 
 		case TASK_PKT_Q_JOB:	
 			pkt_q = (pkt_q_t *)(task->data);
+
+			if(pkt_q->mode == PKT_Q_MODE_MPSC_RING){
+
+				pkt_q_ring_release_held(&pkt_q->ring);
+				/* Producers which find scheduled set do not schedule
+ 				 * the task, so look once more after clearing it. Both
+ 				 * sides flip the flag with a RMW, a producer is either
+ 				 * seen here or finds the flag clear */
+				(void)__atomic_exchange_n(&pkt_q->scheduled, false, __ATOMIC_SEQ_CST);
+				if(!pkt_q_ring_peek(&pkt_q->ring, pkt_q->ring.head))
+					return;
+				if(__atomic_exchange_n(&pkt_q->scheduled, true, __ATOMIC_SEQ_CST))
+					return;
+				event_dispatcher_schedule_task(task);
+				return;
+			}
+
 			pthread_mutex_lock(&pkt_q->q_mutex);
 			
 			if (IS_GLTHREAD_LIST_EMPTY(&pkt_q->q_head)) {
@@ -138,61 +471,139 @@ eve_dis_process_task_post_call(task_t *task){
 	}
 }
 
-static task_t *
-event_dispatcher_get_next_task_to_run(){
+static ev_dis_domain_t *
+event_dispatcher_steal_domain(ev_dis_worker_t *worker,
+							  task_priority_t priority){
 
+	uint32_t i;
 	glthread_t *curr;
-	curr = dequeue_glthread_first(&ev_dis.task_array_head);
-	if(!curr) return NULL;
-	return glue_to_task(curr);
+	ev_dis_worker_t *victim;
+
+	for(i = 1; i < ev_dis.n_workers; i++){
+
+		victim = &ev_dis.workers[(worker->worker_id + i) % ev_dis.n_workers];
+		if(!__atomic_load_n(&victim->deque[priority].count, __ATOMIC_RELAXED))
+			continue;
+		pthread_mutex_lock(&victim->deque_mutex);
+		curr = ev_dis_fifo_pop_back(&victim->deque[priority]);
+		pthread_mutex_unlock(&victim->deque_mutex);
+		if(curr){
+			worker->n_steals++;
+			return glue_to_domain(curr);
+		}
+	}
+	return NULL;
+}
+
+static ev_dis_domain_t *
+event_dispatcher_get_next_domain_to_run(ev_dis_worker_t *worker){
+
+	uint32_t i;
+	glthread_t *curr;
+	task_priority_t priority;
+	ev_dis_domain_t *domain = NULL;
+
+	for(i = 0; i < TASK_PRIORITY_MAX && !domain; i++){
+
+		priority = ev_dis_priority_order[i];
+
+		pthread_mutex_lock(&worker->deque_mutex);
+		curr = ev_dis_fifo_pop_front(&worker->deque[priority]);
+		pthread_mutex_unlock(&worker->deque_mutex);
+
+		domain = curr ? glue_to_domain(curr) :
+			event_dispatcher_steal_domain(worker, priority);
+	}
+
+	if(domain)
+		__atomic_fetch_sub(&ev_dis.n_runnable_domains, 1, __ATOMIC_SEQ_CST);
+	return domain;
+}
+
+static void
+event_dispatcher_worker_sleep(ev_dis_worker_t *worker){
+
+	EV_DIS_LOCK(&ev_dis);
+	ev_dis.n_idle_workers++;
+	if(debug) printf("Worker %u : No Task to run, moved to IDLE STATE\n",
+			worker->worker_id);
+	while(!__atomic_load_n(&ev_dis.n_runnable_domains, __ATOMIC_SEQ_CST)){
+		pthread_cond_wait(&ev_dis.ev_dis_cond_wait,
+				&ev_dis.ev_dis_mutex);
+		ev_dis.signal_recv_cnt++;
+		if(debug) printf("Worker %u recvd Signal # %u, woken up\n",
+				worker->worker_id, ev_dis.signal_recv_cnt);
+	}
+	ev_dis.n_idle_workers--;
+	EV_DIS_UNLOCK(&ev_dis);
 }
 
 static void *
 event_dispatcher_thread(void *arg) {
 
 	task_t *task;
+	bool queued_again;
+	task_type_t task_type;
+	ev_dis_domain_t *domain;
+	ev_dis_worker_t *worker = (ev_dis_worker_t *)arg;
 
-	EV_DIS_LOCK(&ev_dis);
+	ev_dis_curr_worker = worker;
 
-	if(debug) printf("Dispatcher Thread started\n");
+	if(debug) printf("Dispatcher Worker %u started\n", worker->worker_id);
 
 	while(1) {
 		
-		task = event_dispatcher_get_next_task_to_run();
-
-		if(!task) {
-			ev_dis.ev_dis_state = EV_DIS_IDLE;
-			if(debug) printf("No Task to run, EVE DIS moved to IDLE STATE\n");
-			ev_dis.signal_sent = false;
-			pthread_cond_wait(&ev_dis.ev_dis_cond_wait,
-					&ev_dis.ev_dis_mutex);
-			ev_dis.signal_recv_cnt++;
-			if(debug) printf("Eve Dis recvd Signal # %u, woken up\n",
-					ev_dis.signal_recv_cnt);
+		domain = event_dispatcher_get_next_domain_to_run(worker);
+
+		if(!domain) {
+			event_dispatcher_worker_sleep(worker);
+			continue;
 		}
-		else {
-			ev_dis.pending_task_count--;
-			ev_dis.current_task = task;
-			
-			if(ev_dis.ev_dis_state != EV_DIS_TASK_FIN_WAIT){
-				ev_dis.ev_dis_state = EV_DIS_TASK_FIN_WAIT;
-				if(debug) printf("EVE DIS moved to EV_DIS_TASK_FIN_WAIT, "
-						"dispatching the task\n");
-			}
 
-			EV_DIS_UNLOCK(&ev_dis);
+		pthread_mutex_lock(&domain->domain_mutex);
+		task = ev_dis_domain_dequeue_task(domain);
+		if(!task){
+			/* All its tasks were cancelled while it was queued */
+			domain->state = EV_DIS_DOMAIN_IDLE;
+			pthread_mutex_unlock(&domain->domain_mutex);
+			continue;
+		}
+		domain->state = EV_DIS_DOMAIN_RUNNING;
+		pthread_mutex_unlock(&domain->domain_mutex);
 
-			if(debug) printf("invoking the task\n");
+		ev_dis_curr_task = task;
 
-			task->ev_cbk(task->data, task->data_size);
-			task->no_of_invocations++;
-			if(debug) printf("Job execution finished\n");
+		if(debug) printf("Worker %u invoking the task\n", worker->worker_id);
 
-			eve_dis_process_task_post_call(task);
+		/* A timer may be released by its own callback, dont
+ 		 * touch its task once the callback returns */
+		task_type = task->task_type;
+		task->no_of_invocations++;
+		task->ev_cbk(task->data, task->data_size);
+		worker->n_tasks_run++;
+		if(debug) printf("Job execution finished\n");
 
-			EV_DIS_LOCK(&ev_dis);
-			ev_dis.current_task = NULL;
+		/* task may be gone after this */
+		if(task_type != TASK_TIMER_JOB)
+			eve_dis_process_task_post_call(task);
+		ev_dis_curr_task = NULL;
+
+		/* Go to the back of the deque, domains sharing
+ 		 * a worker take turns */
+		queued_again = false;
+		pthread_mutex_lock(&domain->domain_mutex);
+		if(domain->pending_task_count){
+			ev_dis_domain_push(domain, worker,
+					ev_dis_domain_top_priority(domain));
+			queued_again = true;
 		}
+		else{
+			domain->state = EV_DIS_DOMAIN_IDLE;
+		}
+		pthread_mutex_unlock(&domain->domain_mutex);
+
+		if(queued_again && ev_dis.n_workers > 1)
+			event_dispatcher_wake_up_worker();
 	}
 	return 0;
 }
@@ -207,6 +618,8 @@ create_new_task(void *arg,
 	task->data_size = arg_size;
 	task->ev_cbk = cbk;
 	task->task_type = TASK_ONE_SHOT; /* default */
+	task->priority = TASK_PRIORITY_MEDIUM;
+	task->domain = &ev_dis.default_domain;
 	task->re_schedule = false;
 	init_glthread(&task->glue);
 	return task;
@@ -225,59 +638,122 @@ task_schedule_again(task_t *task){
 void
 event_dispatcher_run(){
 
+	uint32_t i;
 	pthread_attr_t attr;
-	pthread_t *event_dis_thread;
-	
-	event_dis_thread = calloc(1, sizeof(pthread_t));
-	ev_dis.thread = event_dis_thread;
+
+	assert(!ev_dis.running);
+	ev_dis.running = true;
 
 	pthread_attr_init(&attr);
 	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-	pthread_create(event_dis_thread, &attr,
-					event_dispatcher_thread,
-					NULL);
+
+	for(i = 0; i < ev_dis.n_workers; i++){
+		pthread_create(&ev_dis.workers[i].thread, &attr,
+						event_dispatcher_thread,
+						(void *)&ev_dis.workers[i]);
+	}
+
+	pthread_create(&ev_dis.timer_wheel.thread, &attr,
+					ev_dis_timer_wheel_thread,
+					(void *)&ev_dis.timer_wheel);
 }
 
 task_t *
 eve_dis_get_current_task(){
 
-	return ev_dis.current_task;
+	return ev_dis_curr_task;
 }
 
-
 task_t *
-task_create_new_job(
+task_create_new_job_in_domain(
 	void *data,
 	event_cbk cbk,
-	task_type_t task_type) {
+	task_type_t task_type,
+	task_priority_t priority,
+	ev_dis_domain_t *domain) {
 
 	task_t *task = create_new_task(data, 0, cbk);
 	task->task_type = task_type;
+	task->priority = priority;
+	if(domain) task->domain = domain;
 	event_dispatcher_schedule_task(task);
 	return task;								
 }
 
 task_t *
-task_create_new_job_synchronous(
+task_create_new_job(
 	void *data,
 	event_cbk cbk,
 	task_type_t task_type) {
 
+	return task_create_new_job_in_domain(data, cbk, task_type,
+				TASK_PRIORITY_MEDIUM, NULL);
+}
+
+task_t *
+task_create_new_job_synchronous_in_domain(
+	void *data,
+	event_cbk cbk,
+	task_type_t task_type,
+	task_priority_t priority,
+	ev_dis_domain_t *domain) {
+
 	task_t *task = create_new_task(data, 0, cbk);
 	task->task_type = task_type;
+	task->priority = priority;
+	if(domain) task->domain = domain;
 	task->app_cond_var = calloc(1, sizeof(pthread_cond_t));
 	pthread_cond_init(task->app_cond_var, 0);
 	event_dispatcher_schedule_task(task);
-	return task;								
+
+	if(debug) printf("Syn Task Waiting to return\n");
+	EV_DIS_LOCK(&ev_dis);
+	while(!task->done){
+		pthread_cond_wait(task->app_cond_var,
+						  &ev_dis.ev_dis_mutex);
+	}
+	EV_DIS_UNLOCK(&ev_dis);
+	if(debug) printf("Syn Task Returned\n");
+
+	/* Task finished, free now */
+	pthread_cond_destroy(task->app_cond_var);
+	free(task->app_cond_var);
+	free(task);
+	return NULL;
+}
+
+task_t *
+task_create_new_job_synchronous(
+	void *data,
+	event_cbk cbk,
+	task_type_t task_type) {
+
+	return task_create_new_job_synchronous_in_domain(data, cbk,
+				task_type, TASK_PRIORITY_MEDIUM, NULL);
+}
+
+static void
+ev_dis_domain_remove_task(task_t *task){
+
+	ev_dis_domain_t *domain = task->domain;
+
+	pthread_mutex_lock(&domain->domain_mutex);
+	if(!IS_GLTHREAD_LIST_EMPTY(&task->glue)){
+		ev_dis_fifo_remove(&domain->task_q[task->priority], &task->glue);
+		domain->pending_task_count--;
+	}
+	pthread_mutex_unlock(&domain->domain_mutex);
 }
 
 void
 task_cancel_job(task_t *task){
 
+	task_t *curr_task = eve_dis_get_current_task();
+
 	/* Dont kill yourself while you are still executing
 	 * and you are one SHOT */
-	if(ev_dis.current_task->task_type == TASK_ONE_SHOT &&
-		ev_dis.current_task == task) {
+	if(curr_task && curr_task == task &&
+		curr_task->task_type == TASK_ONE_SHOT) {
 		assert(0);
 	}
 	
@@ -289,17 +765,20 @@ task_cancel_job(task_t *task){
 		delete_glthread_list(&pkt_q->q_head);
 	 	pthread_mutex_unlock(&pkt_q->q_mutex);
 		
+		ev_dis_domain_remove_task(task);
 		EV_DIS_LOCK(&ev_dis);
 		remove_glthread(&pkt_q->glue);
-		remove_glthread(&task->glue);
-		free(task);
 		EV_DIS_UNLOCK(&ev_dis);
+		if(pkt_q->mode == PKT_Q_MODE_MPSC_RING){
+			free(pkt_q->ring.cells);
+			free(pkt_q->ring.pkt_buffers);
+			memset(&pkt_q->ring, 0, sizeof(pkt_q_ring_t));
+		}
+		free(task);
 	}
 	else if (task->task_type == TASK_ONE_SHOT ||
 			  task->task_type == TASK_BG ) {
-		EV_DIS_LOCK(&ev_dis);
-		remove_glthread(&task->glue);
-		EV_DIS_UNLOCK(&ev_dis);
+		ev_dis_domain_remove_task(task);
 		free(task);	
 	}
 }
@@ -334,6 +813,18 @@ task_get_next_pkt(uint32_t *pkt_size){
 
 	pkt_q_t *pkt_q = (pkt_q_t *)(task->data);
 
+	if(pkt_q->mode == PKT_Q_MODE_MPSC_RING){
+
+		pkt_q_ring_cell_t *cell;
+
+		pkt_q_ring_release_held(&pkt_q->ring);
+		cell = pkt_q_ring_peek(&pkt_q->ring, pkt_q->ring.head);
+		if(!cell) return NULL;
+		pkt_q->ring.n_held = 1;
+		*pkt_size = cell->pkt_size;
+		return cell->pkt;
+	}
+
 	pthread_mutex_lock(&pkt_q->q_mutex);
 	curr = dequeue_glthread_first(&pkt_q->q_head);
 	if(debug) printf("%s() ...\n", __FUNCTION__);
@@ -350,11 +841,55 @@ task_get_next_pkt(uint32_t *pkt_size){
 }
 
 
-void
+uint32_t
+task_get_next_pkt_batch(char **pkts, uint32_t *pkt_sizes,
+						uint32_t max_pkts){
+
+	uint32_t n = 0;
+	pkt_q_ring_t *ring;
+	pkt_q_ring_cell_t *cell;
+	task_t *task = eve_dis_get_current_task();
+	pkt_q_t *pkt_q = (pkt_q_t *)(task->data);
+
+	if(pkt_q->mode == PKT_Q_MODE_LOCKED){
+		for( ; n < max_pkts; n++){
+			pkts[n] = task_get_next_pkt(&pkt_sizes[n]);
+			if(!pkts[n]) break;
+		}
+		return n;
+	}
+
+	ring = &pkt_q->ring;
+	pkt_q_ring_release_held(ring);
+
+	for( ; n < max_pkts; n++){
+		cell = pkt_q_ring_peek(ring, ring->head + n);
+		if(!cell) break;
+		pkts[n] = cell->pkt;
+		pkt_sizes[n] = cell->pkt_size;
+	}
+	ring->n_held = n;
+	return n;
+}
+
+bool
 pkt_q_enqueue(pkt_q_t *pkt_q,
 			  char *_pkt, uint32_t pkt_size){
 
-	pkt_t *pkt = task_get_new_pkt(_pkt, pkt_size);
+	pkt_t *pkt;
+
+	if(pkt_q->mode == PKT_Q_MODE_MPSC_RING){
+
+		if(!pkt_q_ring_enqueue(&pkt_q->ring, _pkt, pkt_size))
+			return false;
+		/* Only the producer which finds the task idle schedules it,
+ 		 * the rest stay off the domain lock */
+		if(!__atomic_exchange_n(&pkt_q->scheduled, true, __ATOMIC_SEQ_CST))
+			event_dispatcher_schedule_task(pkt_q->task);
+		return true;
+	}
+
+	pkt = task_get_new_pkt(_pkt, pkt_size);
 	
 	if (debug) printf("%s() ... \n", __FUNCTION__);
 
@@ -362,21 +897,19 @@ pkt_q_enqueue(pkt_q_t *pkt_q,
 	glthread_add_next(&pkt_q->q_head, &pkt->glue);
 	pthread_mutex_unlock(&pkt_q->q_mutex);
 
-	EV_DIS_LOCK(&ev_dis);
-	/* Job is already scheduled to run */
-	if (!IS_GLTHREAD_LIST_EMPTY(&pkt_q->task->glue)){
-		EV_DIS_UNLOCK(&ev_dis);
-		return;
-	}
-	EV_DIS_UNLOCK(&ev_dis);
+	/* No-op if the Job is already scheduled to run */
 	if (debug) printf("%s() calling event_dispatcher_schedule_task()\n",
 			__FUNCTION__);
 	event_dispatcher_schedule_task(pkt_q->task);	
+	return true;
 }
 
 void
 init_pkt_q(pkt_q_t *pkt_q, event_cbk cbk){
 
+	pkt_q->mode = PKT_Q_MODE_LOCKED;
+	memset(&pkt_q->ring, 0, sizeof(pkt_q_ring_t));
+	pkt_q->scheduled = false;
 	init_glthread(&pkt_q->q_head);
 	pthread_mutex_init(&pkt_q->q_mutex, NULL);
 	pkt_q->task = create_new_task((void *)pkt_q,
@@ -384,6 +917,296 @@ init_pkt_q(pkt_q_t *pkt_q, event_cbk cbk){
 								  cbk);
 	pkt_q->task->task_type = TASK_PKT_Q_JOB;
 	init_glthread(&pkt_q->glue);
+	EV_DIS_LOCK(&ev_dis);
 	glthread_add_next(&ev_dis.pkt_queue_head, &pkt_q->glue);
+	EV_DIS_UNLOCK(&ev_dis);
+}
+
+void
+init_pkt_q_mpsc(pkt_q_t *pkt_q, event_cbk cbk,
+				uint32_t ring_size, uint32_t max_pkt_size){
+
+	uint32_t i, size = 1;
+	pkt_q_ring_t *ring = &pkt_q->ring;
+
+	assert(ring_size && max_pkt_size);
+	while(size < ring_size) size <<= 1;
+
+	init_pkt_q(pkt_q, cbk);
+	pkt_q->mode = PKT_Q_MODE_MPSC_RING;
+
+	ring->size = size;
+	ring->mask = size - 1;
+	ring->max_pkt_size = max_pkt_size;
+	ring->cells = calloc(size, sizeof(pkt_q_ring_cell_t));
+	ring->pkt_buffers = calloc(size, max_pkt_size);
+	for(i = 0; i < size; i++){
+		ring->cells[i].seq = i;
+		ring->cells[i].pkt = ring->pkt_buffers + ((size_t)i * max_pkt_size);
+	}
 }
 
+
+/* Timer wheel */
+
+uint64_t
+ev_dis_get_monotonic_msec(){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+static uint64_t
+ev_dis_timer_wheel_now_tick(ev_dis_timer_wheel_t *wheel){
+
+	return (ev_dis_get_monotonic_msec() - wheel->start_msec) /
+			EV_DIS_TIMER_TICK_MSEC;
+}
+
+static uint64_t
+ev_dis_timer_msec_to_ticks(uint32_t msec){
+
+	return (msec + EV_DIS_TIMER_TICK_MSEC - 1) / EV_DIS_TIMER_TICK_MSEC;
+}
+
+static void
+ev_dis_timer_wheel_init(ev_dis_timer_wheel_t *wheel){
+
+	uint32_t level, slot;
+	pthread_condattr_t attr;
+
+	pthread_mutex_init(&wheel->wheel_mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&wheel->wheel_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	wheel->start_msec = ev_dis_get_monotonic_msec();
+	wheel->curr_tick = 0;
+	wheel->n_armed = 0;
+	wheel->n_expired = 0;
+
+	for(level = 0; level < EV_DIS_TIMER_WHEEL_LEVELS; level++){
+		for(slot = 0; slot < EV_DIS_TIMER_WHEEL_SLOTS; slot++){
+			init_glthread(&wheel->slots[level][slot]);
+		}
+	}
+}
+
+/* Called with wheel locked. Level n holds timers expiring within
+ * 2^(BITS * (n + 1)) ticks, slotted by the bits of their expiry
+ * tick for that level */
+static void
+ev_dis_timer_wheel_insert(ev_dis_timer_wheel_t *wheel,
+						  ev_dis_timer_t *timer){
+
+	uint32_t level;
+	uint64_t expires = timer->expires;
+	uint64_t delta;
+
+	if(expires < wheel->curr_tick)
+		expires = wheel->curr_tick;
+	delta = expires - wheel->curr_tick;
+	if(delta > EV_DIS_TIMER_MAX_TICKS){
+		delta = EV_DIS_TIMER_MAX_TICKS;
+		expires = wheel->curr_tick + delta;
+	}
+
+	for(level = 0; level < EV_DIS_TIMER_WHEEL_LEVELS - 1; level++){
+		if(delta < (1ULL << (EV_DIS_TIMER_WHEEL_BITS * (level + 1))))
+			break;
+	}
+
+	glthread_add_next(&wheel->slots[level][(expires >>
+		(EV_DIS_TIMER_WHEEL_BITS * level)) & EV_DIS_TIMER_WHEEL_MASK],
+		&timer->wheel_glue);
+}
+
+/* Called with wheel locked, re-slots the timers of one slot of
+ * level into lower levels. Returns the slot index cascaded */
+static uint32_t
+ev_dis_timer_wheel_cascade(ev_dis_timer_wheel_t *wheel, uint32_t level){
+
+	glthread_t *curr;
+	glthread_t *slot_head;
+	uint32_t index = (wheel->curr_tick >>
+		(EV_DIS_TIMER_WHEEL_BITS * level)) & EV_DIS_TIMER_WHEEL_MASK;
+
+	slot_head = &wheel->slots[level][index];
+
+	ITERATE_GLTHREAD_BEGIN(slot_head, curr){
+
+		remove_glthread(curr);
+		ev_dis_timer_wheel_insert(wheel, wheel_glue_to_timer(curr));
+	} ITERATE_GLTHREAD_END(slot_head, curr);
+	return index;
+}
+
+/* Called with wheel locked, processes tick curr_tick */
+static void
+ev_dis_timer_wheel_tick(ev_dis_timer_wheel_t *wheel){
+
+	uint32_t level;
+	glthread_t *curr;
+	ev_dis_timer_t *timer;
+	glthread_t *slot_head;
+	uint32_t index = wheel->curr_tick & EV_DIS_TIMER_WHEEL_MASK;
+
+	/* Entering a new round of a level pulls down the
+ 	 * next slot of the level above */
+	for(level = 1; !index && level < EV_DIS_TIMER_WHEEL_LEVELS; level++){
+		index = ev_dis_timer_wheel_cascade(wheel, level);
+	}
+
+	slot_head = &wheel->slots[0][wheel->curr_tick & EV_DIS_TIMER_WHEEL_MASK];
+
+	ITERATE_GLTHREAD_BEGIN(slot_head, curr){
+
+		timer = wheel_glue_to_timer(curr);
+		remove_glthread(curr);
+
+		if(timer->period_ticks){
+			timer->expires += timer->period_ticks;
+			/* Dont replay the expiries missed while late */
+			if(timer->expires <= wheel->curr_tick)
+				timer->expires = wheel->curr_tick + timer->period_ticks;
+			ev_dis_timer_wheel_insert(wheel, timer);
+		}
+		else{
+			timer->armed = false;
+			wheel->n_armed--;
+		}
+		wheel->n_expired++;
+		event_dispatcher_schedule_task(&timer->task);
+	} ITERATE_GLTHREAD_END(slot_head, curr);
+}
+
+static void *
+ev_dis_timer_wheel_thread(void *arg){
+
+	struct timespec ts;
+	uint64_t now_tick, next_msec;
+	ev_dis_timer_wheel_t *wheel = (ev_dis_timer_wheel_t *)arg;
+
+	pthread_mutex_lock(&wheel->wheel_mutex);
+
+	while(1){
+
+		if(!wheel->n_armed){
+			pthread_cond_wait(&wheel->wheel_cond, &wheel->wheel_mutex);
+			continue;
+		}
+
+		now_tick = ev_dis_timer_wheel_now_tick(wheel);
+		while(wheel->n_armed && wheel->curr_tick <= now_tick){
+			ev_dis_timer_wheel_tick(wheel);
+			wheel->curr_tick++;
+		}
+		if(!wheel->n_armed) continue;
+
+		/* Sleep till the next tick is due, an arm wakes us up early */
+		next_msec = wheel->start_msec +
+			(wheel->curr_tick * EV_DIS_TIMER_TICK_MSEC);
+		ts.tv_sec = next_msec / 1000;
+		ts.tv_nsec = (next_msec % 1000) * 1000000;
+		pthread_cond_timedwait(&wheel->wheel_cond, &wheel->wheel_mutex, &ts);
+	}
+	return NULL;
+}
+
+void
+ev_dis_timer_init(ev_dis_timer_t *timer,
+				  event_cbk cbk, void *arg,
+				  task_priority_t priority,
+				  ev_dis_domain_t *domain){
+
+	memset(timer, 0, sizeof(ev_dis_timer_t));
+	timer->cbk = cbk;
+	timer->arg = arg;
+	init_glthread(&timer->wheel_glue);
+
+	/* The expiry task is embedded, it is never freed by the dispatcher */
+	timer->task.data = arg;
+	timer->task.ev_cbk = cbk;
+	timer->task.task_type = TASK_TIMER_JOB;
+	timer->task.priority = priority;
+	timer->task.domain = domain ? domain : &ev_dis.default_domain;
+	init_glthread(&timer->task.glue);
+}
+
+void
+ev_dis_timer_arm(ev_dis_timer_t *timer,
+				 uint32_t expire_msec,
+				 uint32_t period_msec){
+
+	ev_dis_timer_wheel_t *wheel = &ev_dis.timer_wheel;
+
+	pthread_mutex_lock(&wheel->wheel_mutex);
+
+	if(timer->armed){
+		remove_glthread(&timer->wheel_glue);
+		wheel->n_armed--;
+	}
+
+	/* Nothing is armed, the wheel may have stood still for long */
+	if(!wheel->n_armed)
+		wheel->curr_tick = ev_dis_timer_wheel_now_tick(wheel);
+
+	/* The tick in progress is partly gone, count the next one
+ 	 * so that a timer never fires early */
+	timer->expires = ev_dis_timer_wheel_now_tick(wheel) + 1 +
+		ev_dis_timer_msec_to_ticks(expire_msec);
+	timer->period_ticks = period_msec ?
+		ev_dis_timer_msec_to_ticks(period_msec) : 0;
+	timer->armed = true;
+	wheel->n_armed++;
+	ev_dis_timer_wheel_insert(wheel, timer);
+
+	pthread_cond_signal(&wheel->wheel_cond);
+	pthread_mutex_unlock(&wheel->wheel_mutex);
+}
+
+void
+ev_dis_timer_cancel(ev_dis_timer_t *timer){
+
+	ev_dis_timer_wheel_t *wheel = &ev_dis.timer_wheel;
+
+	pthread_mutex_lock(&wheel->wheel_mutex);
+	if(timer->armed){
+		remove_glthread(&timer->wheel_glue);
+		timer->armed = false;
+		wheel->n_armed--;
+	}
+	/* Drop an expiry which is still waiting for its domain */
+	ev_dis_domain_remove_task(&timer->task);
+	pthread_mutex_unlock(&wheel->wheel_mutex);
+}
+
+bool
+ev_dis_timer_is_armed(ev_dis_timer_t *timer){
+
+	bool armed;
+
+	pthread_mutex_lock(&ev_dis.timer_wheel.wheel_mutex);
+	armed = timer->armed;
+	pthread_mutex_unlock(&ev_dis.timer_wheel.wheel_mutex);
+	return armed;
+}
+
+uint32_t
+ev_dis_timer_remaining_msec(ev_dis_timer_t *timer){
+
+	uint64_t now_tick;
+	uint32_t remaining = 0;
+	ev_dis_timer_wheel_t *wheel = &ev_dis.timer_wheel;
+
+	pthread_mutex_lock(&wheel->wheel_mutex);
+	if(timer->armed){
+		now_tick = ev_dis_timer_wheel_now_tick(wheel);
+		if(timer->expires > now_tick)
+			remaining = (timer->expires - now_tick) * EV_DIS_TIMER_TICK_MSEC;
+	}
+	pthread_mutex_unlock(&wheel->wheel_mutex);
+	return remaining;
+}
@@ -32,6 +32,8 @@
 typedef struct event_dispatcher_ event_dispatcher_t;
 typedef struct task_ task_t;
 typedef struct pkt_q_ pkt_q_t;
+typedef struct ev_dis_domain_ ev_dis_domain_t;
+typedef struct ev_dis_worker_ ev_dis_worker_t;
 
 typedef void (*event_cbk)(void *, uint32_t );
 
@@ -39,7 +41,8 @@ typedef enum {
 
 	TASK_ONE_SHOT,
 	TASK_PKT_Q_JOB,
-	TASK_BG
+	TASK_BG,
+	TASK_TIMER_JOB	/* Expiry of an ev_dis_timer_t, owned by the timer */
 } task_type_t;
 
 typedef enum {
@@ -51,11 +54,14 @@ typedef enum {
 	TASK_DEFAULT
 } task_src_t;
 
+/* Priority classes are strict : a LOW task runs only when no
+ * HIGH or MEDIUM task is runnable on any worker */
 typedef enum {
 
 	TASK_PRIORITY_MEDIUM,
 	TASK_PRIORITY_LOW,
-	TASK_PRIORITY_HIGH
+	TASK_PRIORITY_HIGH,
+	TASK_PRIORITY_MAX
 } task_priority_t;
 
 struct task_{
@@ -65,47 +71,176 @@ struct task_{
 	event_cbk ev_cbk;
 	uint32_t no_of_invocations;
 	task_type_t task_type;
+	task_priority_t priority;
+	ev_dis_domain_t *domain;	/* Serialized domain the task runs in */
 	bool re_schedule;
 	pthread_cond_t *app_cond_var; /* For synchronous Schedules */
+	bool done;			/* For synchronous Schedules */
 	glthread_t glue;
 };
 GLTHREAD_TO_STRUCT(glue_to_task,
 	task_t, glue);
 
+typedef enum {
+
+	PKT_Q_MODE_LOCKED,	/* Mutex guarded list, pkts are passed by reference */
+	PKT_Q_MODE_MPSC_RING	/* Lock free ring, pkts are copied into ring buffers */
+} pkt_q_mode_t;
+
+#define PKT_Q_CACHE_LINE_SIZE	64
+
+/* A ring cell is free for the producer claiming position pos when
+ * seq == pos, and holds a pkt ready for the consumer when
+ * seq == pos + 1. Consumer hands the cell back for the next lap
+ * by setting seq = pos + size */
+typedef struct pkt_q_ring_cell_{
+
+	uint64_t seq;
+	uint32_t pkt_size;
+	char *pkt;		/* Pre-allocated buffer of max_pkt_size bytes */
+} pkt_q_ring_cell_t;
+
+/* Bounded multi producer single consumer ring. Producers claim cells
+ * with a CAS on tail, the consumer is the pkt Q task which runs in
+ * one domain, hence on one worker at a time */
+typedef struct pkt_q_ring_{
+
+	uint32_t size;		/* Power of 2 */
+	uint32_t mask;
+	uint32_t max_pkt_size;
+	pkt_q_ring_cell_t *cells;
+	char *pkt_buffers;
+	uint64_t tail __attribute__((aligned(PKT_Q_CACHE_LINE_SIZE)));	/* Producers */
+	uint64_t n_drops;	/* Ring full or pkt too big */
+	uint64_t head __attribute__((aligned(PKT_Q_CACHE_LINE_SIZE)));	/* Consumer */
+	uint32_t n_held;	/* Cells handed to the consumer, not yet released */
+} pkt_q_ring_t;
+
 struct pkt_q_{
 
+	pkt_q_mode_t mode;
+	/* PKT_Q_MODE_LOCKED */
 	glthread_t q_head;
 	pthread_mutex_t q_mutex;
+	/* PKT_Q_MODE_MPSC_RING */
+	pkt_q_ring_t ring;
+	bool scheduled;		/* Task is queued or running, atomic */
 	task_t *task;
 	glthread_t glue;
 };
 GLTHREAD_TO_STRUCT(glue_to_pkt_q,
 	pkt_q_t, glue);
 
-typedef enum {
-
-	EV_DIS_IDLE,
-	EV_DIS_TASK_FIN_WAIT,
-} EV_DISPATCHER_STATE;
+/* glthread based FIFO, tail is tracked so that
+ * both ends are reachable in O(1) */
+typedef struct ev_dis_fifo_{
 
-struct event_dispatcher_{
+	glthread_t head;
+	glthread_t *tail;
+	uint32_t count;
+} ev_dis_fifo_t;
 
-	pthread_mutex_t ev_dis_mutex;
+typedef enum {
 
-	glthread_t task_array_head;	
+	EV_DIS_DOMAIN_IDLE,	/* No pending task */
+	EV_DIS_DOMAIN_QUEUED,	/* Waiting in some worker's deque */
+	EV_DIS_DOMAIN_RUNNING	/* One of its tasks is being executed */
+} EV_DIS_DOMAIN_STATE;
+
+/* A serialized domain. Tasks of the same domain never run concurrently
+ * and run FIFO within a priority class, whatever the number of workers.
+ * Tasks scheduled without a domain go to the dispatcher's default domain,
+ * so an application which does not use domains keeps the guarantee that
+ * its tasks never race with each other. Workers schedule domains, not
+ * tasks : a runnable domain sits in exactly one worker's deque. */
+struct ev_dis_domain_{
+
+	char name[32];
+	pthread_mutex_t domain_mutex;
+	ev_dis_fifo_t task_q[TASK_PRIORITY_MAX];
 	uint32_t pending_task_count;
+	EV_DIS_DOMAIN_STATE state;
+	ev_dis_worker_t *worker;		/* Deque holding the domain, if QUEUED */
+	task_priority_t sched_priority;		/* Priority it is queued with, if QUEUED */
+	glthread_t glue;
+};
+GLTHREAD_TO_STRUCT(glue_to_domain,
+	ev_dis_domain_t, glue);
+
+/* Owner takes runnable domains from the front of its deques,
+ * idle workers steal from the back of other workers' deques */
+struct ev_dis_worker_{
+
+	uint32_t worker_id;
+	pthread_t thread;
+	pthread_mutex_t deque_mutex;
+	ev_dis_fifo_t deque[TASK_PRIORITY_MAX];
+	uint32_t n_tasks_run;
+	uint32_t n_steals;
+};
 
-	glthread_t pkt_queue_head;
+#define EV_DIS_MAX_WORKERS	16
+
+/* Timers. Expiry runs the timer callback as a task in the timer's
+ * domain, so timed work never blocks a worker. Timers live in a hashed
+ * hierarchical wheel driven by the monotonic clock, arm and cancel are
+ * O(1). An expiry which finds the previous one still queued is
+ * coalesced with it. */
+typedef struct ev_dis_timer_ ev_dis_timer_t;
+
+#define EV_DIS_TIMER_TICK_MSEC		10
+#define EV_DIS_TIMER_WHEEL_LEVELS	4
+#define EV_DIS_TIMER_WHEEL_BITS		6
+#define EV_DIS_TIMER_WHEEL_SLOTS	(1 << EV_DIS_TIMER_WHEEL_BITS)
+#define EV_DIS_TIMER_WHEEL_MASK		(EV_DIS_TIMER_WHEEL_SLOTS - 1)
+/* Farthest expiry the wheel holds, later ones are parked at the edge */
+#define EV_DIS_TIMER_MAX_TICKS	\
+	((1ULL << (EV_DIS_TIMER_WHEEL_BITS * EV_DIS_TIMER_WHEEL_LEVELS)) - 1)
+
+struct ev_dis_timer_{
+
+	event_cbk cbk;
+	void *arg;
+	uint64_t expires;		/* In ticks */
+	uint32_t period_ticks;		/* 0 for one shot timers */
+	bool armed;
+	task_t task;
+	glthread_t wheel_glue;
+};
+GLTHREAD_TO_STRUCT(wheel_glue_to_timer,
+	ev_dis_timer_t, wheel_glue);
+
+typedef struct ev_dis_timer_wheel_{
+
+	pthread_mutex_t wheel_mutex;
+	pthread_cond_t wheel_cond;	/* Ticks with CLOCK_MONOTONIC */
+	uint64_t start_msec;		/* Monotonic time of tick 0 */
+	uint64_t curr_tick;		/* Next tick to process */
+	uint32_t n_armed;
+	uint64_t n_expired;
+	glthread_t slots[EV_DIS_TIMER_WHEEL_LEVELS][EV_DIS_TIMER_WHEEL_SLOTS];
+	pthread_t thread;
+} ev_dis_timer_wheel_t;
 
-	EV_DISPATCHER_STATE ev_dis_state;
+struct event_dispatcher_{
 
+	/* Guards worker sleep/wake up and synchronous task completion */
+	pthread_mutex_t ev_dis_mutex;
 	pthread_cond_t ev_dis_cond_wait;
-	bool signal_sent;
+	uint32_t n_idle_workers;
+	uint32_t n_runnable_domains;	/* Domains sitting in deques, atomic */
 	uint32_t signal_sent_cnt;
 	uint32_t signal_recv_cnt;
-	pthread_t *thread;	
 
-	task_t *current_task;
+	glthread_t pkt_queue_head;
+
+	ev_dis_domain_t default_domain;
+
+	uint32_t n_workers;
+	uint32_t next_worker;		/* Round robin for schedules by non worker threads */
+	ev_dis_worker_t workers[EV_DIS_MAX_WORKERS];
+	ev_dis_timer_wheel_t timer_wheel;
+	bool running;
 };
 
 #define EV_DIS_LOCK(ev_dis_ptr)		\
@@ -121,35 +256,128 @@ eve_dis_get_current_task();
 void
 event_dispatcher_init();
 
+/* Number of worker threads, to be set before event_dispatcher_run(),
+ * default is 1 */
+void
+event_dispatcher_set_n_workers(uint32_t n_workers);
+
+uint32_t
+event_dispatcher_get_n_workers();
+
+/* Snapshot of the dispatcher counters, read without stopping
+ * the workers hence only approximately consistent */
+typedef struct ev_dis_stats_{
+
+	uint32_t n_workers;
+	uint32_t n_idle_workers;
+	uint32_t n_runnable_domains;
+	uint64_t n_tasks_run[EV_DIS_MAX_WORKERS];
+	uint64_t n_steals[EV_DIS_MAX_WORKERS];
+	uint32_t n_timers_armed;
+	uint64_t n_timers_expired;
+	uint32_t n_pkt_queues;
+	uint64_t n_pkt_drops;		/* Summed over all pkt queues */
+} ev_dis_stats_t;
+
+void
+event_dispatcher_get_stats(ev_dis_stats_t *stats);
+
 void
 event_dispatcher_run();
 
+void
+ev_dis_domain_init(ev_dis_domain_t *domain, const char *name);
+
 task_t *
 task_create_new_job(
     void *data,
     event_cbk cbk,
 	task_type_t task_type);
 
+/* domain NULL is the default domain */
+task_t *
+task_create_new_job_in_domain(
+    void *data,
+    event_cbk cbk,
+	task_type_t task_type,
+	task_priority_t priority,
+	ev_dis_domain_t *domain);
+
+/* Synchronous schedules return once the task has run,
+ * the task is released by then and NULL is returned */
 task_t *
 task_create_new_job_synchronous(
     void *data,
     event_cbk cbk,
 	task_type_t task_type);
 
+task_t *
+task_create_new_job_synchronous_in_domain(
+    void *data,
+    event_cbk cbk,
+	task_type_t task_type,
+	task_priority_t priority,
+	ev_dis_domain_t *domain);
+
 void
 task_cancel_job(task_t *task);
 
 void
 init_pkt_q(pkt_q_t *pkt_q, event_cbk cbk);
 
+/* ring_size is rounded up to a power of 2. Pkts are copied into
+ * the ring on enqueue, so the sender may reuse its buffer at once */
 void
+init_pkt_q_mpsc(pkt_q_t *pkt_q, event_cbk cbk,
+				uint32_t ring_size, uint32_t max_pkt_size);
+
+/* Safe to call from any number of threads. Returns false if
+ * the pkt is dropped : ring is full or pkt is too big */
+bool
 pkt_q_enqueue(pkt_q_t *pkt_q,
 			  char *pkt, uint32_t pkt_size);
 
+/* In PKT_Q_MODE_MPSC_RING, pkts returned point into the ring and stay
+ * valid until the next task_get_next_pkt[_batch]() call or until
+ * the pkt Q task returns, whichever comes first */
 char *
 task_get_next_pkt(uint32_t *pkt_size);
 
+uint32_t
+task_get_next_pkt_batch(char **pkts, uint32_t *pkt_sizes,
+						uint32_t max_pkts);
+
 void
 task_schedule_again(task_t *task);
 
+/* Timers */
+uint64_t
+ev_dis_get_monotonic_msec();
+
+/* domain NULL is the default domain */
+void
+ev_dis_timer_init(ev_dis_timer_t *timer,
+				  event_cbk cbk, void *arg,
+				  task_priority_t priority,
+				  ev_dis_domain_t *domain);
+
+/* Arms (or re-arms) timer to expire after expire_msec, and then
+ * every period_msec if period_msec is non zero */
+void
+ev_dis_timer_arm(ev_dis_timer_t *timer,
+				 uint32_t expire_msec,
+				 uint32_t period_msec);
+
+/* An expiry already running is not interrupted, one still queued
+ * is dropped. The timer may be released once cancelled from its own
+ * domain, or from its own callback */
+void
+ev_dis_timer_cancel(ev_dis_timer_t *timer);
+
+bool
+ev_dis_timer_is_armed(ev_dis_timer_t *timer);
+
+uint32_t
+ev_dis_timer_remaining_msec(ev_dis_timer_t *timer);
+
 #endif /* EVENT_DISPATCHER  */
@@ -3,7 +3,9 @@
  *
  *       Filename:  main_pkt_q.c
  *
- *    Description: This file demonstrates the use of pkt Q tasks 
+ *    Description: This file demonstrates the use of pkt Q tasks, and
+ *                 benchmarks pkt Q throughput :
+ *                 ./main_pkt_q.exe bench [producers] [pkts per producer] [workers]
  *
  *        Version:  1.0
  *        Created:  10/21/2020 10:46:38 AM
@@ -18,7 +20,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <sched.h>
 #include "event_dispatcher.h"
 
 static pkt_q_t pkt_queue1;
@@ -87,9 +91,154 @@ pkt_reciever3(void *_pkt, uint32_t pkt_size) {
 	}
 }
 
+/* Throughput benchmark. Producer threads blast fixed size pkts into a
+ * pkt Q, the pkt Q task drains it in batches. Each pkt carries its
+ * producer id and sequence no, so that the ring is checked for loss
+ * and per producer FIFO order as well */
+
+#define BENCH_PKT_SIZE		64
+#define BENCH_BATCH_SIZE	64
+#define BENCH_RING_SIZE		(64 * 1024)
+#define BENCH_MAX_PRODUCERS	64
+
+typedef struct bench_pkt_{
+
+	uint32_t producer_id;
+	uint64_t seq_no;
+	char payload[BENCH_PKT_SIZE - 16];
+} bench_pkt_t;
+
+typedef struct bench_producer_{
+
+	uint32_t producer_id;
+	uint32_t n_pkts;
+	pkt_q_t *pkt_q;
+	uint64_t n_retries;		/* Enqueues refused because ring was full */
+	bench_pkt_t pkt;		/* Locked mode queues pkts by reference */
+	pthread_t thread;
+} bench_producer_t;
+
+static pkt_q_t bench_locked_q;
+static pkt_q_t bench_mpsc_q;
+static uint64_t bench_n_recvd;
+static uint64_t bench_n_misordered;
+static uint64_t bench_next_seq_no[BENCH_MAX_PRODUCERS];
+
+static void
+bench_pkt_reciever(void *arg, uint32_t arg_size) {
+
+	uint32_t i, n;
+	bench_pkt_t *pkt;
+	pkt_q_t *pkt_q = (pkt_q_t *)arg;
+	char *pkts[BENCH_BATCH_SIZE];
+	uint32_t pkt_sizes[BENCH_BATCH_SIZE];
+
+	while((n = task_get_next_pkt_batch(pkts, pkt_sizes, BENCH_BATCH_SIZE))) {
+
+		if (pkt_q->mode == PKT_Q_MODE_MPSC_RING) {
+			for (i = 0; i < n; i++) {
+				pkt = (bench_pkt_t *)pkts[i];
+				if (pkt->seq_no != bench_next_seq_no[pkt->producer_id])
+					bench_n_misordered++;
+				bench_next_seq_no[pkt->producer_id] = pkt->seq_no + 1;
+			}
+		}
+		__atomic_fetch_add(&bench_n_recvd, n, __ATOMIC_RELEASE);
+	}
+}
+
+static void *
+bench_producer_fn(void *arg) {
+
+	uint32_t i;
+	bench_producer_t *producer = (bench_producer_t *)arg;
+
+	producer->pkt.producer_id = producer->producer_id;
+
+	for (i = 0; i < producer->n_pkts; i++) {
+		producer->pkt.seq_no = i;
+		while (!pkt_q_enqueue(producer->pkt_q, (char *)&producer->pkt,
+					sizeof(bench_pkt_t))) {
+			producer->n_retries++;
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void
+pkt_q_bench_run(pkt_q_t *pkt_q, uint32_t n_producers, uint32_t n_pkts) {
+
+	uint32_t i;
+	uint64_t n_retries = 0, start_msec, elapsed_msec;
+	uint64_t n_total = (uint64_t)n_producers * n_pkts;
+	bench_producer_t *producers = calloc(n_producers, sizeof(bench_producer_t));
+
+	__atomic_store_n(&bench_n_recvd, 0, __ATOMIC_RELEASE);
+	bench_n_misordered = 0;
+	memset(bench_next_seq_no, 0, sizeof(bench_next_seq_no));
+
+	start_msec = ev_dis_get_monotonic_msec();
+
+	for (i = 0; i < n_producers; i++) {
+		producers[i].producer_id = i;
+		producers[i].n_pkts = n_pkts;
+		producers[i].pkt_q = pkt_q;
+		pthread_create(&producers[i].thread, NULL, bench_producer_fn, &producers[i]);
+	}
+
+	for (i = 0; i < n_producers; i++) {
+		pthread_join(producers[i].thread, NULL);
+		n_retries += producers[i].n_retries;
+	}
+
+	while (__atomic_load_n(&bench_n_recvd, __ATOMIC_ACQUIRE) < n_total)
+		sched_yield();
+
+	elapsed_msec = ev_dis_get_monotonic_msec() - start_msec;
+	if (!elapsed_msec) elapsed_msec = 1;
+
+	printf("%-10s : %u producers, %lu pkts in %lu msec, %.2f Mpps, "
+		   "full ring retries %lu",
+		   pkt_q->mode == PKT_Q_MODE_MPSC_RING ? "mpsc ring" : "locked",
+		   n_producers, n_total, elapsed_msec,
+		   (double)n_total / elapsed_msec / 1000, n_retries);
+	if (pkt_q->mode == PKT_Q_MODE_MPSC_RING)
+		printf(", misordered %lu", bench_n_misordered);
+	printf("\n");
+	free(producers);
+}
+
+static int
+pkt_q_bench(int argc, char **argv) {
+
+	uint32_t n_producers = argc > 2 ? atoi(argv[2]) : 4;
+	uint32_t n_pkts = argc > 3 ? atoi(argv[3]) : 1000000;
+	uint32_t n_workers = argc > 4 ? atoi(argv[4]) : 1;
+
+	if (!n_producers || n_producers > BENCH_MAX_PRODUCERS) {
+		printf("producers must be 1 - %u\n", BENCH_MAX_PRODUCERS);
+		return -1;
+	}
+
+	event_dispatcher_init();
+	event_dispatcher_set_n_workers(n_workers);
+	init_pkt_q(&bench_locked_q, bench_pkt_reciever);
+	init_pkt_q_mpsc(&bench_mpsc_q, bench_pkt_reciever,
+		BENCH_RING_SIZE, sizeof(bench_pkt_t));
+	event_dispatcher_run();
+
+	pkt_q_bench_run(&bench_locked_q, n_producers, n_pkts);
+	pkt_q_bench_run(&bench_mpsc_q, n_producers, n_pkts);
+	return 0;
+}
+
 int
 main(int argc, char **argv){
 
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+		return pkt_q_bench(argc, argv);
+
 	/*  init the event dispatcher */
 	event_dispatcher_init();
 
@@ -0,0 +1,332 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  hash_vector.c
+ *
+ *    Description:  Keyed container : a contiguous vector of data pointers
+ *                  indexed by an open addressing hash table
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 10:12:40  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include "hash_vector.h"
+#include "../LinuxMemoryManager/uapi_mm.h"
+
+#define HASH_VECTOR_SLOT_MASK(hv)   ((hv)->n_slots - 1)
+
+hash_vector_t *
+init_hash_vector(){
+
+    return XCALLOC(1, hash_vector_t);
+}
+
+void
+hash_vector_set_comparison_fn(hash_vector_t *hv,
+        int (*comparison_fn)(void *, void *)){
+
+    hv->comparison_fn = comparison_fn;
+}
+
+void
+hash_vector_set_order_comparison_fn(hash_vector_t *hv,
+        int (*order_comparison_fn)(void *, void *)){
+
+    hv->order_comparison_fn = order_comparison_fn;
+}
+
+void
+hash_vector_set_hash_fns(hash_vector_t *hv,
+        uint32_t (*data_hash_fn)(void *),
+        uint32_t (*key_hash_fn)(void *)){
+
+    assert(!hv->count);
+    hv->data_hash_fn = data_hash_fn;
+    hv->key_hash_fn = key_hash_fn;
+}
+
+uint32_t
+hash_vector_ptr_hash(void *ptr){
+
+    uint64_t x = (uint64_t)(uintptr_t)ptr;
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
+/*FNV-1a*/
+uint32_t
+hash_vector_str_hash(const char *str, unsigned int max_len){
+
+    uint32_t hash = 2166136261u;
+    unsigned int i = 0;
+
+    for(i = 0; i < max_len && str[i]; i++){
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t
+hash_vector_hash_combine(uint32_t hash, uint32_t value){
+
+    return hash ^ (value + 0x9e3779b9u + (hash << 6) + (hash >> 2));
+}
+
+static void
+hash_vector_slot_insert(hash_vector_t *hv, uint32_t hash, uint32_t pos){
+
+    uint32_t i = hash & HASH_VECTOR_SLOT_MASK(hv);
+
+    while(hv->slots[i].pos)
+        i = (i + 1) & HASH_VECTOR_SLOT_MASK(hv);
+
+    hv->slots[i].hash = hash;
+    hv->slots[i].pos = pos;
+}
+
+/*Backward shift deletion, keeps probe sequences intact without tombstones*/
+static void
+hash_vector_slot_delete(hash_vector_t *hv, uint32_t i){
+
+    uint32_t j = i, home;
+
+    while(1){
+        j = (j + 1) & HASH_VECTOR_SLOT_MASK(hv);
+        if(!hv->slots[j].pos)
+            break;
+        home = hv->slots[j].hash & HASH_VECTOR_SLOT_MASK(hv);
+        /*Slot j may move to i only if its home does not lie in (i, j]*/
+        if((i <= j) ? (i < home && home <= j) : (i < home || home <= j))
+            continue;
+        hv->slots[i] = hv->slots[j];
+        i = j;
+    }
+    hv->slots[i].pos = 0;
+}
+
+static int
+hash_vector_slot_by_data_ptr(hash_vector_t *hv, void *data){
+
+    uint32_t hash, i;
+
+    if(!hv->count)
+        return -1;
+
+    hash = hv->data_hash_fn(data);
+    i = hash & HASH_VECTOR_SLOT_MASK(hv);
+
+    while(hv->slots[i].pos){
+        if(hv->slots[i].hash == hash &&
+            hv->entries[hv->slots[i].pos - 1].data == data)
+            return (int)i;
+        i = (i + 1) & HASH_VECTOR_SLOT_MASK(hv);
+    }
+    return -1;
+}
+
+static void
+hash_vector_reindex(hash_vector_t *hv){
+
+    unsigned int i = 0;
+
+    memset(hv->slots, 0, hv->n_slots * sizeof(hash_vector_slot_t));
+    for(i = 0; i < hv->count; i++){
+        hash_vector_slot_insert(hv,
+            hv->data_hash_fn(hv->entries[i].data), i + 1);
+    }
+}
+
+static void
+hash_vector_grow(hash_vector_t *hv){
+
+    unsigned int capacity = hv->capacity ?
+        hv->capacity * 2 : HASH_VECTOR_DEFAULT_SIZE;
+    hash_vector_entry_t *entries = XCALLOC(capacity, hash_vector_entry_t);
+
+    if(hv->entries){
+        memcpy(entries, hv->entries, hv->count * sizeof(hash_vector_entry_t));
+        XFREE(hv->entries);
+    }
+    hv->entries = entries;
+    hv->capacity = capacity;
+
+    if(hv->slots)
+        XFREE(hv->slots);
+    hv->n_slots = capacity * 2;
+    hv->slots = XCALLOC(hv->n_slots, hash_vector_slot_t);
+    hash_vector_reindex(hv);
+}
+
+int
+hash_vector_insert_at(hash_vector_t *hv, unsigned int pos, void *data){
+
+    unsigned int i = 0;
+
+    assert(hv->data_hash_fn && hv->key_hash_fn);
+    assert(pos <= hv->count);
+
+    if(hash_vector_slot_by_data_ptr(hv, data) >= 0)
+        return -1;
+
+    if(hv->count == hv->capacity)
+        hash_vector_grow(hv);
+
+    if(pos < hv->count){
+        memmove(&hv->entries[pos + 1], &hv->entries[pos],
+            (hv->count - pos) * sizeof(hash_vector_entry_t));
+        for(i = 0; i < hv->n_slots; i++){
+            if(hv->slots[i].pos > pos)
+                hv->slots[i].pos++;
+        }
+    }
+    hv->entries[pos].data = data;
+    hv->count++;
+    hash_vector_slot_insert(hv, hv->data_hash_fn(data), pos + 1);
+    return 0;
+}
+
+int
+hash_vector_add(hash_vector_t *hv, void *data){
+
+    return hash_vector_insert_at(hv, hv->count, data);
+}
+
+void *
+hash_vector_search_by_key(hash_vector_t *hv, void *key){
+
+    uint32_t hash, i;
+    void *data = NULL;
+
+    assert(hv);
+    if(!key || !hv->count)
+        return NULL;
+
+    hash = hv->key_hash_fn(key);
+    i = hash & HASH_VECTOR_SLOT_MASK(hv);
+
+    while(hv->slots[i].pos){
+        if(hv->slots[i].hash == hash){
+            data = hv->entries[hv->slots[i].pos - 1].data;
+            if(hv->comparison_fn(data, key))
+                return data;
+        }
+        i = (i + 1) & HASH_VECTOR_SLOT_MASK(hv);
+    }
+    return NULL;
+}
+
+int
+hash_vector_is_present(hash_vector_t *hv, void *data){
+
+    return hash_vector_slot_by_data_ptr(hv, data) >= 0;
+}
+
+int
+hash_vector_get_position(hash_vector_t *hv, void *data){
+
+    int slot = hash_vector_slot_by_data_ptr(hv, data);
+
+    if(slot < 0)
+        return -1;
+    return (int)hv->slots[slot].pos - 1;
+}
+
+int
+hash_vector_remove_by_data_ptr(hash_vector_t *hv, void *data){
+
+    int slot = hash_vector_slot_by_data_ptr(hv, data);
+    uint32_t pos;
+
+    if(slot < 0)
+        return -1;
+
+    pos = hv->slots[slot].pos;
+    hash_vector_slot_delete(hv, (uint32_t)slot);
+
+    if(pos != hv->count){
+        /*Move the last data item in the hole*/
+        slot = hash_vector_slot_by_data_ptr(hv,
+                    hv->entries[hv->count - 1].data);
+        assert(slot >= 0);
+        hv->slots[slot].pos = pos;
+        hv->entries[pos - 1] = hv->entries[hv->count - 1];
+    }
+    hv->count--;
+    return 0;
+}
+
+int
+hash_vector_remove_ordered_by_data_ptr(hash_vector_t *hv, void *data){
+
+    int slot = hash_vector_slot_by_data_ptr(hv, data);
+    uint32_t pos, i;
+
+    if(slot < 0)
+        return -1;
+
+    pos = hv->slots[slot].pos;
+    hash_vector_slot_delete(hv, (uint32_t)slot);
+
+    memmove(&hv->entries[pos - 1], &hv->entries[pos],
+        (hv->count - pos) * sizeof(hash_vector_entry_t));
+    hv->count--;
+
+    for(i = 0; i < hv->n_slots; i++){
+        if(hv->slots[i].pos > pos)
+            hv->slots[i].pos--;
+    }
+    return 0;
+}
+
+void
+hash_vector_clear(hash_vector_t *hv){
+
+    if(!hv->count)
+        return;
+    memset(hv->slots, 0, hv->n_slots * sizeof(hash_vector_slot_t));
+    hv->count = 0;
+}
+
+void
+delete_hash_vector(hash_vector_t *hv){
+
+    if(hv->entries)
+        XFREE(hv->entries);
+    if(hv->slots)
+        XFREE(hv->slots);
+    hv->entries = NULL;
+    hv->slots = NULL;
+    hv->count = 0;
+    hv->capacity = 0;
+    hv->n_slots = 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  hash_vector.h
+ *
+ *    Description:  Keyed container : a contiguous vector of data pointers
+ *                  indexed by an open addressing hash table
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 10:12:40  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __HASH_VECTOR__
+#define __HASH_VECTOR__
+
+#include <stdint.h>
+
+/* hash_vector_t is a drop in for ll_t wherever the list is searched
+ * by key. It keeps the comparison fn plug-in model of ll_t, plus a pair
+ * of hash fns which must agree : data_hash_fn(data) == key_hash_fn(key)
+ * whenever comparison_fn(data, key) matches.
+ *
+ * Data lives in a contiguous vector in insertion order (unless removed
+ * with the unordered remove), lookups by key and by data ptr go through
+ * a linear probing hash index and cost O(1). Like ll_t, adding the same
+ * data ptr twice is refused, keeping keys unique is up to the caller.*/
+
+#define HASH_VECTOR_DEFAULT_SIZE    8
+
+typedef struct hash_vector_entry_{
+    void *data;
+} hash_vector_entry_t;
+
+/*Index slot, pos is 1 + position of the data in vector, 0 if slot is free*/
+typedef struct hash_vector_slot_{
+    uint32_t hash;
+    uint32_t pos;
+} hash_vector_slot_t;
+
+typedef struct hash_vector_{
+    unsigned int count;
+    unsigned int capacity;
+    hash_vector_entry_t *entries;
+    unsigned int n_slots;               /*Power of 2, at least twice the capacity*/
+    hash_vector_slot_t *slots;
+    int (*comparison_fn)(void *data, void *key);    /*return 1 if data has key*/
+    int (*order_comparison_fn)(void *, void *);
+    uint32_t (*data_hash_fn)(void *data);
+    uint32_t (*key_hash_fn)(void *key);
+} hash_vector_t;
+
+hash_vector_t *init_hash_vector();
+void hash_vector_set_comparison_fn(hash_vector_t *hv, int (*comparison_fn)(void *, void *));
+void hash_vector_set_order_comparison_fn(hash_vector_t *hv, int (*order_comparison_fn)(void *, void *));
+void hash_vector_set_hash_fns(hash_vector_t *hv,
+        uint32_t (*data_hash_fn)(void *), uint32_t (*key_hash_fn)(void *));
+
+/*Return 0 on success, -1 if data is already present*/
+int hash_vector_add(hash_vector_t *hv, void *data);
+int hash_vector_insert_at(hash_vector_t *hv, unsigned int pos, void *data);
+
+void * hash_vector_search_by_key(hash_vector_t *hv, void *key);
+int hash_vector_is_present(hash_vector_t *hv, void *data);
+/*Position of data in the vector, -1 if not present*/
+int hash_vector_get_position(hash_vector_t *hv, void *data);
+
+/*O(1), the last data item takes the place of the removed one*/
+int hash_vector_remove_by_data_ptr(hash_vector_t *hv, void *data);
+/*O(n), the order of the remaining data items is preserved*/
+int hash_vector_remove_ordered_by_data_ptr(hash_vector_t *hv, void *data);
+
+/*Drop all data items, storage is kept for reuse*/
+void hash_vector_clear(hash_vector_t *hv);
+/*Release the storage, hv itself is not freed*/
+void delete_hash_vector(hash_vector_t *hv);
+
+/*Hash fns for the common key types*/
+uint32_t hash_vector_ptr_hash(void *ptr);
+uint32_t hash_vector_str_hash(const char *str, unsigned int max_len);
+uint32_t hash_vector_hash_combine(uint32_t hash, uint32_t value);
+
+#define HASH_VECTOR_COUNT(hv)           ((hv)->count)
+#define IS_HASH_VECTOR_EMPTY(hv)        ((hv)->count == 0)
+#define HASH_VECTOR_DATA(hv, i)         ((hv)->entries[i].data)
+
+#define ITERATE_HASH_VECTOR_BEGIN(hv_ptr, data_ptr)                         \
+    {                                                                       \
+    unsigned int _hv_i = 0;                                                 \
+    for(; _hv_i < (hv_ptr)->count; _hv_i++){                                \
+        data_ptr = (hv_ptr)->entries[_hv_i].data;
+
+#define ITERATE_HASH_VECTOR_END  }}
+
+#endif /* __HASH_VECTOR__ */
@@ -30,10 +30,15 @@
  * =====================================================================================
  */
 
+#include <pthread.h>
+#include <time.h>
 #include "libtrace.h"
 
 char fn_line_buff[FN_LINE_BUFFER_SIZE];
 
+#define TR_EVENT_ID_INVALID     0xFFFFFFFF
+#define TR_TEXT_BUFFER_SIZE     1024
+
 void
 trace_enable(traceoptions *traceopts, tr_boolean enable){
         traceopts->enable = enable;
@@ -52,7 +57,7 @@ void
 trace_set_log_medium(traceoptions *traceopts, log_storage_t logstorage){
 
     traceopts->logstorage = logstorage;
-    if(logstorage == CONSOLE){
+    if(logstorage != LOG_FILE){
         if(traceopts->logf_fd){
             fclose(traceopts->logf_fd);
             traceopts->logf_fd = NULL;
@@ -82,3 +87,418 @@ disable_trace_event(traceoptions *traceopts, unsigned long long bit){
     TR_UNSET_BIT(traceopts->bit_mask, bit);
 }
 
+/*Structured tracing*/
+
+static tr_event_desc_t *tr_events[TR_MAX_EVENTS];
+static uint32_t tr_n_events = 0;
+static pthread_mutex_t tr_events_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static tr_ring_t *tr_rings = NULL;
+static uint32_t tr_n_rings = 0;
+static uint32_t tr_ring_n_records = TR_RING_DEFAULT_RECORDS;
+static pthread_mutex_t tr_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread tr_ring_t *tr_curr_ring = NULL;
+static __thread char tr_text_buff[TR_TEXT_BUFFER_SIZE];
+
+/*Return the length of the conversion spec starting at fmt[0] == '%',
+ * 0 if it is not supported. arg_type is set for specs which take an arg*/
+static unsigned int
+trace_fmt_spec(const char *fmt, int *arg_type){
+
+    unsigned int i = 1, n_long = 0;
+
+    while(fmt[i] && strchr("-+ #0", fmt[i])) i++;
+    while(fmt[i] >= '0' && fmt[i] <= '9') i++;
+    if(fmt[i] == '.'){
+        i++;
+        while(fmt[i] >= '0' && fmt[i] <= '9') i++;
+    }
+    while(fmt[i] && strchr("hlzjt", fmt[i])){
+        if(fmt[i] != 'h') n_long++;
+        i++;
+    }
+
+    switch(fmt[i]){
+        case 'd': case 'i': case 'c':
+            *arg_type = n_long ? TR_ARG_LONG : TR_ARG_INT;
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            *arg_type = n_long ? TR_ARG_ULONG : TR_ARG_UINT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            *arg_type = TR_ARG_DOUBLE;
+            break;
+        case 's':
+            *arg_type = TR_ARG_STR;
+            break;
+        case 'p':
+            *arg_type = TR_ARG_PTR;
+            break;
+        default:
+            /*'*' width, %n and friends*/
+            return 0;
+    }
+    return i + 1;
+}
+
+int
+trace_event_parse_fmt(tr_event_desc_t *event_desc){
+
+    int arg_type;
+    unsigned int spec_len;
+    const char *fmt = event_desc->fmt;
+
+    event_desc->n_args = 0;
+
+    while(*fmt){
+
+        if(*fmt != '%'){
+            fmt++;
+            continue;
+        }
+        if(*(fmt + 1) == '%'){
+            fmt += 2;
+            continue;
+        }
+        spec_len = trace_fmt_spec(fmt, &arg_type);
+        if(!spec_len || event_desc->n_args == TR_MAX_EVENT_ARGS)
+            return -1;
+        event_desc->arg_types[event_desc->n_args++] = (uint8_t)arg_type;
+        fmt += spec_len;
+    }
+    return 0;
+}
+
+static void
+trace_event_register(tr_event_desc_t *event_desc){
+
+    pthread_mutex_lock(&tr_events_mutex);
+
+    if(__atomic_load_n(&event_desc->event_id, __ATOMIC_ACQUIRE)){
+        /*Another thread got here first*/
+        pthread_mutex_unlock(&tr_events_mutex);
+        return;
+    }
+
+    if(tr_n_events + 1 == TR_MAX_EVENTS ||
+        trace_event_parse_fmt(event_desc) < 0){
+        /*Such events are always formatted as text*/
+        __atomic_store_n(&event_desc->event_id, TR_EVENT_ID_INVALID, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&tr_events_mutex);
+        return;
+    }
+
+    tr_n_events++;
+    tr_events[tr_n_events] = event_desc;
+    __atomic_store_n(&event_desc->event_id, tr_n_events, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&tr_events_mutex);
+}
+
+void
+trace_ring_set_size(uint32_t n_records){
+
+    uint32_t size = 1;
+
+    while(size < n_records) size <<= 1;
+    tr_ring_n_records = size;
+}
+
+static tr_ring_t *
+trace_ring_new(){
+
+    tr_ring_t *ring = calloc(1, sizeof(tr_ring_t));
+
+    ring->n_records = tr_ring_n_records;
+    ring->records = calloc(ring->n_records, sizeof(tr_ring_record_t));
+
+    pthread_mutex_lock(&tr_rings_mutex);
+    ring->ring_id = tr_n_rings++;
+    ring->next = tr_rings;
+    tr_rings = ring;
+    pthread_mutex_unlock(&tr_rings_mutex);
+
+    tr_curr_ring = ring;
+    return ring;
+}
+
+static uint64_t
+trace_get_monotonic_nsec(){
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static void
+trace_ring_write(tr_event_desc_t *event_desc, va_list ap){
+
+    uint8_t i;
+    uint64_t idx, u64;
+    double dbl;
+    const char *str;
+    unsigned int len, offset = 0;
+    tr_ring_t *ring = tr_curr_ring ? tr_curr_ring : trace_ring_new();
+    tr_ring_record_t *record;
+
+    idx = ring->w_idx;
+    record = &ring->records[idx & (ring->n_records - 1)];
+
+    /*Let a concurrent dump tell a half written record*/
+    __atomic_store_n(&record->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record->timestamp_ns = trace_get_monotonic_nsec();
+    record->event_id = event_desc->event_id;
+
+    for(i = 0; i < event_desc->n_args; i++){
+
+        switch(event_desc->arg_types[i]){
+            case TR_ARG_INT:
+                u64 = (uint64_t)(int64_t)va_arg(ap, int);
+                break;
+            case TR_ARG_UINT:
+                u64 = va_arg(ap, unsigned int);
+                break;
+            case TR_ARG_LONG:
+                u64 = (uint64_t)va_arg(ap, long);
+                break;
+            case TR_ARG_ULONG:
+                u64 = va_arg(ap, unsigned long);
+                break;
+            case TR_ARG_DOUBLE:
+                dbl = va_arg(ap, double);
+                memcpy(&u64, &dbl, sizeof(u64));
+                break;
+            case TR_ARG_PTR:
+                u64 = (uint64_t)(uintptr_t)va_arg(ap, void *);
+                break;
+            case TR_ARG_STR:
+                str = va_arg(ap, const char *);
+                if(!str) str = "(null)";
+                if(offset == sizeof(record->args))
+                    goto done;
+                len = strlen(str);
+                if(len > 255) len = 255;
+                /*Truncate, rather than drop, long strings*/
+                if(offset + 1 + len > sizeof(record->args))
+                    len = sizeof(record->args) - offset - 1;
+                record->args[offset] = (unsigned char)len;
+                memcpy(&record->args[offset + 1], str, len);
+                offset += 1 + len;
+                continue;
+            default:
+                goto done;
+        }
+        if(offset + sizeof(u64) > sizeof(record->args))
+            goto done;
+        memcpy(&record->args[offset], &u64, sizeof(u64));
+        offset += sizeof(u64);
+    }
+
+    done:
+    record->args_len = offset;
+    __atomic_store_n(&record->seq, idx + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->w_idx, idx + 1, __ATOMIC_RELEASE);
+}
+
+void
+trace_log_event(traceoptions *traceopts, tr_event_desc_t *event_desc,
+    const char *fmt, ...){
+
+    va_list ap;
+    uint32_t event_id;
+
+    va_start(ap, fmt);
+
+    if(traceopts->logstorage == TRACE_RING){
+        event_id = __atomic_load_n(&event_desc->event_id, __ATOMIC_ACQUIRE);
+        if(!event_id){
+            trace_event_register(event_desc);
+            event_id = event_desc->event_id;
+        }
+        if(event_id != TR_EVENT_ID_INVALID){
+            trace_ring_write(event_desc, ap);
+            va_end(ap);
+            return;
+        }
+    }
+
+    vsnprintf(tr_text_buff, sizeof(tr_text_buff), fmt, ap);
+    va_end(ap);
+
+    if(traceopts->logstorage == LOG_FILE && traceopts->logf_fd)
+        fprintf(traceopts->logf_fd, "%s(%u) : %s\n", event_desc->fn,
+            event_desc->line, tr_text_buff);
+    else
+        printf("%s(%d) : %s\n", event_desc->fn, event_desc->line, tr_text_buff);
+}
+
+int
+trace_ring_record_render(tr_event_desc_t *event_desc,
+    tr_ring_record_t *record, char *buff, unsigned int buff_size){
+
+    int arg_type;
+    uint8_t arg_no = 0;
+    uint64_t u64;
+    double dbl;
+    char spec[32], str[256];
+    unsigned int spec_len, len, offset = 0, n = 0;
+    const char *fmt = event_desc->fmt;
+
+#define TR_RENDER(...)                                                      n += snprintf(buff + n, n < buff_size ? buff_size - n : 0, __VA_ARGS__)
+
+    while(*fmt){
+
+        if(*fmt != '%'){
+            TR_RENDER("%c", *fmt++);
+            continue;
+        }
+        if(*(fmt + 1) == '%'){
+            TR_RENDER("%%");
+            fmt += 2;
+            continue;
+        }
+
+        spec_len = trace_fmt_spec(fmt, &arg_type);
+        if(!spec_len || spec_len >= sizeof(spec) ||
+            arg_no == event_desc->n_args)
+            break;
+        memcpy(spec, fmt, spec_len);
+        spec[spec_len] = '\0';
+        fmt += spec_len;
+        arg_no++;
+
+        if(arg_type == TR_ARG_STR){
+            if(offset >= record->args_len){
+                TR_RENDER("<truncated>");
+                break;
+            }
+            len = record->args[offset];
+            if(offset + 1 + len > record->args_len)
+                len = record->args_len - offset - 1;
+            memcpy(str, &record->args[offset + 1], len);
+            str[len] = '\0';
+            offset += 1 + len;
+            TR_RENDER(spec, str);
+            continue;
+        }
+
+        if(offset + sizeof(u64) > record->args_len){
+            TR_RENDER("<truncated>");
+            break;
+        }
+        memcpy(&u64, &record->args[offset], sizeof(u64));
+        offset += sizeof(u64);
+
+        switch(arg_type){
+            case TR_ARG_INT:
+                TR_RENDER(spec, (int)(int64_t)u64);
+                break;
+            case TR_ARG_UINT:
+                TR_RENDER(spec, (unsigned int)u64);
+                break;
+            case TR_ARG_LONG:
+                TR_RENDER(spec, (long)u64);
+                break;
+            case TR_ARG_ULONG:
+                TR_RENDER(spec, (unsigned long)u64);
+                break;
+            case TR_ARG_DOUBLE:
+                memcpy(&dbl, &u64, sizeof(dbl));
+                TR_RENDER(spec, dbl);
+                break;
+            case TR_ARG_PTR:
+                TR_RENDER(spec, (void *)(uintptr_t)u64);
+                break;
+            default:
+                ;
+        }
+    }
+#undef TR_RENDER
+    return n;
+}
+
+static void
+trace_dump_write_event(FILE *fp, tr_event_desc_t *event_desc){
+
+    uint16_t fn_len = strlen(event_desc->fn),
+             fmt_len = strlen(event_desc->fmt);
+
+    fwrite(&event_desc->event_id, sizeof(uint32_t), 1, fp);
+    fwrite(&event_desc->trace_bit, sizeof(uint32_t), 1, fp);
+    fwrite(&event_desc->line, sizeof(uint32_t), 1, fp);
+    fwrite(&fn_len, sizeof(uint16_t), 1, fp);
+    fwrite(&fmt_len, sizeof(uint16_t), 1, fp);
+    fwrite(event_desc->fn, 1, fn_len, fp);
+    fwrite(event_desc->fmt, 1, fmt_len, fp);
+}
+
+/*Dump file :
+ * magic, version, record size, n_events, n_rings
+ * n_events x {event_id, trace_bit, line, fn_len, fmt_len, fn, fmt}
+ * n_rings x {ring_id, n_records, n_records x tr_ring_record_t}*/
+int
+trace_ring_dump(const char *file_name){
+
+    FILE *fp;
+    tr_ring_t *ring;
+    tr_ring_record_t *records;
+    uint64_t w_idx, pos, seq;
+    uint32_t i, n_rings, n_records, n_total = 0,
+             version = TR_RING_DUMP_VERSION,
+             record_size = sizeof(tr_ring_record_t);
+
+    fp = fopen(file_name, "w");
+    if(!fp)
+        return -1;
+
+    fwrite(TR_RING_DUMP_MAGIC, 1, strlen(TR_RING_DUMP_MAGIC), fp);
+    fwrite(&version, sizeof(uint32_t), 1, fp);
+    fwrite(&record_size, sizeof(uint32_t), 1, fp);
+
+    pthread_mutex_lock(&tr_events_mutex);
+    fwrite(&tr_n_events, sizeof(uint32_t), 1, fp);
+    for(i = 1; i <= tr_n_events; i++)
+        trace_dump_write_event(fp, tr_events[i]);
+    pthread_mutex_unlock(&tr_events_mutex);
+
+    /*Rings are never freed, the list is only ever prepended to*/
+    pthread_mutex_lock(&tr_rings_mutex);
+    ring = tr_rings;
+    n_rings = tr_n_rings;
+    pthread_mutex_unlock(&tr_rings_mutex);
+
+    fwrite(&n_rings, sizeof(uint32_t), 1, fp);
+
+    for( ; ring; ring = ring->next){
+
+        records = calloc(ring->n_records, sizeof(tr_ring_record_t));
+        n_records = 0;
+        w_idx = __atomic_load_n(&ring->w_idx, __ATOMIC_ACQUIRE);
+        pos = w_idx > ring->n_records ? w_idx - ring->n_records : 0;
+
+        /*Owner keeps writing, keep only records which did
+         * not change under our feet*/
+        for( ; pos < w_idx; pos++){
+            tr_ring_record_t *record = &ring->records[pos & (ring->n_records - 1)];
+            seq = __atomic_load_n(&record->seq, __ATOMIC_ACQUIRE);
+            if(seq != pos + 1)
+                continue;
+            memcpy(&records[n_records], record, sizeof(tr_ring_record_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if(__atomic_load_n(&record->seq, __ATOMIC_RELAXED) != seq)
+                continue;
+            n_records++;
+        }
+
+        fwrite(&ring->ring_id, sizeof(uint32_t), 1, fp);
+        fwrite(&n_records, sizeof(uint32_t), 1, fp);
+        fwrite(records, sizeof(tr_ring_record_t), n_records, fp);
+        n_total += n_records;
+        free(records);
+    }
+
+    fclose(fp);
+    return n_total;
+}
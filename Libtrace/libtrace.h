@@ -36,6 +36,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <stdint.h>
+#include <stdarg.h>
 
 #define TR_IS_BIT_SET(n, pos)  ((n & (1 << (pos))) != 0)
 #define TR_TOGGLE_BIT(n, pos)  (n = n ^ (1 << (pos)))
@@ -54,7 +56,8 @@ typedef enum{
 typedef enum{
     
     CONSOLE,
-    LOG_FILE
+    LOG_FILE,
+    TRACE_RING      /*Binary records in per thread rings, see trace_log()*/
 } log_storage_t;
 
 typedef struct {
@@ -99,6 +102,113 @@ extern char fn_line_buff[FN_LINE_BUFFER_SIZE];
 void
 trace_set_log_medium(traceoptions *traceopts, log_storage_t logstorage);
 
+/*Structured tracing
+ *
+ * trace_log(traceopts, bit, fmt, ...) replaces the sprintf into
+ * traceopts->b + trace() pair. Nothing, not even the arguments, is
+ * evaluated unless the bit is enabled. Each call site owns a static
+ * event descriptor which gets an event id the first time it fires, the
+ * argument types are those of the printf conversions in fmt, which the
+ * compiler checks.
+ *
+ * With CONSOLE or LOG_FILE storage the event is formatted and printed as
+ * trace() does. With TRACE_RING storage the event id, a timestamp and
+ * the raw arguments are copied into a binary ring owned by the calling
+ * thread, no formatting, no lock. trace_ring_dump() writes all rings and
+ * the event descriptors to a file which Libtrace/trace_decode renders
+ * as text offline*/
+
+#define TR_MAX_EVENTS           4096
+#define TR_MAX_EVENT_ARGS       12
+#define TR_RING_RECORD_SIZE     128
+#define TR_RING_DEFAULT_RECORDS 4096    /*Per thread, power of 2*/
+#define TR_RING_DUMP_MAGIC      "LIBTRACE"
+#define TR_RING_DUMP_VERSION    1
+
+typedef enum{
+
+    TR_ARG_INT,
+    TR_ARG_UINT,
+    TR_ARG_LONG,
+    TR_ARG_ULONG,
+    TR_ARG_DOUBLE,
+    TR_ARG_STR,
+    TR_ARG_PTR
+} tr_arg_type_t;
+
+typedef struct tr_event_desc_{
+
+    uint32_t event_id;      /*0 until the call site first fires*/
+    unsigned int trace_bit;
+    const char *fn;
+    unsigned int line;
+    const char *fmt;
+    uint8_t n_args;
+    uint8_t arg_types[TR_MAX_EVENT_ARGS];
+} tr_event_desc_t;
+
+/*Fixed size records, so that a ring wraps over whole records*/
+typedef struct tr_ring_record_{
+
+    uint64_t seq;           /*1 + ring position it was written at, 0 while being written*/
+    uint64_t timestamp_ns;  /*CLOCK_MONOTONIC*/
+    uint32_t event_id;
+    uint32_t args_len;
+    /*Numbers take 8 bytes, strings take a length byte + chars*/
+    unsigned char args[TR_RING_RECORD_SIZE - 24];
+} tr_ring_record_t;
+
+typedef struct tr_ring_{
+
+    uint32_t ring_id;
+    uint32_t n_records;
+    uint64_t w_idx;         /*Written by the owner thread only*/
+    tr_ring_record_t *records;
+    struct tr_ring_ *next;
+} tr_ring_t;
+
+#define TR_IS_TRACE_ON(traceopts_ptr, bit)                                                  \
+    ((traceopts_ptr)->enable == TR_TRUE && TR_IS_BIT_SET((traceopts_ptr)->bit_mask, bit))
+
+/*Built with -DTR_COMPILED_OUT trace_log() generates no code, the
+ * arguments are still checked against fmt*/
+#ifdef TR_COMPILED_OUT
+#define trace_log(traceopts_ptr, bit, fmt, ...)                                             \
+    do{                                                                                     \
+        if(0) trace_log_event(traceopts_ptr, NULL, fmt, ##__VA_ARGS__);                     \
+    } while(0)
+#else
+#define trace_log(traceopts_ptr, bit, fmt, ...)                                             \
+    do{                                                                                     \
+        if(TR_IS_TRACE_ON(traceopts_ptr, bit)){                                             \
+            static tr_event_desc_t _tr_event_desc = {0, bit, __FUNCTION__, __LINE__, fmt};  \
+            trace_log_event(traceopts_ptr, &_tr_event_desc, fmt, ##__VA_ARGS__);            \
+        }                                                                                   \
+    } while(0)
+#endif
+
+void
+trace_log_event(traceoptions *traceopts, tr_event_desc_t *event_desc,
+    const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+/*Records per thread ring for threads which have not traced yet*/
+void
+trace_ring_set_size(uint32_t n_records);
+
+/*Return the no of records written, -1 on error*/
+int
+trace_ring_dump(const char *file_name);
+
+/*Fill event_desc->n_args and arg_types from event_desc->fmt,
+ * return -1 if fmt has a conversion the ring does not support*/
+int
+trace_event_parse_fmt(tr_event_desc_t *event_desc);
+
+/*Render one record as text in buff, as printf would have with fmt*/
+int
+trace_ring_record_render(tr_event_desc_t *event_desc,
+    tr_ring_record_t *record, char *buff, unsigned int buff_size);
+
 void
 register_display_trace_options(traceoptions *traceopts, 
     void (*display_trace_options)(unsigned long long));
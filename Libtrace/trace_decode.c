@@ -0,0 +1,178 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  trace_decode.c
+ *
+ *    Description:  Offline decoder, renders a trace_ring_dump() file as text
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 16:20:11  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the Libtrace  distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+/* Usage : trace_decode <dump file>
+ * Records of all threads are merged in timestamp order, one line each :
+ * [<sec>.<usec> since first record] T<thread ring> fn(line) : text */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libtrace.h"
+
+typedef struct tr_decoded_record_{
+
+    uint32_t ring_id;
+    tr_ring_record_t record;
+} tr_decoded_record_t;
+
+static tr_event_desc_t *events[TR_MAX_EVENTS];
+
+static int
+tr_decoded_record_cmp(const void *a, const void *b){
+
+    const tr_decoded_record_t *r1 = a, *r2 = b;
+
+    if(r1->record.timestamp_ns != r2->record.timestamp_ns)
+        return r1->record.timestamp_ns < r2->record.timestamp_ns ? -1 : 1;
+    if(r1->ring_id != r2->ring_id)
+        return r1->ring_id < r2->ring_id ? -1 : 1;
+    return r1->record.seq < r2->record.seq ? -1 : 1;
+}
+
+static char *
+read_string(FILE *fp, uint16_t len){
+
+    char *str = calloc(1, len + 1);
+
+    if(fread(str, 1, len, fp) != len){
+        free(str);
+        return NULL;
+    }
+    return str;
+}
+
+int
+main(int argc, char **argv){
+
+    FILE *fp;
+    char magic[8], text[2048];
+    uint16_t fn_len, fmt_len;
+    uint32_t i, j, version, record_size, n_events,
+             n_rings, ring_id, n_records, n_total = 0;
+    tr_event_desc_t *event_desc;
+    tr_decoded_record_t *records = NULL;
+    uint64_t t0, dt;
+
+    if(argc != 2){
+        printf("Usage : %s <trace dump file>\n", argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[1], "r");
+    if(!fp){
+        printf("Error : Could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    if(fread(magic, 1, sizeof(magic), fp) != sizeof(magic) ||
+        memcmp(magic, TR_RING_DUMP_MAGIC, sizeof(magic)) ||
+        fread(&version, sizeof(uint32_t), 1, fp) != 1 ||
+        version != TR_RING_DUMP_VERSION ||
+        fread(&record_size, sizeof(uint32_t), 1, fp) != 1 ||
+        record_size != sizeof(tr_ring_record_t) ||
+        fread(&n_events, sizeof(uint32_t), 1, fp) != 1 ||
+        n_events >= TR_MAX_EVENTS){
+        printf("Error : %s is not a trace ring dump of this version\n", argv[1]);
+        return 1;
+    }
+
+    for(i = 0; i < n_events; i++){
+
+        event_desc = calloc(1, sizeof(tr_event_desc_t));
+        if(fread(&event_desc->event_id, sizeof(uint32_t), 1, fp) != 1 ||
+           fread(&event_desc->trace_bit, sizeof(uint32_t), 1, fp) != 1 ||
+           fread(&event_desc->line, sizeof(uint32_t), 1, fp) != 1 ||
+           fread(&fn_len, sizeof(uint16_t), 1, fp) != 1 ||
+           fread(&fmt_len, sizeof(uint16_t), 1, fp) != 1 ||
+           !(event_desc->fn = read_string(fp, fn_len)) ||
+           !(event_desc->fmt = read_string(fp, fmt_len)) ||
+           event_desc->event_id >= TR_MAX_EVENTS){
+            printf("Error : Truncated event table\n");
+            return 1;
+        }
+        trace_event_parse_fmt(event_desc);
+        events[event_desc->event_id] = event_desc;
+    }
+
+    if(fread(&n_rings, sizeof(uint32_t), 1, fp) != 1){
+        printf("Error : Truncated dump\n");
+        return 1;
+    }
+
+    for(i = 0; i < n_rings; i++){
+
+        if(fread(&ring_id, sizeof(uint32_t), 1, fp) != 1 ||
+           fread(&n_records, sizeof(uint32_t), 1, fp) != 1){
+            printf("Error : Truncated dump\n");
+            return 1;
+        }
+
+        records = realloc(records, (n_total + n_records) * sizeof(tr_decoded_record_t));
+        for(j = 0; j < n_records; j++, n_total++){
+            records[n_total].ring_id = ring_id;
+            if(fread(&records[n_total].record, sizeof(tr_ring_record_t), 1, fp) != 1){
+                printf("Error : Truncated dump\n");
+                return 1;
+            }
+        }
+    }
+    fclose(fp);
+
+    qsort(records, n_total, sizeof(tr_decoded_record_t), tr_decoded_record_cmp);
+
+    t0 = n_total ? records[0].record.timestamp_ns : 0;
+
+    for(i = 0; i < n_total; i++){
+
+        event_desc = records[i].record.event_id < TR_MAX_EVENTS ?
+            events[records[i].record.event_id] : NULL;
+        dt = records[i].record.timestamp_ns - t0;
+
+        if(!event_desc){
+            printf("[%lu.%06lu] T%u Unknown event %u\n",
+                (unsigned long)(dt / 1000000000ULL), (unsigned long)((dt / 1000) % 1000000),
+                records[i].ring_id, records[i].record.event_id);
+            continue;
+        }
+
+        trace_ring_record_render(event_desc, &records[i].record, text, sizeof(text));
+        printf("[%lu.%06lu] T%u %s(%u) : %s\n",
+            (unsigned long)(dt / 1000000000ULL), (unsigned long)((dt / 1000) % 1000000),
+            records[i].ring_id, event_desc->fn, event_desc->line, text);
+    }
+
+    printf("%u records, %u events, %u threads\n", n_total, n_events, n_rings);
+    free(records);
+    return 0;
+}
@@ -29,6 +29,7 @@
  */
 
 #include "mm.h"
+#include "uapi_mm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -36,6 +37,7 @@
 #include <unistd.h> /*for getpagesize*/
 #include <sys/mman.h>
 #include <errno.h>
+#include <time.h>
 #include "css.h"
 
 #define __USE_MMAP__
@@ -45,12 +47,29 @@
 static vm_page_for_families_t *first_vm_page_for_families = NULL;
 static size_t SYSTEM_PAGE_SIZE = 0;
 void *gb_hsba = NULL;
+/*For allocation rates*/
+static struct timespec mm_init_time;
+
+static double
+mm_seconds_since(struct timespec *since){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - since->tv_sec) +
+        (double)(now.tv_nsec - since->tv_nsec) / 1e9;
+}
 
 void
 mm_init(){
 
     SYSTEM_PAGE_SIZE = getpagesize() * 2;
     gb_hsba = sbrk(0);
+    clock_gettime(CLOCK_MONOTONIC, &mm_init_time);
+    /*xfree() relies upon it to tell blocks and slab objects apart*/
+    assert(offset_of(block_meta_data_t, is_free) + sizeof(vm_bool_t) ==
+            sizeof(block_meta_data_t));
+    assert(offset_of(slab_obj_hdr_t, tag) + sizeof(uint32_t) ==
+            sizeof(slab_obj_hdr_t));
 }
 
 static inline uint32_t
@@ -63,28 +82,6 @@ mm_max_page_allocatable_memory(int units){
 #define MAX_PAGE_ALLOCATABLE_MEMORY(units) \
     (mm_max_page_allocatable_memory(units))
 
-static vm_page_t *
-mm_get_available_page_index(vm_page_family_t *vm_page_family){
-
-    vm_page_t *curr, *prev;
-    int page_index = -1;
-
-    if(!vm_page_family->first_page)
-        return NULL;
-
-    ITERATE_VM_PAGE_BEGIN(vm_page_family, curr){
-
-        if((int)(curr->page_index) == page_index + 1){
-            page_index++;
-            prev = curr;
-            continue;
-        }
-        return curr->prev;
-    } ITERATE_VM_PAGE_END(vm_page_family, curr)
-
-    return prev;
-}
-
 static vm_page_t *
 mm_sbrk_get_available_page_from_heap_segment(int units){
 
@@ -106,6 +103,205 @@ mm_sbrk_get_available_page_from_heap_segment(int units){
     return vm_page_curr;
 }
 
+/* Page source : VM pages are carved out of large mmap'd chunks rather
+ * than being mmap'd one by one. Pages given back are kept on per size
+ * free lists and reused, only requests larger than
+ * MM_PAGE_SOURCE_MAX_UNITS pages are mapped and unmapped directly*/
+
+typedef struct mm_page_source_{
+
+    pthread_mutex_t lock;
+    /*config*/
+    uint32_t chunk_size;
+    vm_bool_t use_hugetlb;
+    vm_bool_t use_thp;
+    /*current chunk being carved*/
+    char *chunk_curr;
+    char *chunk_end;
+    /*free VM pages, indexed by number of SYSTEM_PAGE_SIZE units*/
+    void *free_pages[MM_PAGE_SOURCE_MAX_UNITS + 1];
+    /*Statistics*/
+    mm_page_source_stats_t stats;
+} mm_page_source_t;
+
+static mm_page_source_t mm_page_source = {
+    PTHREAD_MUTEX_INITIALIZER,
+    MM_PAGE_SOURCE_DEFAULT_CHUNK_SIZE,
+    MM_FALSE,
+    MM_TRUE
+};
+
+void
+mm_page_source_config(uint32_t chunk_size,
+                      int use_hugetlb,
+                      int use_thp){
+
+    pthread_mutex_lock(&mm_page_source.lock);
+    /*Takes effect from the next chunk reserved*/
+    if(chunk_size < MM_PAGE_SOURCE_HUGE_PAGE_SIZE)
+        chunk_size = MM_PAGE_SOURCE_HUGE_PAGE_SIZE;
+    mm_page_source.chunk_size = (chunk_size + MM_PAGE_SOURCE_HUGE_PAGE_SIZE - 1) &
+        ~(MM_PAGE_SOURCE_HUGE_PAGE_SIZE - 1);
+    mm_page_source.use_hugetlb = use_hugetlb ? MM_TRUE : MM_FALSE;
+    mm_page_source.use_thp = use_thp ? MM_TRUE : MM_FALSE;
+    pthread_mutex_unlock(&mm_page_source.lock);
+}
+
+void
+mm_page_source_get_stats(mm_page_source_stats_t *stats){
+
+    pthread_mutex_lock(&mm_page_source.lock);
+    *stats = mm_page_source.stats;
+    pthread_mutex_unlock(&mm_page_source.lock);
+}
+
+/*Caller holds the page source lock*/
+static void
+mm_page_source_put_free(char *page, uint32_t units){
+
+    *(void **)page = mm_page_source.free_pages[units];
+    mm_page_source.free_pages[units] = page;
+    mm_page_source.stats.pages_free += units;
+}
+
+/* Reserve a new huge page aligned chunk, the unused tail of the
+ * previous chunk is not lost but goes into the free lists.
+ * Caller holds the page source lock*/
+static vm_bool_t
+mm_page_source_new_chunk(){
+
+    char *region = NULL, *aligned = NULL;
+    size_t chunk_size = mm_page_source.chunk_size;
+    size_t units;
+
+    while(mm_page_source.chunk_curr + SYSTEM_PAGE_SIZE <= mm_page_source.chunk_end){
+        units = (mm_page_source.chunk_end - mm_page_source.chunk_curr) / SYSTEM_PAGE_SIZE;
+        if(units > MM_PAGE_SOURCE_MAX_UNITS)
+            units = MM_PAGE_SOURCE_MAX_UNITS;
+        mm_page_source_put_free(mm_page_source.chunk_curr, units);
+        mm_page_source.chunk_curr += units * SYSTEM_PAGE_SIZE;
+    }
+
+    if(mm_page_source.use_hugetlb){
+#ifdef MAP_HUGETLB
+        region = mmap(NULL, chunk_size, PROT_READ|PROT_WRITE,
+                MAP_ANON|MAP_PRIVATE|MAP_HUGETLB, -1, 0);
+        mm_page_source.stats.n_mmap++;
+        if(region != MAP_FAILED){
+            mm_page_source.stats.n_hugetlb_chunks++;
+            aligned = region;
+        }
+        else{
+            mm_page_source.stats.n_hugetlb_failures++;
+        }
+#endif
+    }
+
+    if(!aligned){
+        /*Over reserve and trim so that the chunk is huge page aligned*/
+        region = mmap(NULL, chunk_size + MM_PAGE_SOURCE_HUGE_PAGE_SIZE,
+                PROT_READ|PROT_WRITE, MAP_ANON|MAP_PRIVATE, -1, 0);
+        mm_page_source.stats.n_mmap++;
+        if(region == MAP_FAILED){
+            printf("Error : VM chunk reservation Failed, errno = %d\n", errno);
+            return MM_FALSE;
+        }
+        aligned = (char *)(((uintptr_t)region + MM_PAGE_SOURCE_HUGE_PAGE_SIZE - 1) & 
+                ~((uintptr_t)MM_PAGE_SOURCE_HUGE_PAGE_SIZE - 1));
+        if(aligned != region){
+            munmap(region, aligned - region);
+            mm_page_source.stats.n_munmap++;
+        }
+        if(aligned + chunk_size != region + chunk_size + MM_PAGE_SOURCE_HUGE_PAGE_SIZE){
+            munmap(aligned + chunk_size,
+                (region + chunk_size + MM_PAGE_SOURCE_HUGE_PAGE_SIZE) - 
+                (aligned + chunk_size));
+            mm_page_source.stats.n_munmap++;
+        }
+#ifdef MADV_HUGEPAGE
+        if(mm_page_source.use_thp){
+            mm_page_source.stats.n_madvise++;
+            if(madvise(aligned, chunk_size, MADV_HUGEPAGE) == 0)
+                mm_page_source.stats.n_thp_chunks++;
+        }
+#endif
+    }
+
+    mm_page_source.chunk_curr = aligned;
+    mm_page_source.chunk_end = aligned + chunk_size;
+    mm_page_source.stats.n_chunks++;
+    mm_page_source.stats.bytes_reserved += chunk_size;
+    return MM_TRUE;
+}
+
+static void *
+mm_page_source_alloc(int units){
+
+    char *page = NULL;
+
+    pthread_mutex_lock(&mm_page_source.lock);
+
+    mm_page_source.stats.n_page_requests++;
+
+    if(units > MM_PAGE_SOURCE_MAX_UNITS){
+        /*Too big to be carved, map it on its own*/
+        page = mmap(NULL, units * SYSTEM_PAGE_SIZE, PROT_READ|PROT_WRITE,
+                MAP_ANON|MAP_PRIVATE, -1, 0);
+        mm_page_source.stats.n_mmap++;
+        if(page == MAP_FAILED){
+            printf("Error : VM Page allocation Failed\n");
+            page = NULL;
+        }
+        else{
+            mm_page_source.stats.pages_in_use += units;
+        }
+        pthread_mutex_unlock(&mm_page_source.lock);
+        return page;
+    }
+
+    if(mm_page_source.free_pages[units]){
+        page = mm_page_source.free_pages[units];
+        mm_page_source.free_pages[units] = *(void **)page;
+        mm_page_source.stats.pages_free -= units;
+        mm_page_source.stats.n_page_recycled++;
+    }
+    else{
+        if(mm_page_source.chunk_curr + (units * SYSTEM_PAGE_SIZE) > 
+                mm_page_source.chunk_end){
+            if(!mm_page_source_new_chunk()){
+                pthread_mutex_unlock(&mm_page_source.lock);
+                return NULL;
+            }
+        }
+        page = mm_page_source.chunk_curr;
+        mm_page_source.chunk_curr += units * SYSTEM_PAGE_SIZE;
+    }
+
+    mm_page_source.stats.pages_in_use += units;
+    pthread_mutex_unlock(&mm_page_source.lock);
+    return page;
+}
+
+static void
+mm_page_source_free(void *page, int units){
+
+    pthread_mutex_lock(&mm_page_source.lock);
+
+    mm_page_source.stats.pages_in_use -= units;
+
+    if(units > MM_PAGE_SOURCE_MAX_UNITS){
+        if(munmap(page, units * SYSTEM_PAGE_SIZE)){
+            printf("Error : Could not munmap VM page (%u) to kernel, errno = %d\n",
+                ((vm_page_t *)page)->page_size, errno);
+        }
+        mm_page_source.stats.n_munmap++;
+    }
+    else{
+        mm_page_source_put_free(page, units);
+    }
+    pthread_mutex_unlock(&mm_page_source.lock);
+}
+
 static vm_page_t *
 mm_get_new_vm_page_from_kernel(int units){
 
@@ -115,18 +311,11 @@ mm_get_new_vm_page_from_kernel(int units){
     vm_page = (vm_page_t *)calloc(units, SYSTEM_PAGE_SIZE);
 
 #elif defined(__USE_MMAP__)
-    char * region = mmap(
-            sbrk(0), 
-            units * SYSTEM_PAGE_SIZE,
-            PROT_READ|PROT_WRITE|PROT_EXEC,
-            MAP_ANON|MAP_PRIVATE,
-            0,0);
-
-    if (region == MAP_FAILED) {
-        printf("Error : VM Page allocation Failed\n");
+    vm_page = (vm_page_t *)mm_page_source_alloc(units);
+
+    if (!vm_page) {
         return NULL;
     }
-    vm_page = (vm_page_t *)region;
 
 #elif defined(__USE_BRK__)
     vm_page = mm_sbrk_get_available_page_from_heap_segment(units);;
@@ -179,15 +368,12 @@ mm_sbrk_free_vm_page(vm_page_t *vm_page, int units){
 static void
 mm_return_vm_page_to_kernel(void *ptr, int units){
 
- int rc = 0;
 MARK_VM_PAGE_EMPTY(((vm_page_t *)ptr));
 
 #ifdef __USE_GLIBC__
     free(ptr); 
 #elif defined(__USE_MMAP__)
-    if(rc = munmap(ptr, units * SYSTEM_PAGE_SIZE)){
-        printf("Error : Could not munmap VM page (%u) to kernel, errno = %d\n", ((vm_page_t *)ptr)->page_size, errno);
-    }
+    mm_page_source_free(ptr, units);
 #elif defined(__USE_BRK__)
     mm_sbrk_free_vm_page((vm_page_t *)ptr, units);
 #endif
@@ -197,9 +383,6 @@ MARK_VM_PAGE_EMPTY(((vm_page_t *)ptr));
 vm_page_t *
 allocate_vm_page(vm_page_family_t *vm_page_family, int units){
 
-    vm_page_t *prev_page = 
-        mm_get_available_page_index(vm_page_family);
-
     vm_page_t *vm_page = mm_get_new_vm_page_from_kernel(units);
     vm_page->block_meta_data.is_free = MM_TRUE;
     vm_page->block_meta_data.block_size = 
@@ -214,26 +397,30 @@ allocate_vm_page(vm_page_family_t *vm_page_family, int units){
     vm_page_family->no_of_system_calls_to_alloc_dealloc_vm_pages++;
     vm_page->pg_family = vm_page_family;
 
-    if(!prev_page){
-        vm_page->page_index = 0;
-        vm_page->next = vm_page_family->first_page;
-        if(vm_page_family->first_page)
-            vm_page_family->first_page->prev = vm_page;
-        vm_page_family->first_page = vm_page;
-        return vm_page;
-    }
-
-    vm_page->next = prev_page->next;
-    vm_page->prev = prev_page;
-    if(vm_page->next)
-        vm_page->next->prev = vm_page;
-    prev_page->next = vm_page;
-    vm_page->page_index = prev_page->page_index + 1;
+    /* Newest page goes first, indexes only ever grow. Looking for the
+     * lowest free index costs a walk over all pages of the family, on
+     * every new page*/
+    vm_page->page_index = vm_page_family->first_page ?
+        vm_page_family->first_page->page_index + 1 : 0;
+    vm_page->next = vm_page_family->first_page;
+    if(vm_page_family->first_page)
+        vm_page_family->first_page->prev = vm_page;
+    vm_page_family->first_page = vm_page;
     return vm_page;
 }
 
 
-void
+static void
+mm_init_free_block_classes(vm_page_family_t *vm_page_family){
+
+    uint32_t class;
+
+    for(class = 0; class < MM_FREE_BLOCK_CLASSES; class++)
+        init_glthread(&vm_page_family->free_block_class_list[class]);
+    vm_page_family->free_block_classes_in_use = 0;
+}
+
+mm_page_family_handle_t
 mm_instantiate_new_page_family(
     char *struct_name,
     uint32_t struct_size){
@@ -248,8 +435,8 @@ mm_instantiate_new_page_family(
             MM_MAX_STRUCT_NAME);
         first_vm_page_for_families->vm_page_family[0].struct_size = struct_size;
         first_vm_page_for_families->vm_page_family[0].first_page = NULL;
-        init_glthread(&first_vm_page_for_families->vm_page_family[0].free_block_priority_list_head);
-        return;
+        mm_init_free_block_classes(&first_vm_page_for_families->vm_page_family[0]);
+        return &first_vm_page_for_families->vm_page_family[0];
     }
 
 	vm_page_family_curr = lookup_page_family_by_name(struct_name);
@@ -278,7 +465,8 @@ mm_instantiate_new_page_family(
             MM_MAX_STRUCT_NAME);
     vm_page_family_curr->struct_size = struct_size;
     vm_page_family_curr->first_page = NULL;
-    init_glthread(&vm_page_family_curr->free_block_priority_list_head);
+    mm_init_free_block_classes(vm_page_family_curr);
+    return vm_page_family_curr;
 }
 
 vm_page_family_t *
@@ -304,34 +492,47 @@ lookup_page_family_by_name(char *struct_name){
     return NULL;
 }
 
-static int
-free_blocks_comparison_function(
-        void *_block_meta_data1,
-        void *_block_meta_data2){
+static void
+mm_add_free_block_meta_data_to_free_block_list(
+        vm_page_family_t *vm_page_family, 
+        block_meta_data_t *free_block){
 
-    block_meta_data_t *block_meta_data1 = 
-        (block_meta_data_t *)_block_meta_data1;
+    uint32_t class;
 
-    block_meta_data_t *block_meta_data2 = 
-        (block_meta_data_t *)_block_meta_data2;
+    assert(free_block->is_free == MM_TRUE);
 
-    if(block_meta_data1->block_size > block_meta_data2->block_size)
-        return -1;
-    else if(block_meta_data1->block_size < block_meta_data2->block_size)
-        return 1;
-    return 0;
+    /* Too small to ever serve an allocation of this family, such soft
+     * fragments only come back into use when merged on free*/
+    if(free_block->block_size < vm_page_family->struct_size)
+        return;
+
+    /* Allocation only needs one of the biggest blocks, not all of them
+     * in order. Filing the block under its size class keeps the insert
+     * O(1) however many free blocks the family has*/
+    class = mm_free_block_class(free_block->block_size);
+    init_glthread(&free_block->priority_thread_glue);
+    glthread_add_next(&vm_page_family->free_block_class_list[class],
+        &free_block->priority_thread_glue);
+    vm_page_family->free_block_classes_in_use |= (1U << class);
 }
 
+/*Must be called before the block size changes, the size
+ * tells the class the block is filed under*/
 static void
-mm_add_free_block_meta_data_to_free_block_list(
-        vm_page_family_t *vm_page_family, 
+mm_remove_free_block_from_free_block_list(
+        vm_page_family_t *vm_page_family,
         block_meta_data_t *free_block){
 
-    assert(free_block->is_free == MM_TRUE);
-    glthread_priority_insert(&vm_page_family->free_block_priority_list_head, 
-            &free_block->priority_thread_glue,
-            free_blocks_comparison_function,
-            offset_of(block_meta_data_t, priority_thread_glue));
+    uint32_t class;
+
+    /*Undersized blocks are on no list*/
+    if(IS_GLTHREAD_LIST_EMPTY(&free_block->priority_thread_glue))
+        return;
+
+    class = mm_free_block_class(free_block->block_size);
+    remove_glthread(&free_block->priority_thread_glue);
+    if(!vm_page_family->free_block_class_list[class].right)
+        vm_page_family->free_block_classes_in_use &= ~(1U << class);
 }
 
 static vm_page_t *
@@ -371,18 +572,19 @@ mm_split_free_data_block_for_allocation(
     uint32_t remaining_size =
         block_meta_data->block_size - size;
 
+    /* Since this block of memory is going to be allocated to the application, 
+     * remove it from the free block lists*/
+    mm_remove_free_block_from_free_block_list(vm_page_family, block_meta_data);
+
     block_meta_data->is_free = MM_FALSE;
     block_meta_data->block_size = size;
 
     /*Unchanged*/
     /*block_meta_data->offset =  ??*/
-
-    /* Since this block of memory is going to be allocated to the application, 
-     * remove it from priority list of free blocks*/
-    remove_glthread(&block_meta_data->priority_thread_glue);
     
     vm_page_family->total_memory_in_use_by_app +=
             sizeof(block_meta_data_t) + size;
+    MM_UPDATE_HIGH_WATER_MARK(vm_page_family);
 
     /*Case 1 : No Split*/
     if(!remaining_size){
@@ -409,6 +611,8 @@ mm_split_free_data_block_for_allocation(
 
     /*Case 3 : Partial Split : Hard Internal Fragmentation*/
     else if(remaining_size < sizeof(block_meta_data_t)){
+        /*Given back when the block is freed*/
+        vm_page_family->hard_internal_frag += remaining_size;
         //next_block_meta_data = block_meta_data->next_block;
         /*No need to repair linkages, they do not change*/
         //mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
@@ -474,12 +678,436 @@ mm_allocate_free_data_block(
     return NULL;
 }
 
-/* The public fn to be invoked by the application for Dynamic 
- * Memory Allocations.*/
+/* Slab mode */
+
+static vm_page_family_t *mm_slab_families[MM_MAX_SLAB_FAMILIES];
+static uint32_t mm_n_slab_families = 0;
+static __thread slab_magazine_t mm_slab_magazines[MM_MAX_SLAB_FAMILIES];
+static __thread vm_bool_t mm_slab_thread_registered = MM_FALSE;
+static pthread_key_t mm_slab_thread_key;
+static pthread_once_t mm_slab_thread_key_once = PTHREAD_ONCE_INIT;
+
+/*Number of system pages making one slab page of the family*/
+static inline int
+mm_slab_page_units(vm_page_family_t *vm_page_family){
+
+    uint32_t min_size = offset_of(slab_page_t, page_memory) + 
+        (MM_SLAB_MAGAZINE_SIZE * vm_page_family->slab_obj_size);
+
+    return (int)((min_size + SYSTEM_PAGE_SIZE - 1) / SYSTEM_PAGE_SIZE);
+}
+
+static inline void
+mm_slab_page_unlink(slab_page_t **list_head, slab_page_t *slab_page){
+
+    if(*list_head == slab_page)
+        *list_head = slab_page->next;
+    if(slab_page->next)
+        slab_page->next->prev = slab_page->prev;
+    if(slab_page->prev)
+        slab_page->prev->next = slab_page->next;
+    slab_page->next = NULL;
+    slab_page->prev = NULL;
+}
+
+static inline void
+mm_slab_page_link(slab_page_t **list_head, slab_page_t *slab_page){
+
+    slab_page->prev = NULL;
+    slab_page->next = *list_head;
+    if(*list_head)
+        (*list_head)->prev = slab_page;
+    *list_head = slab_page;
+}
+
+/*Claim a new slab page from kernel and carve it into free objects,
+ * caller holds the depot lock*/
+static slab_page_t *
+mm_slab_page_new(vm_page_family_t *vm_page_family){
+
+    uint32_t i;
+    slab_obj_hdr_t *slab_obj_hdr = NULL;
+    int units = mm_slab_page_units(vm_page_family);
+
+    slab_page_t *slab_page = 
+        (slab_page_t *)mm_get_new_vm_page_from_kernel(units);
+
+    if(!slab_page)
+        return NULL;
+
+    slab_page->page_size = units * SYSTEM_PAGE_SIZE;
+    slab_page->pg_family = vm_page_family;
+    slab_page->n_objects = (slab_page->page_size - 
+        offset_of(slab_page_t, page_memory)) / vm_page_family->slab_obj_size;
+    slab_page->n_free = slab_page->n_objects;
+    slab_page->free_list = NULL;
+
+    for(i = slab_page->n_objects; i > 0; i--){
+
+        slab_obj_hdr = (slab_obj_hdr_t *)(slab_page->page_memory + 
+            ((i - 1) * vm_page_family->slab_obj_size));
+        slab_obj_hdr->offset = (uint32_t)((char *)slab_obj_hdr - (char *)slab_page);
+        slab_obj_hdr->tag = MM_SLAB_OBJ_FREE;
+        MM_SLAB_OBJ_NEXT_FREE(slab_obj_hdr) = slab_page->free_list;
+        slab_page->free_list = slab_obj_hdr;
+    }
+
+    mm_slab_page_link(&vm_page_family->slab_pages, slab_page);
+    vm_page_family->n_slab_pages++;
+    vm_page_family->n_empty_slab_pages++;
+    vm_page_family->no_of_system_calls_to_alloc_dealloc_vm_pages++;
+    return slab_page;
+}
+
+/*Return an empty slab page to kernel, caller holds the depot lock*/
+static void
+mm_slab_page_release(slab_page_t *slab_page){
+
+    vm_page_family_t *vm_page_family = slab_page->pg_family;
+
+    assert(slab_page->n_free == slab_page->n_objects);
+    mm_slab_page_unlink(&vm_page_family->slab_pages, slab_page);
+    vm_page_family->n_slab_pages--;
+    vm_page_family->n_empty_slab_pages--;
+    vm_page_family->no_of_system_calls_to_alloc_dealloc_vm_pages++;
+    mm_return_vm_page_to_kernel((void *)slab_page, 
+        slab_page->page_size / SYSTEM_PAGE_SIZE);
+}
+
+/*Caller holds the depot lock*/
+static inline void
+mm_slab_fold_stats(vm_page_family_t *vm_page_family,
+                   slab_magazine_t *magazine){
+
+    vm_page_family->total_memory_in_use_by_app += 
+        (uint32_t)(magazine->n_objs_in_use_delta * 
+        (int32_t)vm_page_family->slab_obj_size);
+    vm_page_family->n_slab_objs_in_use += 
+        (uint32_t)magazine->n_objs_in_use_delta;
+    vm_page_family->n_allocs += magazine->n_allocs_delta;
+    vm_page_family->n_frees += magazine->n_frees_delta;
+    MM_UPDATE_HIGH_WATER_MARK(vm_page_family);
+    magazine->n_objs_in_use_delta = 0;
+    magazine->n_allocs_delta = 0;
+    magazine->n_frees_delta = 0;
+}
+
+/*Move up to n_objs free objects from the depot into the magazine*/
+static void
+mm_slab_depot_refill(vm_page_family_t *vm_page_family,
+                     slab_magazine_t *magazine,
+                     uint32_t n_objs){
+
+    slab_page_t *slab_page = NULL;
+    slab_obj_hdr_t *slab_obj_hdr = NULL;
+
+    pthread_mutex_lock(&vm_page_family->slab_lock);
+
+    mm_slab_fold_stats(vm_page_family, magazine);
+
+    while(n_objs && magazine->n_objs < MM_SLAB_MAGAZINE_SIZE){
+
+        slab_page = vm_page_family->slab_pages;
+        if(!slab_page){
+            slab_page = mm_slab_page_new(vm_page_family);
+            if(!slab_page)
+                break;
+        }
+
+        if(slab_page->n_free == slab_page->n_objects)
+            vm_page_family->n_empty_slab_pages--;
+
+        while(n_objs && slab_page->n_free &&
+              magazine->n_objs < MM_SLAB_MAGAZINE_SIZE){
+
+            slab_obj_hdr = slab_page->free_list;
+            slab_page->free_list = MM_SLAB_OBJ_NEXT_FREE(slab_obj_hdr);
+            slab_page->n_free--;
+            magazine->objs[magazine->n_objs++] = slab_obj_hdr;
+            n_objs--;
+        }
+
+        if(!slab_page->n_free){
+            mm_slab_page_unlink(&vm_page_family->slab_pages, slab_page);
+            mm_slab_page_link(&vm_page_family->slab_full_pages, slab_page);
+        }
+        else if(slab_page->n_free == slab_page->n_objects){
+            vm_page_family->n_empty_slab_pages++;
+        }
+    }
+
+    pthread_mutex_unlock(&vm_page_family->slab_lock);
+}
+
+/*Return n_objs objects from the top of the magazine to the depot. Up to
+ * MM_SLAB_MAX_EMPTY_PAGES empty slab pages are kept cached, any further
+ * empty page goes back to kernel*/
+static void
+mm_slab_depot_flush(vm_page_family_t *vm_page_family,
+                    slab_magazine_t *magazine,
+                    uint32_t n_objs){
+
+    slab_page_t *slab_page = NULL;
+    slab_obj_hdr_t *slab_obj_hdr = NULL;
+
+    pthread_mutex_lock(&vm_page_family->slab_lock);
+
+    mm_slab_fold_stats(vm_page_family, magazine);
+
+    while(n_objs && magazine->n_objs){
+
+        slab_obj_hdr = magazine->objs[--magazine->n_objs];
+        n_objs--;
+        slab_page = MM_GET_SLAB_PAGE_FROM_OBJ_HDR(slab_obj_hdr);
+
+        if(!slab_page->n_free){
+            mm_slab_page_unlink(&vm_page_family->slab_full_pages, slab_page);
+            mm_slab_page_link(&vm_page_family->slab_pages, slab_page);
+        }
+
+        MM_SLAB_OBJ_NEXT_FREE(slab_obj_hdr) = slab_page->free_list;
+        slab_page->free_list = slab_obj_hdr;
+        slab_page->n_free++;
+
+        if(slab_page->n_free == slab_page->n_objects){
+            vm_page_family->n_empty_slab_pages++;
+            if(vm_page_family->n_empty_slab_pages > MM_SLAB_MAX_EMPTY_PAGES)
+                mm_slab_page_release(slab_page);
+        }
+    }
+
+    pthread_mutex_unlock(&vm_page_family->slab_lock);
+}
+
+/*Objects cached by an exiting thread go back to the depot*/
+static void
+mm_slab_thread_exit(void *arg){
+
+    uint32_t i;
+
+    (void)arg;
+    for(i = 0; i < mm_n_slab_families; i++){
+        mm_slab_depot_flush(mm_slab_families[i], &mm_slab_magazines[i],
+            MM_SLAB_MAGAZINE_SIZE);
+    }
+}
+
+static void
+mm_slab_thread_key_init(void){
+
+    assert(!pthread_key_create(&mm_slab_thread_key, mm_slab_thread_exit));
+}
+
+static inline void
+mm_slab_register_thread(){
+
+    if(mm_slab_thread_registered)
+        return;
+    pthread_once(&mm_slab_thread_key_once, mm_slab_thread_key_init);
+    pthread_setspecific(mm_slab_thread_key, (void *)mm_slab_magazines);
+    mm_slab_thread_registered = MM_TRUE;
+}
+
+void
+mm_enable_slab_mode(mm_page_family_handle_t pg_family){
+
+    uint32_t obj_size = pg_family->struct_size;
+
+    assert(pg_family->slab_mode == MM_FALSE);
+
+    if(mm_n_slab_families == MM_MAX_SLAB_FAMILIES){
+        printf("Error : Slab mode could not be enabled for %s, max %u families\n",
+            pg_family->struct_name, MM_MAX_SLAB_FAMILIES);
+        return;
+    }
+
+    /*Free objects are linked through their first bytes*/
+    if(obj_size < sizeof(slab_obj_hdr_t *))
+        obj_size = sizeof(slab_obj_hdr_t *);
+
+    pg_family->slab_obj_size = sizeof(slab_obj_hdr_t) + 
+        ((obj_size + 7) & ~7U);
+    pg_family->slab_id = mm_n_slab_families;
+    pthread_mutex_init(&pg_family->slab_lock, NULL);
+    pg_family->slab_pages = NULL;
+    pg_family->slab_full_pages = NULL;
+    pg_family->n_slab_pages = 0;
+    pg_family->n_empty_slab_pages = 0;
+    mm_slab_families[mm_n_slab_families++] = pg_family;
+    pg_family->slab_mode = MM_TRUE;
+}
+
+static void *
+mm_slab_alloc(vm_page_family_t *vm_page_family){
+
+    slab_obj_hdr_t *slab_obj_hdr = NULL;
+    slab_magazine_t *magazine = 
+        &mm_slab_magazines[vm_page_family->slab_id];
+
+    if(!magazine->n_objs){
+        mm_slab_register_thread();
+        mm_slab_depot_refill(vm_page_family, magazine,
+            MM_SLAB_MAGAZINE_SIZE / 2);
+        if(!magazine->n_objs)
+            return NULL;
+    }
+
+    slab_obj_hdr = magazine->objs[--magazine->n_objs];
+    assert(slab_obj_hdr->tag == MM_SLAB_OBJ_FREE);
+    slab_obj_hdr->tag = MM_SLAB_OBJ_ALLOCATED;
+    magazine->n_objs_in_use_delta++;
+    magazine->n_allocs_delta++;
+    memset((char *)(slab_obj_hdr + 1), 0, vm_page_family->struct_size);
+    return (void *)(slab_obj_hdr + 1);
+}
+
+static void
+mm_slab_free(slab_obj_hdr_t *slab_obj_hdr){
+
+    vm_page_family_t *vm_page_family = 
+        MM_GET_SLAB_PAGE_FROM_OBJ_HDR(slab_obj_hdr)->pg_family;
+    slab_magazine_t *magazine = 
+        &mm_slab_magazines[vm_page_family->slab_id];
+
+    slab_obj_hdr->tag = MM_SLAB_OBJ_FREE;
+
+    if(magazine->n_objs == MM_SLAB_MAGAZINE_SIZE){
+        mm_slab_register_thread();
+        mm_slab_depot_flush(vm_page_family, magazine,
+            MM_SLAB_MAGAZINE_SIZE / 2);
+    }
+
+    magazine->objs[magazine->n_objs++] = slab_obj_hdr;
+    magazine->n_objs_in_use_delta--;
+    magazine->n_frees_delta++;
+}
+
+/*Bring the stats of the family up to date with the calling
+ * thread's magazine, other threads' figures lag by at most a magazine*/
+static void
+mm_slab_sync_stats(vm_page_family_t *vm_page_family){
+
+    if(vm_page_family->slab_mode == MM_FALSE)
+        return;
+
+    pthread_mutex_lock(&vm_page_family->slab_lock);
+    mm_slab_fold_stats(vm_page_family, 
+        &mm_slab_magazines[vm_page_family->slab_id]);
+    pthread_mutex_unlock(&vm_page_family->slab_lock);
+}
+
+/* Arena */
+
+/*VM pages held by all arenas, for stats*/
+static uint32_t mm_arena_vm_pages = 0;
+
+void
+mm_arena_init(mm_arena_t *arena){
+
+    memset(arena, 0, sizeof(mm_arena_t));
+}
+
+static mm_arena_page_t *
+mm_arena_page_new(mm_arena_t *arena, uint32_t size){
+
+    int units = (int)((offset_of(mm_arena_page_t, page_memory) + size + 
+                SYSTEM_PAGE_SIZE - 1) / SYSTEM_PAGE_SIZE);
+
+    mm_arena_page_t *arena_page = 
+        (mm_arena_page_t *)mm_get_new_vm_page_from_kernel(units);
+
+    if(!arena_page)
+        return NULL;
+
+    arena_page->next = NULL;
+    arena_page->page_size = units * SYSTEM_PAGE_SIZE;
+    arena_page->used = 0;
+    arena->n_pages++;
+    __atomic_fetch_add(&mm_arena_vm_pages, units, __ATOMIC_RELAXED);
+    return arena_page;
+}
+
+/* Bump allocate size bytes, zeroed and 8B aligned. Pages left over
+ * from before the last reset are reused before asking kernel for more*/
 void *
-xcalloc(char *struct_name, int units){
+mm_arena_alloc(mm_arena_t *arena, uint32_t size){
+
+    slab_obj_hdr_t *obj_hdr = NULL;
+    mm_arena_page_t *arena_page = NULL;
+    uint32_t req_size = sizeof(slab_obj_hdr_t) + ((size + 7) & ~7U);
+
+    /*Pages past the current one are all unused*/
+    arena_page = arena->curr_page;
+
+    if(arena_page && !MM_ARENA_PAGE_HAS_ROOM(arena_page, req_size)){
+        arena_page = arena_page->next;
+        if(arena_page && !MM_ARENA_PAGE_HAS_ROOM(arena_page, req_size))
+            arena_page = NULL;
+    }
+
+    if(!arena_page){
+
+        arena_page = mm_arena_page_new(arena, req_size);
+        if(!arena_page)
+            return NULL;
+
+        if(!arena->first_page){
+            arena->first_page = arena_page;
+        }
+        else{
+            /*Insert after the page being currently bumped*/
+            arena_page->next = arena->curr_page->next;
+            arena->curr_page->next = arena_page;
+        }
+    }
+
+    arena->curr_page = arena_page;
+    obj_hdr = (slab_obj_hdr_t *)(arena_page->page_memory + arena_page->used);
+    arena_page->used += req_size;
+    arena->bytes_in_use += req_size;
+
+    obj_hdr->offset = (uint32_t)((char *)obj_hdr - (char *)arena_page);
+    obj_hdr->tag = MM_ARENA_OBJ;
+    memset((char *)(obj_hdr + 1), 0, req_size - sizeof(slab_obj_hdr_t));
+    return (void *)(obj_hdr + 1);
+}
+
+/* Release everything allocated from arena in O(pages), the pages are
+ * kept with the arena for the next computation*/
+void
+mm_arena_reset(mm_arena_t *arena){
+
+    mm_arena_page_t *arena_page = NULL;
+
+    for(arena_page = arena->first_page; arena_page; arena_page = arena_page->next){
+        arena_page->used = 0;
+    }
+    arena->curr_page = arena->first_page;
+    arena->bytes_in_use = 0;
+    arena->n_resets++;
+}
+
+/*Return all pages of the arena to kernel*/
+void
+mm_arena_destroy(mm_arena_t *arena){
+
+    mm_arena_page_t *arena_page = NULL, *next = NULL;
+    int units;
+
+    for(arena_page = arena->first_page; arena_page; arena_page = next){
+        next = arena_page->next;
+        units = (int)(arena_page->page_size / SYSTEM_PAGE_SIZE);
+        __atomic_fetch_sub(&mm_arena_vm_pages, units, __ATOMIC_RELAXED);
+        mm_return_vm_page_to_kernel((void *)arena_page, units);
+    }
+    mm_arena_init(arena);
+}
+
+/* Resolve the page family of a registered structure once, the
+ * returned handle stays valid for the life time of the process*/
+mm_page_family_handle_t
+mm_lookup_page_family_handle(char *struct_name){
 
-    /*Step 1*/
     vm_page_family_t *pg_family = 
         lookup_page_family_by_name(struct_name);
 
@@ -490,7 +1118,28 @@ xcalloc(char *struct_name, int units){
         assert(0);
         return NULL;
     }
-    
+    return pg_family;
+}
+
+/* The public fn to be invoked by the application for Dynamic 
+ * Memory Allocations.*/
+void *
+xcalloc(char *struct_name, int units){
+
+    return xcalloc_by_handle(
+            mm_lookup_page_family_handle(struct_name), units);
+}
+
+/* Fast path : allocation cost does not depend upon the number
+ * of structures registered with Memory Manager*/
+void *
+xcalloc_by_handle(mm_page_family_handle_t pg_family, int units){
+
+    assert(pg_family);
+
+    if(pg_family->slab_mode == MM_TRUE && units == 1)
+        return mm_slab_alloc(pg_family);
+
     /*Find the page which can satisfy the request*/
     block_meta_data_t *free_block_meta_data = NULL;
     
@@ -498,6 +1147,7 @@ xcalloc(char *struct_name, int units){
                             pg_family, units * pg_family->struct_size);
 
     if(free_block_meta_data){
+        pg_family->n_allocs++;
         memset((char *)(free_block_meta_data + 1), 0, free_block_meta_data->block_size);
         return  (void *)(free_block_meta_data + 1);
     }
@@ -505,6 +1155,50 @@ xcalloc(char *struct_name, int units){
     return NULL;
 }
 
+/* Call site accounting */
+
+static mm_call_site_t *mm_call_sites = NULL;
+static pthread_mutex_t mm_call_sites_lock = PTHREAD_MUTEX_INITIALIZER;
+static int mm_call_site_tracking = 0;
+
+static void
+mm_register_call_site(mm_call_site_t *call_site){
+
+    pthread_mutex_lock(&mm_call_sites_lock);
+    if(!call_site->pg_family){
+        call_site->next = mm_call_sites;
+        mm_call_sites = call_site;
+        __atomic_store_n(&call_site->pg_family, 
+            mm_lookup_page_family_handle((char *)call_site->struct_name),
+            __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&mm_call_sites_lock);
+}
+
+void
+mm_enable_call_site_tracking(int enable){
+
+    __atomic_store_n(&mm_call_site_tracking, enable ? 1 : 0, 
+        __ATOMIC_RELAXED);
+}
+
+/* Invoked by XCALLOC, counts the allocation against the call site
+ * while call site tracking is enabled*/
+void *
+xcalloc_at_site(mm_call_site_t *call_site, int units){
+
+    if(!__atomic_load_n(&call_site->pg_family, __ATOMIC_ACQUIRE))
+        mm_register_call_site(call_site);
+
+    if(__atomic_load_n(&mm_call_site_tracking, __ATOMIC_RELAXED)){
+        __atomic_fetch_add(&call_site->n_allocs, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&call_site->n_bytes, 
+            (uint64_t)units * call_site->pg_family->struct_size,
+            __ATOMIC_RELAXED);
+    }
+    return xcalloc_by_handle(call_site->pg_family, units);
+}
+
 static int 
 mm_get_hard_internal_memory_frag_size(
             block_meta_data_t *first,
@@ -520,8 +1214,10 @@ mm_union_free_blocks(block_meta_data_t *first,
 
     assert(first->is_free == MM_TRUE &&
         second->is_free == MM_TRUE);
-    remove_glthread(&first->priority_thread_glue);
-    remove_glthread(&second->priority_thread_glue);
+    mm_remove_free_block_from_free_block_list(
+        MM_GET_PAGE_FROM_META_BLOCK(first)->pg_family, first);
+    mm_remove_free_block_from_free_block_list(
+        MM_GET_PAGE_FROM_META_BLOCK(second)->pg_family, second);
     mm_bind_blocks_for_deallocation(first, second);
 }
 
@@ -568,15 +1264,21 @@ mm_free_blocks(block_meta_data_t *to_be_free_block){
     return_block = to_be_free_block;
     
     to_be_free_block->is_free = MM_TRUE;
+
+    vm_page_family->total_memory_in_use_by_app -=
+        sizeof(block_meta_data_t) + to_be_free_block->block_size;
+    vm_page_family->n_frees++;
     
     block_meta_data_t *next_block = NEXT_META_BLOCK(to_be_free_block);
+    int internal_mem_fragmentation = 0;
 
     /*Handling Hard IF memory*/
     if(next_block){
         /*Scenario 1 : When data block to be freed is not the last 
          * upper most meta block in a VM data page*/
-        to_be_free_block->block_size += 
+        internal_mem_fragmentation = 
             mm_get_hard_internal_memory_frag_size (to_be_free_block, next_block);
+        to_be_free_block->block_size += internal_mem_fragmentation;
     }
     else {
         /* Scenario 2: Page Boundry condition*/
@@ -586,10 +1288,15 @@ mm_free_blocks(block_meta_data_t *to_be_free_block){
         char *end_address_of_vm_page = (char *)((char *)hosting_page + hosting_page->page_size);
         char *end_address_of_free_data_block = 
             (char *)(to_be_free_block + 1) + to_be_free_block->block_size;
-        int internal_mem_fragmentation = (int)((unsigned long)end_address_of_vm_page - 
+        internal_mem_fragmentation = (int)((unsigned long)end_address_of_vm_page - 
                 (unsigned long)end_address_of_free_data_block);
         to_be_free_block->block_size += internal_mem_fragmentation;
     }
+
+    if((uint32_t)internal_mem_fragmentation > vm_page_family->hard_internal_frag)
+        vm_page_family->hard_internal_frag = 0;
+    else
+        vm_page_family->hard_internal_frag -= internal_mem_fragmentation;
     
     /*Now perform Merging*/
     if(next_block && next_block->is_free == MM_TRUE){
@@ -618,6 +1325,21 @@ mm_free_blocks(block_meta_data_t *to_be_free_block){
 void
 xfree(void *app_data){
 
+    /*Slab objects and blocks both keep their tag right before the data*/
+    uint32_t tag = *((uint32_t *)app_data - 1);
+
+    if(tag == MM_SLAB_OBJ_ALLOCATED){
+        mm_slab_free((slab_obj_hdr_t *)app_data - 1);
+        return;
+    }
+    assert(tag != MM_SLAB_OBJ_FREE);
+
+    if(tag == MM_ARENA_OBJ){
+        printf("Error : Memory %p belongs to an arena and cannot be freed\n",
+            app_data);
+        assert(0);
+    }
+
     block_meta_data_t *block_meta_data = 
         (block_meta_data_t *)((char *)app_data - sizeof(block_meta_data_t));
     
@@ -659,6 +1381,62 @@ mm_print_vm_page_details(vm_page_t *vm_page, uint32_t i){
     } ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page, curr);
 }
 
+/*Kernel's view of how much of our anonymous memory sits on huge pages*/
+static long
+mm_read_anon_huge_pages_kb(){
+
+    char line[128];
+    long kb = -1;
+    FILE *fp = fopen("/proc/self/smaps_rollup", "r");
+
+    if(!fp) return -1;
+
+    while(fgets(line, sizeof(line), fp)){
+        if(sscanf(line, "AnonHugePages: %ld kB", &kb) == 1)
+            break;
+    }
+    fclose(fp);
+    return kb;
+}
+
+static void
+mm_print_page_source_stats(){
+
+    mm_page_source_stats_t stats;
+    long anon_huge_kb;
+
+    mm_page_source_get_stats(&stats);
+    anon_huge_kb = mm_read_anon_huge_pages_kb();
+
+    printf("\nPage Source : chunk size = %uB, hugetlb = %s, thp = %s\n",
+        mm_page_source.chunk_size,
+        mm_page_source.use_hugetlb ? "on" : "off",
+        mm_page_source.use_thp ? "on" : "off");
+    printf("\tChunks reserved = %llu (%llu Bytes), hugetlb = %llu (failed %llu), thp advised = %llu\n",
+        (unsigned long long)stats.n_chunks,
+        (unsigned long long)stats.bytes_reserved,
+        (unsigned long long)stats.n_hugetlb_chunks,
+        (unsigned long long)stats.n_hugetlb_failures,
+        (unsigned long long)stats.n_thp_chunks);
+    printf("\tPage requests = %llu, recycled = %llu, VM pages in use = %llu, free = %llu\n",
+        (unsigned long long)stats.n_page_requests,
+        (unsigned long long)stats.n_page_recycled,
+        (unsigned long long)stats.pages_in_use,
+        (unsigned long long)stats.pages_free);
+    printf("\t#Sys Calls : mmap = %llu, munmap = %llu, madvise = %llu\n",
+        (unsigned long long)stats.n_mmap,
+        (unsigned long long)stats.n_munmap,
+        (unsigned long long)stats.n_madvise);
+    /*TLB reach : base pages vs huge pages needed to map the reservation*/
+    printf("\tTLB entries to map reservation : %llu (%zuB pages), %llu (huge pages)\n",
+        (unsigned long long)(stats.bytes_reserved / getpagesize()),
+        (size_t)getpagesize(),
+        (unsigned long long)(stats.bytes_reserved / MM_PAGE_SOURCE_HUGE_PAGE_SIZE));
+    if(anon_huge_kb >= 0){
+        printf("\tAnonHugePages (process) = %ld kB\n", anon_huge_kb);
+    }
+}
+
 void
 mm_print_memory_usage(char *struct_name){
 
@@ -668,10 +1446,15 @@ mm_print_memory_usage(char *struct_name){
     uint32_t number_of_struct_families = 0;
     uint32_t total_memory_in_use_by_application = 0;
     uint32_t cumulative_vm_pages_claimed_from_kernel = 0;
+    vm_page_for_families_t *vm_page_for_families_curr = NULL;
 
     printf("\nPage Size = %zu Bytes\n", SYSTEM_PAGE_SIZE);
 
-    ITERATE_PAGE_FAMILIES_BEGIN(first_vm_page_for_families, vm_page_family_curr){
+    for(vm_page_for_families_curr = first_vm_page_for_families; 
+        vm_page_for_families_curr; 
+        vm_page_for_families_curr = vm_page_for_families_curr->next){
+
+    ITERATE_PAGE_FAMILIES_BEGIN(vm_page_for_families_curr, vm_page_family_curr){
 
         if(struct_name){
             if(strncmp(struct_name, vm_page_family_curr->struct_name, 
@@ -682,6 +1465,8 @@ mm_print_memory_usage(char *struct_name){
 
         number_of_struct_families++;
 
+        mm_slab_sync_stats(vm_page_family_curr);
+
         printf(ANSI_COLOR_GREEN "vm_page_family : %s, struct size = %u\n" 
                 ANSI_COLOR_RESET,
                 vm_page_family_curr->struct_name,
@@ -703,8 +1488,35 @@ mm_print_memory_usage(char *struct_name){
             mm_print_vm_page_details(vm_page, i++);
 
         } ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page);
+
+        if(vm_page_family_curr->slab_mode == MM_TRUE){
+
+            slab_page_t *slab_page = NULL;
+
+            pthread_mutex_lock(&vm_page_family_curr->slab_lock);
+            printf("\tSlab : object size = %uB, slab pages = %u (%u empty)\n",
+                vm_page_family_curr->slab_obj_size,
+                vm_page_family_curr->n_slab_pages,
+                vm_page_family_curr->n_empty_slab_pages);
+            ITERATE_SLAB_PAGE_BEGIN(vm_page_family_curr->slab_pages, slab_page){
+                cumulative_vm_pages_claimed_from_kernel += 
+                    slab_page->page_size / SYSTEM_PAGE_SIZE;
+                printf("\t\t%-14p page_size = %uB  objects = %u  free = %u\n",
+                    slab_page, slab_page->page_size, 
+                    slab_page->n_objects, slab_page->n_free);
+            } ITERATE_SLAB_PAGE_END(vm_page_family_curr->slab_pages, slab_page);
+            ITERATE_SLAB_PAGE_BEGIN(vm_page_family_curr->slab_full_pages, slab_page){
+                cumulative_vm_pages_claimed_from_kernel += 
+                    slab_page->page_size / SYSTEM_PAGE_SIZE;
+                printf("\t\t%-14p page_size = %uB  objects = %u  free = %u\n",
+                    slab_page, slab_page->page_size, 
+                    slab_page->n_objects, slab_page->n_free);
+            } ITERATE_SLAB_PAGE_END(vm_page_family_curr->slab_full_pages, slab_page);
+            pthread_mutex_unlock(&vm_page_family_curr->slab_lock);
+        }
         printf("\n");
-    } ITERATE_PAGE_FAMILIES_END(first_vm_page_for_families, vm_page_family_curr);
+    } ITERATE_PAGE_FAMILIES_END(vm_page_for_families_curr, vm_page_family_curr);
+    }
 
     printf(ANSI_COLOR_MAGENTA "\nTotal Applcation Memory Usage : %u Bytes\n"
         ANSI_COLOR_RESET, total_memory_in_use_by_application);
@@ -727,6 +1539,11 @@ mm_print_memory_usage(char *struct_name){
 
     printf("Total Memory being used by Memory Manager = %lu Bytes\n",
         cumulative_vm_pages_claimed_from_kernel * SYSTEM_PAGE_SIZE); 
+
+    printf("VM Pages held by Arenas = %u (%lu Bytes)\n", mm_arena_vm_pages,
+        mm_arena_vm_pages * SYSTEM_PAGE_SIZE);
+
+    mm_print_page_source_stats();
 }
 
 void
@@ -738,8 +1555,13 @@ mm_print_block_usage(){
     uint32_t total_block_count, free_block_count,
              occupied_block_count;
     uint32_t application_memory_usage;
+    vm_page_for_families_t *vm_page_for_families_curr = NULL;
 
-    ITERATE_PAGE_FAMILIES_BEGIN(first_vm_page_for_families, vm_page_family_curr){
+    for(vm_page_for_families_curr = first_vm_page_for_families; 
+        vm_page_for_families_curr; 
+        vm_page_for_families_curr = vm_page_for_families_curr->next){
+
+    ITERATE_PAGE_FAMILIES_BEGIN(vm_page_for_families_curr, vm_page_family_curr){
 
         total_block_count = 0;
         free_block_count = 0;
@@ -756,7 +1578,8 @@ mm_print_block_usage(){
                     assert(IS_GLTHREAD_LIST_EMPTY(&block_meta_data_curr->\
                         priority_thread_glue));
                 }
-                if(block_meta_data_curr->is_free == MM_TRUE){
+                if(block_meta_data_curr->is_free == MM_TRUE &&
+                   block_meta_data_curr->block_size >= vm_page_family_curr->struct_size){
                     assert(!IS_GLTHREAD_LIST_EMPTY(&block_meta_data_curr->\
                         priority_thread_glue));
                 }
@@ -773,11 +1596,34 @@ mm_print_block_usage(){
             } ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page_curr, block_meta_data_curr);
         } ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page_curr);
 
+        /*Objects cached in the thread magazines count as occupied*/
+        if(vm_page_family_curr->slab_mode == MM_TRUE){
+
+            slab_page_t *slab_page = NULL;
+
+            pthread_mutex_lock(&vm_page_family_curr->slab_lock);
+            ITERATE_SLAB_PAGE_BEGIN(vm_page_family_curr->slab_pages, slab_page){
+                total_block_count += slab_page->n_objects;
+                free_block_count += slab_page->n_free;
+                occupied_block_count += slab_page->n_objects - slab_page->n_free;
+                application_memory_usage += (slab_page->n_objects - 
+                    slab_page->n_free) * vm_page_family_curr->slab_obj_size;
+            } ITERATE_SLAB_PAGE_END(vm_page_family_curr->slab_pages, slab_page);
+            ITERATE_SLAB_PAGE_BEGIN(vm_page_family_curr->slab_full_pages, slab_page){
+                total_block_count += slab_page->n_objects;
+                occupied_block_count += slab_page->n_objects;
+                application_memory_usage += 
+                    slab_page->n_objects * vm_page_family_curr->slab_obj_size;
+            } ITERATE_SLAB_PAGE_END(vm_page_family_curr->slab_full_pages, slab_page);
+            pthread_mutex_unlock(&vm_page_family_curr->slab_lock);
+        }
+
     printf("%-20s   TBC : %-4u    FBC : %-4u    OBC : %-4u AppMemUsage : %u\n",
         vm_page_family_curr->struct_name, total_block_count,
         free_block_count, occupied_block_count, application_memory_usage);
 
-    } ITERATE_PAGE_FAMILIES_END(first_vm_page_for_families, vm_page_family_curr); 
+    } ITERATE_PAGE_FAMILIES_END(vm_page_for_families_curr, vm_page_family_curr); 
+    }
 }
 
 void
@@ -794,11 +1640,301 @@ mm_print_registered_page_families(){
             vm_page_family_curr){
 
 
-            printf("Page Family : %s, Size = %u\n", 
+            printf("Page Family : %s, Size = %u%s\n", 
                 vm_page_family_curr->struct_name,
-                vm_page_family_curr->struct_size);
+                vm_page_family_curr->struct_size,
+                vm_page_family_curr->slab_mode == MM_TRUE ? ", slab" : "");
 
         } ITERATE_PAGE_FAMILIES_END(vm_page_for_families_curr,
             vm_page_family_curr);
     }
 }
+
+/* Instrumentation : family stats, call site histogram and leak report */
+
+/*Caller frees the returned array*/
+static vm_page_family_t **
+mm_get_all_page_families(uint32_t *n_families){
+
+    uint32_t n = 0;
+    vm_page_family_t *vm_page_family_curr = NULL;
+    vm_page_for_families_t *vm_page_for_families_curr = NULL;
+    vm_page_family_t **families = NULL;
+
+    for(vm_page_for_families_curr = first_vm_page_for_families; 
+        vm_page_for_families_curr; 
+        vm_page_for_families_curr = vm_page_for_families_curr->next){
+
+        n += MAX_FAMILIES_PER_VM_PAGE;
+    }
+
+    families = calloc(n + 1, sizeof(vm_page_family_t *));
+    n = 0;
+
+    for(vm_page_for_families_curr = first_vm_page_for_families; 
+        vm_page_for_families_curr; 
+        vm_page_for_families_curr = vm_page_for_families_curr->next){
+
+        ITERATE_PAGE_FAMILIES_BEGIN(vm_page_for_families_curr, 
+            vm_page_family_curr){
+
+            mm_slab_sync_stats(vm_page_family_curr);
+            families[n++] = vm_page_family_curr;
+
+        } ITERATE_PAGE_FAMILIES_END(vm_page_for_families_curr,
+            vm_page_family_curr);
+    }
+    *n_families = n;
+    return families;
+}
+
+void
+mm_get_alloc_stats(mm_alloc_stats_t *stats){
+
+    uint32_t i = 0, n_families = 0;
+    vm_page_family_t **families = mm_get_all_page_families(&n_families);
+
+    memset(stats, 0, sizeof(mm_alloc_stats_t));
+    for(i = 0; i < n_families; i++){
+        stats->n_allocs += families[i]->n_allocs;
+        stats->n_frees += families[i]->n_frees;
+        stats->bytes_in_use += families[i]->total_memory_in_use_by_app;
+    }
+    free(families);
+}
+
+static uint32_t
+mm_get_internal_frag_size(vm_page_family_t *vm_page_family){
+
+    uint32_t frag = vm_page_family->hard_internal_frag;
+
+    if(vm_page_family->slab_mode == MM_TRUE){
+        frag += vm_page_family->n_slab_objs_in_use * 
+            MM_SLAB_OBJ_PADDING(vm_page_family);
+    }
+    return frag;
+}
+
+void
+mm_print_family_stats(){
+
+    uint32_t i = 0, n_families = 0;
+    vm_page_family_t *vm_page_family;
+    uint64_t total_allocs = 0, total_frees = 0;
+    uint32_t total_in_use = 0, total_frag = 0;
+    double uptime = mm_seconds_since(&mm_init_time);
+    vm_page_family_t **families = mm_get_all_page_families(&n_families);
+
+    printf("%-30s %10s %10s %10s %10s %8s %10s %8s\n",
+        "Page Family", "In Use(B)", "HWM(B)", "#Allocs", "#Frees",
+        "#Live", "Allocs/s", "IF(B)");
+
+    for(i = 0; i < n_families; i++){
+
+        vm_page_family = families[i];
+        printf("%-30s %10u %10u %10llu %10llu %8lld %10.1f %8u\n",
+            vm_page_family->struct_name,
+            vm_page_family->total_memory_in_use_by_app,
+            vm_page_family->high_water_mark,
+            (unsigned long long)vm_page_family->n_allocs,
+            (unsigned long long)vm_page_family->n_frees,
+            (long long)(vm_page_family->n_allocs - vm_page_family->n_frees),
+            uptime > 0 ? vm_page_family->n_allocs / uptime : 0.0,
+            mm_get_internal_frag_size(vm_page_family));
+
+        total_allocs += vm_page_family->n_allocs;
+        total_frees += vm_page_family->n_frees;
+        total_in_use += vm_page_family->total_memory_in_use_by_app;
+        total_frag += mm_get_internal_frag_size(vm_page_family);
+    }
+
+    printf("\nTotal : In Use = %uB, Allocs = %llu, Frees = %llu, "
+        "Internal Fragmentation = %uB, Uptime = %.1fs\n",
+        total_in_use, (unsigned long long)total_allocs,
+        (unsigned long long)total_frees, total_frag, uptime);
+    free(families);
+}
+
+static int
+mm_call_site_count_comparison_function(const void *a, const void *b){
+
+    const mm_call_site_snapshot_t *site_a = a;
+    const mm_call_site_snapshot_t *site_b = b;
+
+    if(site_a->n_allocs == site_b->n_allocs)
+        return 0;
+    return site_a->n_allocs > site_b->n_allocs ? -1 : 1;
+}
+
+/* Copy the counters of all known call sites, diffed against
+ * base_sites if given, sorted by allocations in descending order.
+ * Caller frees the returned array*/
+static mm_call_site_snapshot_t *
+mm_collect_call_sites(mm_call_site_snapshot_t *base_sites,
+                      uint32_t n_base_sites,
+                      uint32_t *n_sites){
+
+    uint32_t i = 0, n = 0;
+    mm_call_site_t *call_site = NULL;
+    mm_call_site_snapshot_t *sites = NULL;
+
+    pthread_mutex_lock(&mm_call_sites_lock);
+
+    for(call_site = mm_call_sites; call_site; call_site = call_site->next)
+        n++;
+
+    sites = calloc(n + 1, sizeof(mm_call_site_snapshot_t));
+    n = 0;
+
+    for(call_site = mm_call_sites; call_site; call_site = call_site->next){
+
+        sites[n].call_site = call_site;
+        sites[n].n_allocs = __atomic_load_n(&call_site->n_allocs,
+                                __ATOMIC_RELAXED);
+        for(i = 0; i < n_base_sites; i++){
+            if(base_sites[i].call_site == call_site){
+                sites[n].n_allocs -= base_sites[i].n_allocs;
+                break;
+            }
+        }
+        n++;
+    }
+    pthread_mutex_unlock(&mm_call_sites_lock);
+
+    qsort(sites, n, sizeof(mm_call_site_snapshot_t),
+        mm_call_site_count_comparison_function);
+    *n_sites = n;
+    return sites;
+}
+
+void
+mm_print_call_sites(){
+
+    uint32_t i = 0, n_sites = 0;
+    mm_call_site_snapshot_t *sites = 
+        mm_collect_call_sites(NULL, 0, &n_sites);
+
+    if(!mm_call_site_tracking){
+        printf("Call site tracking is disabled, counts are stale\n");
+    }
+
+    printf("%-40s %-30s %10s %12s\n", 
+        "Call Site", "Structure", "#Allocs", "Bytes");
+
+    for(i = 0; i < n_sites; i++){
+
+        char location[256];
+        snprintf(location, sizeof(location), "%s:%u",
+            sites[i].call_site->file, sites[i].call_site->line);
+        printf("%-40s %-30s %10llu %12llu\n", location,
+            sites[i].call_site->struct_name,
+            (unsigned long long)sites[i].n_allocs,
+            (unsigned long long)__atomic_load_n(
+                &sites[i].call_site->n_bytes, __ATOMIC_RELAXED));
+    }
+    free(sites);
+}
+
+static mm_family_snapshot_t *mm_family_snapshot = NULL;
+static uint32_t mm_n_family_snapshot = 0;
+static mm_call_site_snapshot_t *mm_call_site_snapshot = NULL;
+static uint32_t mm_n_call_site_snapshot = 0;
+static struct timespec mm_snapshot_time;
+
+/* Record the counters of every page family and call site, 
+ * mm_print_leak_report() reports the growth since then*/
+void
+mm_take_snapshot(){
+
+    uint32_t i = 0, n_families = 0;
+    vm_page_family_t **families = mm_get_all_page_families(&n_families);
+
+    free(mm_family_snapshot);
+    free(mm_call_site_snapshot);
+
+    mm_family_snapshot = calloc(n_families + 1, sizeof(mm_family_snapshot_t));
+    for(i = 0; i < n_families; i++){
+        mm_family_snapshot[i].vm_page_family = families[i];
+        mm_family_snapshot[i].n_allocs = families[i]->n_allocs;
+        mm_family_snapshot[i].n_frees = families[i]->n_frees;
+        mm_family_snapshot[i].total_memory_in_use_by_app = 
+            families[i]->total_memory_in_use_by_app;
+    }
+    mm_n_family_snapshot = n_families;
+    free(families);
+
+    /*Raw counts, the undiffed and unsorted order does not matter here*/
+    mm_call_site_snapshot = mm_collect_call_sites(NULL, 0, 
+                                &mm_n_call_site_snapshot);
+    clock_gettime(CLOCK_MONOTONIC, &mm_snapshot_time);
+}
+
+void
+mm_print_leak_report(){
+
+    uint32_t i = 0, j = 0, n_families = 0, n_sites = 0;
+    uint32_t n_growing = 0;
+    vm_page_family_t **families = NULL;
+    mm_call_site_snapshot_t *sites = NULL;
+    mm_family_snapshot_t base;
+    double interval;
+
+    if(!mm_family_snapshot){
+        printf("No snapshot taken\n");
+        return;
+    }
+
+    interval = mm_seconds_since(&mm_snapshot_time);
+    families = mm_get_all_page_families(&n_families);
+
+    printf("Growth since snapshot taken %.1fs ago :\n", interval);
+    printf("%-30s %10s %10s %10s %12s %10s\n",
+        "Page Family", "+Allocs", "+Frees", "Net Objs", "Net Bytes",
+        "Allocs/s");
+
+    for(i = 0; i < n_families; i++){
+
+        memset(&base, 0, sizeof(base));
+        for(j = 0; j < mm_n_family_snapshot; j++){
+            if(mm_family_snapshot[j].vm_page_family == families[i]){
+                base = mm_family_snapshot[j];
+                break;
+            }
+        }
+
+        uint64_t d_allocs = families[i]->n_allocs - base.n_allocs;
+        uint64_t d_frees = families[i]->n_frees - base.n_frees;
+        int64_t d_bytes = (int64_t)families[i]->total_memory_in_use_by_app - 
+            (int64_t)base.total_memory_in_use_by_app;
+
+        if(d_allocs == d_frees && !d_bytes)
+            continue;
+
+        n_growing++;
+        printf("%-30s %10llu %10llu %+10lld %+12lld %10.1f\n",
+            families[i]->struct_name,
+            (unsigned long long)d_allocs, (unsigned long long)d_frees,
+            (long long)(d_allocs - d_frees), (long long)d_bytes,
+            interval > 0 ? d_allocs / interval : 0.0);
+    }
+    free(families);
+
+    if(!n_growing){
+        printf("No page family grew\n");
+    }
+
+    if(!mm_call_site_tracking)
+        return;
+
+    sites = mm_collect_call_sites(mm_call_site_snapshot, 
+                mm_n_call_site_snapshot, &n_sites);
+
+    printf("\nAllocations by call site since snapshot :\n");
+    for(i = 0; i < n_sites && sites[i].n_allocs; i++){
+        printf("\t%s:%u (%s) : %llu\n",
+            sites[i].call_site->file, sites[i].call_site->line,
+            sites[i].call_site->struct_name,
+            (unsigned long long)sites[i].n_allocs);
+    }
+    free(sites);
+}
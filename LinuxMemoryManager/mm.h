@@ -32,6 +32,7 @@
 #define __MM__
 
 #include <stdint.h>
+#include <pthread.h>
 #include "../gluethread/glthread.h"
 #include <stddef.h> /*for size_t*/
 
@@ -44,12 +45,15 @@ typedef enum{
 
 typedef struct block_meta_data_{
 
-    vm_bool_t is_free;
     uint32_t block_size;
     uint32_t offset;    /*offset from the start of the page*/
     glthread_t priority_thread_glue;
     struct block_meta_data_ *prev_block;
     struct block_meta_data_ *next_block;
+    uint32_t reserved;
+    /* Must stay the last member : xfree() reads the 32 bits right
+     * before the application data to tell a block from a slab object*/
+    vm_bool_t is_free;
 } block_meta_data_t;
 GLTHREAD_TO_STRUCT(glthread_to_block_meta_data, 
     block_meta_data_t, priority_thread_glue);
@@ -98,18 +102,133 @@ typedef struct vm_page_{
 vm_bool_t
 mm_is_vm_page_empty(vm_page_t *vm_page);
 
+/* Slab mode : single unit allocations of a fixed size family are
+ * served from slab pages carved into equal sized objects. Each thread
+ * keeps a magazine of free objects per slab family, magazines are
+ * refilled from and flushed to the central depot (the family's slab
+ * pages) in bulk, so the depot lock is taken once per
+ * MM_SLAB_MAGAZINE_SIZE/2 allocations rather than on every one*/
+#define MM_MAX_SLAB_FAMILIES    32
+#define MM_SLAB_MAGAZINE_SIZE   32
+#define MM_SLAB_MAX_EMPTY_PAGES 4   /*empty slab pages kept cached in depot*/
+
+/*Tags stored in the is_free position of a slab object header*/
+#define MM_SLAB_OBJ_ALLOCATED   0x51AB0A11
+#define MM_SLAB_OBJ_FREE        0x51AB0F4E
+
+typedef struct slab_obj_hdr_{
+
+    uint32_t offset;    /*offset from the start of the slab page*/
+    uint32_t tag;       /*overlays block_meta_data_t.is_free*/
+} slab_obj_hdr_t;
+
+typedef struct slab_page_{
+
+    struct slab_page_ *next;
+    struct slab_page_ *prev;
+    struct vm_page_family_ *pg_family; /*back pointer*/
+    uint32_t page_size;
+    uint32_t n_objects;
+    uint32_t n_free;
+    slab_obj_hdr_t *free_list; /*linked through the object memory*/
+    char page_memory[0];
+} slab_page_t;
+
+#define MM_SLAB_OBJ_NEXT_FREE(slab_obj_hdr_ptr)    \
+    (*(slab_obj_hdr_t **)(slab_obj_hdr_ptr + 1))
+
+#define MM_GET_SLAB_PAGE_FROM_OBJ_HDR(slab_obj_hdr_ptr)    \
+    ((slab_page_t *)((char *)slab_obj_hdr_ptr - slab_obj_hdr_ptr->offset))
+
+/* Page source : VM pages are carved from chunks reserved with mmap*/
+#define MM_PAGE_SOURCE_HUGE_PAGE_SIZE       (2 * 1024 * 1024)
+#define MM_PAGE_SOURCE_DEFAULT_CHUNK_SIZE   (8 * MM_PAGE_SOURCE_HUGE_PAGE_SIZE)
+#define MM_PAGE_SOURCE_MAX_UNITS            32  /*bigger requests are mmap'd directly*/
+
+/* Arena : bump allocation over VM pages, everything allocated from an
+ * arena is released at once by mm_arena_reset(). Arena objects carry
+ * the same 8B header layout as slab objects so that a stray xfree()
+ * on them is caught*/
+#define MM_ARENA_OBJ            0xA4E4A0B1
+
+typedef struct mm_arena_page_{
+
+    struct mm_arena_page_ *next;
+    uint32_t page_size;
+    uint32_t used;      /*bytes handed out from page_memory*/
+    char page_memory[0];
+} mm_arena_page_t;
+
+#define MM_ARENA_PAGE_HAS_ROOM(arena_page_ptr, size)   \
+    (arena_page_ptr->used + size <=                    \
+     arena_page_ptr->page_size - offset_of(mm_arena_page_t, page_memory))
+
 #define MM_MAX_STRUCT_NAME 32
+/*Free blocks are kept in lists by size class, class c holds
+ * the blocks of [2^c, 2^(c+1)) bytes*/
+#define MM_FREE_BLOCK_CLASSES   32
 typedef struct vm_page_family_{
 
     char struct_name[MM_MAX_STRUCT_NAME];
     uint32_t struct_size;
     vm_page_t *first_page;
-    glthread_t free_block_priority_list_head;
+    glthread_t free_block_class_list[MM_FREE_BLOCK_CLASSES];
+    uint32_t free_block_classes_in_use;  /*bit c set when class c is non empty*/
+    /*Slab mode, central depot*/
+    vm_bool_t slab_mode;
+    uint32_t slab_id;         /*index of the family in per-thread magazines*/
+    uint32_t slab_obj_size;   /*header + object, 8B aligned*/
+    pthread_mutex_t slab_lock;
+    slab_page_t *slab_pages;      /*pages having at least one free object*/
+    slab_page_t *slab_full_pages; /*pages with all objects handed out*/
+    uint32_t n_slab_pages;
+    uint32_t n_empty_slab_pages;
+    uint32_t n_slab_objs_in_use;
     /*Statistics*/
     uint32_t total_memory_in_use_by_app;
     uint32_t no_of_system_calls_to_alloc_dealloc_vm_pages;
+    uint32_t high_water_mark;       /*of total_memory_in_use_by_app*/
+    uint32_t hard_internal_frag;    /*bytes lost to hard internal fragmentation*/
+    uint64_t n_allocs;
+    uint64_t n_frees;
 } vm_page_family_t;
 
+#define MM_UPDATE_HIGH_WATER_MARK(vm_page_family_ptr)                 \
+    if(vm_page_family_ptr->total_memory_in_use_by_app >               \
+        vm_page_family_ptr->high_water_mark)                          \
+        vm_page_family_ptr->high_water_mark =                         \
+            vm_page_family_ptr->total_memory_in_use_by_app
+
+/*Bytes every slab object wastes as padding*/
+#define MM_SLAB_OBJ_PADDING(vm_page_family_ptr)                       \
+    (vm_page_family_ptr->slab_obj_size - sizeof(slab_obj_hdr_t) -     \
+     vm_page_family_ptr->struct_size)
+
+typedef struct slab_magazine_{
+
+    uint32_t n_objs;
+    /*folded into the family stats at depot visits*/
+    int32_t n_objs_in_use_delta;
+    uint32_t n_allocs_delta;
+    uint32_t n_frees_delta;
+    slab_obj_hdr_t *objs[MM_SLAB_MAGAZINE_SIZE];
+} slab_magazine_t;
+
+/*Per family counters saved by mm_take_snapshot()*/
+typedef struct mm_family_snapshot_{
+
+    vm_page_family_t *vm_page_family;
+    uint64_t n_allocs;
+    uint64_t n_frees;
+    uint32_t total_memory_in_use_by_app;
+} mm_family_snapshot_t;
+
+typedef struct mm_call_site_snapshot_{
+
+    struct mm_call_site_ *call_site;
+    uint64_t n_allocs;
+} mm_call_site_snapshot_t;
+
 typedef struct vm_page_for_families_{
 
     struct vm_page_for_families_ *next;
@@ -120,17 +239,29 @@ typedef struct vm_page_for_families_{
     ((SYSTEM_PAGE_SIZE - sizeof(vm_page_for_families_t *))/sizeof(vm_page_family_t))
 
 
+static inline uint32_t
+mm_free_block_class(uint32_t block_size){
+
+    return 31 - __builtin_clz(block_size);
+}
+
+/*Last freed block of the highest non empty size class. Blocks of
+ * lower classes are all smaller. Other blocks of the class are not
+ * searched, a request it cannot serve gets a new page even if one of
+ * them could, as walking a class piled up with blocks just too small
+ * for a growing array costs more than the page*/
 static inline block_meta_data_t *
 mm_get_biggest_free_block_page_family(
         vm_page_family_t *vm_page_family){
 
-    glthread_t *biggest_free_block_glue = 
-        vm_page_family->free_block_priority_list_head.right;
-    
-    if(biggest_free_block_glue)
-        return glthread_to_block_meta_data(biggest_free_block_glue);
+    uint32_t class;
 
-    return NULL;
+    if(!vm_page_family->free_block_classes_in_use)
+        return NULL;
+
+    class = 31 - __builtin_clz(vm_page_family->free_block_classes_in_use);
+    return glthread_to_block_meta_data(
+        vm_page_family->free_block_class_list[class].right);
 }
 
 vm_page_t *
@@ -169,6 +300,15 @@ lookup_page_family_by_name(char *struct_name);
 #define ITERATE_VM_PAGE_END(vm_page_family_ptr, curr)   \
     }}
 
+#define ITERATE_SLAB_PAGE_BEGIN(slab_page_list_head, curr) \
+{                                             \
+    slab_page_t *next = NULL;                 \
+    for(curr = slab_page_list_head; curr; curr = next){ \
+        next = curr->next;
+
+#define ITERATE_SLAB_PAGE_END(slab_page_list_head, curr) \
+    }}
+
 #define ITERATE_VM_PAGE_ALL_BLOCKS_BEGIN(vm_page_ptr, curr)    \
 {                                                              \
     curr = &vm_page_ptr->block_meta_data;                      \
@@ -33,34 +33,150 @@
 
 #include <stdint.h>
 
+/*Opaque handle to a registered page family. Handles never
+ * change once the struct is registered, so they can be cached
+ * by the callers and used to skip the lookup by name*/
+struct vm_page_family_;
+typedef struct vm_page_family_ *mm_page_family_handle_t;
+
+/*Per computation arena, embed it by value and mm_arena_init() it.
+ * An arena is owned by one thread at a time, it is not locked*/
+typedef struct mm_arena_{
+
+    struct mm_arena_page_ *first_page;
+    struct mm_arena_page_ *curr_page;
+    uint32_t n_pages;
+    uint32_t bytes_in_use;
+    uint32_t n_resets;
+} mm_arena_t;
+
+/*VM page source statistics*/
+typedef struct mm_page_source_stats_{
+
+    uint64_t n_page_requests;
+    uint64_t n_page_recycled;   /*served from pages given back earlier*/
+    uint64_t n_mmap;
+    uint64_t n_munmap;
+    uint64_t n_madvise;
+    uint64_t n_chunks;
+    uint64_t n_hugetlb_chunks;
+    uint64_t n_hugetlb_failures;
+    uint64_t n_thp_chunks;
+    uint64_t bytes_reserved;
+    uint64_t pages_in_use;      /*in units of VM pages*/
+    uint64_t pages_free;
+} mm_page_source_stats_t;
+
+/*XCALLOC/XFREE totals over all page families*/
+typedef struct mm_alloc_stats_{
+
+    uint64_t n_allocs;
+    uint64_t n_frees;
+    uint64_t bytes_in_use;      /*by the application*/
+} mm_alloc_stats_t;
+
+/*Every XCALLOC in the code has one of these*/
+typedef struct mm_call_site_{
+
+    const char *file;
+    uint32_t line;
+    const char *struct_name;
+    mm_page_family_handle_t pg_family;  /*resolved on first use*/
+    struct mm_call_site_ *next;
+    /*counted only while call site tracking is enabled*/
+    uint64_t n_allocs;
+    uint64_t n_bytes;
+} mm_call_site_t;
+
 void *
 xcalloc(char *struct_name, int units);
 
+void *
+xcalloc_at_site(mm_call_site_t *call_site, int units);
+
+void *
+xcalloc_by_handle(mm_page_family_handle_t pg_family, int units);
+
 void
 xfree(void *app_ptr);
 
+/*Arena functions*/
+void
+mm_arena_init(mm_arena_t *arena);
+
+void *
+mm_arena_alloc(mm_arena_t *arena, uint32_t size);
+
+void
+mm_arena_reset(mm_arena_t *arena);
+
+void
+mm_arena_destroy(mm_arena_t *arena);
+
+/*Page source functions. chunk_size is rounded up to huge page size,
+ * use_hugetlb falls back to normal pages if no huge page is available,
+ * use_thp advises the kernel to back chunks with transparent huge pages*/
+void
+mm_page_source_config(uint32_t chunk_size,
+                      int use_hugetlb,
+                      int use_thp);
+
+void
+mm_page_source_get_stats(mm_page_source_stats_t *stats);
+
+void
+mm_get_alloc_stats(mm_alloc_stats_t *stats);
+
+/*Instrumentation functions*/
+void mm_enable_call_site_tracking(int enable);
+void mm_take_snapshot();
+
 /*Printing Functions*/
 void mm_print_memory_usage(char *struct_name);
 void mm_print_block_usage();
 void mm_print_registered_page_families();
+void mm_print_family_stats();
+void mm_print_call_sites();
+void mm_print_leak_report();
 
 /*Initialization Functions*/
 void
 mm_init();
 
 /*Registration function*/
-void
+mm_page_family_handle_t
 mm_instantiate_new_page_family(
         char *struct_name,
         uint32_t struct_size);
 
-#define XCALLOC(units, struct_name) \
-    (xcalloc(#struct_name, units))
+mm_page_family_handle_t
+mm_lookup_page_family_handle(char *struct_name);
+
+/*Serve single unit allocations of the family from per-thread
+ * magazines backed by slab pages, to be called at registration*/
+void
+mm_enable_slab_mode(mm_page_family_handle_t pg_family);
+
+/*Every XCALLOC call site resolves the page family of its struct
+ * once and caches the handle, subsequent allocations go straight
+ * to the family without searching the registered families*/
+#define XCALLOC(units, struct_name)                                     \
+    ({  static mm_call_site_t _mm_call_site =                           \
+            {__FILE__, __LINE__, #struct_name, 0, 0, 0, 0};             \
+        xcalloc_at_site(&_mm_call_site, units); })
 
 #define MM_REG_STRUCT(struct_name)  \
     (mm_instantiate_new_page_family(#struct_name, sizeof(struct_name)))
 
+#define MM_REG_STRUCT_SLAB(struct_name) \
+    (mm_enable_slab_mode(MM_REG_STRUCT(struct_name)))
+
 #define XFREE(ptr)  \
    xfree(ptr)
 
+/*Memory from arena need not be registered and must never be XFREE'd,
+ * it goes away with mm_arena_reset()/mm_arena_destroy() of the arena*/
+#define XCALLOC_ARENA(arena, units, struct_name)  \
+    (mm_arena_alloc(arena, (units) * sizeof(struct_name)))
+
 #endif /* __UAPI_MM__ */
@@ -31,7 +31,7 @@
  */
 
 #include <assert.h>
-#include <unistd.h>
+#include <string.h>
 #include "advert.h"
 #include "instance.h"
 #include "spfutil.h"
@@ -60,47 +60,162 @@ lsp_distribution_routine(node_t *lsp_generator,
     
      switch(dist_info->advert_id){
         case TLV128:
-                partial_spf_run(lsp_receiver, dist_info->info_dist_level);
+            {
+                tlv128_ip_reach_t *ad_msg = (tlv128_ip_reach_t *)dist_info->info_data;
+                /*Without the prefix, PRC rebuilds the whole routing table*/
+                spf_schedule_prefix(lsp_receiver, dist_info->info_dist_level,
+                    ad_msg ? ad_msg->prefix : NULL, ad_msg ? ad_msg->mask : 0);
+            }
                 break;
 
         case TLV2:
-                spf_computation(lsp_receiver, &lsp_receiver->spf_info, dist_info->info_dist_level, FULL_RUN, 0);
+                spf_schedule(lsp_receiver, dist_info->info_dist_level, SPF_TRIGGER_TOPOLOGY);
                 break;
 
         case OVERLOAD:
                 /*Trigger full spf run if router overloads/or unoverloads*/
-                spf_computation(lsp_receiver, &lsp_receiver->spf_info, dist_info->info_dist_level, FULL_RUN, 0);
+                spf_schedule(lsp_receiver, dist_info->info_dist_level, SPF_TRIGGER_OVERLOAD);
                 break;  
         default:
             ; 
      }
 }
 
+void
+copy_dist_info_hdr(dist_info_hdr_t *dst, dist_info_hdr_t *src,
+                   lsp_advert_copy_t *advert){
+
+    *dst = *src;
+    memset(advert, 0, sizeof(lsp_advert_copy_t));
+    dst->info_data = (char *)advert;
+
+    if(!src->info_data){
+        dst->info_data = NULL;
+        return;
+    }
+
+    switch(src->advert_id){
+        case TLV128:
+            advert->u.tlv128 = *(tlv128_ip_reach_t *)src->info_data;
+            if(advert->u.tlv128.prefix){
+                strncpy(advert->prefix, advert->u.tlv128.prefix, PREFIX_LEN);
+                advert->u.tlv128.prefix = advert->prefix;
+            }
+            break;
+        case OVERLOAD:
+            advert->u.lsp_hdr = *(lsp_hdr_t *)src->info_data;
+            break;
+        default:
+            /*TLV2 carries no info_data*/
+            dst->info_data = NULL;
+    }
+}
+
 void
 init_instance_traversal(instance_t * instance){
 
-    singly_ll_node_t *list_node = NULL;
     node_t *node = NULL;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = (node_t *)list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
         node->traversing_bit = 0;
-    }ITERATE_LIST_END;  
+    }ITERATE_HASH_VECTOR_END;  
 }
 
 static void
 init_instance_lsp_distribution_traversal(instance_t * instance){
 
-    singly_ll_node_t *list_node = NULL;
     node_t *node = NULL;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = (node_t *)list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
         node->lsp_distribution_bit = 0;
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 }
 
 
+static int
+lsp_flood_node_comparison_fn(void *node, void *key){
+
+    return node == key;
+}
+
+static void
+lsp_flood_node_set_init(hash_vector_t *node_set){
+
+    memset(node_set, 0, sizeof(hash_vector_t));
+    hash_vector_set_comparison_fn(node_set, lsp_flood_node_comparison_fn);
+    hash_vector_set_hash_fns(node_set, hash_vector_ptr_hash, hash_vector_ptr_hash);
+}
+
+static void
+lsp_flood_pacing_timer_expiry(void *arg, uint32_t arg_size){
+
+    lsp_flood_t *flood = (lsp_flood_t *)arg;
+    hash_vector_t next_wave;
+
+    node_t  *curr_node = NULL,
+            *nbr_node = NULL,
+            *pn_node = NULL;
+
+    edge_t *edge1 = NULL,
+           *edge2 = NULL;
+
+    lsp_flood_node_set_init(&next_wave);
+
+    ITERATE_HASH_VECTOR_BEGIN(&flood->wave, curr_node){
+
+        ITERATE_NODE_PHYSICAL_NBRS_BEGIN(curr_node, nbr_node, pn_node, edge1, 
+                edge2, flood->level){
+
+            if(hash_vector_is_present(&flood->visited, nbr_node)){
+                ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(curr_node, nbr_node, pn_node, flood->level);
+            }
+            trace_log(flood->instance->traceopts, SPF_EVENTS_BIT, "Paced LSP Distribution Src : %s, Des Node : %s", 
+                    flood->dist_info.lsp_generator->node_name, nbr_node->node_name);
+            flood->fn_ptr(flood->dist_info.lsp_generator, nbr_node, &flood->dist_info);
+            hash_vector_add(&flood->visited, nbr_node);
+            hash_vector_add(&next_wave, nbr_node);
+        }
+        ITERATE_NODE_PHYSICAL_NBRS_END(curr_node, nbr_node, pn_node, flood->level);
+    }ITERATE_HASH_VECTOR_END;
+
+    delete_hash_vector(&flood->wave);
+    flood->wave = next_wave;
+
+    if(!IS_HASH_VECTOR_EMPTY(&flood->wave))
+        return;
+
+    /*LSP has reached the entire level*/
+    ev_dis_timer_cancel(&flood->pacing_timer);
+    delete_hash_vector(&flood->wave);
+    delete_hash_vector(&flood->visited);
+    XFREE(flood);
+}
+
+static void
+generate_lsp_paced(instance_t *instance,
+                   node_t *lsp_generator,
+                   info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info,
+                   LEVEL level){
+
+    lsp_flood_t *flood = XCALLOC(1, lsp_flood_t);
+
+    flood->instance = instance;
+    flood->fn_ptr = fn_ptr;
+    copy_dist_info_hdr(&flood->dist_info, dist_info, &flood->advert);
+    flood->dist_info.lsp_generator = lsp_generator;
+    flood->level = level;
+
+    lsp_flood_node_set_init(&flood->visited);
+    lsp_flood_node_set_init(&flood->wave);
+    hash_vector_add(&flood->visited, lsp_generator);
+    hash_vector_add(&flood->wave, lsp_generator);
+
+    ev_dis_timer_init(&flood->pacing_timer, lsp_flood_pacing_timer_expiry,
+            (void *)flood, TASK_PRIORITY_MEDIUM, NULL);
+    ev_dis_timer_arm(&flood->pacing_timer, instance->lsp_pacing_msec,
+            instance->lsp_pacing_msec);
+}
+
 /*fn to simulate LSP generation and distribution at its simplest.*/
 void
 generate_lsp(instance_t *instance, 
@@ -117,9 +232,24 @@ generate_lsp(instance_t *instance,
     LEVEL level_of_info_dist = dist_info->info_dist_level,
           level_it = LEVEL_UNKNOWN;
 
+    if(instance->flood_sim_config.enabled){
+        flood_sim_generate_lsp(instance, lsp_generator, fn_ptr, dist_info);
+        return;
+    }
+
     /*distribute the info to self*/
     fn_ptr(lsp_generator, lsp_generator, dist_info);
 
+    /*Let us introduce some delay in information propogation, the
+     * remaining distribution is driven by the pacing timer*/
+    if(instance->lsp_pacing_msec){
+        for(level_it = LEVEL1 ; level_it < MAX_LEVEL; level_it++){
+            if(IS_LEVEL_SET(level_of_info_dist, level_it))
+                generate_lsp_paced(instance, lsp_generator, fn_ptr, dist_info, level_it);
+        }
+        return;
+    }
+
     /*distribute info in the network at a given level*/
     Queue_t *q = initQ();
 
@@ -132,23 +262,18 @@ generate_lsp(instance_t *instance,
 
         lsp_generator->lsp_distribution_bit = 1;
         enqueue(q, lsp_generator);
-        unsigned int propogation_delay = 0;
 
         while(!is_queue_empty(q)){
 
             curr_node = deque(q);
-            sleep(propogation_delay); /*Let us introduce some delay in information propogation*/
             ITERATE_NODE_PHYSICAL_NBRS_BEGIN(curr_node, nbr_node, pn_node, edge1, 
                                             edge2, level_it){
 
                 if(nbr_node->lsp_distribution_bit){
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(curr_node, nbr_node, pn_node, level_it);
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "LSP Distribution Src : %s, Des Node : %s", 
-                        lsp_generator->node_name, nbr_node->node_name); 
-                trace(instance->traceopts, SPF_EVENTS_BIT);
-#endif
+                trace_log(instance->traceopts, SPF_EVENTS_BIT, "LSP Distribution Src : %s, Des Node : %s", 
+                        lsp_generator->node_name, nbr_node->node_name);
 
                 fn_ptr(lsp_generator, nbr_node, dist_info);
                 nbr_node->lsp_distribution_bit = 1;
@@ -162,4 +287,3 @@ generate_lsp(instance_t *instance,
     XFREE(q);
     q = NULL;
 }
-
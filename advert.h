@@ -35,6 +35,8 @@
 #define __ADVERT__
 
 #include "instanceconst.h"
+#include "hash_vector.h"
+#include "EventDispatcher/event_dispatcher.h"
 
 typedef struct instance_ instance_t;
 typedef struct _node_t node_t;
@@ -64,6 +66,11 @@ typedef struct dist_info_hdr_t_{
 
 typedef void (*info_dist_fn_ptr)(node_t *, node_t *, dist_info_hdr_t *);
 
+/*If instance->lsp_pacing_msec is set, LSP advances one hop per pacing
+ * interval and generate_lsp returns before distribution completes,
+ * else LSP is distributed to the entire level before returning.
+ * With the flood simulator enabled, distribution is simulated in
+ * virtual time, see floodsim.h*/
 void
 generate_lsp(instance_t *instance, 
                   node_t *lsp_generator, 
@@ -87,6 +94,34 @@ typedef struct LSPHDR_{
     FLAG overload;
 } lsp_hdr_t;
 
+/*Copy of the advertised info, for LSPs whose flooding outlives
+ * the caller of generate_lsp()*/
+typedef struct lsp_advert_copy_{
+    union{
+        tlv128_ip_reach_t tlv128;
+        lsp_hdr_t lsp_hdr;
+    } u;
+    char prefix[PREFIX_LEN + 1];    /*tlv128.prefix points here*/
+} lsp_advert_copy_t;
+
+/*Copies src into dst, dst->info_data is made to point to advert*/
+void
+copy_dist_info_hdr(dist_info_hdr_t *dst, dist_info_hdr_t *src,
+                   lsp_advert_copy_t *advert);
+
+/*State of one paced LSP flood at one level*/
+typedef struct lsp_flood_{
+
+    instance_t *instance;
+    info_dist_fn_ptr fn_ptr;
+    dist_info_hdr_t dist_info;  /*info_data points to advert*/
+    lsp_advert_copy_t advert;
+    LEVEL level;
+    hash_vector_t visited;      /*Nodes the LSP has reached*/
+    hash_vector_t wave;         /*Nodes to flood the LSP on next pacing timer expiry*/
+    ev_dis_timer_t pacing_timer;
+} lsp_flood_t;
+
 void
 prefix_distribution_routine(node_t *lsp_generator,
                             node_t *lsp_receiver,
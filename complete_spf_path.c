@@ -42,26 +42,22 @@
 #include "sr_tlv_api.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
+/* Predecessor lists and DAG slots are scratch of compute_spf_paths(),
+ * they are allocated from this arena and released in one go once the
+ * DAG has been built*/
+static mm_arena_t spf_path_arena;
+
 extern instance_t *instance;
 extern void init_instance_traversal(instance_t * instance);
 extern boolean tilfa_is_link_pruned(edge_t *edge);
 extern boolean tilfa_is_node_pruned(node_t *node);
-extern void tilfa_clear_post_convergence_spf_path(
-            glthread_t *post_convergence_spf_path_head);
-
-static unsigned int spf_level_version[MAX_LEVEL] = {0, 0, 0};
 
 typedef struct tilfa_info_ tilfa_info_t;
 
-extern glthread_t *
-tilfa_get_post_convergence_spf_path_head(
+extern spf_path_dag_t **
+tilfa_get_post_convergence_spf_path_dag(
         tilfa_info_t *tilfa_info, LEVEL level);
 
-extern
-spf_path_result_t *
-TILFA_GET_SPF_PATH_RESULT(node_t *node, node_t *candidate_node,
-                          LEVEL level);
-
 static int
 pred_info_compare_fn(void *_pred_info_1, void *_pred_info_2){
 
@@ -82,13 +78,12 @@ init_spf_paths_lists(instance_t *instance, LEVEL level){
     nh_type_t nh;
     singly_ll_node_t *list_node = NULL;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
         ITERATE_NH_TYPE_BEGIN(nh){
             assert(IS_GLTHREAD_LIST_EMPTY(&(node->pred_lst[level][nh])));
             init_glthread(&(node->pred_lst[level][nh]));
         } ITERATE_NH_TYPE_END;
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 void
@@ -96,11 +91,10 @@ clear_spf_predecessors(glthread_t *spf_predecessors){
 
     glthread_t *curr = NULL;
 
+    /*pred_info_t memory is reclaimed with the reset of spf_path_arena*/
     ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
 
-        pred_info_t *pred_info = glthread_to_pred_info(curr);
         remove_glthread(curr);
-        XFREE(pred_info);
     } ITERATE_GLTHREAD_END(spf_predecessors, curr);
 }
 
@@ -115,9 +109,22 @@ add_pred_info_to_spf_predecessors(spf_info_t *spf_info,
     glthread_t *curr = NULL;
     pred_info_t *temp = NULL;
 
-    pred_info_t *pred_info = NULL;
+    pred_info_t *pred_info = NULL, key;
+
+    key.node = pred_node;
+    key.oif = oif;
+    memset(key.gw_prefix, 0, PREFIX_LEN);
+    if(gw_prefix)
+        strncpy(key.gw_prefix, gw_prefix, PREFIX_LEN);
+
+    /*Check for duplicates*/
+    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
+        temp = glthread_to_pred_info(curr);
+        if(pred_info_compare_fn((void *)&key, (void *)temp) == 0)
+            return;
+    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
     
-    pred_info = XCALLOC(1, pred_info_t);
+    pred_info = XCALLOC_ARENA(&spf_path_arena, 1, pred_info_t);
 
     pred_info->oif = oif;
     
@@ -128,15 +135,6 @@ add_pred_info_to_spf_predecessors(spf_info_t *spf_info,
 
     init_glthread(&(pred_info->glue));
 
-    /*Check for duplicates*/
-    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
-        temp = glthread_to_pred_info(curr);
-        if(pred_info_compare_fn((void *)pred_info, (void *)temp) == 0){
-            XFREE(pred_info);
-            return;
-        }
-    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
-    
     glthread_add_next(spf_predecessors, &(pred_info->glue));
 }
 
@@ -157,7 +155,6 @@ del_pred_info_from_spf_predecessors(glthread_t *spf_predecessors, node_t *pred_n
         if(pred_info_compare_fn(&pred_info, lst_pred_info))
             continue;
         remove_glthread(&(lst_pred_info->glue));
-        XFREE(lst_pred_info);
         return; 
     } ITERATE_GLTHREAD_END(spf_predecessors, curr);
     assert(0);
@@ -240,7 +237,7 @@ print_spf_paths(glthread_t *path, void *arg){
             prev_gw_prefix = pred_info->gw_prefix;
     } ITERATE_GLTHREAD_END(path, curr);
 
-    printf("(%s)%s", prev_gw_prefix, pred_info->node->node_name);
+    printf("(%s)%s\n", prev_gw_prefix, pred_info->node->node_name);
 }
 
 void
@@ -286,98 +283,74 @@ print_sr_tunnel_paths(glthread_t *path, void *arg){
 }
 
 static void
-construct_spf_path_recursively(node_t *spf_root, 
-                               glthread_t *spf_predecessors, 
-                               LEVEL level, 
-                               nh_type_t nh, 
+construct_spf_path_recursively(spf_path_dag_t *dag,
+                               node_t *spf_root, 
+                               node_t *node,
                                glthread_t *path, 
                                spf_path_processing_fn_ptr fn_ptr, 
-                               void *fn_ptr_arg,
-                               boolean is_post_conv_path){
+                               void *fn_ptr_arg){
 
-    glthread_t *curr = NULL;
-    pred_info_t *pred_info = NULL;
-    spf_path_result_t *res = NULL;
+    spf_path_dag_pred_t *pred = NULL;
+    pred_info_t pred_info;
+    pred_info_wrapper_t pred_info_wrapper;
 
-    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
+    ITERATE_SPF_PATH_DAG_PREDS_BEGIN(dag, node, pred){
 
-        pred_info = glthread_to_pred_info(curr);
-        pred_info_wrapper_t pred_info_wrapper;
-        pred_info_wrapper.pred_info = pred_info;
+        memset(&pred_info, 0, sizeof(pred_info_t));
+        pred_info.node = SPF_PATH_DAG_PRED_NODE(dag, pred);
+        pred_info.oif = pred->oif;
+        strncpy(pred_info.gw_prefix, pred->gw_prefix, PREFIX_LEN);
+        pred_info_wrapper.pred_info = &pred_info;
         init_glthread(&pred_info_wrapper.glue);
         glthread_add_next(path, &pred_info_wrapper.glue);
-        if(!is_post_conv_path){
-            res = GET_SPF_PATH_RESULT(spf_root, pred_info->node, level, nh);
-        }
-        else{
-            res = TILFA_GET_SPF_PATH_RESULT(spf_root, pred_info->node, level); 
-        }
-        assert(res);
 
-        construct_spf_path_recursively(spf_root, &res->pred_db, 
-                level, nh, path, fn_ptr, fn_ptr_arg, is_post_conv_path);
+        construct_spf_path_recursively(dag, spf_root, pred_info.node,
+                path, fn_ptr, fn_ptr_arg);
 
-        if(pred_info->node == spf_root){
+        if(pred_info.node == spf_root){
             fn_ptr(path, fn_ptr_arg);
-            printf("\n");
         }
         remove_glthread(path->right);
-    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
+    } ITERATE_SPF_PATH_DAG_PREDS_END;
 }
 
 void
-trace_spf_path_to_destination_node(node_t *spf_root, 
-                                   node_t *dst_node, 
-                                   LEVEL level, 
-                                   spf_path_processing_fn_ptr fn_ptr,
-                                   void *fn_ptr_arg,
-                                   boolean is_post_conv_path){
+spf_path_dag_enumerate_paths(spf_path_dag_t *dag,
+                             node_t *spf_root, node_t *dst_node,
+                             spf_path_processing_fn_ptr fn_ptr, 
+                             void *fn_ptr_arg){
 
-   nh_type_t nh;
    glthread_t path;
-   spf_path_result_t *res = NULL;
    pred_info_wrapper_t pred_info_wrapper;
    pred_info_t pred_info;
 
-   init_glthread(&path);
+   if(!SPF_PATH_DAG_IS_NODE_REACHED(dag, dst_node))
+       return;
 
-   /*Optimization - If Full spf run hasnt been run since the last
-    * time user triggered the command to display all SR tunnels, 
-    * then there is no need to recompute all tunnel paths again*/
-#if 0
-   if((spf_level_version[level] != 
-           spf_root->spf_info.spf_level_info[level].version) ||
-           !spf_level_version[level]){
+   init_glthread(&path);
 
-       spf_level_version[level] = 
-           spf_root->spf_info.spf_level_info[level].version;
-    
-       if(!is_post_conv_path)
-           compute_spf_paths(spf_root, level, FULL_RUN);
-       else
-           compute_spf_paths(spf_root, level, TILFA_RUN);
-   }
-#endif
    /*Add destination node as pred_info*/
    memset(&pred_info, 0 , sizeof(pred_info_t));
    pred_info.node = dst_node;
    pred_info_wrapper.pred_info = &pred_info;
    init_glthread(&pred_info_wrapper.glue);
    glthread_add_next(&path, &pred_info_wrapper.glue);    
-   nh = IPNH;
-   if(!is_post_conv_path){
-       res = GET_SPF_PATH_RESULT(spf_root, dst_node, level, nh);
-   }
-   else{
-       res = TILFA_GET_SPF_PATH_RESULT(spf_root, dst_node, level);
-   }
-   if(!res){
-       return;
-   }
-   glthread_t *spf_predecessors = &res->pred_db;
-   construct_spf_path_recursively(spf_root, spf_predecessors, 
-                                    level, nh, &path, fn_ptr, fn_ptr_arg,
-                                    is_post_conv_path);
+
+   construct_spf_path_recursively(dag, spf_root, dst_node, 
+                                  &path, fn_ptr, fn_ptr_arg);
+}
+
+void
+trace_spf_path_to_destination_node(node_t *spf_root, 
+                                   node_t *dst_node, 
+                                   LEVEL level, 
+                                   spf_path_processing_fn_ptr fn_ptr,
+                                   void *fn_ptr_arg,
+                                   boolean is_post_conv_path){
+
+   spf_path_dag_enumerate_paths(
+        spf_path_dag_get(spf_root, level, is_post_conv_path),
+        spf_root, dst_node, fn_ptr, fn_ptr_arg);
 }
 
 sr_tunn_trace_info_t
@@ -425,7 +398,7 @@ static void
 run_spf_paths_dijkastra(node_t *spf_root, 
                         LEVEL level, 
                         candidate_tree_t *ctree,
-                        spf_type_t spf_type){
+                        spf_path_dag_slot_t *slots){
 
     node_t *candidate_node = NULL,
     *nbr_node = NULL;
@@ -436,7 +409,7 @@ run_spf_paths_dijkastra(node_t *spf_root,
     pred_info_t *pred_info = NULL,
                 *pred_info_copy = NULL;
 
-    spf_path_result_t *res = NULL;
+    spf_path_dag_slot_t *slot = NULL;
 
     /* There is no need to compute per nexthop for IPV4 links and
      * RSVP LSPs. Just treat RSVP nexthops as IPV4 nexthops 
@@ -444,9 +417,8 @@ run_spf_paths_dijkastra(node_t *spf_root,
      * from IGP links*/
     nh_type_t nh = IPNH;
 
-    sprintf(instance->traceopts->b, "Node : %s : Running %s() with spf_root = %s, at %s", 
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Running %s() with spf_root = %s, at %s", 
             spf_root->node_name, __FUNCTION__, spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, DIJKSTRA_BIT);
 
     while(!SPF_IS_CANDIDATE_TREE_EMPTY(ctree)){
 
@@ -455,55 +427,21 @@ run_spf_paths_dijkastra(node_t *spf_root,
         SPF_REMOVE_CANDIDATE_TREE_TOP(ctree);
         candidate_node->is_node_on_heap = FALSE;
 
-#ifdef __ENABLE_TRACE__    
-        sprintf(instance->traceopts->b, "Node : %s : Candidate node removed : %s(spf_metric = %u)", 
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Candidate node removed : %s(spf_metric = %u)", 
                 spf_root->node_name, candidate_node->node_name, candidate_node->spf_metric[level]);
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
         if(candidate_node->node_type[level] != PSEUDONODE){
-            if(spf_type != TILFA_RUN){
-
-                /*copy spf path list from node to its result*/
-                res = GET_SPF_PATH_RESULT(spf_root, candidate_node, level, nh);
-                assert(!res);
-                res = XCALLOC(1, spf_path_result_t);
-                init_glthread(&res->pred_db);
-                init_glthread(&res->glue);
-                glthread_add_next(&spf_root->spf_path_result[level][nh], &res->glue);
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New Result Recorded for node %s for NH type : %s", 
-                        spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
-                res->node = candidate_node;
-                clear_spf_predecessors(&res->pred_db);
-                if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
-                    glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
-                    init_glthread(&candidate_node->pred_lst[level][nh]);
-                }
-            }
-            else if(spf_type == TILFA_RUN){
-                res = TILFA_GET_SPF_PATH_RESULT(spf_root, candidate_node, level);
-                assert(!res);
-                res = XCALLOC(1, spf_path_result_t);
-                init_glthread(&res->pred_db);
-                init_glthread(&res->glue);
-                glthread_add_next(tilfa_get_post_convergence_spf_path_head(
-                            spf_root->tilfa_info, level), &res->glue);
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New Result Recorded for node %s for NH type : %s", 
-                        spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
-                res->node = candidate_node;
-                clear_spf_predecessors(&res->pred_db);
-                if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
-                    glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
-                    init_glthread(&candidate_node->pred_lst[level][nh]);
-                }
+
+            /*move spf path list from node to its DAG slot*/
+            slot = &slots[candidate_node->node_index];
+            assert(!slot->node);
+            slot->node = candidate_node;
+            init_glthread(&slot->pred_db);
+            trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : New Result Recorded for node %s for NH type : %s", 
+                    spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
+            if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
+                glthread_add_next(&slot->pred_db, candidate_node->pred_lst[level][nh].right);
+                init_glthread(&candidate_node->pred_lst[level][nh]);
             }
-            else
-                assert(0);
         }
 
         /*Iterare over all the nbrs of Candidate node*/
@@ -511,16 +449,12 @@ run_spf_paths_dijkastra(node_t *spf_root,
         ITERATE_NODE_LOGICAL_NBRS_BEGIN(candidate_node, nbr_node, edge, level){
             /* Two way handshake check. Nbr-ship should be two way with nbr, even if nbr is PN. Do
              * not consider the node for SPF computation if we find 2-way nbrship is broken. */
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Exploring : Candidate Node = %s, Nbr = %s, oif = %s",
+            trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Exploring : Candidate Node = %s, Nbr = %s, oif = %s",
                     spf_root->node_name, candidate_node->node_name, nbr_node->node_name, edge->from.intf_name);
-            trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
             if(!is_two_way_nbrship(candidate_node, nbr_node, level) || 
                     edge->status == 0){
-                sprintf(instance->traceopts->b, "Node : %s : Two way nbr ship failed for Candidate Node = %s, Nbr = %s",
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Two way nbr ship failed for Candidate Node = %s, Nbr = %s",
                         spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
-                trace(instance->traceopts, DIJKSTRA_BIT);
                 continue;
             }
 
@@ -533,20 +467,14 @@ run_spf_paths_dijkastra(node_t *spf_root,
                         ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) < 
                     (unsigned long long)nbr_node->spf_metric[level]){
 
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : Candidate Node : %s, Nbr Node %s, pred DB cleared", 
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Candidate Node : %s, Nbr Node %s, pred DB cleared", 
                         spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                 clear_spf_predecessors(&nbr_node->pred_lst[level][nh]);
                 assert(IS_GLTHREAD_LIST_EMPTY(&nbr_node->pred_lst[level][nh]));
 
                 if(candidate_node->node_type[level] != PSEUDONODE){
-#ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Node = %s , predecossor Added = %s",
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node = %s , predecossor Added = %s",
                             spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                     add_pred_info_to_spf_predecessors(&spf_root->spf_info, &nbr_node->pred_lst[level][nh], 
                             candidate_node, &edge->from, 
                             nbr_node->node_type[level] != PSEUDONODE ? \
@@ -554,21 +482,15 @@ run_spf_paths_dijkastra(node_t *spf_root,
                 }
                 else{
                     /*copy (do not move) all predecessors of PN into nbr node*/
-#ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
                             spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                     ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
 
                         pred_info = glthread_to_pred_info(curr);  
-                        pred_info_copy = XCALLOC(1, pred_info_t);
+                        pred_info_copy = XCALLOC_ARENA(&spf_path_arena, 1, pred_info_t);
                         memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
-#ifdef __ENABLE_TRACE__                                
-                        sprintf(instance->traceopts->b, "Node : %s : Predecessor copied = %s", 
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Predecessor copied = %s", 
                                 spf_root->node_name, pred_info->node->node_name);
-                        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                         init_glthread(&pred_info_copy->glue);
                         strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
                         glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
@@ -577,19 +499,13 @@ run_spf_paths_dijkastra(node_t *spf_root,
 
                 nbr_node->spf_metric[level] =  IS_OVERLOADED(candidate_node, level) ? 
                     INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]; 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node = %s metric improved to = %u",
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node = %s metric improved to = %u",
                         spf_root->node_name,  nbr_node->node_name, nbr_node->spf_metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
 
                 if(nbr_node->is_node_on_heap == FALSE){
                     SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node %s Added to Candidate tree", 
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node %s Added to Candidate tree", 
                             spf_root->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                     nbr_node->is_node_on_heap = TRUE;
                 }
                 else{
@@ -603,11 +519,8 @@ run_spf_paths_dijkastra(node_t *spf_root,
                     (unsigned long long)nbr_node->spf_metric[level]){
 
                 if(candidate_node->node_type[level] != PSEUDONODE){
-#ifdef __ENABLE_TRACE__                        
-                    sprintf(instance->traceopts->b, "Node : %s : Node = %s , predecossor Added = %s",
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node = %s , predecossor Added = %s",
                             spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                     add_pred_info_to_spf_predecessors(&spf_root->spf_info, &nbr_node->pred_lst[level][nh], 
                             candidate_node, &edge->from, 
                             nbr_node->node_type[level] != PSEUDONODE ? \
@@ -615,22 +528,16 @@ run_spf_paths_dijkastra(node_t *spf_root,
                 }
                 else{
                     /*copy (do not move) all predecessors of PN into nbr node*/
-#ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
                             spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
 
                     ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
 
                         pred_info = glthread_to_pred_info(curr);  
-                        pred_info_copy = XCALLOC(1, pred_info_t);
+                        pred_info_copy = XCALLOC_ARENA(&spf_path_arena, 1, pred_info_t);
                         memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
-#ifdef __ENABLE_TRACE__                                
-                        sprintf(instance->traceopts->b, "Node : %s : Predecessor copied = %s", 
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Predecessor copied = %s", 
                                 spf_root->node_name, pred_info->node->node_name);
-                        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                         init_glthread(&pred_info_copy->glue);
                         strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
                         glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
@@ -639,11 +546,8 @@ run_spf_paths_dijkastra(node_t *spf_root,
 
                 if(nbr_node->is_node_on_heap == FALSE){
                     SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node %s Added to Candidate tree", 
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node %s Added to Candidate tree", 
                             spf_root->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
                     nbr_node->is_node_on_heap = TRUE;
                 }
             }
@@ -652,55 +556,115 @@ run_spf_paths_dijkastra(node_t *spf_root,
 
         /*Delete the PN's predecessor list*/
         if(candidate_node->node_type[level] == PSEUDONODE){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : PN = %s, Clean up pred db",
-                    spf_root->node_name, candidate_node->node_name);
-            trace(instance->traceopts, DIJKSTRA_BIT); 
-#endif
+            trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : PN = %s, Clean up pred db",
+                    spf_root->node_name, candidate_node->node_name); 
             ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
 
                 pred_info = glthread_to_pred_info(curr);
                 remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
             } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
         }
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Node = %s has been processed",
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Node = %s has been processed",
                 spf_root->node_name, candidate_node->node_name);
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
     } /* while loop ends*/
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Running %s() with spf_root = %s, at %s Finished", 
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s : Running %s() with spf_root = %s, at %s Finished", 
             spf_root->node_name, __FUNCTION__, spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
 }
 
-void
-spf_clear_spf_path_result(node_t *spf_root, LEVEL level){
+static spf_path_dag_t *
+spf_path_dag_build(spf_path_dag_slot_t *slots, uint32_t n_nodes,
+                   unsigned int version){
 
-    nh_type_t nh;
-    glthread_t *curr = NULL, *curr1= NULL;
-    spf_path_result_t *spf_path_result = NULL;
+    uint32_t i = 0, n_preds = 0, arena_size = 0;
+    char *arena = NULL;
+    glthread_t *curr = NULL;
     pred_info_t *pred_info = NULL;
+    spf_path_dag_t *dag = NULL;
+    spf_path_dag_pred_t *pred = NULL;
+
+    for(i = 0; i < n_nodes; i++){
+        if(!slots[i].node) continue;
+        ITERATE_GLTHREAD_BEGIN(&slots[i].pred_db, curr){
+            n_preds++;
+        } ITERATE_GLTHREAD_END(&slots[i].pred_db, curr);
+    }
 
-    ITERATE_NH_TYPE_BEGIN(nh){
+    /*One arena : header, preds, nodes, pred_offset*/
+    arena_size = sizeof(spf_path_dag_t) + 
+                 (n_preds * sizeof(spf_path_dag_pred_t)) +
+                 (n_nodes * sizeof(node_t *)) +
+                 ((n_nodes + 1) * sizeof(uint32_t));
 
-        ITERATE_GLTHREAD_BEGIN(&spf_root->spf_path_result[level][nh], curr){
+    arena = XCALLOC((arena_size + sizeof(spf_path_dag_pred_t) - 1)/
+                     sizeof(spf_path_dag_pred_t), spf_path_dag_pred_t);
 
-            spf_path_result = glthread_to_spf_path_result(curr);        
-            ITERATE_GLTHREAD_BEGIN(&spf_path_result->pred_db, curr1){
+    dag = (spf_path_dag_t *)arena;
+    dag->n_nodes = n_nodes;
+    dag->n_preds = n_preds;
+    dag->version = version;
+    dag->preds = (spf_path_dag_pred_t *)(arena + sizeof(spf_path_dag_t));
+    dag->nodes = (node_t **)(dag->preds + n_preds);
+    dag->pred_offset = (uint32_t *)(dag->nodes + n_nodes);
 
-                pred_info = glthread_to_pred_info(curr1);
-                remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
-            } ITERATE_GLTHREAD_END(&spf_path_result->pred_db, curr1);
-            remove_glthread(&spf_path_result->glue);
-            XFREE(spf_path_result);
-        } ITERATE_GLTHREAD_END(&spf_root->spf_path_result[level][nh], curr);
-        init_glthread(&spf_root->spf_path_result[level][nh]);
-    }ITERATE_NH_TYPE_END;
+    pred = dag->preds;
+
+    for(i = 0; i < n_nodes; i++){
+
+        dag->pred_offset[i] = pred - dag->preds;
+        if(!slots[i].node) continue;
+
+        dag->nodes[i] = slots[i].node;
+
+        ITERATE_GLTHREAD_BEGIN(&slots[i].pred_db, curr){
+
+            pred_info = glthread_to_pred_info(curr);
+            pred->node_index = pred_info->node->node_index;
+            pred->oif = pred_info->oif;
+            strncpy(pred->gw_prefix, pred_info->gw_prefix, PREFIX_LEN);
+            pred++;
+        } ITERATE_GLTHREAD_END(&slots[i].pred_db, curr);
+    }
+    dag->pred_offset[n_nodes] = pred - dag->preds;
+    return dag;
+}
+
+void
+spf_path_dag_free(spf_path_dag_t **dag){
+
+    if(!*dag) return;
+    XFREE(*dag);
+    *dag = NULL;
+}
+
+/* Return the DAG of spf_root. Complete paths of normal SPF run are 
+ * computed on demand, and recomputed only if full spf run has been
+ * run since the last time the DAG was computed*/
+spf_path_dag_t *
+spf_path_dag_get(node_t *spf_root, LEVEL level, boolean is_post_conv_path){
+
+    unsigned int version;
+
+    if(is_post_conv_path){
+        if(!spf_root->tilfa_info) return NULL;
+        return *tilfa_get_post_convergence_spf_path_dag(
+                spf_root->tilfa_info, level);
+    }
+
+    version = spf_root->spf_info.spf_level_info[level].version;
+
+    if(!version) return NULL;
+
+    if(!spf_root->spf_path_dag[level] ||
+        spf_root->spf_path_dag[level]->version != version){
+        compute_spf_paths(spf_root, level, FULL_RUN);
+    }
+    return spf_root->spf_path_dag[level];
+}
+
+void
+spf_clear_spf_path_result(node_t *spf_root, LEVEL level){
+
+    spf_path_dag_free(&spf_root->spf_path_dag[level]);
 }
 
 void
@@ -708,16 +672,19 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
 
     node_t *curr_node = NULL, *nbr_node = NULL;
     edge_t *edge = NULL;
+    spf_path_dag_t **dag = NULL;
+    spf_path_dag_slot_t *slots = NULL;
 
-    /* TILFA rsults has been cleared from the caller
-     * tilfa_run_post_convergence_spf()*/
+    /* DAG of the previous run of the same type is
+     * released in one go*/
     if(spf_type != TILFA_RUN){
-        spf_clear_spf_path_result(spf_root, level);
+        dag = &spf_root->spf_path_dag[level];
     }
     else{
-        tilfa_clear_post_convergence_spf_path(
-            tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level));
+        dag = tilfa_get_post_convergence_spf_path_dag(
+                spf_root->tilfa_info, level);
     }
+    spf_path_dag_free(dag);
     
     SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
     SPF_INSERT_NODE_INTO_CANDIDATE_TREE(&instance->ctree, spf_root, level);
@@ -749,7 +716,11 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
 
         } ITERATE_NODE_LOGICAL_NBRS_END;
     }
-    run_spf_paths_dijkastra(spf_root, level, &instance->ctree, spf_type);
+    slots = XCALLOC_ARENA(&spf_path_arena, instance->n_nodes, spf_path_dag_slot_t);
+    run_spf_paths_dijkastra(spf_root, level, &instance->ctree, slots);
+    *dag = spf_path_dag_build(slots, instance->n_nodes, 
+                spf_root->spf_info.spf_level_info[level].version);
+    mm_arena_reset(&spf_path_arena);
     assert(is_queue_empty(q));
     XFREE(q);
     q = NULL;
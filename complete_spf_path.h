@@ -33,6 +33,7 @@
 #ifndef __COMPLETE_SPF_PATH__
 #define __COMPLETE_SPF_PATH__
 
+#include <stdint.h>
 #include "instance.h"
 
 /*Initialize the spf path list in all nodes of graph
@@ -48,14 +49,63 @@ typedef struct pred_info_t_{
 
 GLTHREAD_TO_STRUCT(glthread_to_pred_info, pred_info_t, glue);
 
-typedef struct spf_path_result_t_{
+/* Shortest path DAG of one complete path spf run, in CSR form.
+ * Predecessors of the node with node_index i are
+ * preds[pred_offset[i] .. pred_offset[i + 1]). Header and all arrays
+ * are carved out of a single arena allocation, the DAG is freed in O(1)*/
 
-    node_t *node;   /*key*/
+typedef struct spf_path_dag_pred_t_{
+
+    uint32_t node_index;            /*predecessor node*/
+    char gw_prefix[PREFIX_LEN + 1];
+    edge_end_t *oif;                /*oif of predecessor node*/
+} spf_path_dag_pred_t;
+
+typedef struct spf_path_dag_t_{
+
+    uint32_t n_nodes;               /*node_index space of the run*/
+    uint32_t n_preds;
+    unsigned int version;           /*spf version the DAG is computed for*/
+    node_t **nodes;                 /*node_index -> node, NULL if not reached*/
+    uint32_t *pred_offset;          /*n_nodes + 1 entries*/
+    spf_path_dag_pred_t *preds;
+} spf_path_dag_t;
+
+/* Per run scratch slot, indexed by node_index. Holds the predecessors
+ * of the node at the time it is taken off the candidate tree, until
+ * the DAG is built*/
+typedef struct spf_path_dag_slot_t_{
+
+    node_t *node;
     glthread_t pred_db;
-    glthread_t glue;
-} spf_path_result_t;
+} spf_path_dag_slot_t;
+
+#define SPF_PATH_DAG_IS_NODE_REACHED(_dag, _node)                   \
+    ((_dag) && (_node)->node_index < (_dag)->n_nodes &&             \
+     (_dag)->nodes[(_node)->node_index] == (_node))
+
+#define SPF_PATH_DAG_PRED_NODE(_dag, _pred)                         \
+    ((_dag)->nodes[(_pred)->node_index])
 
-GLTHREAD_TO_STRUCT(glthread_to_spf_path_result, spf_path_result_t, glue);
+#define SPF_PATH_DAG_N_PREDS(_dag, _node)                           \
+    ((_dag)->pred_offset[(_node)->node_index + 1] -                 \
+     (_dag)->pred_offset[(_node)->node_index])
+
+/*Iterate over predecessors of a node reached in the DAG*/
+#define ITERATE_SPF_PATH_DAG_PREDS_BEGIN(_dag, _node, _pred)        \
+    {uint32_t _pred_it;                                             \
+     for(_pred_it = (_dag)->pred_offset[(_node)->node_index];       \
+         _pred_it < (_dag)->pred_offset[(_node)->node_index + 1];   \
+         _pred_it++){                                               \
+         _pred = &(_dag)->preds[_pred_it];
+
+#define ITERATE_SPF_PATH_DAG_PREDS_END  }}
+
+void
+spf_path_dag_free(spf_path_dag_t **dag);
+
+spf_path_dag_t *
+spf_path_dag_get(node_t *spf_root, LEVEL level, boolean is_post_conv_path);
 
 /*API to construct the SPF path from spf_root to dst_node*/
 
@@ -139,19 +189,12 @@ trace_spf_path_to_destination_node(node_t *spf_root, node_t *dst_node, LEVEL lev
 sr_tunn_trace_info_t
 show_sr_tunnels(node_t *spf_root, char *prefix);
 
-static inline spf_path_result_t *
-GET_SPF_PATH_RESULT(node_t *node, node_t *node2, LEVEL level, nh_type_t nh){
-
-    glthread_t *curr = NULL;
-    ITERATE_GLTHREAD_BEGIN(&node->spf_path_result[level][nh], curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-        if(spf_path_result->node == node2){
-            return spf_path_result; 
-        }
-    } ITERATE_GLTHREAD_END(&node->spf_path_result[level][nh], curr);
-    return NULL;
-}
+/*Enumerate all shortest paths from spf_root to dst_node in the DAG*/
+void
+spf_path_dag_enumerate_paths(spf_path_dag_t *dag,
+                             node_t *spf_root, node_t *dst_node,
+                             spf_path_processing_fn_ptr fn_ptr, 
+                             void *fn_ptr_arg);
 
 void
 compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type);
@@ -39,6 +39,7 @@
 #include "spfutil.h"
 #include "stack.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "metrics.h"
 
 extern instance_t *instance;
 void
@@ -200,7 +201,8 @@ free_rt_un_entry(rt_un_entry_t *rt_un_entry){
         free_un_nexthop(nxt_hop);    
     } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
     
-    if(IS_GLTHREAD_LIST_EMPTY((&rt_un_entry->glthread))){
+    /*Entry stays as long as other protocols' nexthops use it*/
+    if(IS_GLTHREAD_LIST_EMPTY((&rt_un_entry->nh_list_head))){
         remove_glthread(&rt_un_entry->glthread);
         XFREE(rt_un_entry);
         return 0;
@@ -226,6 +228,54 @@ lookup_clone_next_hop(rt_un_table_t *rib,
 }
 
 
+static metric_t *rib_nh_installs_metric[RIB_COUNT];
+static metric_t *rib_route_deletes_metric[RIB_COUNT];
+static metric_t *rib_flushed_entries_metric[RIB_COUNT];
+static metric_t *rib_entries_metric[RIB_COUNT];
+
+static void
+data_plane_metrics_collect(){
+
+    node_t *node = NULL;
+    rib_type_t rib_type;
+    uint64_t n_entries[RIB_COUNT];
+
+    if(!instance) return;
+
+    memset(n_entries, 0, sizeof(n_entries));
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+        for(rib_type = 0; rib_type < RIB_COUNT; rib_type++){
+            if(node->spf_info.rib[rib_type])
+                n_entries[rib_type] += node->spf_info.rib[rib_type]->count;
+        }
+    } ITERATE_HASH_VECTOR_END;
+
+    for(rib_type = 0; rib_type < RIB_COUNT; rib_type++){
+        metric_set(rib_entries_metric[rib_type], n_entries[rib_type]);
+    }
+}
+
+void
+data_plane_metrics_init(){
+
+    rib_type_t rib_type;
+    char *rib_names[RIB_COUNT] = {"inet.0", "inet.3", "mpls.0"};
+    char labels[METRIC_LABELS_LEN];
+
+    for(rib_type = 0; rib_type < RIB_COUNT; rib_type++){
+        snprintf(labels, sizeof(labels), "rib=\"%s\"", rib_names[rib_type]);
+        rib_nh_installs_metric[rib_type] = metrics_register(METRIC_COUNTER,
+            "rib_nexthop_installs_total", "Nexthops installed in the RIB", labels);
+        rib_route_deletes_metric[rib_type] = metrics_register(METRIC_COUNTER,
+            "rib_route_deletes_total", "Routes deleted from the RIB", labels);
+        rib_flushed_entries_metric[rib_type] = metrics_register(METRIC_COUNTER,
+            "rib_flushed_entries_total", "Routes removed by flushes of a level from the RIB", labels);
+        rib_entries_metric[rib_type] = metrics_register(METRIC_GAUGE,
+            "rib_entries", "Routes in the RIB, summed over all nodes", labels);
+    }
+    metrics_register_collector(data_plane_metrics_collect);
+}
+
 /*Rib functions*/
 boolean
 inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level, 
@@ -234,11 +284,8 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
      
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
     
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
     internal_un_nh_t *existing_nh = NULL;
@@ -268,11 +315,8 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     }
 
     if(!nexthop){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
+        trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : local route %s/%d added to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
         return TRUE;
     }
     
@@ -282,12 +326,9 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
     
     if(existing_nh){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+        trace_log(instance->traceopts, ROUTING_TABLE_BIT, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
             rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
             RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
         return FALSE;
     }
 
@@ -297,17 +338,15 @@ inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     else
         glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
     
+    metric_counter_inc(rib_nh_installs_metric[rib->rib_type]);
     return TRUE;
 }
 
 static boolean
 inet_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
@@ -344,12 +383,9 @@ inet_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
@@ -373,17 +409,15 @@ inet_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            if(free_rt_un_entry(temp) == 0)
+                rib->count--;
+            metric_counter_inc(rib_route_deletes_metric[rib->rib_type]);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -398,11 +432,8 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
      
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
     internal_un_nh_t *existing_nh = NULL;
@@ -432,11 +463,8 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     }
 
     if(!nexthop){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
+        trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : local route %s/%d added to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
         return TRUE;
     }
 
@@ -445,12 +473,9 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
 
     if(existing_nh){
-#ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+        trace_log(instance->traceopts, ROUTING_TABLE_BIT, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
             rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
             RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
         return FALSE;
     }
 
@@ -460,17 +485,15 @@ inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     else
         glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
     
+    metric_counter_inc(rib_nh_installs_metric[rib->rib_type]);
     return TRUE;
 }
 
 static boolean
 inet_3_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
@@ -507,12 +530,9 @@ inet_3_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
@@ -536,17 +556,15 @@ inet_3_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            if(free_rt_un_entry(temp) == 0)
+                rib->count--;
+            metric_counter_inc(rib_route_deletes_metric[rib->rib_type]);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -557,12 +575,9 @@ inet_3_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
 static boolean
 mpls_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d(%u) to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d(%u) to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
             RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
@@ -578,11 +593,8 @@ mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
     glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
     /*Refresh time before adding an enntry*/
     time(&nexthop->last_refresh_time);
 
@@ -615,12 +627,9 @@ mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
 
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
     if(existing_nh){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+        trace_log(instance->traceopts, ROUTING_TABLE_BIT, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
             rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
             RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
         return FALSE;
     }
 
@@ -630,6 +639,7 @@ mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL l
         glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
     else
         glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
+    metric_counter_inc(rib_nh_installs_metric[rib->rib_type]);
     return TRUE;
 }
 
@@ -662,12 +672,9 @@ mpls_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d(%u) to Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d(%u) to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
     rib->rt_un_route_install(rib, rt_un_entry);
@@ -692,18 +699,16 @@ mpls_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
         return FALSE;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
+    trace_log(instance->traceopts, ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_LABEL_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            if(free_rt_un_entry(temp) == 0)
+                rib->count--;
+            metric_counter_inc(rib_route_deletes_metric[rib->rib_type]);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -858,6 +863,7 @@ init_rib(rib_type_t rib_type){
 
     rt_un_table_t * rib = XCALLOC(1, rt_un_table_t);
     rib->count = 0;
+    rib->rib_type = rib_type;
     init_glthread(&rib->head);
 
     switch (rib_type){
@@ -912,6 +918,7 @@ flush_rib(rt_un_table_t *rib, LEVEL level){
         if(rc == 0) count++;
     } ITERATE_GLTHREAD_END(&rib->head, curr);
     rib->count -= count;
+    metric_counter_add(rib_flushed_entries_metric[rib->rib_type], count);
 }
 
 void
@@ -1579,7 +1586,7 @@ ping(char *node_name, char *dst_prefix){
     mpls_label_stack_t *mpls_label_stack = NULL;
     trace_route_pref_order_t pref_order = FIRST_PREF_ORDER;
 
-    node_t *node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name); 
+    node_t *node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name); 
     node_t *next_node = node;
 
     printf("Source Node : %s, Prefix traced : %s\n", node_name, dst_prefix);
@@ -264,6 +264,7 @@ typedef struct rt_un_table_{
     unsigned int count;
     glthread_t head; /*List of nexthops - primary and backups both*/
     char *rib_name;
+    rib_type_t rib_type;
     /*CRUD*/
     boolean (*rt_un_route_install_nexthop)(struct rt_un_table_ *, rt_key_t *, LEVEL , internal_un_nh_t *);
     boolean (*rt_un_route_install)(struct rt_un_table_ *, rt_un_entry_t *);
@@ -283,8 +284,8 @@ internal_un_nh_t *
 lookup_clone_next_hop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry, internal_un_nh_t *nexthop);
 
 #define UN_RTENTRY_PFX_MATCH(rt_un_entry_t_ptr, rt_key_ptr) \
-    (strncmp(RT_ENTRY_PFX(rt_key_ptr), RT_ENTRY_PFX(&rt_un_entry->rt_key), PREFIX_LEN) == 0 &&    \
-            RT_ENTRY_MASK(rt_key) == RT_ENTRY_MASK(&rt_un_entry->rt_key))
+    (strncmp(RT_ENTRY_PFX(rt_key_ptr), RT_ENTRY_PFX(&(rt_un_entry_t_ptr)->rt_key), PREFIX_LEN) == 0 &&    \
+            RT_ENTRY_MASK(rt_key_ptr) == RT_ENTRY_MASK(&(rt_un_entry_t_ptr)->rt_key))
 
 #define UN_RTENTRY_LABEL_MATCH(rt_un_entry_t_ptr, rt_key_ptr) \
     (RT_ENTRY_LABEL(&rt_un_entry_t_ptr->rt_key) == RT_ENTRY_LABEL(rt_key_ptr))
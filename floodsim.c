@@ -0,0 +1,687 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  floodsim.c
+ *
+ *    Description:  Discrete event LSP flooding simulator with virtual time
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 19:40:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "instance.h"
+#include "floodsim.h"
+#include "spfsched.h"
+#include "spftrace.h"
+#include "spfutil.h"
+#include "spfclihandler.h"
+
+/*Running simulation, or the last one run, kept for show*/
+static flood_sim_t *flood_sim = NULL;
+
+static flood_sim_spf_delay_model_t spf_delay_models[FLOOD_SIM_MAX_SPF_DELAY_MODELS];
+static unsigned int n_spf_delay_models = 0;
+
+static uint64_t
+flood_sim_wall_usec(){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+/*SPF delay models*/
+
+static uint64_t
+spf_delay_constant(instance_t *instance, node_t *spf_root,
+                   LEVEL level, uint64_t measured_usec){
+
+    return instance->flood_sim_config.spf_base_usec;
+}
+
+static uint64_t
+spf_delay_linear(instance_t *instance, node_t *spf_root,
+                 LEVEL level, uint64_t measured_usec){
+
+    return instance->flood_sim_config.spf_base_usec +
+        ((uint64_t)instance->flood_sim_config.spf_per_node_usec * instance->n_nodes);
+}
+
+/*Dijkstra with a binary heap*/
+static uint64_t
+spf_delay_nlogn(instance_t *instance, node_t *spf_root,
+                LEVEL level, uint64_t measured_usec){
+
+    unsigned int log2n = 1,
+                 n = instance->n_nodes;
+
+    while(n >>= 1)
+        log2n++;
+
+    return instance->flood_sim_config.spf_base_usec +
+        ((uint64_t)instance->flood_sim_config.spf_per_node_usec * instance->n_nodes * log2n);
+}
+
+static uint64_t
+spf_delay_measured(instance_t *instance, node_t *spf_root,
+                   LEVEL level, uint64_t measured_usec){
+
+    return measured_usec;
+}
+
+int
+flood_sim_register_spf_delay_model(const char *name, flood_sim_spf_delay_fn delay_fn){
+
+    if(n_spf_delay_models == FLOOD_SIM_MAX_SPF_DELAY_MODELS ||
+        flood_sim_get_spf_delay_model(name) >= 0)
+        return -1;
+
+    spf_delay_models[n_spf_delay_models].name = name;
+    spf_delay_models[n_spf_delay_models].delay_fn = delay_fn;
+    return (int)n_spf_delay_models++;
+}
+
+int
+flood_sim_get_spf_delay_model(const char *name){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < n_spf_delay_models; i++){
+        if(strcmp(spf_delay_models[i].name, name) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+void
+init_flood_sim_config(flood_sim_config_t *config){
+
+    if(!n_spf_delay_models){
+        flood_sim_register_spf_delay_model("constant", spf_delay_constant);
+        flood_sim_register_spf_delay_model("linear", spf_delay_linear);
+        flood_sim_register_spf_delay_model("nlogn", spf_delay_nlogn);
+        flood_sim_register_spf_delay_model("measured", spf_delay_measured);
+    }
+
+    memset(config, 0, sizeof(flood_sim_config_t));
+    config->lsp_size = FLOOD_SIM_DEFAULT_LSP_SIZE;
+    config->lsp_proc_usec = FLOOD_SIM_DEFAULT_LSP_PROC_USEC;
+    config->spf_delay_model = (unsigned int)flood_sim_get_spf_delay_model("nlogn");
+    config->spf_base_usec = FLOOD_SIM_DEFAULT_SPF_BASE_USEC;
+    config->spf_per_node_usec = FLOOD_SIM_DEFAULT_SPF_PER_NODE_USEC;
+    config->fib_per_route_usec = FLOOD_SIM_DEFAULT_FIB_PER_ROUTE_USEC;
+}
+
+bool_t
+flood_sim_is_running(){
+
+    return flood_sim && flood_sim->running;
+}
+
+uint64_t
+flood_sim_now_usec(){
+
+    return flood_sim ? flood_sim->now_usec : 0;
+}
+
+/*Event queue*/
+
+static bool_t
+flood_sim_heap_entry_before(flood_sim_heap_entry_t *a, flood_sim_heap_entry_t *b){
+
+    if(a->time_usec != b->time_usec)
+        return a->time_usec < b->time_usec;
+    return a->seq < b->seq;
+}
+
+static void
+flood_sim_post(flood_sim_t *sim, uint64_t time_usec, flood_sim_event_t *event){
+
+    unsigned int i, parent;
+    flood_sim_heap_entry_t entry, *heap = NULL;
+
+    assert(time_usec >= sim->now_usec);
+
+    if(sim->heap_size == sim->heap_capacity){
+        sim->heap_capacity = sim->heap_capacity ? sim->heap_capacity * 2 : 64;
+        heap = XCALLOC(sim->heap_capacity, flood_sim_heap_entry_t);
+        if(sim->heap){
+            memcpy(heap, sim->heap, sim->heap_size * sizeof(flood_sim_heap_entry_t));
+            XFREE(sim->heap);
+        }
+        sim->heap = heap;
+    }
+
+    entry.time_usec = time_usec;
+    entry.seq = sim->next_seq++;
+    entry.event = event;
+
+    i = sim->heap_size++;
+    while(i){
+        parent = (i - 1) / 2;
+        if(!flood_sim_heap_entry_before(&entry, &sim->heap[parent]))
+            break;
+        sim->heap[i] = sim->heap[parent];
+        i = parent;
+    }
+    sim->heap[i] = entry;
+}
+
+static flood_sim_heap_entry_t
+flood_sim_pop(flood_sim_t *sim){
+
+    unsigned int i = 0, child;
+    flood_sim_heap_entry_t top = sim->heap[0],
+                           last = sim->heap[--sim->heap_size];
+
+    while((child = (2 * i) + 1) < sim->heap_size){
+        if(child + 1 < sim->heap_size &&
+            flood_sim_heap_entry_before(&sim->heap[child + 1], &sim->heap[child]))
+            child++;
+        if(!flood_sim_heap_entry_before(&sim->heap[child], &last))
+            break;
+        sim->heap[i] = sim->heap[child];
+        i = child;
+    }
+    sim->heap[i] = last;
+    return top;
+}
+
+static flood_sim_event_t *
+flood_sim_new_event(flood_sim_ev_type_t ev_type, node_t *node){
+
+    flood_sim_event_t *event = XCALLOC(1, flood_sim_event_t);
+    event->ev_type = ev_type;
+    event->node = node;
+    init_glthread(&event->rx_q_glue);
+    return event;
+}
+
+static flood_sim_node_t *
+flood_sim_get_node(flood_sim_t *sim, node_t *node){
+
+    assert(node->node_index < sim->n_nodes);
+    return &sim->nodes[node->node_index];
+}
+
+static int
+flood_sim_link_comparison_fn(void *link, void *edge){
+
+    return ((flood_sim_link_t *)link)->edge == edge;
+}
+
+static uint32_t
+flood_sim_link_hash_fn(void *link){
+
+    return hash_vector_ptr_hash(((flood_sim_link_t *)link)->edge);
+}
+
+static flood_sim_link_t *
+flood_sim_get_link(flood_sim_t *sim, edge_t *edge){
+
+    flood_sim_link_t *link = hash_vector_search_by_key(&sim->links, edge);
+
+    if(link)
+        return link;
+
+    link = XCALLOC(1, flood_sim_link_t);
+    link->edge = edge;
+    hash_vector_add(&sim->links, link);
+    return link;
+}
+
+static int
+flood_sim_lsp_node_comparison_fn(void *node, void *key){
+
+    return node == key;
+}
+
+void
+flood_sim_schedule_spf(spf_sched_t *spf_sched, unsigned int wait_msec){
+
+    flood_sim_event_t *event = flood_sim_new_event(FLOOD_SIM_EV_SPF_RUN, spf_sched->node);
+
+    assert(flood_sim_is_running());
+    event->spf_sched = spf_sched;
+    flood_sim_post(flood_sim, flood_sim->now_usec + ((uint64_t)wait_msec * 1000), event);
+}
+
+/*Serialize the LSP on edge1, edge2 is the PN to nbr edge on LANs*/
+static void
+flood_sim_lsp_transmit(flood_sim_t *sim, node_t *node, node_t *nbr_node,
+                       edge_t *edge1, edge_t *edge2, flood_sim_lsp_t *lsp){
+
+    flood_sim_event_t *event = NULL;
+    flood_sim_link_t *link = flood_sim_get_link(sim, edge1);
+    float bandwidth = edge1->bandwidth > 0 ? edge1->bandwidth : DEFAULT_LINK_BW;
+    /*bandwidth is in Gbps, i.e. 1000 bits per usec*/
+    uint64_t tx_usec = (uint64_t)((sim->instance->flood_sim_config.lsp_size * 8) /
+                        (bandwidth * 1000)) + 1;
+    uint64_t prop_usec = edge1->prop_delay_usec;
+
+    if(edge2 != edge1)
+        prop_usec += edge2->prop_delay_usec;
+
+    if(link->tx_busy_until_usec < sim->now_usec)
+        link->tx_busy_until_usec = sim->now_usec;
+    link->tx_busy_until_usec += tx_usec;
+
+    event = flood_sim_new_event(FLOOD_SIM_EV_LSP_ARRIVE, nbr_node);
+    event->from_node = node;
+    event->lsp = lsp;
+    flood_sim_post(sim, link->tx_busy_until_usec + prop_usec, event);
+}
+
+static void
+flood_sim_lsp_receive(flood_sim_t *sim, node_t *node,
+                      node_t *from_node, flood_sim_lsp_t *lsp){
+
+    node_t *nbr_node = NULL,
+           *pn_node = NULL;
+
+    edge_t *edge1 = NULL,
+           *edge2 = NULL;
+
+    flood_sim_node_t *sim_node = flood_sim_get_node(sim, node);
+
+    sim_node->n_lsp_rx++;
+
+    if(hash_vector_is_present(&lsp->received, node)){
+        sim_node->n_lsp_dup++;
+        return;
+    }
+    hash_vector_add(&lsp->received, node);
+
+    if(sim_node->n_lsp_rx - sim_node->n_lsp_dup == 1)
+        sim_node->first_lsp_rx_usec = sim->now_usec;
+    sim_node->last_lsp_rx_usec = sim->now_usec;
+
+    trace_log(sim->instance->traceopts, SPF_EVENTS_BIT, "Simulated LSP Distribution Src : %s, Des Node : %s, at %llu usec",
+            lsp->dist_info.lsp_generator->node_name, node->node_name, (unsigned long long)sim->now_usec);
+
+    lsp->fn_ptr(lsp->dist_info.lsp_generator, node, &lsp->dist_info);
+
+    /*Flood on all adjacencies but the one LSP came from*/
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(node, nbr_node, pn_node, edge1,
+            edge2, lsp->level){
+
+        if(nbr_node == from_node){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(node, nbr_node, pn_node, lsp->level);
+        }
+        flood_sim_lsp_transmit(sim, node, nbr_node, edge1, edge2, lsp);
+    }
+    ITERATE_NODE_PHYSICAL_NBRS_END(node, nbr_node, pn_node, lsp->level);
+}
+
+static void
+flood_sim_process_event(flood_sim_t *sim, flood_sim_event_t *event){
+
+    glthread_t *curr = NULL;
+    flood_sim_event_t *rx_event = NULL;
+    flood_sim_node_t *sim_node = flood_sim_get_node(sim, event->node);
+    flood_sim_config_t *config = &sim->instance->flood_sim_config;
+    uint64_t wall_usec = 0;
+    unsigned int n_routes = 0;
+
+    switch(event->ev_type){
+        case FLOOD_SIM_EV_LSP_ARRIVE:
+            glthread_add_last(&sim_node->rx_q, &event->rx_q_glue);
+            if(sim_node->busy)
+                return;
+            sim_node->busy = TRUE;
+            flood_sim_post(sim, sim->now_usec + config->lsp_proc_usec,
+                flood_sim_new_event(FLOOD_SIM_EV_LSP_PROCESSED, event->node));
+            return;
+        case FLOOD_SIM_EV_LSP_PROCESSED:
+            curr = dequeue_glthread_first(&sim_node->rx_q);
+            assert(curr);
+            rx_event = rx_q_glue_to_flood_sim_event(curr);
+            flood_sim_lsp_receive(sim, rx_event->node, rx_event->from_node, rx_event->lsp);
+            XFREE(rx_event);
+            if(IS_GLTHREAD_LIST_EMPTY(&sim_node->rx_q)){
+                sim_node->busy = FALSE;
+                break;
+            }
+            /*Reuse the event for the next LSP in queue*/
+            flood_sim_post(sim, sim->now_usec + config->lsp_proc_usec, event);
+            return;
+        case FLOOD_SIM_EV_SPF_RUN:
+            sim_node->n_spf_runs++;
+            sim_node->spf_start_usec = sim->now_usec;
+            wall_usec = flood_sim_wall_usec();
+            spf_sched_run(event->spf_sched);
+            wall_usec = flood_sim_wall_usec() - wall_usec;
+            sim_node->spf_done_usec = sim->now_usec +
+                spf_delay_models[config->spf_delay_model].delay_fn(sim->instance,
+                    event->node, event->spf_sched->level, wall_usec);
+            n_routes = get_glthread_list_count(&event->node->spf_info.routes_list[UNICAST_T]);
+            event->ev_type = FLOOD_SIM_EV_FIB_UPDATED;
+            flood_sim_post(sim, sim_node->spf_done_usec +
+                ((uint64_t)n_routes * config->fib_per_route_usec), event);
+            return;
+        case FLOOD_SIM_EV_FIB_UPDATED:
+            sim_node->fib_updated_usec = sim->now_usec;
+            break;
+        default:
+            assert(0);
+    }
+    XFREE(event);
+}
+
+static void
+flood_sim_set_routers_quiet(flood_sim_t *sim){
+
+    unsigned int i = 0;
+    LEVEL level_it;
+
+    for(i = 0; i < sim->n_nodes; i++){
+        if(!sim->nodes[i].node)
+            continue;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++)
+            sim->nodes[i].node->spf_info.spf_level_info[level_it].spf_sched.has_run = FALSE;
+    }
+}
+
+static void
+flood_sim_free(flood_sim_t *sim){
+
+    glthread_t *curr = NULL;
+    flood_sim_lsp_t *lsp = NULL;
+    flood_sim_link_t *link = NULL;
+
+    assert(!sim->running && !sim->heap_size);
+
+    while((curr = dequeue_glthread_first(&sim->lsps))){
+        lsp = lsp_glue_to_flood_sim_lsp(curr);
+        delete_hash_vector(&lsp->received);
+        XFREE(lsp);
+    }
+
+    ITERATE_HASH_VECTOR_BEGIN(&sim->links, link){
+        XFREE(link);
+    } ITERATE_HASH_VECTOR_END;
+    delete_hash_vector(&sim->links);
+
+    if(sim->heap)
+        XFREE(sim->heap);
+    XFREE(sim->nodes);
+    XFREE(sim);
+}
+
+static flood_sim_t *
+flood_sim_begin(instance_t *instance){
+
+    node_t *node = NULL;
+    flood_sim_t *sim = NULL;
+
+    if(flood_sim){
+        flood_sim_free(flood_sim);
+        flood_sim = NULL;
+    }
+
+    sim = XCALLOC(1, flood_sim_t);
+    sim->instance = instance;
+    sim->n_nodes = instance->n_nodes;
+    sim->nodes = XCALLOC(sim->n_nodes, flood_sim_node_t);
+
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+        sim->nodes[node->node_index].node = node;
+        init_glthread(&sim->nodes[node->node_index].rx_q);
+    } ITERATE_HASH_VECTOR_END;
+
+    hash_vector_set_comparison_fn(&sim->links, flood_sim_link_comparison_fn);
+    hash_vector_set_hash_fns(&sim->links, flood_sim_link_hash_fn, hash_vector_ptr_hash);
+    init_glthread(&sim->lsps);
+
+    /*Every router is quiet when the simulation starts*/
+    flood_sim_set_routers_quiet(sim);
+    flood_sim = sim;
+    return sim;
+}
+
+static void
+flood_sim_originate(flood_sim_t *sim, node_t *lsp_generator,
+                    info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info){
+
+    LEVEL level_it;
+    flood_sim_lsp_t *lsp = NULL;
+    flood_sim_event_t *event = NULL;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        if(!IS_LEVEL_SET(dist_info->info_dist_level, level_it))
+            continue;
+
+        lsp = XCALLOC(1, flood_sim_lsp_t);
+        lsp->lsp_id = sim->n_lsps++;
+        lsp->fn_ptr = fn_ptr;
+        copy_dist_info_hdr(&lsp->dist_info, dist_info, &lsp->advert);
+        lsp->dist_info.lsp_generator = lsp_generator;
+        lsp->dist_info.info_dist_level = level_it;
+        lsp->level = level_it;
+        lsp->originated_usec = sim->now_usec;
+        hash_vector_set_comparison_fn(&lsp->received, flood_sim_lsp_node_comparison_fn);
+        hash_vector_set_hash_fns(&lsp->received, hash_vector_ptr_hash, hash_vector_ptr_hash);
+        init_glthread(&lsp->lsp_glue);
+        glthread_add_last(&sim->lsps, &lsp->lsp_glue);
+
+        /*Generator accepts its own LSP first*/
+        event = flood_sim_new_event(FLOOD_SIM_EV_LSP_ARRIVE, lsp_generator);
+        event->lsp = lsp;
+        flood_sim_post(sim, sim->now_usec, event);
+    }
+}
+
+static void
+flood_sim_run(flood_sim_t *sim){
+
+    flood_sim_heap_entry_t entry;
+    uint64_t wall_usec = flood_sim_wall_usec();
+
+    sim->running = TRUE;
+    while(sim->heap_size){
+        entry = flood_sim_pop(sim);
+        sim->now_usec = entry.time_usec;
+        sim->n_events++;
+        flood_sim_process_event(sim, entry.event);
+    }
+    sim->running = FALSE;
+    sim->wall_usec += flood_sim_wall_usec() - wall_usec;
+
+    /*Virtual time stamps of SPF runs mean nothing to the real clock*/
+    flood_sim_set_routers_quiet(sim);
+}
+
+static uint64_t
+flood_sim_converged_usec(flood_sim_t *sim){
+
+    unsigned int i = 0;
+    uint64_t converged_usec = 0;
+    flood_sim_node_t *sim_node = NULL;
+
+    for(i = 0; i < sim->n_nodes; i++){
+        sim_node = &sim->nodes[i];
+        if(sim_node->fib_updated_usec > converged_usec)
+            converged_usec = sim_node->fib_updated_usec;
+        if(sim_node->last_lsp_rx_usec > converged_usec)
+            converged_usec = sim_node->last_lsp_rx_usec;
+    }
+    return converged_usec;
+}
+
+#define FLOOD_SIM_MSEC_FMT      "%8llu.%03llu"
+#define FLOOD_SIM_MSEC(usec)    (unsigned long long)((usec) / 1000), (unsigned long long)((usec) % 1000)
+
+static void
+flood_sim_print_summary(flood_sim_t *sim){
+
+    uint64_t converged_usec = flood_sim_converged_usec(sim);
+
+    printf("Flood sim : %u LSPs, network converged at " FLOOD_SIM_MSEC_FMT " msec, "
+        "%llu events simulated in %llu usec\n",
+        sim->n_lsps, FLOOD_SIM_MSEC(converged_usec),
+        (unsigned long long)sim->n_events, (unsigned long long)sim->wall_usec);
+}
+
+void
+flood_sim_generate_lsp(instance_t *instance, node_t *lsp_generator,
+                       info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info){
+
+    flood_sim_t *sim = NULL;
+
+    /*LSP generated while the simulation runs joins it*/
+    if(flood_sim_is_running()){
+        flood_sim_originate(flood_sim, lsp_generator, fn_ptr, dist_info);
+        return;
+    }
+
+    sim = flood_sim_begin(instance);
+    flood_sim_originate(sim, lsp_generator, fn_ptr, dist_info);
+    flood_sim_run(sim);
+    flood_sim_print_summary(sim);
+}
+
+void
+flood_sim_link_failure(instance_t *instance, node_t *node, char *slot_name){
+
+    LEVEL level_it;
+    flood_sim_t *sim = NULL;
+    dist_info_hdr_t dist_info_hdr;
+    edge_end_t *interface = get_interface_from_intf_name(node, slot_name);
+    edge_t *edge = NULL;
+    node_t *nbr_node = NULL;
+
+    if(!interface || interface->dirn != OUTGOING){
+        printf("Error : node %s, Interface %s not found\n", node->node_name, slot_name);
+        return;
+    }
+
+    edge = GET_EGDE_PTR_FROM_EDGE_END(interface);
+    if(!edge->status){
+        printf("Error : node %s, Interface %s is already down\n", node->node_name, slot_name);
+        return;
+    }
+
+    if(flood_sim_is_running()){
+        printf("Error : flood simulation in progress\n");
+        return;
+    }
+
+    nbr_node = edge->to.node;
+    spf_node_slot_enable_disable(node, slot_name, CONFIG_DISABLE);
+    if(edge->inv_edge){
+        spf_node_slot_enable_disable(edge->inv_edge->from.node,
+            edge->inv_edge->from.intf_name, CONFIG_DISABLE);
+    }
+
+    /*Both ends detect the failure at time 0*/
+    sim = flood_sim_begin(instance);
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        if(!IS_LEVEL_SET(edge->level, level_it))
+            continue;
+
+        memset(&dist_info_hdr, 0, sizeof(dist_info_hdr_t));
+        dist_info_hdr.info_dist_level = level_it;
+        dist_info_hdr.add_or_remove = AD_CONFIG_UPDATED;
+        dist_info_hdr.advert_id = TLV2;
+        flood_sim_originate(sim, node, lsp_distribution_routine, &dist_info_hdr);
+        if(edge->inv_edge && nbr_node->node_type[level_it] != PSEUDONODE)
+            flood_sim_originate(sim, nbr_node, lsp_distribution_routine, &dist_info_hdr);
+    }
+
+    flood_sim_run(sim);
+    flood_sim_show(instance);
+}
+
+static int
+flood_sim_node_convergence_cmp(const void *a, const void *b){
+
+    const flood_sim_node_t *node_a = a, *node_b = b;
+
+    if(node_a->fib_updated_usec != node_b->fib_updated_usec)
+        return node_a->fib_updated_usec < node_b->fib_updated_usec ? -1 : 1;
+    if(node_a->last_lsp_rx_usec != node_b->last_lsp_rx_usec)
+        return node_a->last_lsp_rx_usec < node_b->last_lsp_rx_usec ? -1 : 1;
+    return strcmp(node_a->node->node_name, node_b->node->node_name);
+}
+
+void
+flood_sim_show(instance_t *instance){
+
+    unsigned int i = 0, n_routers = 0;
+    flood_sim_config_t *config = &instance->flood_sim_config;
+    flood_sim_node_t *timeline = NULL,
+                     *sim_node = NULL;
+
+    printf("Flood sim : %s, lsp-size %u B, lsp-proc-delay %u usec, spf-delay-model %s"
+        " (base %u usec, per node %u usec), fib-delay %u usec per route\n",
+        config->enabled ? "enabled" : "disabled", config->lsp_size, config->lsp_proc_usec,
+        spf_delay_models[config->spf_delay_model].name, config->spf_base_usec,
+        config->spf_per_node_usec, config->fib_per_route_usec);
+
+    if(!flood_sim){
+        printf("No simulation has run\n");
+        return;
+    }
+
+    flood_sim_print_summary(flood_sim);
+
+    /*Timeline in order of convergence*/
+    timeline = XCALLOC(flood_sim->n_nodes, flood_sim_node_t);
+    for(i = 0; i < flood_sim->n_nodes; i++){
+        sim_node = &flood_sim->nodes[i];
+        if(!sim_node->node || !sim_node->n_lsp_rx)
+            continue;
+        timeline[n_routers++] = *sim_node;
+    }
+    qsort(timeline, n_routers, sizeof(flood_sim_node_t), flood_sim_node_convergence_cmp);
+
+    printf("%-16s %9s %12s %12s %5s %12s %12s %12s\n", "Router", "LSPs/dup",
+        "1st LSP", "last LSP", "SPFs", "last SPF", "SPF done", "FIB updated");
+    for(i = 0; i < n_routers; i++){
+        sim_node = &timeline[i];
+        printf("%-16s %5u/%-3u " FLOOD_SIM_MSEC_FMT " " FLOOD_SIM_MSEC_FMT " %5u ",
+            sim_node->node->node_name, sim_node->n_lsp_rx, sim_node->n_lsp_dup,
+            FLOOD_SIM_MSEC(sim_node->first_lsp_rx_usec),
+            FLOOD_SIM_MSEC(sim_node->last_lsp_rx_usec), sim_node->n_spf_runs);
+        if(sim_node->n_spf_runs){
+            printf(FLOOD_SIM_MSEC_FMT " " FLOOD_SIM_MSEC_FMT " " FLOOD_SIM_MSEC_FMT "\n",
+                FLOOD_SIM_MSEC(sim_node->spf_start_usec),
+                FLOOD_SIM_MSEC(sim_node->spf_done_usec),
+                FLOOD_SIM_MSEC(sim_node->fib_updated_usec));
+        }
+        else{
+            printf("%12s %12s %12s\n", "-", "-", "-");
+        }
+    }
+    printf("Times in msec since the first LSP was originated\n");
+    XFREE(timeline);
+}
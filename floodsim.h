@@ -0,0 +1,197 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  floodsim.h
+ *
+ *    Description:  Discrete event LSP flooding simulator with virtual time
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 19:40:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#ifndef __FLOODSIM__
+#define __FLOODSIM__
+
+#include <stdint.h>
+#include "instanceconst.h"
+#include "LinkedListApi.h"
+#include "glthread.h"
+#include "hash_vector.h"
+#include "advert.h"
+
+/* The flood simulator replaces the inline BFS of generate_lsp with a
+ * discrete event simulation in virtual time. An LSP is serialized on
+ * every link at the link bandwidth, arrives after the link propagation
+ * delay, waits in the receive queue of the router and costs it
+ * lsp-proc-delay to process. Accepted LSPs are flooded on to all other
+ * neighbours, and their SPF triggers go through the router's SPF
+ * scheduler (spf-interval) in virtual time. The SPF itself is really
+ * run, its virtual duration is given by a pluggable delay model, and
+ * is followed by a FIB update costing fib-delay per route.
+ *
+ * A simulation runs to completion as fast as the CPU allows and leaves
+ * behind the per router convergence timeline. */
+
+typedef struct instance_ instance_t;
+typedef struct _node_t node_t;
+typedef struct _edge_t edge_t;
+typedef struct spf_sched_ spf_sched_t;
+
+#define FLOOD_SIM_DEFAULT_LSP_SIZE          1492    /*Bytes*/
+#define FLOOD_SIM_DEFAULT_LSP_PROC_USEC     50
+#define FLOOD_SIM_DEFAULT_SPF_BASE_USEC     1000
+#define FLOOD_SIM_DEFAULT_SPF_PER_NODE_USEC 10
+#define FLOOD_SIM_DEFAULT_FIB_PER_ROUTE_USEC 20
+#define FLOOD_SIM_MAX_SPF_DELAY_MODELS      8
+
+/* SPF delay model : virtual duration of an SPF run on spf_root.
+ * measured_usec is the wall clock time the run actually took */
+typedef uint64_t (*flood_sim_spf_delay_fn)(instance_t *instance,
+                    node_t *spf_root, LEVEL level, uint64_t measured_usec);
+
+typedef struct flood_sim_spf_delay_model_{
+    const char *name;
+    flood_sim_spf_delay_fn delay_fn;
+} flood_sim_spf_delay_model_t;
+
+typedef struct flood_sim_config_{
+    bool_t enabled;                 /*generate_lsp floods through the simulator*/
+    unsigned int lsp_size;
+    unsigned int lsp_proc_usec;
+    unsigned int spf_delay_model;   /*Index of registered model*/
+    unsigned int spf_base_usec;
+    unsigned int spf_per_node_usec;
+    unsigned int fib_per_route_usec;
+} flood_sim_config_t;
+
+typedef enum{
+
+    FLOOD_SIM_EV_LSP_ARRIVE,
+    FLOOD_SIM_EV_LSP_PROCESSED,
+    FLOOD_SIM_EV_SPF_RUN,
+    FLOOD_SIM_EV_FIB_UPDATED
+} flood_sim_ev_type_t;
+
+/*One LSP, flooded at one level*/
+typedef struct flood_sim_lsp_{
+    unsigned int lsp_id;
+    info_dist_fn_ptr fn_ptr;
+    dist_info_hdr_t dist_info;      /*info_data points to advert*/
+    lsp_advert_copy_t advert;
+    LEVEL level;
+    uint64_t originated_usec;
+    hash_vector_t received;         /*Routers which have accepted this LSP*/
+    glthread_t lsp_glue;
+} flood_sim_lsp_t;
+GLTHREAD_TO_STRUCT(lsp_glue_to_flood_sim_lsp, flood_sim_lsp_t, lsp_glue);
+
+typedef struct flood_sim_event_{
+    flood_sim_ev_type_t ev_type;
+    node_t *node;
+    node_t *from_node;              /*LSP sender, NULL if node originated it*/
+    flood_sim_lsp_t *lsp;
+    spf_sched_t *spf_sched;
+    glthread_t rx_q_glue;           /*LSP_ARRIVE waiting in node's receive queue*/
+} flood_sim_event_t;
+GLTHREAD_TO_STRUCT(rx_q_glue_to_flood_sim_event, flood_sim_event_t, rx_q_glue);
+
+/*Event queue is a binary min heap, seq keeps same time events FIFO*/
+typedef struct flood_sim_heap_entry_{
+    uint64_t time_usec;
+    uint64_t seq;
+    flood_sim_event_t *event;
+} flood_sim_heap_entry_t;
+
+/*Per router state and convergence timeline*/
+typedef struct flood_sim_node_{
+    node_t *node;
+    glthread_t rx_q;
+    bool_t busy;                    /*Processing an LSP*/
+    unsigned int n_lsp_rx;
+    unsigned int n_lsp_dup;
+    unsigned int n_spf_runs;
+    uint64_t first_lsp_rx_usec;
+    uint64_t last_lsp_rx_usec;
+    uint64_t spf_start_usec;
+    uint64_t spf_done_usec;
+    uint64_t fib_updated_usec;
+} flood_sim_node_t;
+
+/*Transmit side of a link, LSPs are serialized one after the other*/
+typedef struct flood_sim_link_{
+    edge_t *edge;
+    uint64_t tx_busy_until_usec;
+} flood_sim_link_t;
+
+typedef struct flood_sim_{
+    instance_t *instance;
+    bool_t running;
+    uint64_t now_usec;
+    uint64_t next_seq;
+    flood_sim_heap_entry_t *heap;
+    unsigned int heap_size;
+    unsigned int heap_capacity;
+    unsigned int n_nodes;
+    flood_sim_node_t *nodes;        /*Indexed by node_index*/
+    hash_vector_t links;
+    glthread_t lsps;
+    unsigned int n_lsps;
+    uint64_t n_events;
+    uint64_t wall_usec;
+} flood_sim_t;
+
+void
+init_flood_sim_config(flood_sim_config_t *config);
+
+/*Return the index of the model, -1 if there is no room or name is taken*/
+int
+flood_sim_register_spf_delay_model(const char *name, flood_sim_spf_delay_fn delay_fn);
+
+int
+flood_sim_get_spf_delay_model(const char *name);
+
+bool_t
+flood_sim_is_running();
+
+uint64_t
+flood_sim_now_usec();
+
+void
+flood_sim_schedule_spf(spf_sched_t *spf_sched, unsigned int wait_msec);
+
+/*generate_lsp hands the LSP to the simulator when it is enabled*/
+void
+flood_sim_generate_lsp(instance_t *instance, node_t *lsp_generator,
+                info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info);
+
+/*Bring down the link on both ends, flood both ends' LSPs and
+ * converge the network*/
+void
+flood_sim_link_failure(instance_t *instance, node_t *node, char *slot_name);
+
+void
+flood_sim_show(instance_t *instance);
+
+#endif /* __FLOODSIM__ */
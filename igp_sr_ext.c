@@ -63,6 +63,16 @@ init_srgb_defaults(srgb_t *srgb){
     init_bit_array(&srgb->index_array, srgb->range);
 }
 
+/*All indexes of the resized SRGB are free*/
+void
+resize_srgb(srgb_t *srgb, unsigned int range){
+
+    free((SRGB_INDEX_ARRAY(srgb))->array);
+    (SRGB_INDEX_ARRAY(srgb))->array = NULL;
+    srgb->range = range;
+    init_bit_array(SRGB_INDEX_ARRAY(srgb), srgb->range);
+}
+
 mpls_label_t
 get_available_srgb_label(srgb_t *srgb){
 
@@ -210,22 +220,16 @@ springify_rlfa_nexthop(node_t *spf_root,
     mpls_label_t mpls_label = 0;
     
     if(!is_node_spring_enabled(nxthop->proxy_nbr, route->level)) {
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, LDP proxy nexthop %s(%s) cannot be springified. SPRING not enabled",
+        trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, LDP proxy nexthop %s(%s) cannot be springified. SPRING not enabled",
                 spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
                 get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
         return;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, springifying LDP backup nexthops %s(%s), RLFA : %s",
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, springifying LDP backup nexthops %s(%s), RLFA : %s",
             spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
             get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name,
             nxthop->rlfa->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 
     /* PLR should send the traffic to Destination via RLFA. There are two options to
      * perform this via SR-tunnels:
@@ -252,26 +256,20 @@ springify_rlfa_nexthop(node_t *spf_root,
         nxthop->mpls_label_out[1] = mpls_label;
         nxthop->stack_op[1] = PUSH;
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u\t%s:%u, oif : %s, gw : %s, nexthop : %s", 
+        trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u\t%s:%u, oif : %s, gw : %s, nexthop : %s", 
                 spf_root->node_name, route->rt_key.u.prefix.prefix,
                 route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label,
                 get_str_stackops(nxthop->stack_op[1]) , nxthop->mpls_label_out[1],
                 get_str_stackops(nxthop->stack_op[0]) , nxthop->mpls_label_out[0], next_hop_oif_name(*nxthop),
                 next_hop_gateway_pfx(nxthop), nxthop->proxy_nbr->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
         return;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u, oif : %s, gw : %s, nexthop : %s", 
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u, oif : %s, gw : %s, nexthop : %s", 
         spf_root->node_name, route->rt_key.u.prefix.prefix,
         route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label,
         get_str_stackops(nxthop->stack_op[0]) , nxthop->mpls_label_out[0], next_hop_oif_name(*nxthop),
         next_hop_gateway_pfx(nxthop), nxthop->proxy_nbr->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 }
 
 static void
@@ -285,21 +283,15 @@ springify_ipv4_nexthop(node_t *spf_root,
     unsigned int outgoing_label = 0;
    
     if(!is_node_spring_enabled(nxthop->node, route->level)) {
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, IPV4 nexthop %s(%s) cannot be springified. SPRING not enabled",
+        trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, IPV4 nexthop %s(%s) cannot be springified. SPRING not enabled",
                 spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
                 get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
         return;
     }
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, springifying IPV4 nexthop %s(%s)",
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, springifying IPV4 nexthop %s(%s)",
             spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
             get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 
     /*caluclate the SPRING Nexthop related information first*/
     if(is_node_best_prefix_originator(nxthop->node, route)){
@@ -328,14 +320,11 @@ springify_ipv4_nexthop(node_t *spf_root,
     nxthop->stack_op[0] = stack_op;
     
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u, OutLabel : %u," 
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u, OutLabel : %u," 
             " Stack Op : %s, oif : %s, gw : %s, nexthop : %s", spf_root->node_name, route->rt_key.u.prefix.prefix, 
             route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label, 
             nxthop->mpls_label_out[0], get_str_stackops(nxthop->stack_op[0]), next_hop_oif_name(*nxthop),
             next_hop_gateway_pfx(nxthop), nxthop->node->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 }
 
 
@@ -349,12 +338,9 @@ springify_unicast_route(node_t *spf_root, routes_t *route,
     singly_ll_node_t *list_node = NULL;
     internal_nh_t *nxthop = NULL;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Springifying route %s/%u at %s", 
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : Springifying route %s/%u at %s", 
         spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
         get_str_level(route->level));
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 
     /*Now Do primary next hops*/
     ITERATE_LIST_BEGIN(route->primary_nh_list[IPNH], list_node){
@@ -108,6 +108,9 @@ get_available_srgb_label(srgb_t *srgb);
 void
 init_srgb_defaults(srgb_t *srgb);
 
+void
+resize_srgb(srgb_t *srgb, unsigned int range);
+
 void
 mark_srgb_index_in_use(srgb_t *srgb, unsigned int index);
 
@@ -45,7 +45,7 @@ extern void init_memory_manager();
 
 static void
 add_node_to_owning_instance(instance_t *instance, node_t *node){
-    singly_ll_add_node_by_val(instance->instance_node_list, (void *)node);
+    hash_vector_add(instance->instance_node_list, (void *)node);
 }
 
 extern void init_tilfa(node_t *node);
@@ -59,7 +59,7 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
 
     assert(node_name);
 
-    if(singly_ll_search_by_key(instance->instance_node_list, node_name)){
+    if(hash_vector_search_by_key(instance->instance_node_list, node_name)){
         printf("Error : Node %s already exists\n", node_name);
         return NULL;
     }
@@ -71,6 +71,8 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
     node->router_id[PREFIX_LEN] = '\0';
 
     node->area = area;
+    node->node_index = instance->n_nodes++;
+    node->instance = instance;
     node->is_node_on_heap = FALSE;
     SPF_CANDIDATE_TREE_NODE_INIT(&instance->ctree, node); 
 
@@ -79,26 +81,29 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
         node->node_type[level] = NON_PSEUDONODE;
         node->pn_intf[level] = NULL;
 
-        node->local_prefix_list[level] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->local_prefix_list[level] , 
+        node->local_prefix_list[level] = init_hash_vector();
+        hash_vector_set_comparison_fn(node->local_prefix_list[level] , 
                 get_prefix_comparison_fn());
         
-        singly_ll_set_order_comparison_fn(node->local_prefix_list[level] , 
+        hash_vector_set_order_comparison_fn(node->local_prefix_list[level] , 
                 get_prefix_order_comparison_fn());
 
+        hash_vector_set_hash_fns(node->local_prefix_list[level],
+                get_prefix_hash_fn(), get_prefix_key_hash_fn());
+
         router_id_pfx = create_new_prefix(node->router_id, 32, level);
         router_id_pfx->hosting_node = node;
         add_new_prefix_in_list(GET_NODE_PREFIX_LIST(node, level), router_id_pfx, 0);
 
-        node->spf_run_result[level] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->spf_run_result[level], spf_run_result_comparison_fn);
+        node->spf_run_result[level] = init_spf_run_result_list();
+        mm_arena_init(&node->spf_run_arena[level]);
+        init_glthread(&node->spf_root_self_results[level]);
 
         node->spf_info.spf_level_info[level].version = 0;
         node->spf_info.spf_level_info[level].node = node; /*back ptr*/
+        spf_sched_init(&node->spf_info.spf_level_info[level].spf_sched, node, level);
 
-        node->self_spf_result[level] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->self_spf_result[level], 
-                        self_spf_run_result_comparison_fn);
+        node->self_spf_result[level] = init_self_spf_result_list();
         
         init_glthread(&node->prefix_sids_thread_lst[level]);
 
@@ -106,21 +111,22 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
         ITERATE_NH_TYPE_BEGIN(nh){
 
             init_glthread(&node->pred_lst[level][nh]);
-            init_glthread(&node->spf_path_result[level][nh]);
         } ITERATE_NH_TYPE_END;    
+        node->spf_path_dag[level] = NULL;
     }
     rtttype_t rt_type;
 
     for(rt_type = UNICAST_T; rt_type < TOPO_MAX; rt_type++){
-        node->spf_info.routes_list[rt_type] = init_singly_ll();/*List of routes calculated, routes are not categorised under Levels*/
-        singly_ll_set_comparison_fn(node->spf_info.routes_list[rt_type], route_search_comparison_fn);
-
-        node->spf_info.priority_routes_list[rt_type] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->spf_info.priority_routes_list[rt_type], route_search_comparison_fn);
+        init_glthread(&node->spf_info.routes_list[rt_type]);/*List of routes calculated, routes are not categorised under Levels*/
+        init_glthread(&node->spf_info.priority_routes_list[rt_type]);
 
         node->spf_info.deferred_routes_list[rt_type] = init_singly_ll();
         singly_ll_set_comparison_fn(node->spf_info.deferred_routes_list[rt_type], route_search_comparison_fn);
     }
+    node->spf_info.routes_index = init_hash_vector();
+    hash_vector_set_comparison_fn(node->spf_info.routes_index, route_search_comparison_fn);
+    hash_vector_set_hash_fns(node->spf_info.routes_index, route_hash_fn,
+        get_prefix_key_hash_fn());
 
     node->spf_info.rib[INET_0] = init_rib(INET_0);
     node->spf_info.rib[INET_3] = init_rib(INET_3);
@@ -198,6 +204,7 @@ create_new_edge(char *from_ifname,
     edge->etype = UNICAST;
     edge->fa = NULL;
     edge->bandwidth = DEFAULT_LINK_BW;
+    edge->prop_delay_usec = DEFAULT_LINK_PROP_DELAY_USEC;
     edge->is_tilfa_pruned = FALSE;
     return edge;
 }
@@ -365,7 +372,7 @@ mark_node_pseudonode(node_t *node, LEVEL level){
         if(get_edge_direction(node, edge) == OUTGOING){ 
             edge->metric[level] = 0;
             if(edge_end->prefix[level]){
-                singly_ll_delete_node_by_data_ptr(GET_NODE_PREFIX_LIST(node, level), 
+                hash_vector_remove_ordered_by_data_ptr(GET_NODE_PREFIX_LIST(node, level), 
                         edge_end->prefix[level]);
                 edge_end->prefix[level]->ref_count--;
             }
@@ -385,6 +392,18 @@ instance_node_comparison_fn(void *_node, void *input_node_name){
     return 0;
 }
 
+static uint32_t
+instance_node_hash_fn(void *_node){
+
+    return hash_vector_str_hash(((node_t *)_node)->node_name, NODE_NAME_SIZE);
+}
+
+static uint32_t
+instance_node_key_hash_fn(void *node_name){
+
+    return hash_vector_str_hash((char *)node_name, NODE_NAME_SIZE);
+}
+
 extern void
 _spf_display_trace_options(unsigned long long bit_mask);
 
@@ -395,15 +414,18 @@ get_new_instance(){
 
     init_memory_manager();
     instance_t *instance = XCALLOC(1, instance_t);
-    instance->instance_node_list = init_singly_ll();
-    singly_ll_set_comparison_fn(instance->instance_node_list, 
+    instance->instance_node_list = init_hash_vector();
+    hash_vector_set_comparison_fn(instance->instance_node_list, 
         instance_node_comparison_fn);
+    hash_vector_set_hash_fns(instance->instance_node_list,
+        instance_node_hash_fn, instance_node_key_hash_fn);
     SPF_CANDIDATE_TREE_INIT(&instance->ctree);
     instance->traceopts = XCALLOC(1, traceoptions);
     init_trace(instance->traceopts);
     register_display_trace_options(instance->traceopts, _spf_display_trace_options);
     enable_spf_trace(instance, SPF_EVENTS_BIT);
     instance->mapping_server = NULL;
+    init_flood_sim_config(&instance->flood_sim_config);
     init_pfe();
     return instance;
 }
@@ -471,11 +493,8 @@ attach_prefix_on_node(node_t *node,
     _prefix->hosting_node = node;
     _prefix->prefix_flags = prefix_flags;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, prefix attached : %s/%u, prefix metric : %u",
+    trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s, prefix attached : %s/%u, prefix metric : %u",
         node->node_name, prefix, mask, metric);
-    trace(instance->traceopts, SPF_PREFIX_BIT);
-#endif
 
     if(add_prefix_to_prefix_list(GET_NODE_PREFIX_LIST(node, level), _prefix, 0))
         return _prefix;
@@ -499,16 +518,13 @@ deattach_prefix_on_node(node_t *node,
     strncpy(key.u.prefix.prefix, prefix, strlen(prefix));
     key.u.prefix.mask = mask;
     
-    prefix_t *_prefix = singly_ll_search_by_key(GET_NODE_PREFIX_LIST(node, level), &key);
+    prefix_t *_prefix = hash_vector_search_by_key(GET_NODE_PREFIX_LIST(node, level), &key);
     if(!_prefix)
         return;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, prefix deattached : %s/%u, prefix metric : %u",
-        node->node_name, prefix, mask, _prefix->metric); 
-    trace(instance->traceopts, SPF_PREFIX_BIT);
-#endif
-    singly_ll_remove_node_by_dataptr(GET_NODE_PREFIX_LIST(node, level), _prefix);
+    trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s, prefix deattached : %s/%u, prefix metric : %u",
+        node->node_name, prefix, mask, _prefix->metric);
+    hash_vector_remove_ordered_by_data_ptr(GET_NODE_PREFIX_LIST(node, level), _prefix);
     free_prefix(_prefix);
     _prefix = NULL;
 }
@@ -524,9 +540,9 @@ node_local_prefix_search(node_t *node, LEVEL level,
 
     assert(level == LEVEL1 || level == LEVEL2);
     
-    ll_t *prefix_list = GET_NODE_PREFIX_LIST(node, level);
+    hash_vector_t *prefix_list = GET_NODE_PREFIX_LIST(node, level);
 
-    return (prefix_t *)singly_ll_search_by_key(prefix_list, &key);
+    return (prefix_t *)hash_vector_search_by_key(prefix_list, &key);
 }
 
 
@@ -542,7 +558,7 @@ get_interface_from_intf_name(node_t *node, char *intf_name){
             return NULL;
         }
 
-        if(strncmp(intf_name, interface->intf_name, strlen(interface->intf_name)))
+        if(strncmp(intf_name, interface->intf_name, IF_NAME_SIZE))
             continue;
 
         if(interface->dirn != OUTGOING)
@@ -574,3 +590,79 @@ get_peer_node(edge_end_t *oif, LEVEL level, char *gw_ip){
     } ITERATE_NODE_LOGICAL_NBRS_END;
     return NULL;
 }
+
+boolean
+is_edge_srlg_member(edge_t *edge, unsigned int srlg){
+
+    unsigned int i = 0;
+
+    for(; i < edge->n_srlg; i++){
+        if(edge->srlg[i] == srlg)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+boolean
+is_edges_share_srlg(edge_t *edge1, edge_t *edge2){
+
+    unsigned int i = 0;
+
+    for(; i < edge1->n_srlg; i++){
+        if(is_edge_srlg_member(edge2, edge1->srlg[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*SRLG is the property of the link, so both directions of the
+ * link are updated, or none of them*/
+boolean
+edge_add_srlg(edge_t *edge, unsigned int srlg){
+
+    edge_t *inv_edge = edge->inv_edge;
+    boolean inv_member = inv_edge ? is_edge_srlg_member(inv_edge, srlg) : TRUE;
+
+    if(is_edge_srlg_member(edge, srlg) && inv_member)
+        return FALSE;
+
+    if((!is_edge_srlg_member(edge, srlg) && 
+            edge->n_srlg == MAX_SRLG_PER_LINK) ||
+       (!inv_member && inv_edge->n_srlg == MAX_SRLG_PER_LINK)){
+        printf("%s() : Error : Link %s can be member of max %u SRLGs\n",
+            __FUNCTION__, edge->from.intf_name, MAX_SRLG_PER_LINK);
+        return FALSE;
+    }
+
+    if(!is_edge_srlg_member(edge, srlg))
+        edge->srlg[edge->n_srlg++] = srlg;
+    if(!inv_member)
+        inv_edge->srlg[inv_edge->n_srlg++] = srlg;
+    return TRUE;
+}
+
+static void
+_edge_remove_srlg(edge_t *edge, unsigned int srlg){
+
+    unsigned int i = 0;
+
+    for(; i < edge->n_srlg; i++){
+        if(edge->srlg[i] != srlg)
+            continue;
+        edge->srlg[i] = edge->srlg[edge->n_srlg - 1];
+        edge->n_srlg--;
+        return;
+    }
+}
+
+boolean
+edge_remove_srlg(edge_t *edge, unsigned int srlg){
+
+    if(!is_edge_srlg_member(edge, srlg))
+        return FALSE;
+
+    _edge_remove_srlg(edge, srlg);
+    if(edge->inv_edge)
+        _edge_remove_srlg(edge->inv_edge, srlg);
+    return TRUE;
+}
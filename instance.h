@@ -37,6 +37,7 @@
 #include <assert.h>
 #include "instanceconst.h"
 #include "LinkedListApi.h"
+#include "hash_vector.h"
 #include "spfcomputation.h"
 #include "prefix.h"
 #include "rlfa.h"
@@ -46,6 +47,7 @@
 #include "rsvp.h"
 #include "Tree/candidate_tree.h"
 #include "spring_adjsid.h"
+#include "floodsim.h"
 
 
 typedef struct edge_end_ edge_end_t;
@@ -53,6 +55,8 @@ typedef struct tilfa_info_ tilfa_info_t;
 
 typedef struct _node_t{
     char node_name[NODE_NAME_SIZE];
+    unsigned int node_index;                                /*Dense index of node in instance, assigned at creation*/
+    instance_t *instance;                                   /*Owning instance*/
     char router_id[PREFIX_LEN+1];
     AREA area;
     edge_end_t *edges[MAX_NODE_INTF_SLOTS];
@@ -70,16 +74,18 @@ typedef struct _node_t{
     /*Complete path spf run*/
     glthread_t pred_lst[MAX_LEVEL][NH_MAX];
 
-    /*list of spf_path_result_t*/
-    glthread_t spf_path_result[MAX_LEVEL][NH_MAX];
+    /*Shortest path DAG of the last complete path spf run*/
+    struct spf_path_dag_t_ *spf_path_dag[MAX_LEVEL];
 
     /*Fields to handle pseudonode case*/
     edge_end_t *pn_intf[MAX_LEVEL];
 
-    ll_t *local_prefix_list[MAX_LEVEL];
-    ll_t *self_spf_result[MAX_LEVEL];                       /*Used for LFA and RLFA computation*/ 
+    hash_vector_t *local_prefix_list[MAX_LEVEL];
+    hash_vector_t *self_spf_result[MAX_LEVEL];              /*Used for LFA and RLFA computation*/ 
     /*For SPF computation only*/ 
-    ll_t *spf_run_result[MAX_LEVEL];                        /*List of nodes of instance which contain result of SPF skeleton run*/
+    hash_vector_t *spf_run_result[MAX_LEVEL];                        /*List of nodes of instance which contain result of SPF skeleton run*/
+    mm_arena_t spf_run_arena[MAX_LEVEL];                    /*spf_run_result and self spf results of this root are allocated from here*/
+    glthread_t spf_root_self_results[MAX_LEVEL];            /*Self spf results this root has planted on other nodes*/
     char attached;                                          /*Set if the router is L1L2 router. Admin responsibility to configure it as per the topology*/
 
     /*Every node in production has its own spf_info and 
@@ -93,6 +99,8 @@ typedef struct _node_t{
     char lsp_distribution_bit;
     internal_nh_t pq_nodes[MAX_LEVEL][MAX_NXT_HOPS];
     unsigned int backup_spf_options;
+    /*Nodes LFA/RLFA are computed for, all destinations if NULL*/
+    hash_vector_t *backup_destinations[MAX_LEVEL];
 
     /*segment routing related members*/
     boolean spring_enabled;
@@ -166,17 +174,29 @@ typedef struct _edge_t{
     rsvp_tunnel_t *fa;      /*Forwarding adjacency*/
     char status;            /* 0 down, 1 up*/
     float bandwidth; /*bandwidth for WECMP in GIG*/
+    unsigned int prop_delay_usec; /*One way propagation delay, used by flood simulator*/
     boolean is_tilfa_pruned;
+    /*Shared risk link groups this link is a member of*/
+    unsigned int srlg[MAX_SRLG_PER_LINK];
+    unsigned int n_srlg;
 } edge_t;
 
 typedef struct instance_{
     node_t *instance_root;
-    ll_t *instance_node_list;
+    hash_vector_t *instance_node_list;
     candidate_tree_t ctree;/*Candidate tree is shared by all nodes for SPF run*/
     traceoptions *traceopts;
     /*SR mapping server. We support only one mapping
      * server per topology*/
     node_t *mapping_server;
+    unsigned int n_nodes;   /*Used to assign node_index to new nodes*/
+    unsigned int lsp_pacing_msec;   /*Per hop LSP propagation delay, 0 distributes LSPs at once*/
+    /*SPF hold down, see spfsched.h. max wait 0 runs SPF on every trigger at once*/
+    unsigned int spf_max_wait_msec;
+    unsigned int spf_initial_wait_msec;
+    unsigned int spf_second_wait_msec;
+    flood_sim_config_t flood_sim_config;
+    hash_vector_t *prefix_originators_index;   /*See prefix_originators_add()*/
 } instance_t;
 
 node_t *
@@ -412,4 +432,16 @@ get_interface_from_intf_name(node_t *node, char *intf_name);
 node_t *
 get_peer_node(edge_end_t *oif, LEVEL level, char *gw_ip);
 
+boolean
+is_edge_srlg_member(edge_t *edge, unsigned int srlg);
+
+boolean
+is_edges_share_srlg(edge_t *edge1, edge_t *edge2);
+
+boolean
+edge_add_srlg(edge_t *edge, unsigned int srlg);
+
+boolean
+edge_remove_srlg(edge_t *edge, unsigned int srlg);
+
 #endif /* __INSTANCE__ */
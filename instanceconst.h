@@ -37,13 +37,14 @@
 
 #define IF_NAME_SIZE            16
 #define NODE_NAME_SIZE          16
-#define MAX_NODE_INTF_SLOTS     20
+#define MAX_NODE_INTF_SLOTS     128
 #define PREFIX_LEN              15
 #define PREFIX_LEN_WITH_MASK    (PREFIX_LEN + 3)
 #define MAX_NXT_HOPS            16
 #define INFINITE_METRIC         (0xFE000000)
 #define LINK_DEFAULT_METRIC     10
 #define DEFAULT_LINK_BW         1 /*1GIG*/
+#define DEFAULT_LINK_PROP_DELAY_USEC    1000 /*~200 Km of fiber*/
 #define STRING_REASON_LEN       256
 #define MPLS_STACK_OP_LIMIT_MAX 8
 #define TOPOLOGY_NAME_SIZE      32
@@ -51,6 +52,11 @@
 #define ZERO_IP                 "0.0.0.0"
 #define NH_NAME_SIZE            32
 #define TILFA_MAX_SEGMENTS      8
+#define TILFA_REMOTE_SPF_DB_MEM_CAP    (1 << 20)   /*Bytes, least default cap*/
+/*Default cap holds at least these many remote SPF results of n_nodes each*/
+#define TILFA_REMOTE_SPF_DB_MIN_ENTRIES 64
+#define TILFA_LAZY_TIME_BUDGET_MSEC    10
+#define MAX_SRLG_PER_LINK       8
 /* instance global flags */
 
 #define IGNOREATTACHED  1   /*If this bit is set, then L1-only router will not install default gateway to L1L2 router of the local Area*/
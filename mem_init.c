@@ -30,6 +30,7 @@
 
 #include "BitOp/bitarr.h"
 #include "LinkedList/LinkedListApi.h"
+#include "HashVector/hash_vector.h"
 #include "Queue/Queue.h"
 #include "Stack/stack.h"
 #include "complete_spf_path.h"
@@ -44,6 +45,11 @@
 #include "mpls/ldp.h"
 #include "spring_adjsid.h"
 #include "tilfa.h"
+#include "advert.h"
+#include "floodsim.h"
+#include "spfstats.h"
+#include "topogen.h"
+#include "metrics.h"
 #include "gluethread/glthread.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
@@ -59,34 +65,49 @@ init_memory_manager(){
     mm_init();
     MM_REG_STRUCT(bit_array_t);
     MM_REG_STRUCT(ll_t);
-    MM_REG_STRUCT(singly_ll_node_t);
+    MM_REG_STRUCT_SLAB(singly_ll_node_t);
+    MM_REG_STRUCT(hash_vector_t);
+    MM_REG_STRUCT(hash_vector_entry_t);
+    MM_REG_STRUCT(hash_vector_slot_t);
     MM_REG_STRUCT(Queue_t);
     MM_REG_STRUCT(stack_t);
-    MM_REG_STRUCT(pred_info_t);
-    MM_REG_STRUCT(spf_path_result_t);
-    MM_REG_STRUCT(internal_un_nh_t);
-    MM_REG_STRUCT(rt_un_entry_t);
+    MM_REG_STRUCT(spf_path_dag_pred_t);
+    MM_REG_STRUCT_SLAB(internal_un_nh_t);
+    MM_REG_STRUCT_SLAB(rt_un_entry_t);
     MM_REG_STRUCT(rt_un_table_t);
     MM_REG_STRUCT(mpls_label_stack_t);
     MM_REG_STRUCT(node_t);
     MM_REG_STRUCT(edge_t);
     MM_REG_STRUCT(instance_t);
     MM_REG_STRUCT(traceoptions);
-    MM_REG_STRUCT(prefix_t);
-    MM_REG_STRUCT(routes_t);
-    MM_REG_STRUCT(internal_nh_t);
+    MM_REG_STRUCT_SLAB(prefix_t);
+    MM_REG_STRUCT(common_pfx_key_t);
+    MM_REG_STRUCT(prefix_originators_t);
+    MM_REG_STRUCT_SLAB(prefix_originator_t);
+    MM_REG_STRUCT_SLAB(routes_t);
+    MM_REG_STRUCT_SLAB(internal_nh_t);
     MM_REG_STRUCT(srgb_t);
     MM_REG_STRUCT(rsvp_tunnel_t);
     MM_REG_STRUCT(ldp_config_t);
     MM_REG_STRUCT(rsvp_config_t);
     MM_REG_STRUCT(spf_result_t);
     MM_REG_STRUCT(self_spf_result_t);
+    MM_REG_STRUCT(lsp_flood_t);
+    MM_REG_STRUCT(flood_sim_t);
+    MM_REG_STRUCT(flood_sim_lsp_t);
+    MM_REG_STRUCT(flood_sim_event_t);
+    MM_REG_STRUCT(flood_sim_heap_entry_t);
+    MM_REG_STRUCT(flood_sim_node_t);
+    MM_REG_STRUCT(flood_sim_link_t);
+    MM_REG_STRUCT(topogen_node_t);
+    MM_REG_STRUCT(spf_stats_t);
     MM_REG_STRUCT(lan_intf_adj_sid_t);
     MM_REG_STRUCT(p2p_intf_adj_sid_t);
     MM_REG_STRUCT(lan_adj_sid_subtlv_t);
     MM_REG_STRUCT(p2p_adj_sid_subtlv_t);
     MM_REG_STRUCT(prefix_sid_subtlv_t);
     MM_REG_STRUCT(tilfa_remote_spf_result_t);
+    MM_REG_STRUCT(uint32_t);
     MM_REG_STRUCT(tilfa_info_t);
     MM_REG_STRUCT(tilfa_lcl_config_t);
     MM_REG_STRUCT(protected_resource_t);     
@@ -94,4 +115,63 @@ init_memory_manager(){
     MM_REG_STRUCT(glthread_t);
     MM_REG_STRUCT(gen_segment_list_t);
     MM_REG_STRUCT(tilfa_segment_list_t);
+    MM_REG_STRUCT(tilfa_interned_segment_list_t);
+    MM_REG_STRUCT(tilfa_lazy_work_t);
+}
+
+static metric_t *mm_allocs_metric;
+static metric_t *mm_frees_metric;
+static metric_t *mm_bytes_in_use_metric;
+static metric_t *mm_bytes_reserved_metric;
+static metric_t *mm_pages_in_use_metric;
+static metric_t *mm_pages_free_metric;
+static metric_t *mm_page_requests_metric;
+static metric_t *mm_pages_recycled_metric;
+static metric_t *mm_mmaps_metric;
+static metric_t *mm_munmaps_metric;
+
+static void
+mm_metrics_collect(){
+
+    mm_alloc_stats_t alloc_stats;
+    mm_page_source_stats_t page_stats;
+
+    mm_get_alloc_stats(&alloc_stats);
+    mm_page_source_get_stats(&page_stats);
+    metric_set(mm_allocs_metric, alloc_stats.n_allocs);
+    metric_set(mm_frees_metric, alloc_stats.n_frees);
+    metric_set(mm_bytes_in_use_metric, alloc_stats.bytes_in_use);
+    metric_set(mm_bytes_reserved_metric, page_stats.bytes_reserved);
+    metric_set(mm_pages_in_use_metric, page_stats.pages_in_use);
+    metric_set(mm_pages_free_metric, page_stats.pages_free);
+    metric_set(mm_page_requests_metric, page_stats.n_page_requests);
+    metric_set(mm_pages_recycled_metric, page_stats.n_page_recycled);
+    metric_set(mm_mmaps_metric, page_stats.n_mmap);
+    metric_set(mm_munmaps_metric, page_stats.n_munmap);
+}
+
+void
+mm_metrics_init(){
+
+    mm_allocs_metric = metrics_register(METRIC_COUNTER,
+        "mm_allocs_total", "XCALLOCs served by the memory manager", NULL);
+    mm_frees_metric = metrics_register(METRIC_COUNTER,
+        "mm_frees_total", "XFREEs done", NULL);
+    mm_bytes_in_use_metric = metrics_register(METRIC_GAUGE,
+        "mm_bytes_in_use", "Bytes allocated by the application", NULL);
+    mm_bytes_reserved_metric = metrics_register(METRIC_GAUGE,
+        "mm_bytes_reserved", "Bytes reserved from the kernel", NULL);
+    mm_pages_in_use_metric = metrics_register(METRIC_GAUGE,
+        "mm_pages_in_use", "VM pages handed to page families", NULL);
+    mm_pages_free_metric = metrics_register(METRIC_GAUGE,
+        "mm_pages_free", "VM pages reserved and not in use", NULL);
+    mm_page_requests_metric = metrics_register(METRIC_COUNTER,
+        "mm_page_requests_total", "VM pages asked for by page families", NULL);
+    mm_pages_recycled_metric = metrics_register(METRIC_COUNTER,
+        "mm_pages_recycled_total", "VM page requests served from pages given back", NULL);
+    mm_mmaps_metric = metrics_register(METRIC_COUNTER,
+        "mm_mmaps_total", "mmap calls", NULL);
+    mm_munmaps_metric = metrics_register(METRIC_COUNTER,
+        "mm_munmaps_total", "munmap calls", NULL);
+    metrics_register_collector(mm_metrics_collect);
 }
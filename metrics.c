@@ -0,0 +1,424 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  metrics.c
+ *
+ *    Description:  Registry of counters, gauges and histograms, exported in the
+ *                  Prometheus text format
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 21:05:37  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <assert.h>
+#include <unistd.h>
+#include "instanceconst.h"
+#include "metrics.h"
+#include "EventDispatcher/event_dispatcher.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+
+extern void init_memory_manager();
+
+const uint64_t metrics_usec_bounds[] = {
+
+    10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000
+};
+const uint32_t metrics_n_usec_bounds =
+    sizeof(metrics_usec_bounds) / sizeof(metrics_usec_bounds[0]);
+
+__thread int metrics_thread_shard = -1;
+
+typedef struct metrics_registry_{
+
+    pthread_mutex_t mutex;
+    glthread_t metric_list_head;
+    uint32_t n_metrics;
+    metrics_collector_fn collectors[METRICS_MAX_COLLECTORS];
+    uint32_t n_collectors;
+    uint32_t next_shard;
+    /*Periodic file export*/
+    char export_file_name[256];
+    uint32_t export_interval_sec;
+    ev_dis_timer_t export_timer;
+    uint64_t n_exports;
+    uint64_t n_export_failures;
+} metrics_registry_t;
+
+static metrics_registry_t metrics_registry;
+static boolean is_metrics_initialized = FALSE;
+
+uint32_t
+metrics_assign_shard(){
+
+    uint32_t shard = __atomic_fetch_add(&metrics_registry.next_shard, 1,
+                        __ATOMIC_RELAXED);
+
+    return shard < METRICS_SHARED_SHARD ? shard : METRICS_SHARED_SHARD;
+}
+
+static void
+metrics_export_timer_expiry(void *arg, uint32_t arg_size);
+
+void
+metrics_init(){
+
+    if(is_metrics_initialized)
+        return;
+    is_metrics_initialized = TRUE;
+
+    init_memory_manager();
+    memset(&metrics_registry, 0, sizeof(metrics_registry_t));
+    pthread_mutex_init(&metrics_registry.mutex, NULL);
+    init_glthread(&metrics_registry.metric_list_head);
+    /*Same domain as CLI, collectors never race with SPF runs*/
+    ev_dis_timer_init(&metrics_registry.export_timer, metrics_export_timer_expiry,
+        NULL, TASK_PRIORITY_LOW, NULL);
+    ev_dis_metrics_init();
+}
+
+static metric_t *
+metrics_register_internal(metric_type_t type, const char *name,
+                          const char *help, const char *labels){
+
+    glthread_t *curr = NULL, *last_of_family = NULL;
+    metric_t *metric = NULL;
+
+    assert(is_metrics_initialized);
+    assert(strlen(name) < METRIC_NAME_LEN);
+    assert(!labels || strlen(labels) < METRIC_LABELS_LEN);
+
+    /*Not XCALLOC, the mm gives no cache line alignment. Metrics
+     * are never freed*/
+    if(posix_memalign((void **)&metric, METRICS_CACHE_LINE_SIZE,
+                      sizeof(metric_t))){
+        printf("Error : %s() : could not allocate metric %s\n",
+               __FUNCTION__, name);
+        assert(0);
+    }
+    memset(metric, 0, sizeof(metric_t));
+    strncpy(metric->name, name, METRIC_NAME_LEN - 1);
+    if(labels)
+        strncpy(metric->labels, labels, METRIC_LABELS_LEN - 1);
+    strncpy(metric->help, help, METRIC_HELP_LEN - 1);
+    metric->type = type;
+    init_glthread(&metric->glue);
+
+    pthread_mutex_lock(&metrics_registry.mutex);
+    ITERATE_GLTHREAD_BEGIN(&metrics_registry.metric_list_head, curr){
+        if(strncmp(glue_to_metric(curr)->name, name, METRIC_NAME_LEN) == 0)
+            last_of_family = curr;
+    } ITERATE_GLTHREAD_END(&metrics_registry.metric_list_head, curr);
+
+    if(last_of_family){
+        assert(glue_to_metric(last_of_family)->type == type);
+        glthread_add_next(last_of_family, &metric->glue);
+    }
+    else
+        glthread_add_last(&metrics_registry.metric_list_head, &metric->glue);
+    metrics_registry.n_metrics++;
+    pthread_mutex_unlock(&metrics_registry.mutex);
+    return metric;
+}
+
+metric_t *
+metrics_register(metric_type_t type, const char *name,
+                 const char *help, const char *labels){
+
+    assert(type != METRIC_HISTOGRAM);
+    return metrics_register_internal(type, name, help, labels);
+}
+
+metric_t *
+metrics_register_histogram(const char *name, const char *help,
+                           const char *labels, const uint64_t *bounds,
+                           uint32_t n_bounds){
+
+    metric_t *metric = NULL;
+
+    assert(n_bounds && n_bounds <= METRIC_MAX_BOUNDS);
+    metric = metrics_register_internal(METRIC_HISTOGRAM, name, help, labels);
+    memcpy(metric->bounds, bounds, n_bounds * sizeof(uint64_t));
+    metric->n_bounds = n_bounds;
+    return metric;
+}
+
+void
+metrics_register_collector(metrics_collector_fn collector){
+
+    pthread_mutex_lock(&metrics_registry.mutex);
+    assert(metrics_registry.n_collectors < METRICS_MAX_COLLECTORS);
+    metrics_registry.collectors[metrics_registry.n_collectors++] = collector;
+    pthread_mutex_unlock(&metrics_registry.mutex);
+}
+
+static char *
+get_str_metric_type(metric_type_t type){
+
+    switch(type){
+        case METRIC_COUNTER:
+            return "counter";
+        case METRIC_GAUGE:
+            return "gauge";
+        case METRIC_HISTOGRAM:
+            return "histogram";
+        default:
+            assert(0);
+    }
+    return NULL;
+}
+
+static uint64_t
+metric_read_value(metric_t *metric){
+
+    uint32_t shard;
+    uint64_t value = __atomic_load_n(&metric->base, __ATOMIC_RELAXED);
+
+    for(shard = 0; shard < METRICS_MAX_SHARDS; shard++){
+        value += __atomic_load_n(&metric->shards[shard].value, __ATOMIC_RELAXED);
+    }
+    return value;
+}
+
+static void
+metric_dump_histogram(FILE *fp, metric_t *metric){
+
+    uint32_t i, shard;
+    uint64_t cumulative = 0, sum = 0;
+    const char *sep = metric->labels[0] ? "," : "";
+
+    /*Count is the sum of the buckets read here, not the shards' value,
+     * so that the +Inf bucket and _count always agree*/
+    for(i = 0; i <= metric->n_bounds; i++){
+        for(shard = 0; shard < METRICS_MAX_SHARDS; shard++){
+            cumulative += __atomic_load_n(&metric->shards[shard].buckets[i],
+                            __ATOMIC_RELAXED);
+        }
+        if(i < metric->n_bounds)
+            fprintf(fp, "%s_bucket{%s%sle=\"%llu\"} %llu\n", metric->name,
+                metric->labels, sep, (unsigned long long)metric->bounds[i],
+                (unsigned long long)cumulative);
+        else
+            fprintf(fp, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", metric->name,
+                metric->labels, sep, (unsigned long long)cumulative);
+    }
+
+    for(shard = 0; shard < METRICS_MAX_SHARDS; shard++){
+        sum += __atomic_load_n(&metric->shards[shard].sum, __ATOMIC_RELAXED);
+    }
+
+    if(metric->labels[0]){
+        fprintf(fp, "%s_sum{%s} %llu\n", metric->name, metric->labels,
+            (unsigned long long)sum);
+        fprintf(fp, "%s_count{%s} %llu\n", metric->name, metric->labels,
+            (unsigned long long)cumulative);
+    }
+    else{
+        fprintf(fp, "%s_sum %llu\n", metric->name, (unsigned long long)sum);
+        fprintf(fp, "%s_count %llu\n", metric->name, (unsigned long long)cumulative);
+    }
+}
+
+void
+metrics_dump(FILE *fp){
+
+    uint32_t i;
+    glthread_t *curr = NULL;
+    metric_t *metric = NULL;
+    const char *family = "";
+
+    pthread_mutex_lock(&metrics_registry.mutex);
+
+    for(i = 0; i < metrics_registry.n_collectors; i++){
+        metrics_registry.collectors[i]();
+    }
+
+    ITERATE_GLTHREAD_BEGIN(&metrics_registry.metric_list_head, curr){
+
+        metric = glue_to_metric(curr);
+
+        if(strncmp(family, metric->name, METRIC_NAME_LEN)){
+            fprintf(fp, "# HELP %s %s\n", metric->name, metric->help);
+            fprintf(fp, "# TYPE %s %s\n", metric->name,
+                get_str_metric_type(metric->type));
+            family = metric->name;
+        }
+
+        switch(metric->type){
+            case METRIC_COUNTER:
+                fprintf(fp, metric->labels[0] ? "%s{%s} %llu\n" : "%s%s %llu\n",
+                    metric->name, metric->labels,
+                    (unsigned long long)metric_read_value(metric));
+                break;
+            case METRIC_GAUGE:
+                fprintf(fp, metric->labels[0] ? "%s{%s} %lld\n" : "%s%s %lld\n",
+                    metric->name, metric->labels,
+                    (long long)metric_read_value(metric));
+                break;
+            case METRIC_HISTOGRAM:
+                metric_dump_histogram(fp, metric);
+                break;
+            default:
+                assert(0);
+        }
+    } ITERATE_GLTHREAD_END(&metrics_registry.metric_list_head, curr);
+
+    pthread_mutex_unlock(&metrics_registry.mutex);
+}
+
+void
+metrics_show(){
+
+    metrics_dump(stdout);
+    if(metrics_registry.export_file_name[0]){
+        printf("# export : %s, interval %u sec, written %llu times, %llu failures\n",
+            metrics_registry.export_file_name, metrics_registry.export_interval_sec,
+            (unsigned long long)metrics_registry.n_exports,
+            (unsigned long long)metrics_registry.n_export_failures);
+    }
+}
+
+int
+metrics_export_file(const char *file_name){
+
+    FILE *fp = NULL;
+    char tmp_file_name[sizeof(metrics_registry.export_file_name) + 8];
+
+    snprintf(tmp_file_name, sizeof(tmp_file_name), "%s.tmp", file_name);
+    fp = fopen(tmp_file_name, "w");
+    if(!fp)
+        return -1;
+    metrics_dump(fp);
+    if(fclose(fp) != 0 || rename(tmp_file_name, file_name) != 0){
+        unlink(tmp_file_name);
+        return -1;
+    }
+    return 0;
+}
+
+static void
+metrics_export_timer_expiry(void *arg, uint32_t arg_size){
+
+    if(!metrics_registry.export_file_name[0])
+        return;
+    if(metrics_export_file(metrics_registry.export_file_name) == 0)
+        metrics_registry.n_exports++;
+    else
+        metrics_registry.n_export_failures++;
+}
+
+int
+metrics_export_start(const char *file_name, uint32_t interval_sec){
+
+    if(strlen(file_name) >= sizeof(metrics_registry.export_file_name))
+        return -1;
+
+    metrics_export_stop();
+    if(metrics_export_file(file_name) < 0)
+        return -1;
+
+    strncpy(metrics_registry.export_file_name, file_name,
+        sizeof(metrics_registry.export_file_name) - 1);
+    metrics_registry.export_interval_sec = interval_sec;
+    metrics_registry.n_exports = 1;
+    metrics_registry.n_export_failures = 0;
+    if(interval_sec)
+        ev_dis_timer_arm(&metrics_registry.export_timer,
+            interval_sec * 1000, interval_sec * 1000);
+    return 0;
+}
+
+void
+metrics_export_stop(){
+
+    ev_dis_timer_cancel(&metrics_registry.export_timer);
+    memset(metrics_registry.export_file_name, 0,
+        sizeof(metrics_registry.export_file_name));
+    metrics_registry.export_interval_sec = 0;
+}
+
+/*Event dispatcher, the library keeps its own counters and
+ * knows nothing of this registry*/
+
+static metric_t *ev_dis_tasks_run[EV_DIS_MAX_WORKERS];
+static metric_t *ev_dis_steals[EV_DIS_MAX_WORKERS];
+static metric_t *ev_dis_idle_workers;
+static metric_t *ev_dis_runnable_domains;
+static metric_t *ev_dis_timers_armed;
+static metric_t *ev_dis_timers_expired;
+static metric_t *ev_dis_pkt_queues;
+static metric_t *ev_dis_pkt_drops;
+
+static void
+ev_dis_metrics_collect(){
+
+    uint32_t i;
+    ev_dis_stats_t stats;
+
+    event_dispatcher_get_stats(&stats);
+    for(i = 0; i < stats.n_workers; i++){
+        metric_set(ev_dis_tasks_run[i], stats.n_tasks_run[i]);
+        metric_set(ev_dis_steals[i], stats.n_steals[i]);
+    }
+    metric_set(ev_dis_idle_workers, stats.n_idle_workers);
+    metric_set(ev_dis_runnable_domains, stats.n_runnable_domains);
+    metric_set(ev_dis_timers_armed, stats.n_timers_armed);
+    metric_set(ev_dis_timers_expired, stats.n_timers_expired);
+    metric_set(ev_dis_pkt_queues, stats.n_pkt_queues);
+    metric_set(ev_dis_pkt_drops, stats.n_pkt_drops);
+}
+
+void
+ev_dis_metrics_init(){
+
+    uint32_t i;
+    char labels[METRIC_LABELS_LEN];
+
+    for(i = 0; i < event_dispatcher_get_n_workers(); i++){
+        snprintf(labels, sizeof(labels), "worker=\"%u\"", i);
+        ev_dis_tasks_run[i] = metrics_register(METRIC_COUNTER,
+            "ev_dis_tasks_run_total", "Tasks run by the event dispatcher worker", labels);
+    }
+    for(i = 0; i < event_dispatcher_get_n_workers(); i++){
+        snprintf(labels, sizeof(labels), "worker=\"%u\"", i);
+        ev_dis_steals[i] = metrics_register(METRIC_COUNTER,
+            "ev_dis_steals_total", "Domains stolen from other workers", labels);
+    }
+    ev_dis_idle_workers = metrics_register(METRIC_GAUGE,
+        "ev_dis_idle_workers", "Workers waiting for work", NULL);
+    ev_dis_runnable_domains = metrics_register(METRIC_GAUGE,
+        "ev_dis_runnable_domains", "Domains with tasks waiting for a worker", NULL);
+    ev_dis_timers_armed = metrics_register(METRIC_GAUGE,
+        "ev_dis_timers_armed", "Timers armed in the timer wheel", NULL);
+    ev_dis_timers_expired = metrics_register(METRIC_COUNTER,
+        "ev_dis_timers_expired_total", "Timer expiries", NULL);
+    ev_dis_pkt_queues = metrics_register(METRIC_GAUGE,
+        "ev_dis_pkt_queues", "Packet queues", NULL);
+    ev_dis_pkt_drops = metrics_register(METRIC_COUNTER,
+        "ev_dis_pkt_drops_total", "Packets dropped by full packet queue rings", NULL);
+    metrics_register_collector(ev_dis_metrics_collect);
+}
@@ -0,0 +1,217 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  metrics.h
+ *
+ *    Description:  Registry of counters, gauges and histograms, exported in the
+ *                  Prometheus text format
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 21:05:37  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __METRICS__
+#define __METRICS__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "gluethread/glthread.h"
+
+#define METRICS_MAX_SHARDS          16
+/*Threads beyond the first METRICS_MAX_SHARDS - 1 share the last shard*/
+#define METRICS_SHARED_SHARD        (METRICS_MAX_SHARDS - 1)
+#define METRICS_CACHE_LINE_SIZE     64
+#define METRIC_MAX_BOUNDS           12
+#define METRIC_NAME_LEN             64
+#define METRIC_LABELS_LEN           96
+#define METRIC_HELP_LEN             128
+#define METRICS_MAX_COLLECTORS      16
+
+typedef enum{
+
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} metric_type_t;
+
+/*One per thread, cache line aligned so that two threads never update
+ * the same cache line. The alignment holds only if the metric_t itself
+ * is, see metrics_register_internal(). Histograms use sum and buckets only*/
+typedef struct metric_shard_{
+
+    uint64_t value;
+    uint64_t sum;
+    uint64_t buckets[METRIC_MAX_BOUNDS + 1];    /*Last one is +Inf*/
+} __attribute__((aligned(METRICS_CACHE_LINE_SIZE))) metric_shard_t;
+
+/*A metric is one time series, name + labels. Metrics of the same name
+ * are kept next to each other in the registry, as the text format
+ * wants all samples of a family together*/
+typedef struct metric_{
+
+    char name[METRIC_NAME_LEN];
+    char labels[METRIC_LABELS_LEN];     /*key="value",... without the braces*/
+    char help[METRIC_HELP_LEN];
+    metric_type_t type;
+    uint32_t n_bounds;
+    uint64_t bounds[METRIC_MAX_BOUNDS];
+    /*Set by collectors for values owned by some other module,
+     * added to the sum of the shards*/
+    uint64_t base;
+    metric_shard_t shards[METRICS_MAX_SHARDS];
+    glthread_t glue;
+} metric_t;
+GLTHREAD_TO_STRUCT(glue_to_metric, metric_t, glue);
+
+/*Called before every dump, to refresh the metrics whose
+ * value is owned by some other module through metric_set()*/
+typedef void (*metrics_collector_fn)(void);
+
+void
+metrics_init();
+
+metric_t *
+metrics_register(metric_type_t type, const char *name,
+                 const char *help, const char *labels);
+
+/*bounds are the ascending upper bounds of the buckets, +Inf is implicit*/
+metric_t *
+metrics_register_histogram(const char *name, const char *help,
+                           const char *labels, const uint64_t *bounds,
+                           uint32_t n_bounds);
+
+void
+metrics_register_collector(metrics_collector_fn collector);
+
+void
+metrics_dump(FILE *fp);
+
+void
+metrics_show();
+
+/*Writes to <file_name>.tmp and renames it, a scraper never reads
+ * a file half written*/
+int
+metrics_export_file(const char *file_name);
+
+/*interval_sec 0 writes the file once*/
+int
+metrics_export_start(const char *file_name, uint32_t interval_sec);
+
+void
+metrics_export_stop();
+
+/*Updates, cheap enough to stay on hot paths. NULL metrics are
+ * ignored, so that code also linked without metrics_init() works*/
+
+extern __thread int metrics_thread_shard;
+
+uint32_t
+metrics_assign_shard();
+
+static inline uint32_t
+metrics_get_shard(){
+
+    if(metrics_thread_shard < 0)
+        metrics_thread_shard = (int)metrics_assign_shard();
+    return (uint32_t)metrics_thread_shard;
+}
+
+static inline void
+metric_shard_add(uint32_t shard, uint64_t *field, uint64_t delta){
+
+    if(shard == METRICS_SHARED_SHARD){
+        __atomic_fetch_add(field, delta, __ATOMIC_RELAXED);
+        return;
+    }
+    /*Single writer, atomic store only so that readers never see a torn value*/
+    __atomic_store_n(field, __atomic_load_n(field, __ATOMIC_RELAXED) + delta,
+        __ATOMIC_RELAXED);
+}
+
+static inline void
+metric_counter_add(metric_t *metric, uint64_t delta){
+
+    uint32_t shard;
+
+    if(!metric) return;
+    shard = metrics_get_shard();
+    metric_shard_add(shard, &metric->shards[shard].value, delta);
+}
+
+static inline void
+metric_counter_inc(metric_t *metric){
+
+    metric_counter_add(metric, 1);
+}
+
+static inline void
+metric_gauge_add(metric_t *metric, int64_t delta){
+
+    metric_counter_add(metric, (uint64_t)delta);
+}
+
+static inline void
+metric_set(metric_t *metric, uint64_t value){
+
+    if(!metric) return;
+    __atomic_store_n(&metric->base, value, __ATOMIC_RELAXED);
+}
+
+static inline void
+metric_histogram_observe(metric_t *metric, uint64_t value){
+
+    uint32_t i = 0, shard;
+
+    if(!metric) return;
+    while(i < metric->n_bounds && value > metric->bounds[i]) i++;
+    shard = metrics_get_shard();
+    metric_shard_add(shard, &metric->shards[shard].buckets[i], 1);
+    metric_shard_add(shard, &metric->shards[shard].sum, value);
+}
+
+/*Bucket bounds of the durations in usec*/
+extern const uint64_t metrics_usec_bounds[];
+extern const uint32_t metrics_n_usec_bounds;
+
+/*Registrations of the modules*/
+void
+spf_metrics_init();
+
+void
+routes_metrics_init();
+
+void
+data_plane_metrics_init();
+
+void
+tilfa_metrics_init();
+
+void
+mm_metrics_init();
+
+void
+ev_dis_metrics_init();
+
+#endif /* __METRICS__ */
@@ -64,19 +64,17 @@ show_mpls_rsvp_label_local_bindings(node_t *node){
     printf("\tPrefix/msk          Lcl Label\n");
     printf("\t================================\n");
 
-    singly_ll_node_t *list_node = NULL;
     LEVEL level_it;
     prefix_t *prefix = NULL;
     char str_prefix_with_mask[PREFIX_LEN_WITH_MASK + 1];
     
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level_it), list_node){
-            prefix = list_node->data;
+        ITERATE_HASH_VECTOR_BEGIN(GET_NODE_PREFIX_LIST(node, level_it), prefix){
             memset(str_prefix_with_mask, 0, PREFIX_LEN_WITH_MASK + 1);
             apply_mask2(prefix->prefix, prefix->mask, str_prefix_with_mask);
             printf("\t%-22s %u\n", str_prefix_with_mask, 
                 get_rsvp_label_binding(node, prefix->prefix, prefix->mask));
-        } ITERATE_LIST_END;
+        } ITERATE_HASH_VECTOR_END;
     }
 }
 
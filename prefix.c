@@ -79,6 +79,23 @@ prefix_comparison_fn(void *_prefix, void *_key){
     return FALSE;
 }
 
+static uint32_t
+prefix_hash_fn(void *_prefix){
+
+    prefix_t *prefix = (prefix_t *)_prefix;
+    return hash_vector_hash_combine(
+        hash_vector_str_hash(prefix->prefix, PREFIX_LEN + 1), prefix->mask);
+}
+
+static uint32_t
+prefix_key_hash_fn(void *_key){
+
+    common_pfx_key_t *key = (common_pfx_key_t *)_key;
+    return hash_vector_hash_combine(
+        hash_vector_str_hash(key->u.prefix.prefix, PREFIX_LEN + 1),
+        key->u.prefix.mask);
+}
+
 /*Currently it decides based only on metric, in future we will
  * enhance this fn with other parameters such as external/internal routes
  * inter area/intra area routes etc*/
@@ -270,6 +287,16 @@ get_prefix_order_comparison_fn(){
     return prefix_order_comparison_fn;
 }
 
+hash_fn
+get_prefix_hash_fn(){
+    return prefix_hash_fn;
+}
+
+hash_fn
+get_prefix_key_hash_fn(){
+    return prefix_key_hash_fn;
+}
+
 /* Returns the prefix being leaked from L2 to L1 (Or otherwise). If the prefix is already
  * leaked, return NULL. This fn simply add the new prefix to new prefix list.*/
 
@@ -287,7 +314,7 @@ leak_prefix(char *node_name, char *_prefix, char mask,
         return NULL;
     }
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     prefix = node_local_prefix_search(node, from_level, _prefix, mask);
        
@@ -304,11 +331,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
         leaked_prefix = attach_prefix_on_node (node, prefix->prefix, prefix->mask, 
                         to_level, prefix->metric, prefix->prefix_flags);
         if(!leaked_prefix){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
+            trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
                 node->node_name, STR_PREFIX(prefix), get_str_level(to_level));
-            trace(instance->traceopts, SPF_PREFIX_BIT);
-#endif
             return NULL;
         }
         leaked_prefix->ref_count = 0;
@@ -316,11 +340,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
         if(from_level == LEVEL2 && to_level == LEVEL1)
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
+        trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s : prefix %s/%u leaked from %s to %s", 
                 node->node_name, STR_PREFIX(prefix), PREFIX_MASK(prefix), get_str_level(from_level), get_str_level(to_level));
-        trace(instance->traceopts, SPF_PREFIX_BIT);
-#endif
 
         return leaked_prefix;
     }
@@ -349,11 +370,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
                         route_to_be_leaked->ext_metric : route_to_be_leaked->spf_metric, 0);
 
         if(!leaked_prefix){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
+            trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
                 node->node_name, STR_PREFIX(prefix), get_str_level(to_level));
-            trace(instance->traceopts, SPF_PREFIX_BIT);
-#endif
             return NULL;
         }
 
@@ -363,80 +381,120 @@ leak_prefix(char *node_name, char *_prefix, char mask,
         if(from_level == LEVEL2 && to_level == LEVEL1)
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
+        trace_log(instance->traceopts, SPF_PREFIX_BIT, "Node : %s : prefix %s/%u leaked from %s to %s", 
                 node->node_name, route_to_be_leaked->rt_key.u.prefix.prefix, 
                 route_to_be_leaked->rt_key.u.prefix.mask, get_str_level(from_level), 
                 get_str_level(to_level)); 
-        trace(instance->traceopts, SPF_PREFIX_BIT); 
-#endif
 
         return leaked_prefix;
     }
     return NULL;
 }
 
-void
-add_new_prefix_in_list(ll_t *prefix_list , prefix_t *prefix, 
-                unsigned int prefix_hosting_node_metric){
+static int
+prefix_originators_comparison_fn(void *_originators, void *_key){
 
-    singly_ll_node_t *list_node_prev = NULL, 
-                     *list_node_next = NULL;
+    prefix_originators_t *originators = _originators;
+    common_pfx_key_t *key = _key;
 
-    prefix_t *list_prefix = NULL;
+    return strncmp(originators->key.u.prefix.prefix, key->u.prefix.prefix, PREFIX_LEN) == 0 &&
+           originators->key.u.prefix.mask == key->u.prefix.mask;
+}
 
-    /* empty list*/
-    if(is_singly_ll_empty(prefix_list)){
-        singly_ll_add_node_by_val(prefix_list, prefix);
-        return;
-    }
+void
+prefix_originators_add(prefix_t *prefix){
 
-    /* Only one node*/
-    if(GET_NODE_COUNT_SINGLY_LL(prefix_list) == 1){
-        if(prefix->metric + prefix_hosting_node_metric < ((prefix_t *)(prefix_list->head->data))->metric){
-            singly_ll_add_node_by_val(prefix_list, prefix);
-        }
-        else{
-            singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-            prefix_list->head->next = new_node;
-            INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        }
+    common_pfx_key_t key;
+    instance_t *instance = NULL;
+    prefix_originators_t *originators = NULL;
+    prefix_originator_t *originator = NULL;
+
+    if(!prefix->hosting_node)
         return;
+
+    instance = prefix->hosting_node->instance;
+    if(!instance->prefix_originators_index){
+        instance->prefix_originators_index = init_hash_vector();
+        hash_vector_set_comparison_fn(instance->prefix_originators_index,
+            prefix_originators_comparison_fn);
+        hash_vector_set_hash_fns(instance->prefix_originators_index,
+            prefix_key_hash_fn, prefix_key_hash_fn);
     }
 
-    /* If prefix need to be added as first node in a list*/
-    if(prefix->metric + prefix_hosting_node_metric < 
-                ((prefix_t *)(GET_HEAD_SINGLY_LL(prefix_list)->data))->metric){
+    init_prefix_key(&key, prefix->prefix, prefix->mask);
+    originators = hash_vector_search_by_key(instance->prefix_originators_index, &key);
+    if(!originators){
+        originators = XCALLOC(1, prefix_originators_t);
+        originators->key = key;
+        hash_vector_add(instance->prefix_originators_index, originators);
+    }
 
-        singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-        new_node->next = GET_HEAD_SINGLY_LL(prefix_list);
-        prefix_list->head = new_node;
-        INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        return;
+    for(originator = originators->head; originator; originator = originator->next){
+        if(originator->node == prefix->hosting_node &&
+            originator->mask == prefix->mask &&
+            strncmp(originator->prefix, prefix->prefix, PREFIX_LEN) == 0)
+            return;
     }
 
+    originator = XCALLOC(1, prefix_originator_t);
+    originator->node = prefix->hosting_node;
+    strncpy(originator->prefix, prefix->prefix, PREFIX_LEN);
+    originator->mask = prefix->mask;
+    originator->next = originators->head;
+    originators->head = originator;
+}
 
-    ITERATE_LIST_BEGIN(prefix_list, list_node_next){
+prefix_originator_t *
+prefix_originators_lookup(instance_t *instance, common_pfx_key_t *pfx_key){
 
-        list_prefix = list_node_next->data;
-        if(!(prefix->metric + prefix_hosting_node_metric < list_prefix->metric)){ 
+    LEVEL level_it;
+    prefix_originators_t *originators = NULL;
+    prefix_originator_t **pp = NULL,
+                        *originator = NULL;
 
-            list_node_prev = list_node_next;
+    if(!instance->prefix_originators_index)
+        return NULL;
+
+    originators = hash_vector_search_by_key(instance->prefix_originators_index, pfx_key);
+    if(!originators)
+        return NULL;
+
+    pp = &originators->head;
+    while((originator = *pp)){
+
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            if(node_local_prefix_search(originator->node, level_it,
+                originator->prefix, originator->mask))
+                break;
+        }
+        if(level_it < MAX_LEVEL){
+            pp = &originator->next;
             continue;
         }
+        *pp = originator->next;
+        XFREE(originator);
+    }
+    return originators->head;
+}
 
-        singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-        new_node->next = list_node_next;
-        list_node_prev->next = new_node;
-        INC_NODE_COUNT_SINGLY_LL(prefix_list);
-        return;
+void
+add_new_prefix_in_list(hash_vector_t *prefix_list , prefix_t *prefix, 
+                unsigned int prefix_hosting_node_metric){
 
-    }ITERATE_LIST_END;
+    unsigned int pos = 0;
+    prefix_t *list_prefix = NULL;
+
+    prefix_originators_add(prefix);
+
+    /*List is kept sorted by metric, prefix goes after all prefixes
+     * with metric no worse than its own*/
+    for(pos = 0; pos < HASH_VECTOR_COUNT(prefix_list); pos++){
 
-    /*Add in the end*/
-    singly_ll_node_t *new_node = singly_ll_init_node(prefix);
-    list_node_prev->next = new_node;
-    INC_NODE_COUNT_SINGLY_LL(prefix_list);
+        list_prefix = HASH_VECTOR_DATA(prefix_list, pos);
+        if(prefix->metric + prefix_hosting_node_metric < list_prefix->metric)
+            break;
+    }
+    hash_vector_insert_at(prefix_list, pos, prefix);
 }
 
 FLAG
@@ -455,7 +513,7 @@ is_prefix_byte_equal(prefix_t *prefix1, prefix_t *prefix2,
 /* Let us delegate all add logic to this fn*/
 /* Returns 1 if prefix added, 0 if rejected*/
 FLAG
-add_prefix_to_prefix_list(ll_t *prefix_list, 
+add_prefix_to_prefix_list(hash_vector_t *prefix_list, 
                           prefix_t *prefix, 
                           unsigned int hosting_node_metric){
 
@@ -464,23 +522,23 @@ add_prefix_to_prefix_list(ll_t *prefix_list,
     strncpy(key.u.prefix.prefix, prefix->prefix, PREFIX_LEN);
     key.u.prefix.prefix[PREFIX_LEN] = '\0'; 
     key.u.prefix.mask = prefix->mask;
-    assert(!singly_ll_search_by_key(prefix_list, &key));
+    assert(!hash_vector_search_by_key(prefix_list, &key));
     add_new_prefix_in_list(prefix_list, prefix, hosting_node_metric);
     return 1;
 }
 
 void
-delete_prefix_from_prefix_list(ll_t *prefix_list, char *prefix, char mask){
+delete_prefix_from_prefix_list(hash_vector_t *prefix_list, char *prefix, char mask){
 
     prefix_t *old_prefix = NULL;
     common_pfx_key_t key;
     strncpy(key.u.prefix.prefix, prefix, PREFIX_LEN);
     key.u.prefix.prefix[PREFIX_LEN] = '\0';
     key.u.prefix.mask = mask;
-    old_prefix = singly_ll_search_by_key(prefix_list, &key);
+    old_prefix = hash_vector_search_by_key(prefix_list, &key);
     if(!old_prefix)
         return;
-    singly_ll_delete_node_by_data_ptr(prefix_list, old_prefix);
+    hash_vector_remove_ordered_by_data_ptr(prefix_list, old_prefix);
     free_prefix(old_prefix);
     old_prefix = NULL;
 }
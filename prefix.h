@@ -35,9 +35,12 @@
 
 #include "instanceconst.h"
 #include "LinkedListApi.h"
+#include "hash_vector.h"
 #include "igp_sr_ext.h"
 #include "glthread.h"
 
+typedef struct instance_ instance_t;
+
 #define DEFAULT_LOCAL_PREFIX_METRIC         0
 #define DEFAULT_PHYSICAL_INTF_PFX_METRIC    LINK_DEFAULT_METRIC
 
@@ -147,6 +150,7 @@ set_prefix_flag(unsigned int flag);
 
 typedef int (*comparison_fn)(void *, void *);
 typedef int (*order_comparison_fn)(void *, void *);
+typedef uint32_t (*hash_fn)(void *);
 
 comparison_fn
 get_prefix_comparison_fn();
@@ -154,6 +158,13 @@ get_prefix_comparison_fn();
 order_comparison_fn
 get_prefix_order_comparison_fn();
 
+/*Hash fns of a prefix and of its common_pfx_key_t*/
+hash_fn
+get_prefix_hash_fn();
+
+hash_fn
+get_prefix_key_hash_fn();
+
 /*This fn leak the prefix from L2 to L1*/
 prefix_t *
 leak_prefix(char *node_name, char *prefix, char mask, 
@@ -165,20 +176,46 @@ leak_prefix(char *node_name, char *prefix, char mask,
 typedef struct routes_ routes_t;
 
 FLAG
-add_prefix_to_prefix_list(ll_t *prefix_list, prefix_t *prefix, unsigned int hosting_node_metric);
+add_prefix_to_prefix_list(hash_vector_t *prefix_list, prefix_t *prefix, unsigned int hosting_node_metric);
 
 void
-delete_prefix_from_prefix_list(ll_t *prefix_list, char *prefix, char mask);
+delete_prefix_from_prefix_list(hash_vector_t *prefix_list, char *prefix, char mask);
 
 prefix_pref_data_t
 route_preference(FLAG route_flags, LEVEL level);
 
 void
-add_new_prefix_in_list(ll_t *prefix_list , prefix_t *prefix,
+add_new_prefix_in_list(hash_vector_t *prefix_list , prefix_t *prefix,
                 unsigned int prefix_hosting_node_metric);
 
 boolean
 is_node_best_prefix_originator(node_t *node, routes_t *route);
 
+/*Index of the nodes originating a prefix, keyed by the masked prefix,
+ * one per instance. Nodes are indexed when the prefix is added to their
+ * prefix list, and dropped lazily by prefix_originators_lookup() once they no longer
+ * carry it in any level*/
+typedef struct prefix_originator_{
+
+    node_t *node;
+    char prefix[PREFIX_LEN + 1];    /*As in node's prefix list, not masked*/
+    unsigned char mask;
+    struct prefix_originator_ *next;
+} prefix_originator_t;
+
+typedef struct prefix_originators_{
+
+    common_pfx_key_t key;           /*Must be first, hashed as the data*/
+    prefix_originator_t *head;
+} prefix_originators_t;
+
+void
+prefix_originators_add(prefix_t *prefix);
+
+/*Nodes of instance which may originate pfx_key, the caller still
+ * checks the prefix list of the node at the level of interest*/
+prefix_originator_t *
+prefix_originators_lookup(instance_t *instance, common_pfx_key_t *pfx_key);
+
 #endif /* __ROUTES__ */
 
@@ -38,6 +38,7 @@
 #include "bitsop.h"
 #include "spftrace.h"
 #include "routes.h"
+#include "tilfa.h"
 
 extern instance_t *instance;
 
@@ -59,15 +60,13 @@ clear_pq_nodes(node_t *S, LEVEL level){
 void
 init_back_up_computation(node_t *S, LEVEL level){
 
-   singly_ll_node_t* list_node = NULL;
    spf_result_t *res = NULL;
    nh_type_t nh = NH_MAX;
    unsigned int i = 0;
-   ll_t *spf_result = S->spf_run_result[level];
+   hash_vector_t *spf_result = S->spf_run_result[level];
    
-   ITERATE_LIST_BEGIN(spf_result, list_node){
+   ITERATE_HASH_VECTOR_BEGIN(spf_result, res){
        
-       res = (spf_result_t *)list_node->data;
        ITERATE_NH_TYPE_BEGIN(nh){
            if(is_internal_nh_t_empty(res->node->backup_next_hop[level][nh][0]))
                continue;
@@ -76,7 +75,7 @@ init_back_up_computation(node_t *S, LEVEL level){
            }
        } ITERATE_NH_TYPE_END;
        res->backup_requirement[level] = BACKUPS_REQUIRED;
-   } ITERATE_LIST_END;
+   } ITERATE_HASH_VECTOR_END;
    clear_pq_nodes(S, level);
 }
 
@@ -169,7 +168,7 @@ void
 Compute_and_Store_Forward_SPF(node_t *spf_root,
                               LEVEL level){
 
-    spf_computation(spf_root, &spf_root->spf_info, level, FORWARD_RUN, 0);
+    spf_computation(spf_root, &spf_root->spf_info, level, FORWARD_RUN, 0, 0);
 }
 
 
@@ -268,7 +267,6 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
     *P_node = NULL;
 
     edge_t *edge1 = NULL, *edge2 = NULL;
-    singly_ll_node_t *list_node1 = NULL;
 
     unsigned int d_nbr_to_p_node = 0,
                  d_nbr_to_S = 0,
@@ -305,8 +303,7 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
     PN = protected_link->to.node;
 
 
-    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
-        spf_result_p_node = (spf_result_t *)list_node1->data;
+    ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], spf_result_p_node){
         P_node = spf_result_p_node->node;
 
         if(P_node == S || IS_OVERLOADED(P_node, level) ||
@@ -320,10 +317,8 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
 
         d_S_to_p_node = spf_result_p_node->spf_metric;
         d_PN_to_p_node = DIST_X_Y(PN, P_node, level);
-#ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
-                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
+                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level));
 
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
 
@@ -346,11 +341,8 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
             d_PN_to_nbr = DIST_X_Y(PN, nbr_node, level);
 
             if(!(d_S_to_nbr <  d_S_to_PN + d_PN_to_nbr)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s will not be considered for computing P-space," 
-                        "nbr traverses protected link", S->node_name, nbr_node->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s will not be considered for computing P-space," 
+                        "nbr traverses protected link", S->node_name, nbr_node->node_name);
                 ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
             }   
 
@@ -361,66 +353,45 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                 d_PN_to_p_node = DIST_X_Y(PN, P_node, level);
 
                 /*Loop free inequality 1 : N should be Loop free wrt S and PN*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : checking loop free wrt S = %s, Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : checking loop free wrt S = %s, Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
 
                 d_nbr_to_S = DIST_X_Y(nbr_node, S, level);
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
+                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node);
 
                 if(!(d_nbr_to_p_node < d_nbr_to_S + d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : inequality 1 failed, Nbr = %s(oif = %s) is not loop free wrt S", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 1 failed, Nbr = %s(oif = %s) is not loop free wrt S", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name);
                     continue;
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : above inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : above inequality 1 passed", S->node_name);
                 /*Testing Downstream condition : P-node must be downstream node*/
                 if(!(d_nbr_to_p_node < d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name);
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protection inequality for Broadcast link: S = %s, nbr = %s, P_node = %s, PN = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protection inequality for Broadcast link: S = %s, nbr = %s, P_node = %s, PN = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, PN->node_name);
                 /*Node protection criteria for broadcast link should be : Nbr should be able to send traffic to P_node wihout 
                  * passing through any node attached to broadcast segment*/
 
                 if(broadcast_node_protection_critera(S, level, protected_link, P_node, nbr_node) == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality passed", S->node_name);
 
                     rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                     rlfa->lfa_type = BROADCAST_NODE_PROTECTION_RLFA;
                     /*Check for link protection, nbr_node should be loop free wrt to PN*/
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name);
                     /*For link protection, Nbr should be loop free wrt to PN*/
                     if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
                         rlfa->lfa_type = BROADCAST_LINK_AND_NODE_PROTECTION_RLFA;
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide node-link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide node-link protection to S = %s, Nbr = %s(oif=%s)",
+                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                     }
                     rlfa->level = level;     
                     rlfa->oif = &edge1->from;
@@ -438,35 +409,25 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                     ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
                 }
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality failed", S->node_name);
 
                 if(is_link_protection_enabled == FALSE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)", 
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
                 /*P_node could not provide node protection, check for link protection*/
                 if(is_link_protection_enabled == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name);
 
                     /*For link protection, Nbr should be loop free wrt to PN*/
                     if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                         rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                         rlfa->level = level;     
                         rlfa->oif = &edge1->from;
@@ -484,18 +445,14 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                         rlfa->is_eligible = TRUE; /*Not known yet*/
                         ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
                     }
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : candidate P_node = %s do not provide link protection" 
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : candidate P_node = %s do not provide link protection" 
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                 }
             }else if(is_link_protection_enabled == TRUE){
                 if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                     rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                     rlfa->level = level;     
                     rlfa->oif = &edge1->from;
@@ -517,7 +474,7 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                 assert(0);
             }
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, nbr_node, pn_node, level);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }   
 
 /*-----------------------------------------------------------------------------
@@ -538,7 +495,6 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
     *P_node = NULL;
 
     edge_t *edge1 = NULL, *edge2 = NULL;
-    singly_ll_node_t *list_node1 = NULL;
     internal_nh_t *rlfa = NULL;
 
     unsigned int d_nbr_to_p_node = 0,
@@ -575,8 +531,7 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
     E = protected_link->to.node;
     d_S_to_E = DIST_X_Y(S, E, level);
 
-    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
-        spf_result_p_node = (spf_result_t *)list_node1->data;
+    ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], spf_result_p_node){
         P_node = spf_result_p_node->node;
 
         if(P_node == S || IS_OVERLOADED(P_node, level) || 
@@ -592,10 +547,8 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
 
         d_S_to_p_node = spf_result_p_node->spf_metric;
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
-                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
+                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level));
 
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
 
@@ -624,10 +577,8 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
              * not passing through protected-link*/
 
             if(!(d_S_to_nbr <  d_S_to_E + d_E_to_nbr)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s will not be considered for computing P-space," 
-                        "nbr traverses protected link", S->node_name, nbr_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s will not be considered for computing P-space," 
+                        "nbr traverses protected link", S->node_name, nbr_node->node_name);
                 ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
             }
 
@@ -638,51 +589,34 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
                 d_E_to_p_node = DIST_X_Y(E, P_node, level);
 
                 /*Loop free inequality 1 : N should be Loop free wrt S*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : S = %s, Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : S = %s, Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
 
                 d_nbr_to_S = DIST_X_Y(nbr_node, S, level);
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
+                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node);
 
                 if(!(d_nbr_to_p_node < d_nbr_to_S + d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : inequality 1 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 1 failed", S->node_name);
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : above inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : above inequality 1 passed", S->node_name);
 
                 /*Testing Downstream condition : P-node must be downstream node*/
                 if(!(d_nbr_to_p_node < d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name);
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
                 /*condition for node protection RLFA - RFC : 
                  * draft-ietf-rtgwg-rlfa-node-protection-13 - section 2.2.6.2*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protection inequality : S = %s, nbr = %s, P_node = %s, E = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, E->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_E(%u) + d_E_to_p_node(%u)", 
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_E, d_E_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protection inequality : S = %s, nbr = %s, P_node = %s, E = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, E->node_name);
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_E(%u) + d_E_to_p_node(%u)", 
+                        S->node_name, d_nbr_to_p_node, d_nbr_to_E, d_E_to_p_node);
 
                 if(d_nbr_to_p_node < (d_nbr_to_E + d_E_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality passed", S->node_name);
                     /*Node has been added to extended p-space, no need to check for link protection
                      * as node-protecting node in extended pspace is automatically link protecting node for P2P links*/
                     {
@@ -704,23 +638,17 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
                     }
                     ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality failed", S->node_name);
                 if(is_link_protection_enabled == FALSE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)", 
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
                 /*P_node could not provide node protection, check for link protection*/
                 if(is_link_protection_enabled == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Checking if potential P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 
                     if(d_nbr_to_p_node < (d_nbr_to_S + protected_link->metric[level])){
                         {
@@ -740,23 +668,17 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
                             rlfa->dest_metric = 0; /*Not known yet*/ 
                             rlfa->is_eligible = TRUE; /*Not known yet*/
                         }
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); 
-                        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                         ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
                     }
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : candidate P_node = %s do not provide link protection" 
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : candidate P_node = %s do not provide link protection" 
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
                 }
             }
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, nbr_node, pn_node, level);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }   
 
 void
@@ -774,7 +696,6 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
                   *rlfa = NULL;
     
     spf_result_t *D_res = NULL;
-    singly_ll_node_t *list_node1 = NULL;
 
     assert(is_broadcast_link(protected_link, level));
 
@@ -796,9 +717,10 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
         boolean is_dest_impacted = FALSE,
                  mandatory_node_protection = FALSE; 
 
-        ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
+        ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], D_res){
+            if(!IS_BACKUP_DESTINATION(S, D_res->node, level))
+                continue;
             is_dest_impacted = FALSE;
-            D_res = list_node1->data;
 
             /* if RLFA's proxy nbr itself is a destination, then no need to find
              * PQ node for such a destination. p_node->proxy_nbr will surely qualify to be
@@ -819,10 +741,8 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             mandatory_node_protection = FALSE;
             is_dest_impacted = is_destination_impacted(S, protected_link, D_res->node, 
                         level, impact_reason, &mandatory_node_protection);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 
             if(is_dest_impacted == FALSE) continue;
         
@@ -831,28 +751,22 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
                 /*This node cannot provide node protection, check only link protection
                  * p_node should be loop free wrt to PN*/
                 if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     continue;
                 }
                 d_p_to_E = DIST_X_Y(E, p_node->rlfa, level);
                 d_p_to_D = DIST_X_Y(p_node->rlfa, D_res->node, level);
                 d_E_to_D = DIST_X_Y(E, D_res->node, level);
                 if(!(d_p_to_D < d_p_to_E + d_E_to_D)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node",
-                            S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node",
+                            S->node_name, p_node->rlfa->node_name);
                     /*p node fails to provide link protection, this do not qualifies to be pq node*/
                     continue;    
                 }
                 /*Doesnt matter if p_node qualifies node protection criteria, it will be link protecting only*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s qualify as link protection Q node",
-                        S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s qualify as link protection Q node",
+                        S->node_name, p_node->rlfa->node_name);
                 rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
                 //(*(p_node->ref_count))++;
                 copy_internal_nh_t(*p_node, *rlfa);
@@ -863,10 +777,8 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             /*Check if p_node provides node protection*/
             if(broadcast_node_protection_critera(S, level, protected_link, D_res->node, p_node->rlfa) == TRUE){
                 /*This node provides node protection to Destination D*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as node protection Q node for for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as node protection Q node for for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                 
                 /*When tested for P nodes, node protecting p-nodes are automatically link protecting 
                  * p nodes also for given Destination*/
@@ -876,26 +788,18 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
                 continue;
             }
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
-                S->node_name, p_node->rlfa->node_name, D_res->node->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
+                S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
             /*p_node fails to provide node protection, demote the p_node to LINK_PROTECTION
              * if it provides atleast link protection to Destination D*/
             if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                 continue;
             }
 
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : node link degradation is not enabled", S->node_name);
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : node link degradation is not enabled", S->node_name);
                 continue;
             }
 
@@ -903,22 +807,18 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             d_p_to_E = DIST_X_Y(E, p_node->rlfa, level);
             d_E_to_D = DIST_X_Y(E, D_res->node, level);
             if(!(d_p_to_D < d_p_to_E + d_E_to_D)){
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                 continue;
             }
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as link protection Q node"
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as link protection Q node"
                     "Demoted from LINK_NODE_PROTECTION to LINK_PROTECTION PQ node for Dest %s", 
-                     S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                     S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
             rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
             //(*(p_node->ref_count))++;
             copy_internal_nh_t(*p_node, *rlfa);
             rlfa->lfa_type = BROADCAST_LINK_PROTECTION_RLFA;
-        }ITERATE_LIST_END;
+        }ITERATE_HASH_VECTOR_END;
     } 
 }
 
@@ -940,7 +840,6 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                   *rlfa = NULL;
 
     spf_result_t *D_res = NULL;
-    singly_ll_node_t *list_node1 = NULL;
     assert(!is_broadcast_link(protected_link, level));
 
     /*Compute reverse SPF for nodes S and E as roots*/
@@ -959,20 +858,16 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
         d_p_to_S = DIST_X_Y(S, p_node->rlfa, level); 
         d_p_to_E = DIST_X_Y(E, p_node->rlfa, level);
         if(!(d_p_to_E < d_p_to_S + d_S_to_E)){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : p-node %s failed to qualify as link protection Q node",
-                    S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : p-node %s failed to qualify as link protection Q node",
+                    S->node_name, p_node->rlfa->node_name);
             /*p node fails to provide link protection, this do not qualifies to be pq node*/
             p_node->is_eligible = FALSE;
             continue;
         }
 #if 0
         /*Doesnt matter if p_node qualifies node protection criteria, it will be link protecting only*/
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : p-node %s qualify as link protection Q node",
-                S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : p-node %s qualify as link protection Q node",
+                S->node_name, p_node->rlfa->node_name);
 #endif
     }
     for( i = 0; i < MAX_NXT_HOPS; i++){
@@ -988,9 +883,10 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
 
         d_p_to_E = DIST_X_Y(E, p_node->rlfa, level); 
         d_p_to_S = DIST_X_Y(S, p_node->rlfa, level);
-        ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
+        ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], D_res){
+            if(!IS_BACKUP_DESTINATION(S, D_res->node, level))
+                continue;
             is_dest_impacted = FALSE;
-            D_res = list_node1->data;
 
             /*if RLFA's proxy nbr itself is a destination, then no need to find
              * PQ node for such a destination. p_node->proxy_nbr will surely quality to be
@@ -1010,10 +906,8 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
             mandatory_node_protection = FALSE;
             is_dest_impacted = is_destination_impacted(S, protected_link, D_res->node, 
                     level, impact_reason, &mandatory_node_protection);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 
             if(is_dest_impacted == FALSE) continue;
 
@@ -1021,20 +915,14 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
             if(p_node->lfa_type == LINK_AND_NODE_PROTECTION_RLFA){
                 d_p_to_D = DIST_X_Y(p_node->rlfa, D_res->node, level);
                 d_E_to_D = DIST_X_Y(E, D_res->node, level);
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Cheking if Node-protected p-node %s  qualify as node protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_p_to_D(%u) < d_p_to_E(%u) + d_E_to_D(%u)", 
-                            S->node_name, d_p_to_D, d_p_to_E, d_E_to_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Cheking if Node-protected p-node %s  qualify as node protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : d_p_to_D(%u) < d_p_to_E(%u) + d_E_to_D(%u)", 
+                            S->node_name, d_p_to_D, d_p_to_E, d_E_to_D);
                 if(d_p_to_D < d_p_to_E + d_E_to_D){
                     /*This node provides node protection to Destination D*/
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as node protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as node protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     p_node->dest_metric = d_p_to_D;
                     rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
                     //(*(p_node->ref_count))++;
@@ -1042,32 +930,23 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                     continue;
                 }
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                 /*p_node fails to provide node protection, demote the p_node to LINK_PROTECTION
                  * if it provides atleast link protection to Destination D*/
                 if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : node link degradation is not enabled", S->node_name);
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : node link degradation is not enabled", S->node_name);
                     continue;
                 }
 
                 if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     continue;
                 }
                 if(!(d_p_to_D < d_p_to_S + protected_link->metric[level])){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     continue;
                 }
                 p_node->dest_metric = d_p_to_D;
@@ -1075,30 +954,24 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 //(*(p_node->ref_count))++;
                 copy_internal_nh_t(*p_node, *rlfa);
                 rlfa->lfa_type = LINK_PROTECTION_RLFA;
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as link protection Q node"
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as link protection Q node"
                         "Demoted from LINK_AND_NODE_PROTECTION_RLFA to LINK_PROTECTION_RLFA PQ node for Dest %s", 
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
             }else if(p_node->lfa_type == LINK_PROTECTION_RLFA ||
                     p_node->lfa_type == LINK_PROTECTION_RLFA_DOWNSTREAM){
                 if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
                     continue;
                 }
                 if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     continue;
                 }
 
                 d_p_to_D = DIST_X_Y(p_node->rlfa, D_res->node, level);
                 if(!(d_p_to_D < d_p_to_S + protected_link->metric[level])){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
                     continue;
                 }
                 p_node->dest_metric = d_p_to_D;
@@ -1106,14 +979,12 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 //(*(p_node->ref_count))++;
                 copy_internal_nh_t(*p_node, *rlfa);
                 rlfa->lfa_type = LINK_PROTECTION_RLFA;
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : link protected p-node %s qualify as link protection Q node for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : link protected p-node %s qualify as link protection Q node for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
             }else{
                 assert(0);
             }
-        }ITERATE_LIST_END;
+        }ITERATE_HASH_VECTOR_END;
     }
 }
 
@@ -1200,10 +1071,9 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             *edge2 = NULL;
 
     spf_result_t *D_res = NULL;
-    singly_ll_node_t *list_node = NULL;
 
     lfa_type_t lfa_type = UNKNOWN_LFA_TYPE;
-    boolean all_next_hops_node_protecting;
+    boolean all_next_hops_node_protecting = FALSE;
 
 
     nh_type_t nh = NH_MAX, backup_nh_type = NH_MAX;
@@ -1223,30 +1093,27 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
     assert(is_broadcast_link(protected_link, level));
     boolean is_dest_impacted = FALSE,
              mandatory_node_protection = FALSE;
+    boolean srlg_protection = protected_link->n_srlg && 
+        tilfa_is_srlg_protection_enabled(S, protected_link->from.intf_name);
 
     PN = protected_link->to.node;
     Compute_and_Store_Forward_SPF(PN, level);  
 
-    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node){
+    ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], D_res){
 
-        D_res = list_node->data;
         D = D_res->node;
         if(D == S) continue;
+        if(!IS_BACKUP_DESTINATION(S, D, level)) continue;
 
         memset(impact_reason, 0, STRING_REASON_LEN);
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : LFA computation for Destination %s begin", S->node_name, D->node_name); 
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : LFA computation for Destination %s begin", S->node_name, D->node_name);
         
         mandatory_node_protection = FALSE;
         is_dest_impacted = is_destination_impacted(S, protected_link, D, level, impact_reason,
                             &mandatory_node_protection);
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 
         if(is_dest_impacted == FALSE) continue;
         
@@ -1256,68 +1123,52 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, N, pn_node, edge1, edge2, level){
             
             lfa_type = UNKNOWN_LFA_TYPE;
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s, edge2 = %s for LFA candidature",
-                    S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s, edge2 = %s for LFA candidature",
+                    S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
 
             /*Do not consider the link being protected to find LFA*/
             if(edge1 == protected_link){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
-                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
+                goto NBR_PROCESSING_DONE;
+            }
+
+            /*RFC 5286 section 3.5 : SRLG protection, alternate must not
+             * share the risk of the protected link*/
+            if(srlg_protection && is_edges_share_srlg(edge1, protected_link)){
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s shares SRLG with protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
                 goto NBR_PROCESSING_DONE;
             }
 
             if(IS_OVERLOADED(N, level)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", S->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
             dist_N_S = DIST_X_Y(N, S, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s", 
-                    S->node_name, S->node_name, N->node_name, D->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s", 
+                    S->node_name, S->node_name, N->node_name, D->node_name);
 
             dist_N_D = DIST_X_Y(N, D, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
-                    S->node_name, dist_N_D, dist_N_S, dist_S_D); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
+                    S->node_name, dist_N_D, dist_N_S, dist_S_D);
 
             /* Apply inequality 1*/
             if(!(dist_N_D < dist_N_S + dist_S_D)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 1 failed", S->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 1 passed", S->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 passed", S->node_name);
             lfa_type = BROADCAST_LINK_PROTECTION_LFA;
              
             /* Inequality 3 : Node protecting LFA 
              * All primary nexthop MUST qualify node protection inequality # 3*/
             if(IS_LINK_NODE_PROTECTION_ENABLED(protected_link)){
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
-                        S->node_name, D->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
+                        S->node_name, D->node_name, N->node_name);
 
                 all_next_hops_node_protecting = TRUE;
 
@@ -1332,19 +1183,13 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
                         if(dist_N_D < dist_N_E + dist_E_D){
                             //lfa_type = BROADCAST_ONLY_NODE_PROTECTION_LFA;  
-#ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Passed with #%u next hop %s(%s)",
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH"); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Passed with #%u next hop %s(%s)",
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH");
                         }else{
                             all_next_hops_node_protecting = FALSE;
                             //lfa_type = UNKNOWN_LFA_TYPE;
-#ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), ", 
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH"); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), ", 
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH");
                             break;
                         }
                     }
@@ -1374,36 +1219,25 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                 backup_nh->dest_metric = dist_N_D;
                 backup_nh->is_eligible = TRUE;
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s," 
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s," 
                               "looking to promote it to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", N->node_name, 
                         backup_nh->oif->intf_name, backup_nh->node->node_name, 
-                        get_str_lfa_type(backup_nh->lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        get_str_lfa_type(backup_nh->lfa_type));
 
                 /*Check for Link protection criteria*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
-                        S->node_name, dist_N_D, dist_N_PN, dist_PN_D); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
+                        S->node_name, dist_N_D, dist_N_PN, dist_PN_D);
 
                 /*Apply inequality 4*/
                 dist_N_PN = DIST_X_Y(N, PN, level);
                 if(!(dist_N_D < dist_N_PN + dist_PN_D)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 4 failed, LFA not promoted to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", S->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 failed, LFA not promoted to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", S->node_name);
                     goto NBR_PROCESSING_DONE;
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 4 passed, LFA %s(OIF = %s) , Dest = %s promoted from %s to %s", 
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 passed, LFA %s(OIF = %s) , Dest = %s promoted from %s to %s", 
                         S->node_name, N->node_name, backup_nh->oif->intf_name, backup_nh->node->node_name,
                         get_str_lfa_type(backup_nh->lfa_type),
-                        get_str_lfa_type(BROADCAST_LINK_AND_NODE_PROTECTION_LFA)); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        get_str_lfa_type(BROADCAST_LINK_AND_NODE_PROTECTION_LFA));
 
                 backup_nh->lfa_type = BROADCAST_LINK_AND_NODE_PROTECTION_LFA;
                 ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, N, pn_node, level);
@@ -1411,63 +1245,45 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
             /*We are here because LFA is not node protecting, try for link protection LFA only*/
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
-                        S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
+                        S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
            
             if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
-                            S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
+                            S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
             
             if(strict_down_stream_lfa){
                 /* 4. Narrow down the subset further using inequality 2 */
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
-                        S->node_name, dist_N_D, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
+                        S->node_name, dist_N_D, dist_S_D);
 
                 if(!(dist_N_D < dist_S_D)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 2 failed", S->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 failed", S->node_name);
                     goto NBR_PROCESSING_DONE;
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
-                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); 
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
+                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM));
                 lfa_type = LINK_PROTECTION_LFA_DOWNSTREAM;
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
-#endif
             }
 
             /*Now check inequality 4*/ 
             dist_N_PN = DIST_X_Y(N, PN, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
-                    S->node_name, dist_N_D, dist_N_PN, dist_PN_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
+                    S->node_name, dist_N_D, dist_N_PN, dist_PN_D);
 
             /*Apply inequality 4*/
             if(!(dist_N_D < dist_N_PN + dist_PN_D)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 4 failed, LFA candidature failed for nbr %s, Dest = %s",
-                              S->node_name, N->node_name, D->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 failed, LFA candidature failed for nbr %s, Dest = %s",
+                              S->node_name, N->node_name, D->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 4 passed for Nbr %s is LFA for Dest =  %s",
-                        S->node_name, N->node_name, D->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 passed for Nbr %s is LFA for Dest =  %s",
+                        S->node_name, N->node_name, D->node_name);
 
             /*Record the LFA*/
             backup_nh_type = edge1->etype == UNICAST ? IPNH : LSPNH;
@@ -1487,22 +1303,16 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             backup_nh->dest_metric = dist_N_D;
             backup_nh->is_eligible = TRUE;
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
                     backup_nh->oif->intf_name, backup_nh->node->node_name, 
-                    get_str_lfa_type(backup_nh->lfa_type)); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    get_str_lfa_type(backup_nh->lfa_type));
 
 NBR_PROCESSING_DONE:
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
-                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
+                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, N, pn_node, level);
         
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 /* In case of LFAs, the LFA is promoted to Node protecting LFA if they
@@ -1526,8 +1336,7 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
     char impact_reason[STRING_REASON_LEN];
 
     spf_result_t *D_res = NULL;
-    singly_ll_node_t *list_node = NULL;
-    boolean all_next_hops_node_protecting;
+    boolean all_next_hops_node_protecting = FALSE;
 
     unsigned int dist_N_D = 0, 
                  dist_N_S = 0, 
@@ -1539,93 +1348,83 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
     nh_type_t nh = NH_MAX;
     lfa_type_t lfa_type = UNKNOWN_LFA_TYPE;
 
+    boolean srlg_protection = protected_link->n_srlg && 
+        tilfa_is_srlg_protection_enabled(S, protected_link->from.intf_name);
+
     /* 3. Filter nbrs of S using inequality 1 */
     E = protected_link->to.node;
 
-    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node){
-        D_res = list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(S->spf_run_result[level], D_res){
         D = D_res->node;
+        if(!IS_BACKUP_DESTINATION(S, D, level)) continue;
         is_dest_impacted = FALSE;
 
         if(D == S) continue; 
         memset(impact_reason, 0, STRING_REASON_LEN);
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : LFA computation for Destination %s begin for protected link (%s)", 
-            S->node_name, D->node_name, protected_link->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : LFA computation for Destination %s begin for protected link (%s)", 
+            S->node_name, D->node_name, protected_link->from.intf_name);
         
         mandatory_node_protection = FALSE;
         is_dest_impacted = is_destination_impacted(S, protected_link, D, level, impact_reason, 
                              &mandatory_node_protection);
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
                     
         if(is_dest_impacted == FALSE) continue;
 
         dist_S_D = D_res->spf_metric;
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, N, pn_node, edge1, edge2, level){
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1(%s) = %s, edge2(%s) = %s for LFA candidature",
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1(%s) = %s, edge2(%s) = %s for LFA candidature",
                     S->node_name, N->node_name, edge1->status == 1 ? "UP" : "DOWN", 
                     edge1->from.intf_name,
                     edge2->status == 1 ? "UP" : "DOWN", 
-                    edge2->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    edge2->from.intf_name);
             
             /*Do not consider the link being protected to find LFA*/
             if(edge1 == protected_link){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
-                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
+                goto NBR_PROCESSING_DONE;
+            }
+
+            /*RFC 5286 section 3.5 : SRLG protection, alternate must not
+             * share the risk of the protected link*/
+            if(srlg_protection && is_edges_share_srlg(edge1, protected_link)){
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s shares SRLG with protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
                 goto NBR_PROCESSING_DONE;
             }
 
             if(IS_OVERLOADED(N, level)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", 
-                S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", 
+                S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
             dist_N_S = DIST_X_Y(N, S, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s, Primary NH(E) = %s", 
-                    S->node_name, S->node_name, N->node_name, D->node_name, E->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s, Primary NH(E) = %s", 
+                    S->node_name, S->node_name, N->node_name, D->node_name, E->node_name);
 
             dist_N_D = DIST_X_Y(N, D, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
-                    S->node_name, dist_N_D, dist_N_S, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
+                    S->node_name, dist_N_D, dist_N_S, dist_S_D);
 
             /* Apply inequality 1*/
             if(!(dist_N_D < dist_N_S + dist_S_D)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 1 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 passed", S->node_name);
             lfa_type = LINK_PROTECTION_LFA;             
             /* Inequality 3 : Node protecting LFA 
              * All primary nexthop MUST qualify node protection inequality # 3*/
             if(IS_LINK_NODE_PROTECTION_ENABLED(protected_link)){
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
-                        S->node_name, D->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
+                        S->node_name, D->node_name, N->node_name);
 
                 /*N is node protecting LFA if it could send traffic to D without passing
                  * through ALL primary next hops of D*/
@@ -1640,18 +1439,12 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
                         if(dist_N_D < dist_N_E + dist_E_D){
                             //lfa_type = LINK_AND_NODE_PROTECTION_LFA;  
-#ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Passed with #%u next hop %s(%s), lfa_type = %s",
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type)); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Passed with #%u next hop %s(%s), lfa_type = %s",
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type));
                         }else{
                             all_next_hops_node_protecting = FALSE;
-#ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), lfa_type = %s", 
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type)); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), lfa_type = %s", 
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type));
                             break;
                         }
                     }
@@ -1664,11 +1457,9 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
             if(lfa_type == LINK_AND_NODE_PROTECTION_LFA){
                 /*Record the LFA*/ 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s), Dest = %s, lfa_type = %s", N->node_name, 
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s), Dest = %s, lfa_type = %s", N->node_name, 
                         edge1->from.intf_name, D->node_name, 
-                        get_str_lfa_type(lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                        get_str_lfa_type(lfa_type));
 
                 {
                     /*code to record the back up next hop*/
@@ -1695,10 +1486,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             }
 
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
-                        S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
+                        S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
           
@@ -1714,24 +1503,18 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
              * of this inequality at his own will
              * */
             if(mandatory_node_protection == TRUE){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
-                            S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
+                            S->node_name, N->node_name);
                 goto NBR_PROCESSING_DONE;
             }
 
             if(strict_down_stream_lfa){
                 /* 4. Narrow down the subset further using inequality 2 */
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
-                        S->node_name, dist_N_D, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
+                        S->node_name, dist_N_D, dist_S_D);
 
                 if(!(dist_N_D < dist_S_D)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 2 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+                    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 failed", S->node_name);
                     /*We are here because inequality 1 is passed, but 2 and 3 fails*/ 
                     /*Record the LFA*/ 
                     {
@@ -1757,10 +1540,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                     }
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, N, pn_node, level);
                 }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
-                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
-#endif
+                trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
+                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); 
                 lfa_type = LINK_PROTECTION_LFA_DOWNSTREAM;
             }
             
@@ -1787,21 +1568,16 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                 backup_nh->dest_metric = dist_N_D;
                 backup_nh->is_eligible = TRUE;
             }
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
-                    edge1->from.intf_name, D->node_name, get_str_lfa_type(lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+            trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
+                    edge1->from.intf_name, D->node_name, get_str_lfa_type(lfa_type));
 
 NBR_PROCESSING_DONE:
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
-                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
+                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
 
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, N, pn_node, level);
 
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 void 
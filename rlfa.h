@@ -58,6 +58,12 @@ typedef struct _edge_t edge_t;
 #define IS_LINK_NODE_PROTECTION_ENABLED(edge_ptr)               \
     (IS_BIT_SET(edge_ptr->from.edge_config_flags, LINK_NODE_PROTECTION))
 
+/*LFAs and RLFAs are computed for all destinations, unless a PRC
+ * narrows them down to the set of nodes in backup_destinations*/
+#define IS_BACKUP_DESTINATION(S, D, level)                      \
+    (!(S)->backup_destinations[level] ||                        \
+     hash_vector_search_by_key((S)->backup_destinations[level], (D)))
+
 /*Back up SPF options */
 
 /*config node <node-name> backup-spf-options*/
@@ -38,6 +38,8 @@
 #include "igp_sr_ext.h"
 #include "sr_tlv_api.h"
 #include "no_warn.h"
+#include "spfstats.h"
+#include "metrics.h"
 
 extern instance_t *instance;
 
@@ -74,9 +76,6 @@ delete_route(spf_info_t *spf_info, routes_t *route,
              boolean del_from_igp,
              boolean del_from_rib){
 
-    singly_ll_node_t *list_node1 = NULL,
-                     *list_node2 = NULL;
-    
     rt_key_t rt_key;
     boolean is_found = FALSE;
     rtttype_t rt_type = route->rt_type;
@@ -87,15 +86,9 @@ delete_route(spf_info_t *spf_info, routes_t *route,
     strncpy((RT_ENTRY_PFX(&rt_key)), route->rt_key.u.prefix.prefix, PREFIX_LEN);
     RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
     
-    if(del_from_igp){           
-        ITERATE_LIST_BEGIN2(spf_info->routes_list[rt_type], list_node1, list_node2){
-
-            if(list_node1->data == route){
-                ITERATIVE_LIST_NODE_DELETE2(spf_info->routes_list[rt_type], list_node1, list_node2);
-                is_found = TRUE;
-                ITERATE_LIST_BREAK2(spf_info->routes_list[rt_type], list_node1, list_node2);
-            }
-        }ITERATE_LIST_END2(spf_info->routes_list[rt_type], list_node1, list_node2);
+    if(del_from_igp && IS_ROUTE_IN_ROUTE_LIST(route)){
+        ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, rt_type);
+        is_found = TRUE;
     }
 
     if(del_from_rib){
@@ -143,6 +136,25 @@ route_malloc(){
     return route;
 }
 
+/*A prefix advertised by several nodes collects the nexthops of all of
+ * them, the route keeps MAX_NXT_HOPS and the rest are dropped*/
+static metric_t *routes_nexthops_dropped_metric[MAX_LEVEL];
+
+static void
+route_drop_nexthops(routes_t *route, spf_result_t *result,
+                    internal_nh_t *nexthops, unsigned int from,
+                    const char *nh_kind){
+
+    unsigned int i = from;
+
+    while(i < MAX_NXT_HOPS && !is_internal_nh_t_empty(nexthops[i]))
+        i++;
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u has %u %s next hops, %u %s next hops of %s dropped",
+        route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, MAX_NXT_HOPS,
+        nh_kind, i - from, nh_kind, result->node->node_name);
+    metric_counter_add(routes_nexthops_dropped_metric[route->level], i - from);
+}
+
 static void
 merge_route_primary_nexthops(routes_t *route, spf_result_t *result, nh_type_t nh){
 
@@ -156,15 +168,16 @@ merge_route_primary_nexthops(routes_t *route, spf_result_t *result, nh_type_t nh
 
         if(is_internal_nh_exist(route->primary_nh_list[nh], &result->next_hop[nh][i]))
             continue;
+        if(GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]) == MAX_NXT_HOPS){
+            route_drop_nexthops(route, result, result->next_hop[nh], i, "primary");
+            break;
+        }
         int_nxt_hop = XCALLOC(1, internal_nh_t);
         copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
         singly_ll_add_node_by_val(route->primary_nh_list[nh], int_nxt_hop);
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
                      route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->next_hop[nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+                     result->next_hop[nh][i].node->node_name);
     }
 
     assert(GET_NODE_COUNT_SINGLY_LL(route->primary_nh_list[nh]) <= MAX_NXT_HOPS);
@@ -198,29 +211,29 @@ merge_route_backup_nexthops(routes_t *route,
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_LFA_DOWNSTREAM ||
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                             backup->oif->intf_name,
                             next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                             next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                             backup->node ? backup->node->node_name : backup->rlfa->node_name,
                             backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                            backup->protected_link->intf_name); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+                            backup->protected_link->intf_name);
                 continue;
             }
         }
 
+        if(GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]) == MAX_NXT_HOPS){
+            route_drop_nexthops(route, result,
+                result->node->backup_next_hop[route->level][nh], i, "backup");
+            break;
+        }
+
         int_nxt_hop = XCALLOC(1, internal_nh_t);
         copy_internal_nh_t(result->node->backup_next_hop[route->level][nh][i], *int_nxt_hop);
         singly_ll_add_node_by_val(route->backup_nh_list[nh], int_nxt_hop);
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
                      route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->node->backup_next_hop[route->level][nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                     result->node->backup_next_hop[route->level][nh][i].node->node_name);
     }
     assert(GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]) <= MAX_NXT_HOPS);
 }
@@ -264,26 +277,18 @@ search_route_in_spf_route_list(spf_info_t *spf_info,
 
     routes_t *route = NULL;
     singly_ll_node_t* list_node = NULL;
-    char prefix_with_mask[PREFIX_LEN + 1];
+    common_pfx_key_t masked_key;
 
     switch(rt_type){
         case UNICAST_T:
-            apply_mask(common_pfx->u.prefix.prefix, common_pfx->u.prefix.mask, prefix_with_mask);
-            prefix_with_mask[PREFIX_LEN] = '\0';
-            ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
-                route = list_node->data;
-                if(strncmp(route->rt_key.u.prefix.prefix, prefix_with_mask, PREFIX_LEN) == 0 &&
-                        (route->rt_key.u.prefix.mask == common_pfx->u.prefix.mask))
-                    return route;    
-            }ITERATE_LIST_END;
-            break;
+            init_prefix_key(&masked_key, common_pfx->u.prefix.prefix, common_pfx->u.prefix.mask);
+            return hash_vector_search_by_key(spf_info->routes_index, &masked_key);
         case SPRING_T:
-            ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
-                route = list_node->data;
+            ITERATE_ROUTE_LIST_BEGIN(spf_info, rt_type, route){
                 if(route->rt_key.u.label == common_pfx->u.label){
                     return route;
                 }
-            }ITERATE_LIST_END;
+            }ITERATE_ROUTE_LIST_END(spf_info, rt_type);
             break;
         default:
             assert(0);
@@ -294,36 +299,26 @@ search_route_in_spf_route_list(spf_info_t *spf_info,
 static unsigned int
 delete_stale_routes(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
 
-    singly_ll_node_t *list_node1 = NULL, 
-                     *list_node2 = NULL;
-
     routes_t *route = NULL;
     unsigned int i = 0;
 
-#ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "Deleting Stale Routes");
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Deleting Stale Routes");
 
-    ITERATE_LIST_BEGIN2(spf_info->routes_list[rt_type], list_node1, list_node2){
+    /*Iteration is delete safe*/
+    ITERATE_ROUTE_LIST_BEGIN(spf_info, rt_type, route){
 
-        route = list_node1->data;
-        if(route->level != level){
-            ITERATE_LIST_CONTINUE2(spf_info->routes_list[rt_type], list_node1, list_node2);   
-        }
+        if(route->level != level)
+            continue;
 
         if(route->version != spf_info->spf_level_info[level].version){
-#ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix,
-                    route->rt_key.u.prefix.mask, level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+            trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix,
+                    route->rt_key.u.prefix.mask, level);
             i++;
-            singly_ll_delete_node_by_data_ptr(spf_info->priority_routes_list[rt_type], route);
-            ITERATIVE_LIST_NODE_DELETE2(spf_info->priority_routes_list[rt_type], list_node1, list_node2);
+            ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, rt_type);
             free_route(route);
             route = NULL;
         }
-    }ITERATE_LIST_END2(spf_info->routes_list[rt_type], list_node1, list_node2);
+    }ITERATE_ROUTE_LIST_END(spf_info, rt_type);
     return i;
 }
 
@@ -340,9 +335,8 @@ search_route_in_spf_route_list_by_lpm(spf_info_t *spf_info,
     char longest_mask = 0;
     singly_ll_node_t* list_node = NULL;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
+    ITERATE_ROUTE_LIST_BEGIN(spf_info, rt_type, route){
 
-        route = list_node->data;
         if(strncmp("0.0.0.0", route->rt_key.u.prefix.prefix, strlen("0.0.0.0")) == 0 &&
                 route->rt_key.u.prefix.mask == 0){
             default_route = route;
@@ -353,7 +347,7 @@ search_route_in_spf_route_list_by_lpm(spf_info_t *spf_info,
                 lpm_route = route;   
             }
         }
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_LIST_END(spf_info, rt_type);
     return lpm_route ? lpm_route : default_route;
 }
 
@@ -369,12 +363,9 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
     /*Once we implement the proper route installation between IGP and RIB,
      * we dont need to delete route from here anymore*/
     if(route->level != level){
-#ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Node : %s : IGP route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : IGP route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, 
                 route->rt_key.u.prefix.mask, get_str_level(route->level), get_str_level(level));
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
         delete_route(spf_info, route, FALSE, TRUE);   
     }
     else{
@@ -383,11 +374,8 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
 
     //route_set_key(route, prefix->prefix, prefix->mask); 
 
-#ifdef __ENABLE_TRACE__        
-    sprintf(instance->traceopts->b, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
-            route->rt_key.u.prefix.mask, get_str_level(level)); 
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
+            route->rt_key.u.prefix.mask, get_str_level(level));
 
     route->version = spf_info->spf_level_info[level].version;
     route->flags = prefix->prefix_flags;
@@ -421,11 +409,9 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                 int_nxt_hop = XCALLOC(1, internal_nh_t);
                 copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
                 ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
-#ifdef __ENABLE_TRACE__                    
-                sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                        result->next_hop[nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        result->next_hop[nh][i].node->node_name);
             }
             else
                 break;
@@ -442,16 +428,13 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_LFA_DOWNSTREAM ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
-#ifdef __ENABLE_TRACE__                            
-                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                                 backup->oif->intf_name,
                                 next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                                 next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                                 backup->node ? backup->node->node_name : backup->rlfa->node_name,
                                 backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                backup->protected_link->intf_name); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+                                backup->protected_link->intf_name);
                         continue;
                     }
                 }
@@ -459,11 +442,9 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                 int_nxt_hop = XCALLOC(1, internal_nh_t);
                 copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
                 ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
-#ifdef __ENABLE_TRACE__                    
-                sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                        result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        result->node->backup_next_hop[level][nh][i].node->node_name);
             }
             else
                 break;
@@ -491,11 +472,9 @@ link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
 
     new_prefix_pref = route_preference(new_prefix->prefix_flags, new_prefix->level);
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
                  route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(route->level),
-                 new_prefix->prefix, new_prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                 new_prefix->prefix, new_prefix->mask);
 
     if(is_singly_ll_empty(route->like_prefix_list)){
         singly_ll_add_node_by_val(route->like_prefix_list, new_prefix);
@@ -601,17 +580,13 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
 
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
             GET_SPF_INFO_NODE(spf_info, level)->node_name, result->node->node_name, get_topology_name(rt_type),
-            prefix->prefix, get_str_level(level), prefix->metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+            prefix->prefix, get_str_level(level), prefix->metric);
 
     if(prefix->metric == INFINITE_METRIC){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u discarded because of infinite metric", 
-        prefix->prefix, prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "prefix : %s/%u discarded because of infinite metric", 
+        prefix->prefix, prefix->mask);
         return;
     }
 
@@ -619,11 +594,8 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
     route = search_route_in_spf_route_list(spf_info, &comm_pfx_key, rt_type);
 
     if(!route){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
-                prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
+                prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name);
 
         route = route_malloc();
         route_set_key(route, prefix->prefix, prefix->mask); 
@@ -660,11 +632,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     int_nxt_hop = XCALLOC(1, internal_nh_t);
                     copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
                     ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
+                    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
                             GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask ,
-                            result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                            result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level));
                 }
                 else
                     break;
@@ -674,11 +644,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     int_nxt_hop = XCALLOC(1, internal_nh_t);
                     copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
                     ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
+                    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
                             route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                            result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                            result->node->backup_next_hop[level][nh][i].node->node_name);
                 }
                 else
                     break;
@@ -692,48 +660,37 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
         }
 
         ROUTE_ADD_TO_ROUTE_LIST(spf_info, route, rt_type);
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u, level = %u",  
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u, level = %u",  
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                route->spf_metric, route->lsp_metric, route->level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                route->spf_metric, route->lsp_metric, route->level);
     }
     else{
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u existing route. route verion : %u," 
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u existing route. route verion : %u," 
                 "spf version : %u, route level : %s, spf level : %s", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask, route->version, 
-                spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+                spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level));
         if((route->level == level && route->version == spf_info->spf_level_info[level].version)
                 || (route->level != level)){
             /* Over write based on preference now
                Comparison Block Start*/
             
-#ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Trying over-writing route based on preference",
+            trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Trying over-writing route based on preference",
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask);
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
             prefix_pref = route_preference(prefix->prefix_flags, prefix->level);
             route_pref  = route_preference(route->flags, route->level);
 
             if(prefix_pref.pref == ROUTE_UNKNOWN_PREFERENCE){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                        prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                        prefix->prefix, prefix->mask, prefix_pref.pref_str);
                 return;
             }
 
             if(route_pref.pref < prefix_pref.pref){
 
                 /* if existing route is better*/ 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        route_pref.pref_str, prefix_pref.pref_str);
                 /*Linkage*/
                 if(linkage){
                     link_prefix_to_route(route, prefix, result->spf_metric, spf_info);
@@ -743,11 +700,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             /* If new prefix is better*/
             else if(prefix_pref.pref < route_pref.pref){
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        route_pref.pref_str, prefix_pref.pref_str);
 
                 overwrite_route(spf_info, route, prefix, result, level);
                 /*Linkage*/
@@ -759,11 +714,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             /* If prefixes are of same preference*/ 
             else{
                 /* If route pref = prefix pref, then decide based on metric*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
+                trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        route_pref.pref_str, prefix_pref.pref_str);
 
                 /* If the prefix and route are of same pref, both will have internal metric Or both will have external metric*/
                 if(IS_BIT_SET(route->flags, PREFIX_METRIC_TYPE_EXT) && 
@@ -777,32 +730,21 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
                 if(IS_BIT_SET(prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)){
                     /*Decide pref based on external metric*/
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
+                    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Deciding based on External metric",
                             GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
-#endif
 
                     if(prefix->metric < route->ext_metric){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric);
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(prefix->metric > route->ext_metric){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric);
                     }
                     else{
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);
                         /* Union LFA,s RLFA,s Primary nexthops*/
                         ITERATE_NH_TYPE_BEGIN(nh){
                             merge_route_primary_nexthops(route, result, nh);
@@ -817,27 +759,18 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
                 }else{
                     /*Decide pref based on internal metric*/
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Deciding based on Internal metric",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);
                     if(result->spf_metric + prefix->metric < route->spf_metric){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
                                 GET_SPF_INFO_NODE(spf_info, level)->node_name, 
                                 route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                                result->spf_metric + prefix->metric, route->spf_metric);
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(result->spf_metric + prefix->metric == route->spf_metric){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);
                         /* Union LFA,s RLFA,s Primary nexthops*/ 
                         ITERATE_NH_TYPE_BEGIN(nh){
                             merge_route_primary_nexthops(route, result, nh);
@@ -845,12 +778,10 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                         } ITERATE_NH_TYPE_END;
                     }
                     else{
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
                                 GET_SPF_INFO_NODE(spf_info, level)->node_name, 
                                 route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
-#endif
+                                result->spf_metric + prefix->metric, route->spf_metric);
                     }
                     /*Linkage*/
                     if(linkage){
@@ -862,11 +793,8 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             /* Comparison Block Ends*/
         }
         else if(route->level == level && route->version != spf_info->spf_level_info[level].version){
-#ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level)); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+            trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
             overwrite_route(spf_info, route, prefix, result, level);
             /*Linkage*/
             if(linkage){
@@ -914,11 +842,8 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
     spf_result_t *D_res = GET_SPF_RESULT((&S->spf_info), dst_node, level); 
     D_res->backup_requirement[level] = BACKUPS_REQUIRED;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
+    trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
             S->node_name, get_str_level(level), dst_node->node_name);
-    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
     check_next_outer_nh = FALSE;
 
     ITERATE_NH_TYPE_BEGIN(nh){
@@ -967,11 +892,8 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
     if(indep_pr_nh_count == 2){
         D_res->backup_requirement[level] = NO_BACKUP_REQUIRED;
 
-#ifdef __ENABLE_TRACE__                        
-        sprintf(instance->traceopts->b, "Node : %s : Dest %s has independent Primary nexthops at %s",
+        trace_log(instance->traceopts, BACKUP_COMPUTATION_BIT, "Node : %s : Dest %s has independent Primary nexthops at %s",
                 S->node_name, dst_node->node_name, get_str_level(level));
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
         return TRUE;
     }
     return FALSE;
@@ -1067,12 +989,9 @@ refine_route_backups(routes_t *route){
     
     if(is_independant_primary_next_hop_list(route)){
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route %s/%u at %s has independant "
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "route %s/%u at %s has independant "
                 "Primary Nexthops, All backup nexthops deleted", 
-                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);   
-#endif
+                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));   
         ITERATE_NH_TYPE_BEGIN(nh){
             ROUTE_FLUSH_BACKUP_NH_LIST(route, nh);
         } ITERATE_NH_TYPE_END;
@@ -1100,16 +1019,13 @@ refine_route_backups(routes_t *route){
                             backup->lfa_type == LINK_PROTECTION_RLFA_DOWNSTREAM          ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                                 backup->oif->intf_name,
                                 next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                                 next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                                 backup->node ? backup->node->node_name : backup->rlfa->node_name,
                                 backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                backup->protected_link->intf_name); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+                                backup->protected_link->intf_name);
                         XFREE(backup);
                         ITERATIVE_LIST_NODE_DELETE2(route->backup_nh_list[nh], list_node1, prev_list_node);
                     }
@@ -1131,23 +1047,16 @@ build_routing_table(spf_info_t *spf_info,
     spf_result_t *result = NULL,
                  *L1L2_result = NULL;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
-#endif
+    trace_log(instance->traceopts, ROUTE_INSTALLATION_BIT, "Entered ... spf_root : %s, Level : %s", spf_root->node_name, get_str_level(level));
     
     /*Walk over the SPF result list computed in spf run
      * in the same order. Note that order of this list is :
      * most distant router from spf root is first*/
     
-    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
+    ITERATE_HASH_VECTOR_BEGIN(spf_root->spf_run_result[level], result){
 
-        result = (spf_result_t *)list_node->data;
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node %s : processing result of %s, at level %s", 
-            spf_root->node_name, result->node->node_name, get_str_level(level)); 
-        trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
-#endif
+        trace_log(instance->traceopts, ROUTE_INSTALLATION_BIT, "Node %s : processing result of %s, at level %s", 
+            spf_root->node_name, result->node->node_name, get_str_level(level));
 
         /*Iterate over all the prefixes of result->node for level 'level'*/
 
@@ -1158,11 +1067,8 @@ build_routing_table(spf_info_t *spf_info,
                 !spf_root->spf_info.spff_multi_area){                        /* if the computing router is L1-only router*/
 
             L1L2_result = result;                                    /* Record the L1L2 router result*/
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node %s : L1L2_result recorded - %s", 
+            trace_log(instance->traceopts, ROUTE_INSTALLATION_BIT, "Node %s : L1L2_result recorded - %s", 
                             spf_root->node_name, L1L2_result->node->node_name); 
-            trace(instance->traceopts, ROUTE_INSTALLATION_BIT); 
-#endif
 
             prefix_t default_prefix;
             memset(&default_prefix, 0, sizeof(prefix_t)); 
@@ -1177,19 +1083,17 @@ build_routing_table(spf_info_t *spf_info,
         }
 
 
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(result->node, level), prefix_list_node){
+        ITERATE_HASH_VECTOR_BEGIN(GET_NODE_PREFIX_LIST(result->node, level), prefix){
 
-            prefix = (prefix_t *)prefix_list_node->data;  
             update_route(spf_info, result, prefix, level, UNICAST_T, TRUE);
-        }ITERATE_LIST_END;
+        }ITERATE_HASH_VECTOR_END;
 
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 
     /*Iterate over all UPDATED routes and figured out which one needs to be updated
      * in RIB*/
-    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
+    ITERATE_ROUTE_LIST_BEGIN(spf_info, UNICAST_T, route){
 
-        route = list_node->data;
         
         if(route->level != level)
             continue;
@@ -1197,23 +1101,25 @@ build_routing_table(spf_info_t *spf_info,
         if(route->version == spf_info->spf_level_info[level].version)
             refine_route_backups(route);
 
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_LIST_END(spf_info, UNICAST_T);
 }
 
+static void
+routes_stats_add_counters(node_t *spf_root, LEVEL level,
+                          spf_run_counters_t *counters);
+
 void
 spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
                    node_t *spf_root,     /* computing node which stores the result (list) of spf run*/
                    LEVEL level){         /*Level of spf run*/
 
     unsigned int rc = 0; 
+    spf_run_counters_t counters;
     /*-----------------------------------------------------------------------------
      *  If this is L2 run, then set my spf_info_t->spff_multi_area bit, and schedule
      *  SPF L1 run to ensure L1 routes are uptodate before updating L2 routes
      *-----------------------------------------------------------------------------*/
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... ");
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Entered ... ");
        
     if(level == LEVEL2 && spf_info->spf_level_info[LEVEL1].version){
         /*If at least 1 SPF L1 run has been triggered*/
@@ -1227,21 +1133,27 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
         //spf_computation(spf_root, spf_info, LEVEL1, FULL_RUN);
     }
 
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_ROUTE_BUILD);
     build_routing_table(spf_info, spf_root, level);
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_ROUTE_BUILD);
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_STALE_ROUTES);
     rc = delete_stale_routes(spf_info, level, UNICAST_T);
-#ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "No of Unicast stale routes deleted = %u", rc);
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_STALE_ROUTES);
+    memset(&counters, 0, sizeof(spf_run_counters_t));
+    counters.routes_deleted = rc;
+    routes_stats_add_counters(spf_root, level, &counters);
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "No of Unicast stale routes deleted = %u", rc);
     if(is_node_spring_enabled(spf_root, level)){
+        SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_ROUTE_BUILD);
         update_node_segment_routes_for_remote(spf_info, level);
+        SPF_PHASE_END(spf_root, level, SPF_PHASE_ROUTE_BUILD);
+        SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_STALE_ROUTES);
         rc = delete_stale_routes(spf_info, level, SPRING_T);
-#ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "No of SPRING stale routes deleted = %u", rc);
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+        SPF_PHASE_END(spf_root, level, SPF_PHASE_STALE_ROUTES);
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "No of SPRING stale routes deleted = %u", rc);
     }
   
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_RIB_INSTALL);
     /*Flush all Ribs before route installation*/ 
     flush_rib(spf_info->rib[INET_0], level);
     flush_rib(spf_info->rib[INET_3], level);
@@ -1251,6 +1163,7 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
     if(is_node_spring_enabled(spf_root, level)){
         enhanced_start_route_installation(spf_info, level, SPRING_T);   
     }
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_RIB_INSTALL);
 }
 
 internal_nh_t *
@@ -1286,9 +1199,8 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
         printf("Destination           Version        Metric       Level   Gateway            Nxt-Hop                     OIF           protection    Backup Score\n");
         printf("--------------------------------------------------------------------------------------------------------------------------------------------------\n");
 
-        ITERATE_LIST_BEGIN(node->spf_info.routes_list[rt_type], list_node){
+        ITERATE_ROUTE_LIST_BEGIN(&node->spf_info, rt_type, route){
 
-            route = list_node->data;
 
             /*filter*/
             if(prefix){
@@ -1377,7 +1289,7 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
             } ITERATE_NH_TYPE_END;
                 if(prefix)
                     return;
-        }ITERATE_LIST_END;
+        }ITERATE_ROUTE_LIST_END(&node->spf_info, rt_type);
 }
 
 
@@ -1398,22 +1310,15 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
     node_t *spf_root = GET_SPF_INFO_NODE(spf_info, level),
            *D_res = NULL;
 
-#ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", 
+    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Entered ... spf_root : %s, Level : %s", 
         spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
 
-    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
-        result = list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(spf_root->spf_run_result[level], result){
         D_res = result->node;
         
         if(!is_node_spring_enabled(D_res, level)){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
+            trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
                 spf_root->node_name, D_res->node_name, get_str_level(level));
-            trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
             continue;
         }
         
@@ -1423,12 +1328,9 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             prefix_sid = glthread_to_prefix_sid(curr);
             assert(prefix_sid->prefix);
             if(!IS_PREFIX_SR_ACTIVE(prefix_sid->prefix)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
                         spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix), 
-                        D_res->node_name, get_str_level(level)); 
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
+                        D_res->node_name, get_str_level(level));
                 continue;
             }
             
@@ -1437,11 +1339,8 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             igp_route =  search_route_in_spf_route_list(spf_info, &comm_pfx_key, UNICAST_T); 
 
             if(!igp_route || igp_route->level != level){ 
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : IGP route for prefix %s/%u do not exist, Skipping calculation of Spring Route", 
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : IGP route for prefix %s/%u do not exist, Skipping calculation of Spring Route", 
                         spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix));
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                 continue;   
             }
 
@@ -1451,21 +1350,15 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             if(!sr_route){
                 sr_route = route_malloc();
                 ROUTE_ADD_TO_ROUTE_LIST(spf_info, sr_route, SPRING_T);
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New SR route malloc'd for prefix %s/%u",
-                        spf_root->node_name, comm_pfx_key.u.prefix.prefix, comm_pfx_key.u.prefix.mask);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT); 
-#endif
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : New SR route malloc'd for prefix %s/%u",
+                        spf_root->node_name, comm_pfx_key.u.prefix.prefix, comm_pfx_key.u.prefix.mask); 
             }
             else if(sr_route->level != level){
-#ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : SR route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "Node : %s : SR route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
                         spf_root->node_name, sr_route->rt_key.u.prefix.prefix,  sr_route->rt_key.u.prefix.mask,
                         get_str_level(sr_route->level), get_str_level(level));
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
                 /*Delete this SR route from RIB here*/
                 delete_route(spf_info, sr_route, FALSE, TRUE);
-#endif
             }
 
             /*Over write SR properties*/
@@ -1509,7 +1402,7 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             springify_unicast_route(spf_root, (void *)sr_route, prefix_sid->sid.sid);
             
         } ITERATE_GLTHREAD_END(&D_res->prefix_sids_thread_lst[level], curr);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 static void
@@ -1531,16 +1424,92 @@ ldpify_rlfa_nexthop(internal_nh_t *nxthop,
 }
 
 
+static uint32_t
+route_nh_digest(internal_nh_t *nxthop, uint32_t salt){
+
+    uint64_t h = (uintptr_t)nxthop->node ^ ((uint64_t)(uintptr_t)nxthop->oif << 1) ^
+                 ((uint64_t)(uintptr_t)nxthop->rlfa << 2) ^
+                 ((uint64_t)nxthop->lfa_type << 56) ^ salt;
+
+    /*murmur3 finalizer*/
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/*Order independent digest of the metric and nexthops of a route, never 0*/
+static uint32_t
+route_fib_signature(routes_t *route){
+
+    nh_type_t nh;
+    singly_ll_node_t *list_node = NULL;
+    uint32_t sig = (route->spf_metric * 2654435761U) ^ route->ext_metric ^ route->level;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node){
+            sig += route_nh_digest(list_node->data, nh);
+        } ITERATE_LIST_END;
+        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node){
+            sig += route_nh_digest(list_node->data, NH_MAX + nh);
+        } ITERATE_LIST_END;
+    } ITERATE_NH_TYPE_END;
+    return sig ? sig : 1;
+}
+
+static metric_t *routes_added_metric[MAX_LEVEL];
+static metric_t *routes_changed_metric[MAX_LEVEL];
+static metric_t *routes_deleted_metric[MAX_LEVEL];
+
+void
+routes_metrics_init(){
+
+    LEVEL level_it;
+    char labels[METRIC_LABELS_LEN];
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        snprintf(labels, sizeof(labels), "level=\"%u\"", level_it);
+        routes_added_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "routes_added_total", "Unicast routes installed for the first time", labels);
+        routes_changed_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "routes_changed_total", "Unicast routes reinstalled with a new metric or nexthops", labels);
+        routes_deleted_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "routes_deleted_total", "Stale unicast routes deleted", labels);
+        routes_nexthops_dropped_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "routes_nexthops_dropped_total", "Next hops not merged into a route already holding MAX_NXT_HOPS", labels);
+    }
+}
+
+/*Route counters go to the spf-log of the run and to the metrics*/
 static void
-enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
+routes_stats_add_counters(node_t *spf_root, LEVEL level,
+                          spf_run_counters_t *counters){
 
-    /*Unicast (IGPs) protocols installs the routes in inet.0 and inet.3 tables
-     * only. Flush both the tables first*/
+    spf_stats_add_counters(spf_root, level, counters);
+    metric_counter_add(routes_added_metric[level], counters->routes_added);
+    metric_counter_add(routes_changed_metric[level], counters->routes_changed);
+    metric_counter_add(routes_deleted_metric[level], counters->routes_deleted);
+}
 
-    singly_ll_node_t *list_node = NULL,
-    *list_node2 = NULL;
+/*Counts the route as added or changed against what was installed last*/
+static void
+route_account_install(routes_t *route, spf_run_counters_t *counters){
+
+    uint32_t sig = route_fib_signature(route);
+
+    if(!route->fib_sig)
+        counters->routes_added++;
+    else if(route->fib_sig != sig)
+        counters->routes_changed++;
+    route->fib_sig = sig;
+}
+
+/*Unicast (IGPs) protocols installs the routes in inet.0 and inet.3 tables only*/
+static void
+route_install_unicast(spf_info_t *spf_info, routes_t *route, LEVEL level){
+
+    singly_ll_node_t *list_node2 = NULL;
 
-    routes_t *route = NULL;
     nh_type_t nh;
     internal_nh_t *nxthop = NULL;
     internal_un_nh_t *un_nxthop = NULL;
@@ -1548,99 +1517,259 @@ enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
     rt_key_t rt_key;
     boolean is_local_route = FALSE;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
-
-        route = list_node->data;
-        if(route->level != level) continue;
-
-        assert(route->version == spf_info->spf_level_info[level].version);
-
-        memset(&rt_key, 0, sizeof(rt_key_t));
-        strncpy(RT_ENTRY_PFX(&rt_key), route->rt_key.u.prefix.prefix, PREFIX_LEN);
-        RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
+    memset(&rt_key, 0, sizeof(rt_key_t));
+    strncpy(RT_ENTRY_PFX(&rt_key), route->rt_key.u.prefix.prefix, PREFIX_LEN);
+    RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
 
-        /*Handle local routes*/
-        is_local_route = is_route_local(route);
+    /*Handle local routes*/
+    is_local_route = is_route_local(route);
 
-        if(is_local_route){
-            inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, NULL);
-            inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, NULL);
-            continue;
-        }
+    if(is_local_route){
+        inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, NULL);
+        inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, NULL);
+        return;
+    }
 
-        /*Install primary nexthop first. Primary nexthops are inet.0 routes Or RSVP routes (inet.3)*/
-        ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
-                rc = FALSE;
-                if(nh == IPNH){
-                    un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
-                    rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-                    if(rc == FALSE){
-                        free_un_nexthop(un_nxthop);
-                    }
+    /*Install primary nexthop first. Primary nexthops are inet.0 routes Or RSVP routes (inet.3)*/
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
+            nxthop = list_node2->data;
+            rc = FALSE;
+            if(nh == IPNH){
+                un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
+                rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+                if(rc == FALSE){
+                    free_un_nexthop(un_nxthop);
+                }
+            }
+            else{ /*It is RSVP LSP nexthop, which needs to be installed in inet.3 table*/
+                un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_RSVP_NH, route);
+                rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                if(rc == FALSE){
+                    free_un_nexthop(un_nxthop);
+                }
+                #if 0
+                if(is_node_best_prefix_originator(nxthop->node, route)){
+                    /* RSVP nexthop should not be installed in inet.3 table. Instead it should
+                     * be installed in inet.0 table. We will
+                     * revisit this when we shall support RSVP nexthops properly*/
                 }
-                else{ /*It is RSVP LSP nexthop, which needs to be installed in inet.3 table*/
-                    un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_RSVP_NH, route);
+                else{
+                    un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
                     rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
                     if(rc == FALSE){
                         free_un_nexthop(un_nxthop);
                     }
-                    #if 0
-                    if(is_node_best_prefix_originator(nxthop->node, route)){
-                        /* RSVP nexthop should not be installed in inet.3 table. Instead it should
-                         * be installed in inet.0 table. We will
-                         * revisit this when we shall support RSVP nexthops properly*/
-                    }
-                    else{
-                        un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
-                        rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
-                        if(rc == FALSE){
-                            free_un_nexthop(un_nxthop);
-                        }
-                    }
-                    #endif
                 }
-            } ITERATE_LIST_END;
-        } ITERATE_NH_TYPE_END;
+                #endif
+            }
+        } ITERATE_LIST_END;
+    } ITERATE_NH_TYPE_END;
 
 
-        /*Install backup nexthop now. Backup nexthops are inet.0 routes Or RSVP/LDP routes (inet.3)*/
-        ITERATE_NH_TYPE_BEGIN(nh){
-            ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node2){
-                nxthop = list_node2->data;
-                rc = FALSE;
-                if(nh == IPNH){
-                    un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
-                    rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+    /*Install backup nexthop now. Backup nexthops are inet.0 routes Or RSVP/LDP routes (inet.3)*/
+    ITERATE_NH_TYPE_BEGIN(nh){
+        ITERATE_LIST_BEGIN(route->backup_nh_list[nh], list_node2){
+            nxthop = list_node2->data;
+            rc = FALSE;
+            if(nh == IPNH){
+                un_nxthop = inet_0_unifiy_nexthop(nxthop, IGP_PROTO);                
+                rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
+                if(rc == FALSE){
+                    free_un_nexthop(un_nxthop);
+                }
+            }
+            else{ /*backup is either RSVP or LDP nexthop*/
+                if(is_internal_backup_nexthop_rsvp(nxthop)) {
+                    /*ToDo*/
+
+                }else{
+                    /*LDP backup nexthop(RLFAs)*/
+                    prefix_t *prefix = ROUTE_GET_BEST_PREFIX(route);
+                    ldpify_rlfa_nexthop(nxthop, prefix->prefix, prefix->mask);
+                    /*Could not get LDP label, skip installation of this LDP nexthop*/
+                    if(IS_INTERNAL_NH_MPLS_STACK_EMPTY(nxthop))
+                        continue;
+                    un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
+                    if(IS_BIT_SET(un_nxthop->flags, IPV4_LDP_NH))
+                        rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
+                    else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
+                        rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
                     if(rc == FALSE){
                         free_un_nexthop(un_nxthop);
                     }
                 }
-                else{ /*backup is either RSVP or LDP nexthop*/
-                    if(is_internal_backup_nexthop_rsvp(nxthop)) {
-                        /*ToDo*/
-
-                    }else{
-                        /*LDP backup nexthop(RLFAs)*/
-                        prefix_t *prefix = ROUTE_GET_BEST_PREFIX(route);
-                        ldpify_rlfa_nexthop(nxthop, prefix->prefix, prefix->mask);
-                        /*Could not get LDP label, skip installation of this LDP nexthop*/
-                        if(IS_INTERNAL_NH_MPLS_STACK_EMPTY(nxthop))
-                            continue;
-                        un_nxthop = inet_3_unifiy_nexthop(nxthop, IGP_PROTO, IPV4_LDP_NH, route);
-                        if(IS_BIT_SET(un_nxthop->flags, IPV4_LDP_NH))
-                            rc = inet_3_rt_un_route_install_nexthop(spf_info->rib[INET_3], &rt_key, level, un_nxthop);
-                        else if(IS_BIT_SET(un_nxthop->flags, IPV4_NH))
-                            rc = inet_0_rt_un_route_install_nexthop(spf_info->rib[INET_0], &rt_key, level, un_nxthop);
-                        if(rc == FALSE){
-                            free_un_nexthop(un_nxthop);
-                        }
-                    }
-                }
-            } ITERATE_LIST_END;
-        } ITERATE_NH_TYPE_END;
-    } ITERATE_LIST_END;
+            }
+        } ITERATE_LIST_END;
+    } ITERATE_NH_TYPE_END;
+}
+
+static void
+enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
+
+    routes_t *route = NULL;
+    spf_run_counters_t counters;
+
+    memset(&counters, 0, sizeof(spf_run_counters_t));
+
+    ITERATE_ROUTE_LIST_BEGIN(spf_info, UNICAST_T, route){
+
+        if(route->level != level) continue;
+
+        assert(route->version == spf_info->spf_level_info[level].version);
+        route_account_install(route, &counters);
+        route_install_unicast(spf_info, route, level);
+    } ITERATE_ROUTE_LIST_END(spf_info, UNICAST_T);
+    routes_stats_add_counters(GET_SPF_INFO_NODE(spf_info, level), level, &counters);
+}
+
+/*Drops the inet.0 and inet.3 entries of rt_key installed at level*/
+static void
+rib_delete_unicast_entries(spf_info_t *spf_info, rt_key_t *rt_key, LEVEL level){
+
+    rt_un_table_t *rib = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    rib_type_t rib_type[] = {INET_0, INET_3};
+    unsigned int i = 0;
+
+    for(i = 0; i < sizeof(rib_type)/sizeof(rib_type[0]); i++){
+        rib = spf_info->rib[rib_type[i]];
+        rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+        if(rt_un_entry && rt_un_entry->level == level)
+            rib->rt_un_route_delete(rib, rt_key);
+    }
+}
+
+typedef struct prc_originator_{
+
+    spf_result_t *result;
+    prefix_t *prefix;
+    int result_pos;
+    int prefix_pos;
+} prc_originator_t;
+
+static int
+prc_originator_cmp(const void *_originator1, const void *_originator2){
+
+    const prc_originator_t *originator1 = _originator1,
+                           *originator2 = _originator2;
+
+    if(originator1->result_pos != originator2->result_pos)
+        return originator1->result_pos < originator2->result_pos ? -1 : 1;
+    if(originator1->prefix_pos != originator2->prefix_pos)
+        return originator1->prefix_pos < originator2->prefix_pos ? -1 : 1;
+    return 0;
+}
+
+/*Reachable nodes hosting pfx_key at level, with their prefix, in the
+ * order build_routing_table() visits them : order of SPF results, most
+ * distant router first, then order of the prefix list of the node.
+ * Caller frees *originators_out*/
+static unsigned int
+prc_get_prefix_originators(node_t *spf_root, LEVEL level,
+                           common_pfx_key_t *pfx_key,
+                           prc_originator_t **originators_out){
+
+    unsigned int n = 0;
+    prefix_t *prefix = NULL;
+    spf_result_t *result = NULL;
+    prc_originator_t *originators = NULL;
+    prefix_originator_t *originator = NULL,
+                        *head = prefix_originators_lookup(spf_root->instance, pfx_key);
+
+    *originators_out = NULL;
+    for(originator = head; originator; originator = originator->next)
+        n++;
+    if(!n) return 0;
+
+    originators = calloc(n, sizeof(prc_originator_t));
+    n = 0;
+    for(originator = head; originator; originator = originator->next){
+
+        prefix = node_local_prefix_search(originator->node, level,
+                    originator->prefix, originator->mask);
+        if(!prefix) continue;
+        result = hash_vector_search_by_key(spf_root->spf_run_result[level],
+                    originator->node);
+        if(!result) continue;
+        originators[n].result = result;
+        originators[n].prefix = prefix;
+        originators[n].result_pos = hash_vector_get_position(
+                    spf_root->spf_run_result[level], result);
+        originators[n].prefix_pos = hash_vector_get_position(
+                    GET_NODE_PREFIX_LIST(originator->node, level), prefix);
+        n++;
+    }
+    qsort(originators, n, sizeof(prc_originator_t), prc_originator_cmp);
+    *originators_out = originators;
+    return n;
+}
+
+void
+prc_add_prefix_originator_nodes(node_t *spf_root, LEVEL level,
+                        common_pfx_key_t *pfx_key, hash_vector_t *nodes){
+
+    unsigned int n_originators = 0, i = 0;
+    prc_originator_t *originators = NULL;
+
+    n_originators = prc_get_prefix_originators(spf_root, level, pfx_key, &originators);
+    /*Nodes already present are refused*/
+    for(i = 0; i < n_originators; i++)
+        hash_vector_add(nodes, originators[i].result->node);
+    free(originators);
+}
+
+void
+prc_update_prefix_route(spf_info_t *spf_info, node_t *spf_root,
+                        LEVEL level, common_pfx_key_t *pfx_key){
+
+    routes_t *route = NULL;
+    rt_key_t rt_key;
+    uint32_t old_fib_sig = 0;
+    spf_run_counters_t counters;
+    prc_originator_t *originators = NULL;
+    unsigned int n_originators = 0, i = 0;
+
+    memset(&counters, 0, sizeof(spf_run_counters_t));
+    trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "Node : %s : PRC for prefix %s/%u, %s",
+        spf_root->node_name, pfx_key->u.prefix.prefix, pfx_key->u.prefix.mask, get_str_level(level));
+
+    memset(&rt_key, 0, sizeof(rt_key_t));
+    strncpy(RT_ENTRY_PFX(&rt_key), pfx_key->u.prefix.prefix, PREFIX_LEN);
+    RT_ENTRY_MASK(&rt_key) = pfx_key->u.prefix.mask;
+
+    /*The route of this level is rebuilt from scratch, the route of other
+     * level is compared against as build_routing_table() would do*/
+    route = search_route_in_spf_route_list(spf_info, pfx_key, UNICAST_T);
+    if(route && route->level == level){
+        old_fib_sig = route->fib_sig;
+        delete_route(spf_info, route, TRUE, FALSE);
+    }
+    rib_delete_unicast_entries(spf_info, &rt_key, level);
+
+    n_originators = prc_get_prefix_originators(spf_root, level, pfx_key, &originators);
+    for(i = 0; i < n_originators; i++){
+        update_route(spf_info, originators[i].result, originators[i].prefix,
+            level, UNICAST_T, TRUE);
+    }
+    free(originators);
+
+    route = search_route_in_spf_route_list(spf_info, pfx_key, UNICAST_T);
+    if(!route || route->level != level){
+        if(old_fib_sig){
+            counters.routes_deleted++;
+            routes_stats_add_counters(spf_root, level, &counters);
+        }
+        return;
+    }
+
+    refine_route_backups(route);
+    /*Rebuilt route is the same route as far as accounting goes*/
+    if(!route->fib_sig)
+        route->fib_sig = old_fib_sig;
+    route_account_install(route, &counters);
+    route_install_unicast(spf_info, route, level);
+    routes_stats_add_counters(spf_root, level, &counters);
 }
 
 static void
@@ -1659,9 +1788,8 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
     boolean rc = FALSE;
     rt_key_t rt_key;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[SPRING_T], list_node){
+    ITERATE_ROUTE_LIST_BEGIN(spf_info, SPRING_T, route){
         
-        route = list_node->data;
         if(route->level != level) continue;
        
         assert(route->version == spf_info->spf_level_info[level].version);
@@ -1676,13 +1804,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
         ITERATE_LIST_BEGIN(route->primary_nh_list[IPNH], list_node2){
             nxthop = list_node2->data;
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                 continue;
             }
             rc = FALSE;
@@ -1704,13 +1829,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
         ITERATE_LIST_BEGIN(route->backup_nh_list[IPNH], list_node2){
             nxthop = list_node2->data;
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                 continue;
             }
             rc = FALSE;
@@ -1730,13 +1852,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
             if(is_internal_backup_nexthop_rsvp(nxthop))
                 continue; /*ToDo : Support RSVP later . . . */
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || !is_node_spring_enabled(nxthop->rlfa, level) || nxthop->lfa_type == TILFA){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                 continue;
             }
             rc = FALSE;
@@ -1759,13 +1878,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
             ITERATE_LIST_BEGIN(route->primary_nh_list[nh], list_node2){
                 nxthop = list_node2->data;
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
+                    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
                     GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                             get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                             nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                     continue;
                 }
                 rc = FALSE;
@@ -1783,13 +1899,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                 if(is_internal_backup_nexthop_rsvp(nxthop))
                     continue;
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || (nxthop->rlfa && !is_node_spring_enabled(nxthop->rlfa, level))){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
+                    trace_log(instance->traceopts, SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
                     GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                             get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                             nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
-#endif
                     continue;
                 }
                 rc = FALSE;
@@ -1814,7 +1927,7 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                 }
             } ITERATE_LIST_END;
         } ITERATE_NH_TYPE_END;
-    } ITERATE_LIST_END;
+    } ITERATE_ROUTE_LIST_END(spf_info, SPRING_T);
 }
 
 static void
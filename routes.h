@@ -50,7 +50,15 @@ typedef struct routes_{
     ll_t *primary_nh_list[NH_MAX];/*Taking it as a list to accomodate ECMP*/
     ll_t *backup_nh_list[NH_MAX]; /*List of node_t pointers*/
     ll_t *like_prefix_list; 
+    uint32_t fib_sig;                       /*Digest of what was installed last, 0 if never installed*/
+    glthread_t routes_list_glue;            /*Membership in spf_info->routes_list*/
+    glthread_t priority_routes_list_glue;   /*Membership in spf_info->priority_routes_list*/
 } routes_t;
+GLTHREAD_TO_STRUCT(routes_list_glue_to_route, routes_t, routes_list_glue);
+GLTHREAD_TO_STRUCT(priority_routes_list_glue_to_route, routes_t, priority_routes_list_glue);
+
+#define IS_ROUTE_IN_ROUTE_LIST(routeptr)    \
+    ((routeptr)->routes_list_glue.left != NULL)
 
 routes_t *route_malloc();
 
@@ -70,6 +78,17 @@ route_set_key(routes_t *route, char *ipv4_addr, char mask);
 void
 free_route(routes_t *route);
 
+/*PRC of a single prefix : rebuilds the route of pfx_key at level from the
+ * results of last SPF run, and refreshes only its RIB entries*/
+void
+prc_update_prefix_route(spf_info_t *spf_info, node_t *spf_root,
+                        LEVEL level, common_pfx_key_t *pfx_key);
+
+/*Adds every reachable originator of pfx_key at level to nodes*/
+void
+prc_add_prefix_originator_nodes(node_t *spf_root, LEVEL level,
+                        common_pfx_key_t *pfx_key, hash_vector_t *nodes);
+
 #define ROUTE_ADD_NH(_route_nh_list, _internal_nh_t_ptr)     \
     singly_ll_add_node_by_val(_route_nh_list, _internal_nh_t_ptr)
 
@@ -112,13 +131,27 @@ ROUTE_FLUSH_BACKUP_NH_LIST(routes_t *route, nh_type_t nh){
     delete_singly_ll(route->backup_nh_list[nh]);
 }
 
-#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)               \
-    singly_ll_add_node_by_val(spfinfo_ptr->routes_list[topo], routeptr);   \
-    singly_ll_add_node_by_val(spfinfo_ptr->priority_routes_list[topo], routeptr)
+/*Routes are threaded in both lists through their own glue, so unlinking
+ * a route is O(1) and needs no search. Unicast routes are also indexed
+ * by prefix key in routes_index*/
+#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)                              \
+    glthread_add_next(&spfinfo_ptr->routes_list[topo], &routeptr->routes_list_glue);       \
+    glthread_add_next(&spfinfo_ptr->priority_routes_list[topo], &routeptr->priority_routes_list_glue); \
+    if((topo) == UNICAST_T) hash_vector_add(spfinfo_ptr->routes_index, routeptr)
 
 #define ROUTE_DEL_FROM_ROUTE_LIST(spfinfo_ptr, routeptr, topo)    \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->routes_list[topo], routeptr);  \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->priority_routes_list[topo], routeptr)
+    remove_glthread(&routeptr->routes_list_glue);                  \
+    remove_glthread(&routeptr->priority_routes_list_glue);         \
+    if((topo) == UNICAST_T) hash_vector_remove_by_data_ptr(spfinfo_ptr->routes_index, routeptr)
+
+#define ITERATE_ROUTE_LIST_BEGIN(spfinfo_ptr, topo, routeptr)                         \
+    {                                                                                  \
+    glthread_t *_route_glue = NULL;                                                    \
+    ITERATE_GLTHREAD_BEGIN(&(spfinfo_ptr)->routes_list[topo], _route_glue)             \
+        routeptr = routes_list_glue_to_route(_route_glue);
+
+#define ITERATE_ROUTE_LIST_END(spfinfo_ptr, topo)                                     \
+    ITERATE_GLTHREAD_END(&(spfinfo_ptr)->routes_list[topo], _route_glue);}
 
 #define ROUTE_GET_PR_NH_CNT(routeptr, _nh)   \
     GET_NODE_COUNT_SINGLY_LL(routeptr->primary_nh_list[_nh])
@@ -0,0 +1,965 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfbench.c
+ *
+ *    Description:  Benchmark harness : times the phases of SPF route computation on
+ *                  generated or loaded topologies and compares against a baseline
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 23:02:51  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+/* spfbench builds one topology per scenario, then runs FULL_RUN SPF on a
+ * fixed set of roots, every level the root is in, and measures each phase
+ * of the real spf_computation() code path through spf_phase_hook : wall
+ * time, XCALLOC allocations, net bytes and peak RSS. Scenarios are the
+ * cross product of --type x --protection x --nodes, plus one per --file.
+ *
+ * The first --warmup rounds over all roots are not recorded, they populate
+ * the routing tables so that recorded rounds measure steady state runs.
+ * Results are written as CSV or JSON. Given a baseline CSV written by an
+ * earlier run, the per phase averages are compared and the exit status
+ * is 1 if any phase got slower, or allocates more, beyond the threshold.
+ *
+ * Bookkeeping of the harness itself uses malloc, not XCALLOC, so that it
+ * does not show up in the allocation counts it measures*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include "instance.h"
+#include "topogen.h"
+#include "topofile.h"
+#include "spfutil.h"
+#include "spfcomputation.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+
+#define BENCH_MAX_LIST                  16
+#define BENCH_MAX_NAME                  128
+#define BENCH_DEFAULT_ROOTS             4
+#define BENCH_DEFAULT_ITERATIONS        3
+#define BENCH_DEFAULT_WARMUP            1
+#define BENCH_DEFAULT_THRESHOLD_PCT     10.0
+/*Slow downs below this are noise however big in percent*/
+#define BENCH_MIN_REGRESSION_USEC       50.0
+
+/*The build of the topology is reported as one more phase*/
+#define BENCH_PHASE_BUILD               SPF_PHASE_MAX
+#define BENCH_PHASE_MAX                 (SPF_PHASE_MAX + 1)
+
+typedef enum{
+
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} bench_format_t;
+
+typedef struct bench_phase_stats_{
+
+    double *samples_usec;
+    unsigned int n_samples;
+    unsigned int max_samples;
+    double total_usec;
+    uint64_t n_allocs;
+    int64_t n_bytes;                /*net, may go negative*/
+    long peak_rss_kb;
+} bench_phase_stats_t;
+
+typedef struct bench_scenario_{
+
+    char name[BENCH_MAX_NAME];
+    char topology[BENCH_MAX_NAME];
+    const char *protection;
+    unsigned int n_nodes;
+    unsigned int n_links;
+    unsigned int n_prefixes;
+    unsigned int n_roots;
+    bench_phase_stats_t phases[BENCH_PHASE_MAX];
+} bench_scenario_t;
+
+/*Measurement of the phase in progress, and of the run in progress*/
+typedef struct bench_probe_{
+
+    struct timespec start;
+    mm_alloc_stats_t alloc_start;
+    double run_usec;
+    uint64_t run_allocs;
+    int64_t run_bytes;
+    long run_peak_rss_kb;
+    boolean entered;
+} bench_probe_t;
+
+typedef struct bench_config_{
+
+    topogen_type_t types[BENCH_MAX_LIST];
+    unsigned int n_types;
+    topogen_protection_t protections[BENCH_MAX_LIST];
+    unsigned int n_protections;
+    unsigned int sizes[BENCH_MAX_LIST];
+    unsigned int n_sizes;
+    char *files[BENCH_MAX_LIST];
+    unsigned int n_files;
+    topogen_params_t params;
+    unsigned int n_roots;
+    unsigned int iterations;
+    unsigned int warmup;
+    bench_format_t format;
+    char *output;
+    char *baseline;
+    double threshold_pct;
+} bench_config_t;
+
+/*import from mem_init.c*/
+extern void init_memory_manager();
+
+/*Globals */
+instance_t *instance = NULL;
+
+static bench_probe_t bench_probes[BENCH_PHASE_MAX];
+static boolean bench_rss_resettable = TRUE;
+
+static double
+bench_usec_since(struct timespec *start){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e6 +
+        (now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+/* Peak RSS of the process since the last reset, in kB. Writing 5 to
+ * clear_refs resets the peak to the current RSS (Linux 4.0+), where
+ * that is not permitted the peak is over the life of the process*/
+static void
+bench_reset_peak_rss(){
+
+    FILE *fp = NULL;
+
+    if(!bench_rss_resettable)
+        return;
+    fp = fopen("/proc/self/clear_refs", "w");
+    if(!fp || fputs("5", fp) < 0)
+        bench_rss_resettable = FALSE;
+    if(fp)
+        fclose(fp);
+}
+
+static long
+bench_peak_rss_kb(){
+
+    FILE *fp = NULL;
+    char line[128];
+    long kb = -1;
+    struct rusage usage;
+
+    fp = fopen("/proc/self/status", "r");
+    if(fp){
+        while(fgets(line, sizeof(line), fp)){
+            if(strncmp(line, "VmHWM:", 6) == 0){
+                kb = strtol(line + 6, NULL, 10);
+                break;
+            }
+        }
+        fclose(fp);
+    }
+    if(kb >= 0)
+        return kb;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*Counters are read outside of the timed window*/
+static void
+bench_probe_begin(unsigned int phase){
+
+    bench_probe_t *probe = &bench_probes[phase];
+
+    bench_reset_peak_rss();
+    mm_get_alloc_stats(&probe->alloc_start);
+    clock_gettime(CLOCK_MONOTONIC, &probe->start);
+}
+
+static void
+bench_probe_end(unsigned int phase){
+
+    bench_probe_t *probe = &bench_probes[phase];
+    mm_alloc_stats_t alloc_end;
+    long peak_rss_kb = 0;
+
+    probe->run_usec += bench_usec_since(&probe->start);
+    mm_get_alloc_stats(&alloc_end);
+    peak_rss_kb = bench_peak_rss_kb();
+
+    probe->run_allocs += alloc_end.n_allocs - probe->alloc_start.n_allocs;
+    probe->run_bytes += (int64_t)alloc_end.bytes_in_use -
+        (int64_t)probe->alloc_start.bytes_in_use;
+    if(peak_rss_kb > probe->run_peak_rss_kb)
+        probe->run_peak_rss_kb = peak_rss_kb;
+    probe->entered = TRUE;
+}
+
+static void
+bench_spf_phase_hook(node_t *spf_root, LEVEL level,
+                     spf_phase_t phase, boolean end){
+
+    if(end)
+        bench_probe_end(phase);
+    else
+        bench_probe_begin(phase);
+}
+
+static void
+bench_phase_stats_init(bench_phase_stats_t *stats, unsigned int max_samples){
+
+    memset(stats, 0, sizeof(bench_phase_stats_t));
+    stats->max_samples = max_samples;
+    stats->samples_usec = calloc(max_samples, sizeof(double));
+}
+
+/*Fold the measurements of the run just completed into the scenario*/
+static void
+bench_record_run(bench_scenario_t *scenario, boolean record){
+
+    unsigned int phase;
+    bench_probe_t *probe = NULL;
+    bench_phase_stats_t *stats = NULL;
+
+    for(phase = 0; phase < BENCH_PHASE_MAX; phase++){
+
+        probe = &bench_probes[phase];
+        stats = &scenario->phases[phase];
+
+        if(record && probe->entered && stats->n_samples < stats->max_samples){
+            stats->samples_usec[stats->n_samples++] = probe->run_usec;
+            stats->total_usec += probe->run_usec;
+            stats->n_allocs += probe->run_allocs;
+            stats->n_bytes += probe->run_bytes;
+            if(probe->run_peak_rss_kb > stats->peak_rss_kb)
+                stats->peak_rss_kb = probe->run_peak_rss_kb;
+        }
+        memset(probe, 0, sizeof(bench_probe_t));
+    }
+}
+
+static int
+bench_double_comparison_fn(const void *a, const void *b){
+
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/*Nearest rank percentile, samples must be sorted*/
+static double
+bench_percentile(bench_phase_stats_t *stats, unsigned int pct){
+
+    unsigned int rank = 0;
+
+    if(!stats->n_samples)
+        return 0;
+    rank = (stats->n_samples * pct + 99) / 100;
+    if(rank < 1) rank = 1;
+    return stats->samples_usec[rank - 1];
+}
+
+static const char *
+bench_phase_str(unsigned int phase){
+
+    if(phase == BENCH_PHASE_BUILD)
+        return "topology_build";
+    return get_str_spf_phase(phase);
+}
+
+static boolean
+bench_node_has_level(node_t *node, LEVEL level){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    if(node->node_type[level] == PSEUDONODE)
+        return FALSE;
+
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end) break;
+        if(edge_end->dirn != OUTGOING)
+            continue;
+        edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+        if(IS_LEVEL_SET(edge->level, level))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*instance root first, then routers spread evenly over the node list*/
+static unsigned int
+bench_select_roots(node_t **roots, unsigned int n_roots){
+
+    unsigned int i = 0, j = 0, n = 0,
+                 count = HASH_VECTOR_COUNT(instance->instance_node_list);
+    node_t *node = NULL;
+
+    if(instance->instance_root)
+        roots[n++] = instance->instance_root;
+
+    for(i = 1; n < n_roots && i < n_roots * 2; i++){
+
+        node = HASH_VECTOR_DATA(instance->instance_node_list,
+                    (unsigned int)(((uint64_t)count * i) / (n_roots * 2)));
+
+        if(!bench_node_has_level(node, LEVEL1) &&
+            !bench_node_has_level(node, LEVEL2))
+            continue;
+        for(j = 0; j < n; j++){
+            if(roots[j] == node) break;
+        }
+        if(j == n)
+            roots[n++] = node;
+    }
+    return n;
+}
+
+static void
+bench_run_scenario(bench_config_t *config, bench_scenario_t *scenario){
+
+    unsigned int i = 0, round = 0, n_roots = 0, phase;
+    node_t **roots = calloc(config->n_roots, sizeof(node_t *));
+    LEVEL level;
+
+    n_roots = bench_select_roots(roots, config->n_roots);
+    scenario->n_roots = n_roots;
+
+    for(phase = 0; phase < SPF_PHASE_MAX; phase++){
+        bench_phase_stats_init(&scenario->phases[phase],
+            config->iterations * n_roots * 2);
+    }
+
+    spf_phase_hook = bench_spf_phase_hook;
+
+    for(round = 0; round < config->warmup + config->iterations; round++){
+        for(i = 0; i < n_roots; i++){
+            /*L2 first, as run instance sync does*/
+            for(level = LEVEL2; level >= LEVEL1; level--){
+                if(!bench_node_has_level(roots[i], level))
+                    continue;
+                spf_computation(roots[i], &roots[i]->spf_info, level,
+                    FULL_RUN, NULL, NULL);
+                bench_record_run(scenario, round >= config->warmup);
+            }
+        }
+    }
+
+    spf_phase_hook = NULL;
+    free(roots);
+}
+
+static void
+bench_scenario_init(bench_scenario_t *scenario){
+
+    memset(scenario, 0, sizeof(bench_scenario_t));
+    memset(bench_probes, 0, sizeof(bench_probes));
+    bench_phase_stats_init(&scenario->phases[BENCH_PHASE_BUILD], 1);
+}
+
+static boolean
+bench_build_generated(bench_config_t *config, bench_scenario_t *scenario,
+                      topogen_type_t type, topogen_protection_t protection,
+                      unsigned int n_nodes){
+
+    topogen_params_t params = config->params;
+    topogen_stats_t stats;
+
+    params.type = type;
+    params.protection = protection;
+    params.n_nodes = n_nodes;
+
+    bench_scenario_init(scenario);
+    bench_probe_begin(BENCH_PHASE_BUILD);
+    instance = topogen_build(&params, &stats);
+    bench_probe_end(BENCH_PHASE_BUILD);
+    bench_record_run(scenario, TRUE);
+
+    snprintf(scenario->name, BENCH_MAX_NAME, "%s-%s-%u",
+        topogen_type_str(type), topogen_protection_str(protection), n_nodes);
+    snprintf(scenario->topology, BENCH_MAX_NAME, "%s", topogen_type_str(type));
+    scenario->protection = topogen_protection_str(protection);
+    scenario->n_nodes = stats.n_nodes;
+    scenario->n_links = stats.n_links;
+    scenario->n_prefixes = stats.n_prefixes;
+    return TRUE;
+}
+
+static boolean
+bench_build_loaded(bench_scenario_t *scenario, char *file_name){
+
+    topofile_stats_t stats;
+    instance_t *new_instance = NULL;
+    char *base_name = strrchr(file_name, '/');
+
+    base_name = base_name ? base_name + 1 : file_name;
+
+    bench_scenario_init(scenario);
+    bench_probe_begin(BENCH_PHASE_BUILD);
+    new_instance = topofile_load(file_name, &stats);
+    bench_probe_end(BENCH_PHASE_BUILD);
+    bench_record_run(scenario, TRUE);
+
+    if(!new_instance){
+        fprintf(stderr, "Error : could not load topology file %s\n", file_name);
+        return FALSE;
+    }
+    instance = new_instance;
+
+    snprintf(scenario->name, BENCH_MAX_NAME, "file-%s", base_name);
+    snprintf(scenario->topology, BENCH_MAX_NAME, "%s", base_name);
+    scenario->protection = "file";
+    scenario->n_nodes = stats.n_nodes;
+    scenario->n_links = stats.n_links;
+    scenario->n_prefixes = stats.n_prefixes;
+    return TRUE;
+}
+
+static void
+bench_print_progress(bench_scenario_t *scenario){
+
+    unsigned int phase;
+    bench_phase_stats_t *stats = NULL;
+
+    fprintf(stderr, "%s : %u nodes, %u links, %u roots\n", scenario->name,
+        scenario->n_nodes, scenario->n_links, scenario->n_roots);
+
+    for(phase = 0; phase < BENCH_PHASE_MAX; phase++){
+        stats = &scenario->phases[phase];
+        if(!stats->n_samples)
+            continue;
+        fprintf(stderr, "\t%-24s %10.1f usec avg over %u runs\n",
+            bench_phase_str(phase), stats->total_usec / stats->n_samples,
+            stats->n_samples);
+    }
+}
+
+static void
+bench_write_results(FILE *fp, bench_format_t format,
+                    bench_scenario_t *scenarios, unsigned int n_scenarios){
+
+    unsigned int i = 0, phase;
+    boolean first = TRUE;
+    bench_scenario_t *scenario = NULL;
+    bench_phase_stats_t *stats = NULL;
+
+    if(format == BENCH_FORMAT_CSV){
+        fprintf(fp, "scenario,topology,protection,nodes,links,prefixes,roots,"
+            "phase,runs,min_usec,p50_usec,avg_usec,p99_usec,max_usec,"
+            "allocs_per_run,bytes_per_run,peak_rss_kb\n");
+    }
+    else{
+        fprintf(fp, "{\n  \"results\" : [");
+    }
+
+    for(i = 0; i < n_scenarios; i++){
+
+        scenario = &scenarios[i];
+
+        for(phase = 0; phase < BENCH_PHASE_MAX; phase++){
+
+            stats = &scenario->phases[phase];
+            if(!stats->n_samples)
+                continue;
+
+            qsort(stats->samples_usec, stats->n_samples, sizeof(double),
+                bench_double_comparison_fn);
+
+            if(format == BENCH_FORMAT_CSV){
+                fprintf(fp, "%s,%s,%s,%u,%u,%u,%u,%s,%u,%.1f,%.1f,%.1f,%.1f,%.1f,"
+                    "%.1f,%.1f,%ld\n",
+                    scenario->name, scenario->topology, scenario->protection,
+                    scenario->n_nodes, scenario->n_links, scenario->n_prefixes,
+                    scenario->n_roots, bench_phase_str(phase), stats->n_samples,
+                    stats->samples_usec[0], bench_percentile(stats, 50),
+                    stats->total_usec / stats->n_samples,
+                    bench_percentile(stats, 99),
+                    stats->samples_usec[stats->n_samples - 1],
+                    (double)stats->n_allocs / stats->n_samples,
+                    (double)stats->n_bytes / stats->n_samples,
+                    stats->peak_rss_kb);
+                continue;
+            }
+
+            fprintf(fp, "%s\n    {\"scenario\" : \"%s\", \"topology\" : \"%s\", "
+                "\"protection\" : \"%s\", \"nodes\" : %u, \"links\" : %u, "
+                "\"prefixes\" : %u, \"roots\" : %u, \"phase\" : \"%s\", "
+                "\"runs\" : %u, \"min_usec\" : %.1f, \"p50_usec\" : %.1f, "
+                "\"avg_usec\" : %.1f, \"p99_usec\" : %.1f, \"max_usec\" : %.1f, "
+                "\"allocs_per_run\" : %.1f, \"bytes_per_run\" : %.1f, "
+                "\"peak_rss_kb\" : %ld}",
+                first ? "" : ",",
+                scenario->name, scenario->topology, scenario->protection,
+                scenario->n_nodes, scenario->n_links, scenario->n_prefixes,
+                scenario->n_roots, bench_phase_str(phase), stats->n_samples,
+                stats->samples_usec[0], bench_percentile(stats, 50),
+                stats->total_usec / stats->n_samples,
+                bench_percentile(stats, 99),
+                stats->samples_usec[stats->n_samples - 1],
+                (double)stats->n_allocs / stats->n_samples,
+                (double)stats->n_bytes / stats->n_samples,
+                stats->peak_rss_kb);
+            first = FALSE;
+        }
+    }
+
+    if(format == BENCH_FORMAT_JSON)
+        fprintf(fp, "\n  ]\n}\n");
+}
+
+/* Baseline comparison. The baseline is a CSV written by an earlier run,
+ * columns are located by name so that added columns do not break it*/
+static int
+bench_csv_split(char *line, char **fields, int max_fields){
+
+    int n = 0;
+    char *saveptr = NULL,
+         *field = strtok_r(line, ",\r\n", &saveptr);
+
+    while(field && n < max_fields){
+        fields[n++] = field;
+        field = strtok_r(NULL, ",\r\n", &saveptr);
+    }
+    return n;
+}
+
+static int
+bench_csv_column(char **fields, int n_fields, const char *name){
+
+    int i = 0;
+    for(i = 0; i < n_fields; i++){
+        if(strcmp(fields[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bench_phase_stats_t *
+bench_lookup_phase(bench_scenario_t *scenarios, unsigned int n_scenarios,
+                   char *scenario_name, char *phase_name, unsigned int *phase_out){
+
+    unsigned int i = 0, phase;
+
+    for(i = 0; i < n_scenarios; i++){
+        if(strcmp(scenarios[i].name, scenario_name))
+            continue;
+        for(phase = 0; phase < BENCH_PHASE_MAX; phase++){
+            if(strcmp(bench_phase_str(phase), phase_name) == 0 &&
+                scenarios[i].phases[phase].n_samples){
+                *phase_out = phase;
+                return &scenarios[i].phases[phase];
+            }
+        }
+    }
+    return NULL;
+}
+
+static double
+bench_delta_pct(double old_value, double new_value){
+
+    if(old_value <= 0)
+        return new_value > 0 ? 100.0 : 0.0;
+    return (new_value - old_value) * 100.0 / old_value;
+}
+
+/*Returns the number of regressions, -1 if the baseline could not be read*/
+static int
+bench_compare_baseline(bench_config_t *config, bench_scenario_t *scenarios,
+                       unsigned int n_scenarios){
+
+    FILE *fp = fopen(config->baseline, "r");
+    char line[1024];
+    char *fields[32];
+    int n_fields = 0,
+        col_scenario, col_phase, col_avg, col_allocs,
+        n_regressions = 0, n_compared = 0;
+    unsigned int phase;
+    double old_avg, new_avg, old_allocs, new_allocs;
+    boolean slower, more_allocs;
+    bench_phase_stats_t *stats = NULL;
+
+    if(!fp){
+        fprintf(stderr, "Error : could not open baseline %s\n", config->baseline);
+        return -1;
+    }
+
+    if(!fgets(line, sizeof(line), fp)){
+        fprintf(stderr, "Error : baseline %s is empty\n", config->baseline);
+        fclose(fp);
+        return -1;
+    }
+    n_fields = bench_csv_split(line, fields, 32);
+    col_scenario = bench_csv_column(fields, n_fields, "scenario");
+    col_phase = bench_csv_column(fields, n_fields, "phase");
+    col_avg = bench_csv_column(fields, n_fields, "avg_usec");
+    col_allocs = bench_csv_column(fields, n_fields, "allocs_per_run");
+
+    if(col_scenario < 0 || col_phase < 0 || col_avg < 0 || col_allocs < 0){
+        fprintf(stderr, "Error : baseline %s is not a spfbench CSV\n", config->baseline);
+        fclose(fp);
+        return -1;
+    }
+
+    fprintf(stderr, "\nComparison against %s, threshold %.1f%%\n",
+        config->baseline, config->threshold_pct);
+    fprintf(stderr, "%-32s %-24s %12s %12s %8s %12s %12s %8s\n",
+        "Scenario", "Phase", "Base(usec)", "Now(usec)", "Delta",
+        "Base allocs", "Now allocs", "Delta");
+
+    while(fgets(line, sizeof(line), fp)){
+
+        n_fields = bench_csv_split(line, fields, 32);
+        if(n_fields <= col_scenario || n_fields <= col_phase ||
+            n_fields <= col_avg || n_fields <= col_allocs)
+            continue;
+
+        stats = bench_lookup_phase(scenarios, n_scenarios,
+            fields[col_scenario], fields[col_phase], &phase);
+        if(!stats)
+            continue;
+
+        old_avg = strtod(fields[col_avg], NULL);
+        old_allocs = strtod(fields[col_allocs], NULL);
+        new_avg = stats->total_usec / stats->n_samples;
+        new_allocs = (double)stats->n_allocs / stats->n_samples;
+
+        slower = bench_delta_pct(old_avg, new_avg) > config->threshold_pct &&
+            new_avg - old_avg > BENCH_MIN_REGRESSION_USEC;
+        more_allocs = bench_delta_pct(old_allocs, new_allocs) > config->threshold_pct;
+
+        fprintf(stderr, "%-32s %-24s %12.1f %12.1f %7.1f%% %12.1f %12.1f %7.1f%%%s\n",
+            fields[col_scenario], bench_phase_str(phase),
+            old_avg, new_avg, bench_delta_pct(old_avg, new_avg),
+            old_allocs, new_allocs, bench_delta_pct(old_allocs, new_allocs),
+            (slower || more_allocs) ? "  REGRESSION" : "");
+
+        n_compared++;
+        if(slower || more_allocs)
+            n_regressions++;
+    }
+    fclose(fp);
+
+    fprintf(stderr, "%d phases compared, %d regressions\n", n_compared, n_regressions);
+    return n_regressions;
+}
+
+/*Comma separated list of names or numbers, returns count or -1*/
+static int
+bench_parse_list(char *arg, const char *what, unsigned int *values,
+                 unsigned int max_values,
+                 unsigned int (*from_str)(char *, boolean *)){
+
+    int n = 0;
+    boolean ok = TRUE;
+    char *saveptr = NULL,
+         *token = strtok_r(arg, ",", &saveptr);
+
+    while(token){
+        if(n == (int)max_values){
+            fprintf(stderr, "Error : at most %u %s values\n", max_values, what);
+            return -1;
+        }
+        values[n] = from_str(token, &ok);
+        if(!ok){
+            fprintf(stderr, "Error : invalid %s %s\n", what, token);
+            return -1;
+        }
+        n++;
+        token = strtok_r(NULL, ",", &saveptr);
+    }
+    return n;
+}
+
+static unsigned int
+bench_type_from_str(char *str, boolean *ok){
+
+    topogen_type_t type = topogen_type_from_str(str);
+    *ok = type != TOPOGEN_TYPE_MAX;
+    return type;
+}
+
+static unsigned int
+bench_protection_from_str(char *str, boolean *ok){
+
+    topogen_protection_t protection = topogen_protection_from_str(str);
+    *ok = protection != TOPOGEN_PROTECTION_MAX;
+    return protection;
+}
+
+static unsigned int
+bench_uint_from_str(char *str, boolean *ok){
+
+    char *end = NULL;
+    unsigned long value = strtoul(str, &end, 10);
+    *ok = *str && !*end && value > 0;
+    return (unsigned int)value;
+}
+
+static void
+bench_usage(char *prog){
+
+    unsigned int i = 0;
+
+    fprintf(stderr,
+        "Usage : %s [options]\n"
+        "  -t, --type t1,t2,..        generators (default waxman)\n"
+        "  -n, --nodes n1,n2,..       topology sizes (default 50,100,200,400)\n"
+        "  -p, --protection p1,p2,..  none, lfa, rlfa, tilfa (default rlfa,tilfa)\n"
+        "  -f, --file <topo-file>     also bench a saved topology, may repeat\n"
+        "  -e, --ecmp-width <n>       generator ecmp width\n"
+        "  -m, --metric <min>,<max>   generator link metric range\n"
+        "  -x, --prefixes <n>         extra prefixes per router\n"
+        "  -a, --areas <n>            isp areas\n"
+        "  -s, --seed <n>             generator seed (default 1)\n"
+        "      --no-sr                do not enable segment routing\n"
+        "  -r, --roots <n>            SPF roots per scenario (default %u)\n"
+        "  -i, --iterations <n>       recorded rounds over all roots (default %u)\n"
+        "  -w, --warmup <n>           unrecorded rounds first (default %u)\n"
+        "  -o, --format csv|json      output format (default csv)\n"
+        "  -O, --output <file>        results file (default stdout)\n"
+        "  -b, --baseline <csv>       compare against an earlier CSV result\n"
+        "  -T, --threshold <pct>      regression threshold (default %.0f%%)\n"
+        "Generators :",
+        prog, BENCH_DEFAULT_ROOTS, BENCH_DEFAULT_ITERATIONS,
+        BENCH_DEFAULT_WARMUP, BENCH_DEFAULT_THRESHOLD_PCT);
+
+    for(i = 0; i < TOPOGEN_TYPE_MAX; i++)
+        fprintf(stderr, " %s", topogen_type_str(i));
+    fprintf(stderr, "\n");
+}
+
+static int
+bench_parse_args(bench_config_t *config, int argc, char **argv){
+
+    int opt, n;
+    unsigned int value, metric[2];
+    boolean ok = TRUE;
+
+    static struct option long_options[] = {
+        {"type",        required_argument, 0, 't'},
+        {"nodes",       required_argument, 0, 'n'},
+        {"protection",  required_argument, 0, 'p'},
+        {"file",        required_argument, 0, 'f'},
+        {"ecmp-width",  required_argument, 0, 'e'},
+        {"metric",      required_argument, 0, 'm'},
+        {"prefixes",    required_argument, 0, 'x'},
+        {"areas",       required_argument, 0, 'a'},
+        {"seed",        required_argument, 0, 's'},
+        {"no-sr",       no_argument,       0, 'N'},
+        {"roots",       required_argument, 0, 'r'},
+        {"iterations",  required_argument, 0, 'i'},
+        {"warmup",      required_argument, 0, 'w'},
+        {"format",      required_argument, 0, 'o'},
+        {"output",      required_argument, 0, 'O'},
+        {"baseline",    required_argument, 0, 'b'},
+        {"threshold",   required_argument, 0, 'T'},
+        {"help",        no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    memset(config, 0, sizeof(bench_config_t));
+    topogen_init_params(&config->params);
+    config->params.segment_routing = TRUE;
+    config->n_roots = BENCH_DEFAULT_ROOTS;
+    config->iterations = BENCH_DEFAULT_ITERATIONS;
+    config->warmup = BENCH_DEFAULT_WARMUP;
+    config->format = BENCH_FORMAT_CSV;
+    config->threshold_pct = BENCH_DEFAULT_THRESHOLD_PCT;
+
+    while((opt = getopt_long(argc, argv, "t:n:p:f:e:m:x:a:s:r:i:w:o:O:b:T:h",
+                    long_options, NULL)) != -1){
+
+        switch(opt){
+            case 't':
+                if((n = bench_parse_list(optarg, "type", (unsigned int *)config->types,
+                        BENCH_MAX_LIST, bench_type_from_str)) < 0)
+                    return -1;
+                config->n_types = n;
+                break;
+            case 'n':
+                if((n = bench_parse_list(optarg, "node count", config->sizes,
+                        BENCH_MAX_LIST, bench_uint_from_str)) < 0)
+                    return -1;
+                config->n_sizes = n;
+                break;
+            case 'p':
+                if((n = bench_parse_list(optarg, "protection",
+                        (unsigned int *)config->protections,
+                        BENCH_MAX_LIST, bench_protection_from_str)) < 0)
+                    return -1;
+                config->n_protections = n;
+                break;
+            case 'f':
+                if(config->n_files == BENCH_MAX_LIST){
+                    fprintf(stderr, "Error : at most %u files\n", BENCH_MAX_LIST);
+                    return -1;
+                }
+                config->files[config->n_files++] = optarg;
+                break;
+            case 'm':
+                if(bench_parse_list(optarg, "metric", metric, 2,
+                        bench_uint_from_str) != 2 || metric[1] < metric[0]){
+                    fprintf(stderr, "Error : metric range must be <min>,<max>\n");
+                    return -1;
+                }
+                config->params.metric_min = metric[0];
+                config->params.metric_max = metric[1];
+                break;
+            case 'N':
+                config->params.segment_routing = FALSE;
+                break;
+            case 'o':
+                if(strcmp(optarg, "csv") == 0)
+                    config->format = BENCH_FORMAT_CSV;
+                else if(strcmp(optarg, "json") == 0)
+                    config->format = BENCH_FORMAT_JSON;
+                else{
+                    fprintf(stderr, "Error : unknown format %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'O':
+                config->output = optarg;
+                break;
+            case 'b':
+                config->baseline = optarg;
+                break;
+            case 'T':
+                config->threshold_pct = strtod(optarg, NULL);
+                if(config->threshold_pct <= 0){
+                    fprintf(stderr, "Error : threshold must be positive\n");
+                    return -1;
+                }
+                break;
+            case 'e': case 'x': case 'a': case 's':
+            case 'r': case 'i': case 'w':
+                value = bench_uint_from_str(optarg, &ok);
+                /*Zero is a valid prefix and warmup count*/
+                if(!ok && !((opt == 'x' || opt == 'w') && strcmp(optarg, "0") == 0)){
+                    fprintf(stderr, "Error : invalid value %s for -%c\n", optarg, opt);
+                    return -1;
+                }
+                switch(opt){
+                    case 'e': config->params.ecmp_width = value; break;
+                    case 'x': config->params.prefixes_per_node = value; break;
+                    case 'a': config->params.n_areas = value; break;
+                    case 's': config->params.seed = value; break;
+                    case 'r': config->n_roots = value; break;
+                    case 'i': config->iterations = value; break;
+                    case 'w': config->warmup = value; break;
+                }
+                break;
+            default:
+                bench_usage(argv[0]);
+                return -1;
+        }
+    }
+
+    /*Generated scenarios only if asked for, or if nothing else is*/
+    if(!config->n_types && (!config->n_files || config->n_sizes || config->n_protections)){
+        config->types[config->n_types++] = TOPOGEN_WAXMAN;
+    }
+    if(config->n_types && !config->n_sizes){
+        /*TI-LFA grows about cubic with the size, 800 nodes take 10s a run*/
+        config->sizes[config->n_sizes++] = 50;
+        config->sizes[config->n_sizes++] = 100;
+        config->sizes[config->n_sizes++] = 200;
+        config->sizes[config->n_sizes++] = 400;
+    }
+    if(config->n_types && !config->n_protections){
+        config->protections[config->n_protections++] = TOPOGEN_PROTECTION_RLFA;
+        config->protections[config->n_protections++] = TOPOGEN_PROTECTION_TILFA;
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv){
+
+    bench_config_t config;
+    bench_scenario_t *scenarios = NULL;
+    unsigned int n_scenarios = 0, max_scenarios = 0, i, j, k;
+    FILE *fp = stdout;
+    int rc = 0;
+
+    if(bench_parse_args(&config, argc, argv) < 0)
+        return 2;
+
+    /*Generators allocate before they create the instance*/
+    init_memory_manager();
+
+    max_scenarios = config.n_types * config.n_protections * config.n_sizes +
+        config.n_files;
+    scenarios = calloc(max_scenarios, sizeof(bench_scenario_t));
+
+    /*Sizes in the order given, smallest first is the intended use*/
+    for(i = 0; i < config.n_types; i++){
+        for(j = 0; j < config.n_protections; j++){
+            for(k = 0; k < config.n_sizes; k++){
+                bench_build_generated(&config, &scenarios[n_scenarios],
+                    config.types[i], config.protections[j], config.sizes[k]);
+                bench_run_scenario(&config, &scenarios[n_scenarios]);
+                bench_print_progress(&scenarios[n_scenarios]);
+                n_scenarios++;
+            }
+        }
+    }
+
+    for(i = 0; i < config.n_files; i++){
+        if(!bench_build_loaded(&scenarios[n_scenarios], config.files[i]))
+            return 2;
+        bench_run_scenario(&config, &scenarios[n_scenarios]);
+        bench_print_progress(&scenarios[n_scenarios]);
+        n_scenarios++;
+    }
+
+    if(config.output && strcmp(config.output, "-")){
+        fp = fopen(config.output, "w");
+        if(!fp){
+            fprintf(stderr, "Error : could not open %s for writing\n", config.output);
+            return 2;
+        }
+    }
+    bench_write_results(fp, config.format, scenarios, n_scenarios);
+    if(fp != stdout){
+        fclose(fp);
+        fprintf(stderr, "Results written to %s\n", config.output);
+    }
+
+    if(config.baseline){
+        rc = bench_compare_baseline(&config, scenarios, n_scenarios);
+        if(rc < 0)
+            return 2;
+        if(rc > 0)
+            return 1;
+    }
+    return 0;
+}
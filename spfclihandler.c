@@ -47,6 +47,8 @@
 #include "complete_spf_path.h"
 #include "spring_adjsid.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "metrics.h"
+#include "EventDispatcher/event_dispatcher.h"
 
 extern instance_t * instance;
 
@@ -59,15 +61,13 @@ show_mpls_rsvp_label_local_bindings(node_t *node);
 extern void
 transient_mpls_pfe_engine(node_t *node, mpls_label_stack_t *mpls_label_stack,
                           node_t **next_node);
-extern glthread_t *
-tilfa_get_post_convergence_spf_path_head(
-        tilfa_info_t *tilfa_info, LEVEL level);
 
 extern boolean
 tilfa_update_config(node_t *plr_node,
             char *protected_link,
             boolean link_protection,
-            boolean node_protection);
+            boolean node_protection,
+            boolean srlg_protection);
 
 static void
 _run_spf_run_all_nodes(){
@@ -79,12 +79,11 @@ _run_spf_run_all_nodes(){
     /*Ist run LEVEL2 spf run on all nodes, so that L1L2 routers would set multi_area bit appropriately*/
     for(level_it = LEVEL2; level_it >= LEVEL1; level_it--){
 
-        ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-            node = list_node->data;
+        ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
             if(node->node_type[level_it] == PSEUDONODE)
                 continue;
-            spf_computation(node, &node->spf_info, level_it, FULL_RUN, 0);
-        } ITERATE_LIST_END;
+            spf_computation(node, &node->spf_info, level_it, FULL_RUN, 0, 0);
+        } ITERATE_HASH_VECTOR_END;
     }
 }
 
@@ -98,8 +97,7 @@ _reconstruct_all_rsvp_tunnels(){
     rsvp_tunnel_t rsvp_tunnel_data;
     int rc = 0;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
         ITERATE_GLTHREAD_BEGIN(&node->rsvp_config.lspdb, curr){
             rsvp_tunnel = glthread_to_rsvp_tunnel(curr);
             rc = create_targeted_rsvp_tunnel(node, rsvp_tunnel->egress_lsr->router_id, 
@@ -107,7 +105,7 @@ _reconstruct_all_rsvp_tunnels(){
             if(!rc)
                 memcpy(rsvp_tunnel, &rsvp_tunnel_data, sizeof(rsvp_tunnel_t));
         } ITERATE_GLTHREAD_END(&node->rsvp_config.lspdb, curr);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 int
@@ -212,11 +210,10 @@ show_node_spring_details(node_t *node, LEVEL level){
     printf("\t# Mpls labels in Use : %u, Available : %u\n", in_use_count, avail_count);
 
     printf("\tPrefix SID Database :\n");
-    ITERATE_LIST_BEGIN(node->local_prefix_list[level], list_node){
+    ITERATE_HASH_VECTOR_BEGIN(node->local_prefix_list[level], prefix){
     
-        prefix = list_node->data;
         diplay_prefix_sid(prefix);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 void
@@ -274,11 +271,10 @@ display_instance_nodes(param_t *param, ser_buff_t *tlv_buf){
     singly_ll_node_t *list_node = NULL;
     node_t *node = NULL;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
 
-        node = (node_t *)list_node->data;
         printf("    %s\n", node->node_name);
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 }
 
 void
@@ -296,7 +292,7 @@ display_instance_node_interfaces(param_t *param, ser_buff_t *tlv_buf){
             node_name = tlv->value;
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     if(!node)
         return;
 
@@ -453,46 +449,42 @@ show_route_tree_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
      
     switch(cmd_code){
         case CMDCODE_DEBUG_INSTANCE_NODE_ALL_ROUTES:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[UNICAST_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_ROUTE_LIST_BEGIN(&node->spf_info, UNICAST_T, route){
                 dump_route_info(route);
                 printf("\n");
-            }ITERATE_LIST_END;
+            }ITERATE_ROUTE_LIST_END(&node->spf_info, UNICAST_T);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_ROUTE:
             apply_mask(prefix, mask, masked_prefix);
             masked_prefix[PREFIX_LEN] = '\0';
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[UNICAST_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_ROUTE_LIST_BEGIN(&node->spf_info, UNICAST_T, route){
                 if(strncmp(route->rt_key.u.prefix.prefix, masked_prefix, PREFIX_LEN) != 0)
                     continue;
                 dump_route_info(route);
                 break;
-            }ITERATE_LIST_END;
+            }ITERATE_ROUTE_LIST_END(&node->spf_info, UNICAST_T);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_SPRING_ROUTE:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[SPRING_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_ROUTE_LIST_BEGIN(&node->spf_info, SPRING_T, route){
                 apply_mask(prefix, mask, masked_prefix);
                 if(strncmp(route->rt_key.u.prefix.prefix, masked_prefix, PREFIX_LEN) != 0)
                     continue;
                 dump_spring_route_info(route);
                 break;
-            }ITERATE_LIST_END;
+            }ITERATE_ROUTE_LIST_END(&node->spf_info, SPRING_T);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_ALL_SPRING_ROUTES:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[SPRING_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_ROUTE_LIST_BEGIN(&node->spf_info, SPRING_T, route){
                 dump_spring_route_info(route);
                 printf("\n");
-            }ITERATE_LIST_END;
+            }ITERATE_ROUTE_LIST_END(&node->spf_info, SPRING_T);
             break;
         default:
             assert(0);
@@ -510,7 +502,7 @@ insert_lsp_as_forward_adjacency(node_t *ingress_lsr_node,
 
     rsvp_tunnel_t *rsvp_tunnel = look_up_rsvp_tunnel(ingress_lsr_node, lsp_name);
     if(!rsvp_tunnel){
-        printf("Error : RSVP tunnel : %s do not exist, LSP export into IGP failed.\n", rsvp_tunnel->lsp_name);
+        printf("Error : RSVP tunnel : %s do not exist, LSP export into IGP failed.\n", lsp_name);
         return FALSE;
     }
 
@@ -549,7 +541,7 @@ lfa_rlfa_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
     if(node_name == NULL)
         node = instance->instance_root;
     else
-        node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+        node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
         edge_end = node->edges[i];
@@ -574,12 +566,12 @@ lfa_rlfa_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
             case CONFIG_ENABLE: 
                 SET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
                 tilfa_update_config(node, edge_end->intf_name, 
-                    TRUE, DONT_KNOW);
+                    TRUE, DONT_KNOW, DONT_KNOW);
                 break;
             case CONFIG_DISABLE:
                 UNSET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
                 tilfa_update_config(node, edge_end->intf_name, 
-                    FALSE, DONT_KNOW);
+                    FALSE, DONT_KNOW, DONT_KNOW);
                 break;
             default:
                 assert(0);
@@ -591,12 +583,27 @@ lfa_rlfa_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
                 SET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
                 SET_LINK_PROTECTION_TYPE(edge, LINK_NODE_PROTECTION);
                 tilfa_update_config(node, edge_end->intf_name, 
-                    DONT_KNOW, TRUE);
+                    DONT_KNOW, TRUE, DONT_KNOW);
                 break;
             case CONFIG_DISABLE:
                 UNSET_LINK_PROTECTION_TYPE(edge, LINK_NODE_PROTECTION);
                 tilfa_update_config(node, edge_end->intf_name, 
-                    DONT_KNOW, FALSE);
+                    DONT_KNOW, FALSE, DONT_KNOW);
+                break;
+            default:
+                assert(0);
+        }
+        break;
+        case CMDCODE_CONFIG_INTF_SRLG_PROTECTION:
+        switch(enable_or_disable){
+            case CONFIG_ENABLE: 
+                SET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
+                tilfa_update_config(node, edge_end->intf_name, 
+                    TRUE, DONT_KNOW, TRUE);
+                break;
+            case CONFIG_DISABLE:
+                tilfa_update_config(node, edge_end->intf_name, 
+                    DONT_KNOW, DONT_KNOW, FALSE);
                 break;
             default:
                 assert(0);
@@ -673,7 +680,7 @@ debug_show_node_impacted_destinations(param_t *param, ser_buff_t *tlv_buf, op_mo
           assert(0);
   } TLV_LOOP_END;
   
-  node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+  node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
   
   for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
       edge_end = node->edges[i];
@@ -710,14 +717,13 @@ debug_show_node_impacted_destinations(param_t *param, ser_buff_t *tlv_buf, op_mo
 
     printf("Destination                 Is Impacted             Reason\n");
     printf("=============================================================\n");
-    ITERATE_LIST_BEGIN(node->spf_run_result[level_it], list_node){
-        D_res = list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(node->spf_run_result[level_it], D_res){
         memset(impact_reason , 0 , 256);
         MANDATORY_NODE_PROTECTION = TRUE;
         is_impacted = is_destination_impacted(node, edge, D_res->node, level_it, impact_reason,
                         &MANDATORY_NODE_PROTECTION);
         printf(" %-20s     %-15s   %s\n", D_res->node->node_name, is_impacted ? "IMPACTED" : "NOT IMPACTED", impact_reason);
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
   }
   return 0;
 }
@@ -779,9 +785,9 @@ debug_show_node_back_up_spf_results(param_t *param,
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     if(dst_name)
-        dst_filter = (node_t *)singly_ll_search_by_key(instance->instance_node_list, dst_name);
+        dst_filter = (node_t *)hash_vector_search_by_key(instance->instance_node_list, dst_name);
     
     internal_nh_t *nxthop = NULL;
 
@@ -819,8 +825,7 @@ debug_show_node_back_up_spf_results(param_t *param,
 
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
         printf("\n%s backup spf results\n\n", get_str_level(level_it));
-        ITERATE_LIST_BEGIN(node->spf_run_result[level_it], list_node){
-            D_res = list_node->data;
+        ITERATE_HASH_VECTOR_BEGIN(node->spf_run_result[level_it], D_res){
             D = D_res->node;
             printf("Dest : %s (#IP back-ups = %u, #LSP back-ups = %u)\n", 
                     D->node_name, 
@@ -842,7 +847,7 @@ debug_show_node_back_up_spf_results(param_t *param,
                     printf("\n");           
                 }
             } ITERATE_NH_TYPE_END;
-        } ITERATE_LIST_END;
+        } ITERATE_HASH_VECTOR_END;
     }
     return 0;
 }
@@ -881,7 +886,7 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     cmd_code = EXTRACT_CMD_CODE(tlv_buf);
 
@@ -985,30 +990,33 @@ instance_node_spring_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode
 void
 show_spf_path_predecessors(node_t *spf_root, LEVEL level){
 
-    glthread_t *curr = NULL, *curr2 = NULL;
-    glthread_t *pred_db = NULL;
-    spf_path_result_t *spf_path_result = NULL;
+    uint32_t i = 0;
+    node_t *node = NULL;
+    spf_path_dag_pred_t *pred = NULL;
+    spf_path_dag_t *dag = spf_path_dag_get(spf_root, level, TRUE);
 
     //compute_spf_paths(spf_root, level, FULL_RUN);
 
-        ITERATE_GLTHREAD_BEGIN(
-            tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level), curr){
+    if(!dag) return;
+
+    printf("DAG : nodes = %u, predecessors = %u\n", dag->n_nodes, dag->n_preds);
+
+    for(i = 0; i < dag->n_nodes; i++){
 
-            spf_path_result = glthread_to_spf_path_result(curr);
+        node = dag->nodes[i];
+        if(!node) continue;
 
-            printf("Node : %s, %s pred db\n", spf_path_result->node->node_name,
-                    get_str_level(level));
+        printf("Node : %s, %s pred db\n", node->node_name,
+                get_str_level(level));
 
-            pred_db = &spf_path_result->pred_db;
+        ITERATE_SPF_PATH_DAG_PREDS_BEGIN(dag, node, pred){
 
-            ITERATE_GLTHREAD_BEGIN(pred_db, curr2){
-                pred_info_t *pred_info = glthread_to_pred_info(curr2);
-                printf("\tNode-name = %s, oif = %s, gw-prefix = %s\n",
-                        pred_info->node->node_name,
-                        pred_info->oif->intf_name,
-                        pred_info->gw_prefix);
-            } ITERATE_GLTHREAD_END(pred_db, curr2);
-        } ITERATE_GLTHREAD_END(&spf_root->tilfa_info->post_convergence_spf_path, curr);
+            printf("\tNode-name = %s, oif = %s, gw-prefix = %s\n",
+                    SPF_PATH_DAG_PRED_NODE(dag, pred)->node_name,
+                    pred->oif->intf_name,
+                    pred->gw_prefix);
+        } ITERATE_SPF_PATH_DAG_PREDS_END;
+    }
 }
 
 
@@ -1037,7 +1045,7 @@ instance_node_spring_show_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     switch(cmd_code){
         case CMDCODE_SHOW_NODE_INTF_ADJ_SIDS:
@@ -1138,7 +1146,7 @@ debug_trace_mpls_stack_label(param_t *param, ser_buff_t *tlv_buf, op_mode enable
     for(; i >= 0; i-- )
         PUSH_MPLS_LABEL(mpls_label_stack, label[i]);
     
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     transient_mpls_pfe_engine(node, mpls_label_stack, &next_node);
     free_mpls_label_stack(mpls_label_stack); 
     return 0;
@@ -1164,7 +1172,7 @@ instance_node_ldp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
      
     switch(cmd_code){
         case CMDCODE_CONFIG_NODE_ENABLE_LDP:
@@ -1212,7 +1220,7 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
      
     switch(cmd_code){
         case CMDCODE_CONFIG_NODE_ENABLE_RSVP:
@@ -1242,7 +1250,7 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
             }
             rsvp_tunnel = XCALLOC(1, rsvp_tunnel_t);
             memcpy(rsvp_tunnel, &rsvp_tunnel_data, sizeof(rsvp_tunnel_t));
-            strncpy(rsvp_tunnel->lsp_name, rsvp_lsp_name, RSVP_LSP_NAME_SIZE);
+            strncpy(rsvp_tunnel->lsp_name, rsvp_lsp_name, RSVP_LSP_NAME_SIZE - 1);
             rc = add_new_rsvp_tunnel(node, rsvp_tunnel);
             if(rc == -1){
                 XFREE(rsvp_tunnel);
@@ -1270,7 +1278,7 @@ clear_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_
              assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     switch(cmd_code){
         case CMDCODE_CLEAR_NODE_ROUTE_DB:
@@ -1282,6 +1290,133 @@ clear_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_
     return 0;
 }
 
+int
+instance_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    tlv_struct_t *tlv = NULL;
+    unsigned int lsp_pacing_msec = 0,
+                 max_wait_msec = 0,
+                 initial_wait_msec = 0,
+                 second_wait_msec = 0,
+                 base_usec = 0,
+                 per_node_usec = 0,
+                 proc_usec = 0,
+                 lsp_size = 0,
+                 per_route_usec = 0,
+                 interval_sec = 0;
+    char *model_name = NULL,
+         *file_name = NULL;
+    int spf_delay_model = -1;
+    flood_sim_config_t *flood_sim_config = &instance->flood_sim_config;
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "lsp-pacing", strlen("lsp-pacing")) ==0)
+            lsp_pacing_msec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "max-wait", strlen("max-wait")) ==0)
+            max_wait_msec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "initial-wait", strlen("initial-wait")) ==0)
+            initial_wait_msec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "second-wait", strlen("second-wait")) ==0)
+            second_wait_msec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "model-name", strlen("model-name")) ==0)
+            model_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "base-usec", strlen("base-usec")) ==0)
+            base_usec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "per-node-usec", strlen("per-node-usec")) ==0)
+            per_node_usec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "proc-usec", strlen("proc-usec")) ==0)
+            proc_usec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "lsp-size", strlen("lsp-size")) ==0)
+            lsp_size = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "per-route-usec", strlen("per-route-usec")) ==0)
+            per_route_usec = (unsigned int)atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "interval-sec", strlen("interval-sec")) ==0)
+            interval_sec = (unsigned int)atoi(tlv->value);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_CONFIG_INSTANCE_LSP_PACING:
+            instance->lsp_pacing_msec = (enable_or_disable == CONFIG_DISABLE) ?
+                0 : lsp_pacing_msec;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL:
+            if(enable_or_disable == CONFIG_DISABLE){
+                instance->spf_max_wait_msec = 0;
+                instance->spf_initial_wait_msec = 0;
+                instance->spf_second_wait_msec = 0;
+                break;
+            }
+            if(initial_wait_msec > max_wait_msec || second_wait_msec > max_wait_msec){
+                printf("Error : initial-wait and second-wait must not exceed max-wait\n");
+                return -1;
+            }
+            /*second-wait is doubled per run, 0 would never back off*/
+            if(max_wait_msec && second_wait_msec < EV_DIS_TIMER_TICK_MSEC){
+                printf("Error : second-wait must be at least %u msec\n",
+                    EV_DIS_TIMER_TICK_MSEC);
+                return -1;
+            }
+            instance->spf_max_wait_msec = max_wait_msec;
+            instance->spf_initial_wait_msec = initial_wait_msec;
+            instance->spf_second_wait_msec = second_wait_msec;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM:
+            flood_sim_config->enabled = (enable_or_disable == CONFIG_DISABLE) ? FALSE : TRUE;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_MODEL:
+            if(enable_or_disable == CONFIG_DISABLE)
+                model_name = "nlogn";
+            spf_delay_model = flood_sim_get_spf_delay_model(model_name);
+            if(spf_delay_model < 0){
+                printf("Error : Unknown spf delay model %s\n", model_name);
+                return -1;
+            }
+            flood_sim_config->spf_delay_model = (unsigned int)spf_delay_model;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_PARAMS:
+            flood_sim_config->spf_base_usec = (enable_or_disable == CONFIG_DISABLE) ?
+                FLOOD_SIM_DEFAULT_SPF_BASE_USEC : base_usec;
+            flood_sim_config->spf_per_node_usec = (enable_or_disable == CONFIG_DISABLE) ?
+                FLOOD_SIM_DEFAULT_SPF_PER_NODE_USEC : per_node_usec;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_PROC_DELAY:
+            flood_sim_config->lsp_proc_usec = (enable_or_disable == CONFIG_DISABLE) ?
+                FLOOD_SIM_DEFAULT_LSP_PROC_USEC : proc_usec;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_SIZE:
+            flood_sim_config->lsp_size = (enable_or_disable == CONFIG_DISABLE) ?
+                FLOOD_SIM_DEFAULT_LSP_SIZE : lsp_size;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_FIB_DELAY:
+            flood_sim_config->fib_per_route_usec = (enable_or_disable == CONFIG_DISABLE) ?
+                FLOOD_SIM_DEFAULT_FIB_PER_ROUTE_USEC : per_route_usec;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_METRICS_EXPORT:
+            if(enable_or_disable == CONFIG_DISABLE){
+                metrics_export_stop();
+                break;
+            }
+            if(!file_name){
+                printf("Error : file-name required\n");
+                return -1;
+            }
+            if(metrics_export_start(file_name, interval_sec) < 0){
+                printf("Error : Could not write metrics to %s\n", file_name);
+                return -1;
+            }
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
+
 int
 validate_static_adjsid_label_range(char *value){
 
@@ -1293,7 +1428,7 @@ node_slot_adj_sid_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
 
     char *node_name = NULL;
     char *intf_name = NULL;
-    LEVEL level;
+    LEVEL level = MAX_LEVEL;
     tlv_struct_t *tlv = NULL;
     char *router_id = NULL;
     unsigned int label = 0;
@@ -1318,7 +1453,7 @@ node_slot_adj_sid_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
 
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     set_adj_sid(node, intf_name, level, label, router_id, cmd_code);
     return 0;
 }
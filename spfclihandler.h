@@ -128,4 +128,7 @@ node_slot_adj_sid_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
 
 int
 validate_static_adjsid_label_range(char *value);
+
+int
+instance_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
 #endif /* __SPFCLIHANDLER__ */
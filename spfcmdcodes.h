@@ -186,4 +186,59 @@
 #define CMDCODE_CONFIG_SRTE_POLICY_TO_ADDR                  117 /*config node <node-name> spring spring-path <path-name> to <ip-addr>*/
 #define CMDCODE_CONFIG_SRTE_TUNNEL_MEMBER_SEG_LST           118 /*config node <node-name> spring spring-path <path-name> primary <seg-lst-name>*/
 #define CMDCODE_CONFIG_SRTE_SEG_LST                         119 /*config node <node-name> spring segment-list <seg-lst-name> <hope-name> [label | ip-address] <value>*/
+
+/*Lazy TILFA*/
+#define CMDCODE_CONFIG_NODE_TILFA_LAZY                      120 /*config node <node-name> backup-spf-options tilfa-lazy*/
+#define CMDCODE_CONFIG_NODE_TILFA_LAZY_TIME_BUDGET          121 /*config node <node-name> backup-spf-options tilfa-lazy time-budget <msec>*/
+#define CMDCODE_CONFIG_NODE_TILFA_DEST_PRIORITY             122 /*config node <node-name> backup-spf-options tilfa-priority <high | medium | low>*/
+
+/*SRLG*/
+#define CMDCODE_CONFIG_NODE_SLOT_SRLG                       123 /*config node <node-name> interface <slot-no> srlg <srlg-id>*/
+#define CMDCODE_CONFIG_INTF_SRLG_PROTECTION                 124 /*config node <node-name> interface <slot-no> link-protection srlg*/
+
+/*Memory Manager instrumentation*/
+#define CMDCODE_DEBUG_SHOW_MEMORY_USAGE_STATS               125 /*debug show mem-usage stats*/
+#define CMDCODE_DEBUG_SHOW_MEMORY_USAGE_CALL_SITES          126 /*debug show mem-usage call-sites*/
+#define CMDCODE_DEBUG_SHOW_MEMORY_USAGE_LEAKS               127 /*debug show mem-usage leaks*/
+#define CMDCODE_DEBUG_MEMORY_USAGE_SNAPSHOT                 128 /*debug mem-usage snapshot*/
+#define CMDCODE_DEBUG_MEMORY_USAGE_CALL_SITE_TRACKING       129 /*debug mem-usage call-sites <enable | disable>*/
+
+/*Instance wide config*/
+#define CMDCODE_CONFIG_INSTANCE_LSP_PACING                  130 /*config instance lsp-pacing <msec>*/
+
+/*Binary trace ring*/
+#define CMDCODE_DEBUG_LOG_RING_ENABLE_DISABLE               131 /*debug log enable|disable ring*/
+#define CMDCODE_DEBUG_LOG_RING_DUMP                         132 /*debug log dump <file-name>*/
+
+#define CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL                133 /*config instance spf-interval <max-wait> <initial-wait> <second-wait>*/
+
+/*Flood simulator*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM                   134 /*config instance flood-sim*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_MODEL   135 /*config instance flood-sim spf-delay-model <model-name>*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_PARAMS  136 /*config instance flood-sim spf-delay-params <base-usec> <per-node-usec>*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_PROC_DELAY    137 /*config instance flood-sim lsp-proc-delay <proc-usec>*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_SIZE          138 /*config instance flood-sim lsp-size <lsp-size>*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_FIB_DELAY         139 /*config instance flood-sim fib-delay <per-route-usec>*/
+#define CMDCODE_CONFIG_NODE_SLOT_DELAY                      140 /*config node <node-name> interface <slot-no> delay <delay-usec>*/
+#define CMDCODE_RUN_INSTANCE_FLOOD_SIM_LINK_FAILURE         141 /*run instance flood-sim link-failure node <node-name> interface <slot-no>*/
+#define CMDCODE_SHOW_INSTANCE_FLOOD_SIM                     142 /*show instance flood-sim*/
+
+/*Synthetic topology generators*/
+#define TOPO_GENERATE                                       143 /*config topo generate <topo-type> <node-count>*/
+#define TOPO_GENERATOR_ECMP_WIDTH                           144 /*config topo generator ecmp-width <ecmp-width>*/
+#define TOPO_GENERATOR_METRIC                               145 /*config topo generator metric <metric-min> <metric-max>*/
+#define TOPO_GENERATOR_PREFIXES                             146 /*config topo generator prefixes <prefix-count>*/
+#define TOPO_GENERATOR_AREAS                                147 /*config topo generator areas <area-count>*/
+#define TOPO_GENERATOR_SEED                                 148 /*config topo generator seed <seed>*/
+#define TOPO_GENERATOR_SEGMENT_ROUTING                      149 /*config topo generator segment-routing*/
+#define TOPO_GENERATOR_PROTECTION                           150 /*config topo generator protection <protection-type>*/
+#define TOPO_LOAD                                           151 /*config topo load <file-name>*/
+#define TOPO_SAVE                                           152 /*config topo save <file-name>*/
+#define TOPO_SAVE_BINARY                                    153 /*config topo save <file-name> binary*/
+#define CMDCODE_SHOW_SPF_LOG                                154 /*show spf run level <level-no> root <node-name> spf-log*/
+
+/*Metrics*/
+#define CMDCODE_SHOW_METRICS                                155 /*show metrics*/
+#define CMDCODE_CONFIG_INSTANCE_METRICS_EXPORT              156 /*config instance metrics-export <file-name> [interval <interval-sec>]*/
+#define CMDCODE_CONFIG_NODE_TILFA_REMOTE_SPF_CACHE          157 /*config node <node-name> backup-spf-options tilfa-remote-spf-cache <mem-cap>*/
 #endif /* __SPFCMDCODES__H */
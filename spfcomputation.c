@@ -42,15 +42,35 @@
 #include "no_warn.h"
 #include "complete_spf_path.h"
 #include "spf_candidate_tree.h"
+#include "spfstats.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
 extern instance_t *instance;
 
-extern ll_t *
-tilfa_get_spf_result_list(node_t *node, LEVEL level);
 extern void compute_tilfa(node_t *spf_root, LEVEL level);
 extern boolean tilfa_is_link_pruned(edge_t *edge);
 extern boolean tilfa_is_node_pruned(node_t *node);
+
+spf_phase_hook_t spf_phase_hook = NULL;
+
+static const char *spf_phase_names[SPF_PHASE_MAX] = {
+
+    "spf_init",
+    "run_dijkastra",
+    "compute_backup_routine",
+    "compute_tilfa",
+    "build_routing_table",
+    "delete_stale_routes",
+    "rib_install"
+};
+
+const char *
+get_str_spf_phase(spf_phase_t phase){
+
+    if(phase >= SPF_PHASE_MAX)
+        return "unknown";
+    return spf_phase_names[phase];
+}
 int
 spf_run_result_comparison_fn(void *spf_result_ptr, void *node_ptr){
 
@@ -67,6 +87,40 @@ self_spf_run_result_comparison_fn(void *self_spf_result_ptr, void *node_ptr){
     return 0;
 }
 
+static uint32_t
+spf_run_result_hash_fn(void *spf_result_ptr){
+
+    return hash_vector_ptr_hash(((spf_result_t *)spf_result_ptr)->node);
+}
+
+static uint32_t
+self_spf_run_result_hash_fn(void *self_spf_result_ptr){
+
+    return hash_vector_ptr_hash(((self_spf_result_t *)self_spf_result_ptr)->spf_root);
+}
+
+/*spf results are searched by node_t ptr*/
+hash_vector_t *
+init_spf_run_result_list(){
+
+    hash_vector_t *res_lst = init_hash_vector();
+    hash_vector_set_comparison_fn(res_lst, spf_run_result_comparison_fn);
+    hash_vector_set_hash_fns(res_lst, spf_run_result_hash_fn, 
+        hash_vector_ptr_hash);
+    return res_lst;
+}
+
+/*self spf results are searched by spf root node_t ptr*/
+hash_vector_t *
+init_self_spf_result_list(){
+
+    hash_vector_t *self_res_lst = init_hash_vector();
+    hash_vector_set_comparison_fn(self_res_lst, self_spf_run_result_comparison_fn);
+    hash_vector_set_hash_fns(self_res_lst, self_spf_run_result_hash_fn,
+        hash_vector_ptr_hash);
+    return self_res_lst;
+}
+
 
 /*Comparison function for routes searching in spf_info lists*/
 /*return 0 or failure, 1 on success*/
@@ -84,6 +138,14 @@ route_search_comparison_fn(void * route, void *key){
     return 0;
 }
 
+/*Agrees with prefix key hash, for routes_index*/
+uint32_t
+route_hash_fn(void *route){
+
+    routes_t *_route = (routes_t *)route;
+    return get_prefix_key_hash_fn()(&_route->rt_key);
+}
+
 
 /* Inverse the topology wrt to level*/
 /* ToDo : To inverse the topo, explore the nbrs of nbr recursively instead
@@ -92,15 +154,13 @@ route_search_comparison_fn(void * route, void *key){
 void
 inverse_topology(instance_t *instance, LEVEL level){
 
-    singly_ll_node_t* list_node = NULL;
     node_t *node = NULL;
     unsigned int i = 0, edge_metric = 0;
     edge_end_t *from_edge_end = NULL;
     
     edge_t *edge = NULL;;
 
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = (node_t *)list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
     
         for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
             
@@ -128,12 +188,11 @@ inverse_topology(instance_t *instance, LEVEL level){
             edge->inv_edge->metric[level] = edge_metric;
             edge->inv_edge->inv_edge = NULL;
         }
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 
     /*repair*/
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
         
-        node = (node_t *)list_node->data;
         for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
 
             from_edge_end = node->edges[i];
@@ -157,12 +216,12 @@ inverse_topology(instance_t *instance, LEVEL level){
             edge->metric[level] = edge->inv_edge->metric[level];
             edge->inv_edge->metric[level] = edge_metric;
         }
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 }
 
 static void
 run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
-                    spf_type_t spf_type, ll_t *res_lst){
+                    spf_type_t spf_type, hash_vector_t *res_lst, mm_arena_t *res_arena){
 
     node_t *candidate_node = NULL,
            *nbr_node = NULL,
@@ -174,16 +233,16 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
     spf_result_t *res = NULL;
     nh_type_t nh = NH_MAX;
     self_spf_result_t *self_res = NULL;
+    spf_run_counters_t counters;
+
+    memset(&counters, 0, sizeof(spf_run_counters_t));
 
     /*Process untill candidate tree is not empty*/
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Running Dijkastra with root node = %s, Level = %u", 
-            (SPF_GET_CANDIDATE_TREE_TOP(ctree))->node_name, level); 
-    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Running Dijkastra with root node = %s, Level = %u", 
+            (SPF_GET_CANDIDATE_TREE_TOP(ctree))->node_name, level);
     
     assert(res_lst);
-    assert(is_singly_ll_empty(res_lst));
+    assert(IS_HASH_VECTOR_EMPTY(res_lst));
 
     while(!SPF_IS_CANDIDATE_TREE_EMPTY(ctree)){
 
@@ -192,18 +251,18 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
         candidate_node = SPF_GET_CANDIDATE_TREE_TOP(ctree);
         SPF_REMOVE_CANDIDATE_TREE_TOP(ctree);
         candidate_node->is_node_on_heap = FALSE;
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Candidate node %s Taken off candidate list", candidate_node->node_name); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+        counters.nodes_popped++;
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Candidate node %s Taken off candidate list", candidate_node->node_name);
 
         /*Add the node just taken off the candidate tree into result list. pls note, we dont want PN in results list
          * however we process it as ususal like other nodes*/
         if(candidate_node->node_type[level] != PSEUDONODE){
-            res = singly_ll_search_by_key(res_lst, candidate_node);
+            res = hash_vector_search_by_key(res_lst, candidate_node);
             if(!res) {
-                res = XCALLOC(1, spf_result_t);
-                singly_ll_add_node_by_val(res_lst, (void *)res);
+                res = XCALLOC_ARENA(res_arena, 1, spf_result_t);
+                /*res is hashed on its node*/
+                res->node = candidate_node;
+                hash_vector_add(res_lst, (void *)res);
             }
         }
         res->node = candidate_node;
@@ -216,78 +275,57 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
         } ITERATE_NH_TYPE_END;
 
         if(spf_type != TILFA_RUN){
-            self_res = singly_ll_search_by_key(candidate_node->self_spf_result[level], spf_root);
+            self_res = hash_vector_search_by_key(candidate_node->self_spf_result[level], spf_root);
 
             if(self_res){
-#ifdef __ENABLE_TRACE__            
-                sprintf(instance->traceopts->b, "Curr node : %s, Overwriting self spf result with spf root %s", 
-                        candidate_node->node_name, spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Curr node : %s, Overwriting self spf result with spf root %s", 
+                        candidate_node->node_name, spf_root->node_name);
                 self_res->spf_root = spf_root;
                 self_res->res = res;
             }
             else{
-#ifdef __ENABLE_TRACE__            
-                sprintf(instance->traceopts->b, "Curr node : %s, Creating New self spf result with spf root %s",
-                        candidate_node->node_name, spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
-                self_res = XCALLOC(1, self_spf_result_t);
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Curr node : %s, Creating New self spf result with spf root %s",
+                        candidate_node->node_name, spf_root->node_name);
+                self_res = XCALLOC_ARENA(res_arena, 1, self_spf_result_t);
                 self_res->spf_root = spf_root;
                 self_res->res = res;
-                singly_ll_add_node_by_val(candidate_node->self_spf_result[level], self_res);
+                hash_vector_add(candidate_node->self_spf_result[level], self_res);
+                glthread_add_next(&spf_root->spf_root_self_results[level], &self_res->spf_root_glue);
             }
         }
         /*Iterare over all the nbrs of Candidate node*/
 
           ITERATE_NODE_LOGICAL_NBRS_BEGIN(candidate_node, nbr_node, edge, level){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Processing Nbr : %s", nbr_node->node_name); 
-            trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+            trace_log(instance->traceopts, DIJKSTRA_BIT, "Processing Nbr : %s", nbr_node->node_name);
 
             /*Two way handshake check. Nbr-ship should be two way with nbr, even if nbr is PN. Do
              * not consider the node for SPF computation if we find 2-way nbrship is broken. */
             if(!is_two_way_nbrship(candidate_node, nbr_node, level) || 
                 edge->status == 0){
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Two Way nbrship broken with nbr %s", nbr_node->node_name); 
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Two Way nbrship broken with nbr %s", nbr_node->node_name);
                 continue;
             }
 
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Two Way nbrship verified with nbr %s",nbr_node->node_name); 
-            trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+            trace_log(instance->traceopts, DIJKSTRA_BIT, "Two Way nbrship verified with nbr %s",nbr_node->node_name);
             if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
                         ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) < (unsigned long long)nbr_node->spf_metric[level]){
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, Better Next Hop", 
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, Better Next Hop", 
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
                         ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
 
                 /*case 1 : if My own List is empty, and nbr is Pseuodnode , do nothing*/
                 if(candidate_node == spf_root && nbr_node->node_type[level] == PSEUDONODE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "case 1 if I am root and and nbr is Pseuodnode , do nothing"); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "case 1 if I am root and and nbr is Pseuodnode , do nothing");
                 }
                 /*case 2 : if My own List is empty, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list*/
                 if((candidate_node == spf_root && nbr_node->node_type[level] == NON_PSEUDONODE) || 
                         (candidate_node->node_type[level] == PSEUDONODE && is_all_nh_list_empty2(candidate_node, level))){
 
                     if(candidate_node == spf_root && nbr_node->node_type[level] == NON_PSEUDONODE)
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "case 2 if i am root, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list");
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "case 2 if i am root, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list");
                     else
-                        sprintf(instance->traceopts->b, "case 2 if i am PN and all my nh list are empty");
-#endif
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "case 2 if i am PN and all my nh list are empty");
 
                     /*Drain all NH first*/
                     ITERATE_NH_TYPE_BEGIN(nh){
@@ -297,43 +335,28 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                     /*copy only appropriate direct mexthops to nexthops*/
                     nh = edge->etype == LSP ? LSPNH : IPNH;
 
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Copying %s direct_next_hop %s %s to %s next_hop list", nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Copying %s direct_next_hop %s %s to %s next_hop list", nbr_node->node_name, get_str_level(level), 
+                            nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name);
 
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "printing %s direct_next_hop list at %s %s before copy", nbr_node->node_name, get_str_level(level),
-                            nh == IPNH ? "IPNH" : "LSPNH"); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "printing %s direct_next_hop list at %s %s before copy", nbr_node->node_name, get_str_level(level),
+                            nh == IPNH ? "IPNH" : "LSPNH");
 
                     print_nh_list2(&nbr_node->direct_next_hop[level][nh][0]);
                     copy_nh_list2(&nbr_node->direct_next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0]);
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
+                            nh == IPNH ? "IPNH" : "LSPNH");
                     print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                 }
                 /*case 3 : if My own List is not empty, then nbr should inherit my next hop list*/
                 else if(!is_all_nh_list_empty2(candidate_node, level)){
 
                     ITERATE_NH_TYPE_BEGIN(nh){
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "case 3 if My own List is not empty, then nbr should inherit my next hop list"); 
-                        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Copying %s next_hop list %s %s to %s next_hop list", candidate_node->node_name, get_str_level(level), 
-                                nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "case 3 if My own List is not empty, then nbr should inherit my next hop list");
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "Copying %s next_hop list %s %s to %s next_hop list", candidate_node->node_name, get_str_level(level), 
+                                nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name);
                         copy_nh_list2(&candidate_node->next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0]);
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
-                                nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
+                                nh == IPNH ? "IPNH" : "LSPNH");
                         print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                         ITERATE_NH_TYPE_END;
                     }
@@ -344,68 +367,53 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                 nbr_node->lsp_metric[level] =  IS_OVERLOADED(candidate_node, level) ? 
                     INFINITE_METRIC : candidate_node->lsp_metric[level] + edge->metric[level];
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "%s's spf_metric has been updated to %u",  
-                        nbr_node->node_name, nbr_node->spf_metric[level]); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "%s's spf_metric has been updated to %u",  
+                        nbr_node->node_name, nbr_node->spf_metric[level]);
+                counters.relaxations++;
 
                 if(nbr_node->is_node_on_heap == FALSE){
                     SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
                     nbr_node->is_node_on_heap = TRUE;
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "%s inserted into candidate tree", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "%s inserted into candidate tree", nbr_node->node_name);
                 }
                 else{
                     /* We should remove the node and then add again into candidate tree
                      * But now i dont have brain cells to do this useless work. It has impact
                      * on performance, but not on output*/
                     SPF_CANDIDATE_TREE_NODE_REFRESH(ctree, nbr_node, level);
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "%s is already present in candidate tree", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    counters.decrease_keys++;
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "%s is already present in candidate tree", nbr_node->node_name);
                 }
             }
 
             else if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
                         ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) == (unsigned long long)nbr_node->spf_metric[level]){
 
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, ECMP path",
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, ECMP path",
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
-                        ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]); 
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                        ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
 
                 /*We should do two things here :
                  * 1. union of nexthops (IPNH and LSPNH)
                  * 2. if direct NH is present, then merge it into IPNH or LSPNH depeneding on direct NH type
                  * Help : See pseudonode_ecmp_topo() for detail
                  * */
+                counters.ecmp_merges++;
                 ITERATE_NH_TYPE_BEGIN(nh){
 
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Union next_hop of %s %s at %s %s", candidate_node->node_name, 
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Union next_hop of %s %s at %s %s", candidate_node->node_name, 
                             nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                            nh == IPNH ? "IPNH" : "LSPNH");
 
                     union_nh_list2(&candidate_node->next_hop[level][nh][0]  , &nbr_node->next_hop[level][nh][0]);
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "next_hop of %s at %s %s after Union", nbr_node->node_name,
-                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "next_hop of %s at %s %s after Union", nbr_node->node_name,
+                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH");
                     print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                     
                     if(nbr_node->is_node_on_heap == FALSE){
                         SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
                         nbr_node->is_node_on_heap = TRUE;
-#ifdef __ENABLE_TRACE__                    
-                        sprintf(instance->traceopts->b, "%s inserted into candidate tree", nbr_node->node_name); 
-                        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                        trace_log(instance->traceopts, DIJKSTRA_BIT, "%s inserted into candidate tree", nbr_node->node_name);
                     }
                 } ITERATE_NH_TYPE_END;
                     
@@ -414,30 +422,25 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                 nh = edge->etype == LSP ? LSPNH : IPNH;
 
                 if(is_nh_list_empty2(&candidate_node->next_hop[level][nh][0])){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Union direct_next_hop of %s with Next hop of %s at %s %s", nbr_node->node_name, 
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "Union direct_next_hop of %s with Next hop of %s at %s %s", nbr_node->node_name, 
                             nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                            nh == IPNH ? "IPNH" : "LSPNH");
                     union_direct_nh_list2(&nbr_node->direct_next_hop[level][nh][0] , &nbr_node->next_hop[level][nh][0] );
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "next_hop of %s at %s %s after Union", nbr_node->node_name,
-                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                    trace_log(instance->traceopts, DIJKSTRA_BIT, "next_hop of %s at %s %s after Union", nbr_node->node_name,
+                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH");
                     print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                 }
             }
             else{
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, Not a Better Next Hop",
+                trace_log(instance->traceopts, DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, Not a Better Next Hop",
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
                         ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
             }
         }
         ITERATE_NODE_LOGICAL_NBRS_END;
     }
+    if(spf_type == FULL_RUN)
+        spf_stats_add_counters(spf_root, level, &counters);
 }
 
 
@@ -449,34 +452,22 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
 static void
 spf_clear_result(node_t *spf_root, LEVEL level){
 
-   singly_ll_node_t *list_node = NULL,
-                    *list_node1 = NULL; 
-
-   spf_result_t *result = NULL;
+   glthread_t *curr = NULL;
    self_spf_result_t *self_result = NULL;
-   nh_type_t nh;
 
-   ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
-
-       result = list_node->data;
-        
-       self_result = singly_ll_search_by_key(
-                    result->node->self_spf_result[level], 
-                    spf_root);
+   /*Unplant the self spf results of the previous run from the nodes
+    * they sit on, the root keeps them threaded so no search is needed*/
+   ITERATE_GLTHREAD_BEGIN(&spf_root->spf_root_self_results[level], curr){
         
-       if(self_result){
-           singly_ll_delete_node_by_data_ptr(
-                   result->node->self_spf_result[level],
-                   self_result);
-
-           XFREE(self_result);
-           self_result = NULL;
-       }
-        
-       XFREE(result);
-       result = NULL;    
-   }ITERATE_LIST_END;
-   delete_singly_ll(spf_root->spf_run_result[level]);
+       self_result = spf_root_glue_to_self_spf_result(curr);
+       hash_vector_remove_by_data_ptr(
+               self_result->res->node->self_spf_result[level],
+               self_result);
+       remove_glthread(curr);
+   }ITERATE_GLTHREAD_END(&spf_root->spf_root_self_results[level], curr);
+   hash_vector_clear(spf_root->spf_run_result[level]);
+   /*spf results and self spf results of the previous run go in one shot*/
+   mm_arena_reset(&spf_root->spf_run_arena[level]);
 }
 
 void
@@ -656,16 +647,13 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
     unsigned int i = 0;
     edge_end_t *edge_end = NULL;
     edge_t *edge = NULL;
-    singly_ll_node_t *list_node = NULL;
+    spf_result_t *result = NULL;
     node_t *res_node = NULL;
 
     if(!IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED))
         return;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Begin SPF back up calculation"); 
-    trace(instance->traceopts, SPF_EVENTS_BIT); 
-#endif
+    trace_log(instance->traceopts, SPF_EVENTS_BIT, "Begin SPF back up calculation"); 
     boolean strict_down_stream_lfa = FALSE;
     init_back_up_computation(spf_root, level); 
 
@@ -677,10 +665,11 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
     /*Weed out the nodes which do not need any backup support because they
      * are blessed with independant ECMP primary nexthops*/
 
-    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
-        res_node = ((spf_result_t *)list_node->data)->node;
+    ITERATE_HASH_VECTOR_BEGIN(spf_root->spf_run_result[level], result){
+        res_node = result->node;
+        if(!IS_BACKUP_DESTINATION(spf_root, res_node, level)) continue;
         is_independant_primary_next_hop_list_for_nodes(spf_root, res_node, level);
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 
     for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
         edge_end = spf_root->edges[i];
@@ -715,17 +704,15 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
            broadcast_filter_select_pq_nodes_from_ex_pspace(spf_root, edge, level);
        }
     }
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "END of SPF back up calculation"); 
-    trace(instance->traceopts, SPF_EVENTS_BIT);
-#endif
+    trace_log(instance->traceopts, SPF_EVENTS_BIT, "END of SPF back up calculation");
 }
 
 void
 spf_computation(node_t *spf_root, 
                 spf_info_t *spf_info, 
                 LEVEL level, spf_type_t spf_type,
-                ll_t *res_lst/*output list*/){
+                hash_vector_t *res_lst/*output list*/,
+                mm_arena_t *res_arena){
 
     if(level != LEVEL1 && level != LEVEL2){
         printf("%s() : Error : invalid level specified\n", __FUNCTION__);
@@ -740,70 +727,79 @@ spf_computation(node_t *spf_root,
 
     /*output list provided must be empty by the caller*/
     if(res_lst){
-        assert(is_singly_ll_empty(res_lst));
+        assert(IS_HASH_VECTOR_EMPTY(res_lst));
     }
 
     /*All Tilfa runs must fetch the output in the separate
      * list. This seggregate the TILFA results from rest of 
      * the application code*/
-    if(spf_type == TILFA_RUN && !res_lst){
+    if(spf_type == TILFA_RUN && (!res_lst || !res_arena)){
         assert(0);
     }
 #if 0
     if(level == LEVEL2 && spf_root->spf_info.spf_level_info[LEVEL1].version == 0){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Root : %s, Running first LEVEL1 full SPF run before LEVEL2 full SPF run", 
-                        spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Root : %s, Running first LEVEL1 full SPF run before LEVEL2 full SPF run", 
+                        spf_root->node_name);
         spf_computation(spf_root, &spf_root->spf_info, LEVEL1, FULL_RUN);      
     }
 #endif
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, Triggered SPF run : %s, %s", 
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Node : %s, Triggered SPF run : %s, %s", 
                 spf_root->node_name, spf_type == FULL_RUN ? "FULL_RUN" : "FORWARD_RUN",
-                get_str_level(level)); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+                get_str_level(level));
                  
+    if(spf_type == FULL_RUN){
+        spf_stats_run_begin(spf_root, level, FULL_RUN);
+        SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_INIT);
+    }
+
     SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
 
     spf_init(&instance->ctree, spf_root, level, spf_type);
 
     if(spf_type == FULL_RUN){
+        SPF_PHASE_END(spf_root, level, SPF_PHASE_INIT);
         spf_info->spf_level_info[level].version++;
         assert(!res_lst);
         res_lst = spf_root->spf_run_result[level];
-        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
+        SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_DIJKSTRA);
+        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst,
+            &spf_root->spf_run_arena[level]);
+        SPF_PHASE_END(spf_root, level, SPF_PHASE_DIJKSTRA);
     }
     else if(spf_type == FORWARD_RUN){
         assert(!res_lst);
         res_lst = spf_root->spf_run_result[level];
-        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
+        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst,
+            &spf_root->spf_run_arena[level]);
         return;
     }
     else if(spf_type == TILFA_RUN){
         assert(res_lst);
-        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
+        run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst,
+            res_arena);
         return;
     }
 
     /* Flush off backups from all nodes unconditionally 
-     * otherwise they will be reflected in routes computed.*/ 
-    init_back_up_computation(spf_root, level); 
+     * otherwise they will be reflected in routes computed.*/
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_BACKUP);
+    init_back_up_computation(spf_root, level);
     compute_backup_routine(spf_root, level);
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_BACKUP);
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_TILFA);
     compute_tilfa(spf_root, level);
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_TILFA);
     /* Route Building After SPF computation*/
     /*We dont build routing table for reverse spf run*/
     if(spf_type == FULL_RUN){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Route building starts After SPF FORWARD run"); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Route building starts After SPF FORWARD run");
         spf_postprocessing(spf_info, spf_root, level);
 #if 0
         /*backup routine must not impact main spf computation*/
         compute_backup_routine(spf_root, level);
         spf_backup_postprocessing(spf_info, spf_root, level);
 #endif
+        spf_stats_run_end(spf_root, level);
     }
 }
 
@@ -818,22 +814,20 @@ init_prc_run(node_t *spf_root, LEVEL level){
 void
 partial_spf_run(node_t *spf_root, LEVEL level){
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Root : %s, %s", spf_root->node_name, get_str_level(level)); trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Root : %s, %s", spf_root->node_name, get_str_level(level));
     
     if(spf_root->spf_info.spf_level_info[level].version == 0){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Root : %s, %s. No full SPF run till now. Runnig ...", 
-        spf_root->node_name, get_str_level(level)); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
-        spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0); 
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "Root : %s, %s. No full SPF run till now. Runnig ...", 
+        spf_root->node_name, get_str_level(level));
+        spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0, 0); 
         return;
     }
 
+    spf_stats_run_begin(spf_root, level, PRC_RUN);
     init_prc_run(spf_root, level);
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_BACKUP);
     compute_backup_routine(spf_root, level);
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_BACKUP);
     spf_postprocessing(&spf_root->spf_info, spf_root, level);
     spf_root->spf_info.spf_level_info[level].spf_type = FULL_RUN;
     if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
@@ -841,6 +835,99 @@ partial_spf_run(node_t *spf_root, LEVEL level){
          * their route calculation*/
         init_back_up_computation(spf_root, level);
     }
+    spf_stats_run_end(spf_root, level);
+}
+
+static int
+backup_destination_comparison_fn(void *node, void *key){
+
+    return node == key;
+}
+
+/* PRC for a known set of changed prefixes : only the routes of these prefixes
+ * are rebuilt from the results of last SPF run, and only their RIB entries are
+ * refreshed. Returns FALSE if the whole routing table had to be rebuilt instead*/
+boolean
+partial_spf_run_prefixes(node_t *spf_root, LEVEL level, hash_vector_t *prefixes){
+
+    common_pfx_key_t *pfx_key = NULL;
+    hash_vector_t backup_destinations;
+
+    if(spf_root->spf_info.spf_level_info[level].version == 0){
+        partial_spf_run(spf_root, level);
+        return FALSE;
+    }
+
+    /*SPRING routes, and the default route towards L1L2 routers, are
+     * derived from the entire unicast routing table*/
+    if(is_node_spring_enabled(spf_root, level)){
+        partial_spf_run(spf_root, level);
+        return FALSE;
+    }
+    ITERATE_HASH_VECTOR_BEGIN(prefixes, pfx_key){
+        if(level == LEVEL1 && pfx_key->u.prefix.mask == 0){
+            partial_spf_run(spf_root, level);
+            return FALSE;
+        }
+    } ITERATE_HASH_VECTOR_END;
+
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "Root : %s, %s, %u prefixes",
+        spf_root->node_name, get_str_level(level), HASH_VECTOR_COUNT(prefixes));
+
+    spf_stats_run_begin(spf_root, level, PRC_RUN);
+    /*Backups are not retained across runs, they are recomputed for
+     * the originators of the changed prefixes only*/
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_BACKUP);
+    if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
+        memset(&backup_destinations, 0, sizeof(hash_vector_t));
+        hash_vector_set_comparison_fn(&backup_destinations, backup_destination_comparison_fn);
+        hash_vector_set_hash_fns(&backup_destinations, hash_vector_ptr_hash,
+            hash_vector_ptr_hash);
+        ITERATE_HASH_VECTOR_BEGIN(prefixes, pfx_key){
+            prc_add_prefix_originator_nodes(spf_root, level, pfx_key,
+                &backup_destinations);
+        } ITERATE_HASH_VECTOR_END;
+        spf_root->backup_destinations[level] = &backup_destinations;
+        compute_backup_routine(spf_root, level);
+        spf_root->backup_destinations[level] = NULL;
+        delete_hash_vector(&backup_destinations);
+    }
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_BACKUP);
+    /*Routes are built and installed prefix by prefix*/
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_ROUTE_BUILD);
+    ITERATE_HASH_VECTOR_BEGIN(prefixes, pfx_key){
+        prc_update_prefix_route(&spf_root->spf_info, spf_root, level, pfx_key);
+    } ITERATE_HASH_VECTOR_END;
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_ROUTE_BUILD);
+    if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
+        init_back_up_computation(spf_root, level);
+    }
+    spf_stats_run_end(spf_root, level);
+    return TRUE;
+}
+
+/* Rebuild and re-install the routes from the results of last SPF run,
+ * without recomputing them. Used when backups which are computed
+ * asynchronously become available*/
+void
+spf_reinstall_routes(node_t *spf_root, LEVEL level){
+
+    if(spf_root->spf_info.spf_level_info[level].version == 0)
+        return;
+
+    spf_stats_run_begin(spf_root, level, PRC_RUN);
+    init_prc_run(spf_root, level);
+    /*LFA/RLFA backups live on the nodes shared by all roots, other roots
+     * may have overwritten them since the last run of this root*/
+    SPF_PHASE_BEGIN(spf_root, level, SPF_PHASE_BACKUP);
+    compute_backup_routine(spf_root, level);
+    SPF_PHASE_END(spf_root, level, SPF_PHASE_BACKUP);
+    spf_postprocessing(&spf_root->spf_info, spf_root, level);
+    spf_root->spf_info.spf_level_info[level].spf_type = FULL_RUN;
+    if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
+        init_back_up_computation(spf_root, level);
+    }
+    spf_stats_run_end(spf_root, level);
 }
 
 /*This macro should work as follows :
@@ -876,9 +963,9 @@ DIST_X_Y(node_t *X, node_t *Y, LEVEL _level){
 
     if(X->node_type[_level] != PSEUDONODE &&
             Y->node_type[_level] == PSEUDONODE){
-        self_res = (self_spf_result_t *)(singly_ll_search_by_key(Y->self_spf_result[_level], X));
+        self_res = (self_spf_result_t *)(hash_vector_search_by_key(Y->self_spf_result[_level], X));
         if(!self_res) return INFINITE_METRIC;
-        res = ((self_spf_result_t *)(singly_ll_search_by_key(Y->self_spf_result[_level], X)))->res;
+        res = self_res->res;
         if(!res) return INFINITE_METRIC;
         return res->spf_metric;
     }
@@ -35,6 +35,9 @@
 
 #include "instanceconst.h"
 #include "data_plane.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+#include "hash_vector.h"
+#include "spfsched.h"
 
 /*-----------------------------------------------------------------------------
  *  Do not #include graph.h in this file, as it will create circular dependency.
@@ -266,7 +269,9 @@ typedef struct self_spf_result_{
 
     spf_result_t *res;
     struct _node_t *spf_root;
+    glthread_t spf_root_glue;   /*Threads all self spf results planted by spf_root's run*/
 } self_spf_result_t ;
+GLTHREAD_TO_STRUCT(spf_root_glue_to_self_spf_result, self_spf_result_t, spf_root_glue);
 
 /*A DS to hold level independant SPF configuration
  * and results*/
@@ -281,12 +286,16 @@ typedef enum {
     TILFA_RUN
 } spf_type_t;
 
+typedef struct spf_stats_ spf_stats_t;
+
 typedef struct spf_level_info_{
 
     node_t *node;
     unsigned int version; /* Version of spf run on this level*/
     unsigned int node_level_flags;
     spf_type_t spf_type;
+    spf_sched_t spf_sched;
+    spf_stats_t *spf_stats; /*Allocated on first run, see spfstats.h*/
 } spf_level_info_t;
 
 
@@ -319,9 +328,10 @@ typedef struct spf_info_{
     char spff_multi_area; /* use not known : set to 1 if this node is Attached to other L2 node present in specifically other area*/
 
     /*spf info containers for routes*/
-    ll_t *routes_list[TOPO_MAX];/*Routes computed as a result of SPF run, routes computed are not level specific*/
-    ll_t *priority_routes_list[TOPO_MAX];/*Always add route in this list*/
+    glthread_t routes_list[TOPO_MAX];/*Routes computed as a result of SPF run, routes computed are not level specific*/
+    glthread_t priority_routes_list[TOPO_MAX];/*Always add route in this list*/
     ll_t *deferred_routes_list[TOPO_MAX];
+    hash_vector_t *routes_index;    /*UNICAST_T routes of routes_list, by prefix key*/
 
     /*Routing tables*/
     rt_un_table_t *rib[RIB_COUNT];
@@ -334,28 +344,89 @@ typedef struct spf_info_{
     (spfrootptr->spf_info.spf_level_info[_level].spf_type)
 
 #define GET_SPF_RESULT(_spf_info, _node_ptr, _level)    \
-        singly_ll_search_by_key(_spf_info->spf_level_info[_level].node->spf_run_result[_level], _node_ptr)
+        hash_vector_search_by_key(_spf_info->spf_level_info[_level].node->spf_run_result[_level], _node_ptr)
 
 typedef struct _node_t node_t;
 
+/* Phases of a route computation. Every phase of a FULL_RUN or PRC run is
+ * timed into the spf statistics of the root, and if spf_phase_hook is set
+ * it is called at the beginning and at the end of the phase; a phase may
+ * be entered more than once per run. Runs nested within a phase
+ * (FORWARD_RUN, TILFA_RUN) are not reported*/
+typedef enum{
+
+    SPF_PHASE_INIT,
+    SPF_PHASE_DIJKSTRA,
+    SPF_PHASE_BACKUP,
+    SPF_PHASE_TILFA,
+    SPF_PHASE_ROUTE_BUILD,
+    SPF_PHASE_STALE_ROUTES,
+    SPF_PHASE_RIB_INSTALL,
+    SPF_PHASE_MAX
+} spf_phase_t;
+
+typedef void (*spf_phase_hook_t)(node_t *spf_root, LEVEL level,
+                                 spf_phase_t phase, boolean end);
+
+extern spf_phase_hook_t spf_phase_hook;
+
+void
+spf_stats_phase_begin(node_t *spf_root, LEVEL level, spf_phase_t phase);
+
+void
+spf_stats_phase_end(node_t *spf_root, LEVEL level, spf_phase_t phase);
+
+#define SPF_PHASE_BEGIN(_spf_root, _level, _phase)                      \
+    do{                                                                 \
+        if(spf_phase_hook) spf_phase_hook(_spf_root, _level, _phase, FALSE); \
+        spf_stats_phase_begin(_spf_root, _level, _phase);               \
+    } while(0)
+
+#define SPF_PHASE_END(_spf_root, _level, _phase)                        \
+    do{                                                                 \
+        spf_stats_phase_end(_spf_root, _level, _phase);                 \
+        if(spf_phase_hook) spf_phase_hook(_spf_root, _level, _phase, TRUE); \
+    } while(0)
+
+const char *
+get_str_spf_phase(spf_phase_t phase);
+
+/* res_lst and res_arena go together : spf results of TILFA_RUN are
+ * put in res_lst and allocated from res_arena, the caller releases them
+ * by resetting the arena. Other spf runs use root's own list and arena*/
 void
 spf_computation(node_t *spf_root,
         spf_info_t *spf_info,
         LEVEL level, spf_type_t spf_type,
-        ll_t *res_lst);
+        hash_vector_t *res_lst, mm_arena_t *res_arena);
 
 int
 route_search_comparison_fn(void * route, void *key);
 
+uint32_t
+route_hash_fn(void *route);
+
 int
 spf_run_result_comparison_fn(void *spf_result_ptr, void *node_ptr);
 
 int
 self_spf_run_result_comparison_fn(void *self_spf_result_ptr, void *node_ptr);
 
+hash_vector_t *
+init_spf_run_result_list();
+
+hash_vector_t *
+init_self_spf_result_list();
+
 void
 partial_spf_run(node_t *spf_root, LEVEL level);
 
+boolean
+partial_spf_run_prefixes(node_t *spf_root, LEVEL level, hash_vector_t *prefixes);
+
+void
+spf_reinstall_routes(node_t *spf_root, LEVEL level);
+
 unsigned int 
 DIST_X_Y(node_t *X, node_t *Y, LEVEL _level);
 
@@ -46,6 +46,8 @@
 #include "data_plane.h"
 #include "no_warn.h"
 #include "spf_candidate_tree.h"
+#include "spfstats.h"
+#include "metrics.h"
 #include "complete_spf_path.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
@@ -65,6 +67,9 @@ void config_topology_commands(param_t *config);
 extern int
 show_tilfa_handler(param_t *param, ser_buff_t *tlv_buf,
                     op_mode enable_or_disable);
+extern int
+tilfa_config_handler(param_t *param, ser_buff_t *tlv_buf,
+                    op_mode enable_or_disable);
 extern void srte_init_dcm(param_t *config_node_node_name);
 
 static void
@@ -77,8 +82,7 @@ show_spf_results(node_t *spf_root, LEVEL level){
     nh_type_t nh;
     printf("\nSPF run results for LEVEL%u, ROOT = %s\n", level, spf_root->node_name);
 
-    ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
-        res = (spf_result_t *)list_node->data;
+    ITERATE_HASH_VECTOR_BEGIN(spf_root->spf_run_result[level], res){
         printf("DEST : %-10s spf_metric : %-6u", res->node->node_name, res->spf_metric);
         printf(" Nxt Hop : ");
 
@@ -102,7 +106,7 @@ show_spf_results(node_t *spf_root, LEVEL level){
                 }
             }
         } ITERATE_NH_TYPE_END;
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 }
 
 int
@@ -119,7 +123,7 @@ validate_debug_log_enable_disable(char *value_passed){
 int 
 validate_node_extistence(char *node_name){
 
-    if(singly_ll_search_by_key(instance->instance_node_list, node_name))
+    if(hash_vector_search_by_key(instance->instance_node_list, node_name))
         return VALIDATION_SUCCESS;
 
     printf("Error : Node %s do not exist\n", node_name);
@@ -185,12 +189,15 @@ display_mem_usage(param_t *param, ser_buff_t *tlv_buf,
     
     tlv_struct_t *tlv = NULL;
     char *struct_name = NULL;
+    char *tracking_status = NULL;
     int cmdcode = EXTRACT_CMD_CODE(tlv_buf);
 
     TLV_LOOP_BEGIN(tlv_buf, tlv){
 
         if(strncmp(tlv->leaf_id, "struct-name", strlen("struct-name")) == 0)
             struct_name =  tlv->value;
+        else if(strncmp(tlv->leaf_id, "tracking-status", strlen("tracking-status")) == 0)
+            tracking_status = tlv->value;
     } TLV_LOOP_END;
 
     switch(cmdcode){
@@ -200,6 +207,23 @@ display_mem_usage(param_t *param, ser_buff_t *tlv_buf,
         case CMDCODE_DEBUG_SHOW_MEMORY_USAGE_DETAIL:
             mm_print_memory_usage(struct_name);
             break;
+        case CMDCODE_DEBUG_SHOW_MEMORY_USAGE_STATS:
+            mm_print_family_stats();
+            break;
+        case CMDCODE_DEBUG_SHOW_MEMORY_USAGE_CALL_SITES:
+            mm_print_call_sites();
+            break;
+        case CMDCODE_DEBUG_SHOW_MEMORY_USAGE_LEAKS:
+            mm_print_leak_report();
+            break;
+        case CMDCODE_DEBUG_MEMORY_USAGE_SNAPSHOT:
+            mm_take_snapshot();
+            printf("Memory usage snapshot taken\n");
+            break;
+        case CMDCODE_DEBUG_MEMORY_USAGE_CALL_SITE_TRACKING:
+            mm_enable_call_site_tracking(
+                strncmp(tracking_status, "enable", strlen(tracking_status)) == 0);
+            break;
         default:
             ;
     }
@@ -215,19 +239,26 @@ node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_
     int cmd_code = -1;
     LEVEL level = MAX_LEVEL;
     unsigned int metric = 0;
+    unsigned int srlg = 0;
+    unsigned int delay_usec = 0;
+    edge_end_t *interface = NULL;
       
     TLV_LOOP_BEGIN(tlv_buf, tlv){
         if(strncmp(tlv->leaf_id, "slot-no", strlen("slot-no")) ==0)
             slot_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "srlg-id", strlen("srlg-id")) ==0)
+            srlg = (unsigned int)strtoul(tlv->value, NULL, 10);
         else if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
             node_name = tlv->value;
         else if(strncmp(tlv->leaf_id, "level-no", strlen("level-no")) ==0)
             level = atoi(tlv->value);
         else if(strncmp(tlv->leaf_id, "metric", strlen("metric")) ==0)
             metric = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "delay-usec", strlen("delay-usec")) ==0)
+            delay_usec = (unsigned int)strtoul(tlv->value, NULL, 10);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     cmd_code = EXTRACT_CMD_CODE(tlv_buf);
 
@@ -241,6 +272,26 @@ node_slot_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_
             else
                 spf_node_slot_metric_change(node, slot_name, level, metric);
             break;
+        case CMDCODE_CONFIG_NODE_SLOT_SRLG:
+            interface = get_interface_from_intf_name(node, slot_name);
+            if(!interface){
+                printf("%s() : Error : Interface %s do not exist\n", __FUNCTION__, slot_name);
+                break;
+            }
+            if(enable_or_disable == CONFIG_DISABLE)
+                edge_remove_srlg(GET_EGDE_PTR_FROM_EDGE_END(interface), srlg);
+            else
+                edge_add_srlg(GET_EGDE_PTR_FROM_EDGE_END(interface), srlg);
+            break;
+        case CMDCODE_CONFIG_NODE_SLOT_DELAY:
+            interface = get_interface_from_intf_name(node, slot_name);
+            if(!interface){
+                printf("%s() : Error : Interface %s do not exist\n", __FUNCTION__, slot_name);
+                break;
+            }
+            GET_EGDE_PTR_FROM_EDGE_END(interface)->prop_delay_usec = 
+                (enable_or_disable == CONFIG_DISABLE) ? DEFAULT_LINK_PROP_DELAY_USEC : delay_usec;
+            break;
         default:
             printf("%s() : Error : No Handler for command code : %d\n", __FUNCTION__, cmd_code);
             break;
@@ -267,7 +318,7 @@ show_route_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disabl
              mask = atoi(tlv->value);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     switch(cmd_code){
         case CMDCODE_SHOW_NODE_INTERNAL_ROUTES:
@@ -340,7 +391,7 @@ show_instance_node_spaces(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or
     } TLV_LOOP_END;
 
    cmdcode = EXTRACT_CMD_CODE(tlv_buf); 
-   node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+   node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
    switch(cmdcode){
        case CMDCODE_DEBUG_SHOW_NODE_INTF_EXPSPACE:
@@ -475,7 +526,7 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
             assert(0);
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     
     switch(cmd_code){
         case CMDCODE_CONFIG_NODE_SPF_BACKUP_OPTIONS:
@@ -671,16 +722,21 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
 
             prefix_t *pfx = node_local_prefix_search(node, 
                     level, prefix, mask);
-            if(pfx){
+            if(pfx && enable_or_disable == CONFIG_ENABLE){
                 printf("Error : Attempt to add duplicate prefix %s/%u in %s",
                         prefix, mask, get_str_level(level));
                 return 0;
             }
+            if(!pfx && enable_or_disable == CONFIG_DISABLE){
+                printf("Error : prefix %s/%u is not exported in %s\n",
+                        prefix, mask, get_str_level(level));
+                return 0;
+            }
             tlv128_ip_reach_t ad_msg;
             memset(&ad_msg, 0, sizeof(tlv128_ip_reach_t));
             ad_msg.prefix = prefix,
             ad_msg.mask = mask;
-            ad_msg.metric = 0;
+            ad_msg.metric = metric;
             SET_BIT(ad_msg.prefix_flags, PREFIX_EXTERNABIT_FLAG);
             ad_msg.hosting_node = node;
 
@@ -690,7 +746,10 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
             dist_info_hdr.advert_id = TLV128;
             dist_info_hdr.info_data = (char *)&ad_msg;
             /*Adopting to PRC behavior*/
-            pfx = attach_prefix_on_node (node, prefix, mask, level, 0, ad_msg.prefix_flags);
+            if(enable_or_disable == CONFIG_ENABLE)
+                pfx = attach_prefix_on_node (node, prefix, mask, level, metric, ad_msg.prefix_flags);
+            else
+                deattach_prefix_on_node(node, prefix, mask, level);
             generate_lsp(instance, node, lsp_distribution_routine, &dist_info_hdr);
         }
             break;     
@@ -763,7 +822,7 @@ config_static_route_handler(param_t *param,
     } TLV_LOOP_END;
 
     memset(&inet_key, 0, sizeof(rt_key_t));
-    host_node = singly_ll_search_by_key(instance->instance_node_list, host_node_name);
+    host_node = hash_vector_search_by_key(instance->instance_node_list, host_node_name);
     inet_0_rib = host_node->spf_info.rib[INET_0];
 
     switch(enable_or_disable){
@@ -921,6 +980,24 @@ debug_log_enable_disable_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
                 trace_set_log_medium(instance->traceopts, CONSOLE);
             }
            break; 
+        case CMDCODE_DEBUG_LOG_RING_ENABLE_DISABLE:
+            if(strncmp(value, "enable", strlen(value)) ==0){
+                trace_set_log_medium(instance->traceopts, TRACE_RING);
+            }
+            else if(strncmp(value, "disable", strlen(value)) ==0){
+                trace_set_log_medium(instance->traceopts, CONSOLE);
+            }
+           break; 
+        case CMDCODE_DEBUG_LOG_RING_DUMP:
+            {
+                int n_records = trace_ring_dump(value);
+                if(n_records < 0)
+                    printf("Error : Could not write trace dump to %s\n", value);
+                else
+                    printf("%d trace records written to %s, decode with Libtrace/trace_decode %s\n",
+                        n_records, value, value);
+            }
+           break; 
         default:
             assert(0);
     } 
@@ -932,6 +1009,8 @@ show_spf_run_stats(node_t *node, LEVEL level){
 
     printf("SPF Statistics - root : %s, LEVEL%u\n", node->node_name, level);
     printf("# SPF runs : %u\n", node->spf_info.spf_level_info[level].version);
+    spf_sched_show_stats(&node->spf_info.spf_level_info[level].spf_sched);
+    spf_stats_show(node, level);
 }
 
 
@@ -963,14 +1042,14 @@ show_spf_run_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disa
     if(node_name == NULL)
         spf_root = instance->instance_root;
     else
-        spf_root = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+        spf_root = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
    
     if(dst_node_name)
-        dst_node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, dst_node_name);
+        dst_node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, dst_node_name);
 
     switch(CMDCODE){
         case CMDCODE_SHOW_SPF_RUN:
-            spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0);
+            spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0, 0);
             show_spf_results(spf_root, level);
             break;
         case CMDCODE_DEBUG_SHOW_SPF_PATH_TRACE:
@@ -985,9 +1064,12 @@ show_spf_run_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disa
         case CMDCODE_SHOW_SPF_STATS:
             show_spf_run_stats(spf_root, level);
             break;
+        case CMDCODE_SHOW_SPF_LOG:
+            spf_stats_show_log(spf_root, level);
+            break;
         case CMDCODE_SHOW_SPF_RUN_INVERSE:
             inverse_topology(instance, level);
-            spf_computation(spf_root, &spf_root->spf_info, level, FORWARD_RUN, 0);
+            spf_computation(spf_root, &spf_root->spf_info, level, FORWARD_RUN, 0, 0);
             inverse_topology(instance, level);
             show_spf_results(spf_root, level);
             break;
@@ -1029,12 +1111,12 @@ show_instance_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_dis
         
         case CMDCODE_SHOW_INSTANCE_LEVEL:
             printf("Graph root : %s\n", instance->instance_root->node_name);
-            ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-                dump_nbrs(list_node->data, level);
-            }ITERATE_LIST_END;
+            ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+                dump_nbrs(node, level);
+            }ITERATE_HASH_VECTOR_END;
             break;
         case CMDCODE_SHOW_INSTANCE_NODE_LEVEL:
-            node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+            node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
             dump_nbrs(node, level);
             break;
         default:
@@ -1058,7 +1140,7 @@ show_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_o
 
     cmdcode = EXTRACT_CMD_CODE(tlv_buf);
 
-    node =  (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node =  (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
     switch(cmdcode){    
         case CMDCODE_SHOW_INSTANCE_NODE:
             dump_node_info(node); 
@@ -1072,6 +1154,52 @@ show_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_o
     return 0;
 }
 
+static int
+show_metrics_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    switch(cmd_code){
+        case CMDCODE_SHOW_METRICS:
+            metrics_show();
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+static int
+flood_sim_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    tlv_struct_t *tlv = NULL;
+    char *node_name = NULL,
+         *slot_name = NULL;
+    node_t *node = NULL;
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "slot-no", strlen("slot-no")) ==0)
+            slot_name = tlv->value;
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_FLOOD_SIM_LINK_FAILURE:
+            node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
+            flood_sim_link_failure(instance, node, slot_name);
+            break;
+        case CMDCODE_SHOW_INSTANCE_FLOOD_SIM:
+            flood_sim_show(instance);
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
 
 static void
 register_clear_commands(){
@@ -1148,6 +1276,39 @@ spf_init_dcm(){
             libcli_register_param(&instance, &sync);
             set_param_cmd_code(&sync, CMDCODE_RUN_INSTANCE_SYNC);
         }
+        {
+            /*run instance flood-sim link-failure node <node-name> interface <slot-no>*/
+            static param_t flood_sim;
+            init_param(&flood_sim, CMD, "flood-sim", 0, 0, INVALID, 0, "Flood simulator experiments");
+            libcli_register_param(&instance, &flood_sim);
+            {
+                static param_t link_failure;
+                init_param(&link_failure, CMD, "link-failure", 0, 0, INVALID, 0, "Fail a link and converge the network");
+                libcli_register_param(&flood_sim, &link_failure);
+                {
+                    static param_t node;
+                    init_param(&node, CMD, "node", 0, 0, INVALID, 0, "node");
+                    libcli_register_param(&link_failure, &node);
+                    libcli_register_display_callback(&node, display_instance_nodes);
+                    {
+                        static param_t node_name;
+                        init_param(&node_name, LEAF, 0, 0, validate_node_extistence, STRING, "node-name", "Node Name");
+                        libcli_register_param(&node, &node_name);
+                        {
+                            static param_t interface;
+                            init_param(&interface, CMD, "interface", 0, 0, INVALID, 0, "interface");
+                            libcli_register_param(&node_name, &interface);
+                            {
+                                static param_t slot_no;
+                                init_param(&slot_no, LEAF, 0, flood_sim_handler, 0, STRING, "slot-no", "interface name ethx/y");
+                                libcli_register_param(&interface, &slot_no);
+                                set_param_cmd_code(&slot_no, CMDCODE_RUN_INSTANCE_FLOOD_SIM_LINK_FAILURE);
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 
     /*Show commands*/
@@ -1176,6 +1337,14 @@ spf_init_dcm(){
     init_param(&instance_node_name, LEAF, 0, show_instance_node_handler, validate_node_extistence, STRING, "node-name", "Node Name");
     libcli_register_param(&instance_node, &instance_node_name);
     set_param_cmd_code(&instance_node_name, CMDCODE_SHOW_INSTANCE_NODE); 
+
+    /*show instance flood-sim*/
+    {
+        static param_t flood_sim;
+        init_param(&flood_sim, CMD, "flood-sim", flood_sim_handler, 0, INVALID, 0, "Flood simulator config and last convergence timeline");
+        libcli_register_param(&instance, &flood_sim);
+        set_param_cmd_code(&flood_sim, CMDCODE_SHOW_INSTANCE_FLOOD_SIM);
+    }
     {
         static param_t interfaces;
         init_param(&interfaces, CMD, "interfaces", show_instance_node_handler, 0, INVALID, 0, "Interfaces");
@@ -1339,6 +1508,13 @@ spf_init_dcm(){
         libcli_register_param(&instance_node_name_level_level, &spring);
         set_param_cmd_code(&spring, CMDCODE_SHOW_NODE_SPRING);
     }
+    /*show metrics*/
+    {
+        static param_t metrics;
+        init_param(&metrics, CMD, "metrics", show_metrics_handler, 0, INVALID, 0, "Counters, gauges and histograms in the Prometheus text format");
+        libcli_register_param(show, &metrics);
+        set_param_cmd_code(&metrics, CMDCODE_SHOW_METRICS);
+    }
     /*show spf run*/
 
     static param_t show_spf;
@@ -1412,7 +1588,147 @@ spf_init_dcm(){
     libcli_register_param(&show_spf_run_level_N_root_root_name, &show_spf_statistics);
     set_param_cmd_code(&show_spf_statistics, CMDCODE_SHOW_SPF_STATS);
 
+    /* show spf run level <Level NO> root <node-name> spf-log */
+    static param_t show_spf_log;
+    init_param(&show_spf_log, CMD, "spf-log", show_spf_run_handler, 0, INVALID, 0, "Last SPF runs of the root");
+    libcli_register_param(&show_spf_run_level_N_root_root_name, &show_spf_log);
+    set_param_cmd_code(&show_spf_log, CMDCODE_SHOW_SPF_LOG);
+
     /*config commands */
+
+        /*config instance lsp-pacing <msec>*/
+        static param_t config_instance;
+        init_param(&config_instance, CMD, "instance", 0, 0, INVALID, 0, "Network graph");
+        libcli_register_param(config, &config_instance);
+        {
+            static param_t lsp_pacing;
+            init_param(&lsp_pacing, CMD, "lsp-pacing", 0, 0, INVALID, 0, "Per hop LSP propagation delay");
+            libcli_register_param(&config_instance, &lsp_pacing);
+            {
+                static param_t lsp_pacing_val;
+                init_param(&lsp_pacing_val, LEAF, 0, instance_config_handler, 0, INT, "lsp-pacing", "Delay in msec, 0 to flood at once");
+                libcli_register_param(&lsp_pacing, &lsp_pacing_val);
+                set_param_cmd_code(&lsp_pacing_val, CMDCODE_CONFIG_INSTANCE_LSP_PACING);
+            }
+        }
+        {
+            /*config instance spf-interval <max-wait> <initial-wait> <second-wait>*/
+            static param_t spf_interval;
+            init_param(&spf_interval, CMD, "spf-interval", 0, 0, INVALID, 0, "SPF hold down and backoff");
+            libcli_register_param(&config_instance, &spf_interval);
+            {
+                static param_t max_wait;
+                init_param(&max_wait, LEAF, 0, 0, 0, INT, "max-wait", "Max hold down in msec, 0 to run SPF at once");
+                libcli_register_param(&spf_interval, &max_wait);
+                {
+                    static param_t initial_wait;
+                    init_param(&initial_wait, LEAF, 0, 0, 0, INT, "initial-wait", "Delay of the first run after a quiet period in msec");
+                    libcli_register_param(&max_wait, &initial_wait);
+                    {
+                        static param_t second_wait;
+                        init_param(&second_wait, LEAF, 0, instance_config_handler, 0, INT, "second-wait", "Hold down of the second run in msec, doubles per run");
+                        libcli_register_param(&initial_wait, &second_wait);
+                        set_param_cmd_code(&second_wait, CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL);
+                    }
+                }
+            }
+        }
+        {
+            /*config instance [no] metrics-export <file-name> [interval <interval-sec>]*/
+            static param_t metrics_export;
+            init_param(&metrics_export, CMD, "metrics-export", instance_config_handler, 0, INVALID, 0, "Write the metrics to a file, for the textfile collector of a scraper");
+            libcli_register_param(&config_instance, &metrics_export);
+            set_param_cmd_code(&metrics_export, CMDCODE_CONFIG_INSTANCE_METRICS_EXPORT);
+            {
+                static param_t file_name;
+                init_param(&file_name, LEAF, 0, instance_config_handler, 0, STRING, "file-name", "File written once, or rewritten every interval");
+                libcli_register_param(&metrics_export, &file_name);
+                set_param_cmd_code(&file_name, CMDCODE_CONFIG_INSTANCE_METRICS_EXPORT);
+                {
+                    static param_t interval;
+                    init_param(&interval, CMD, "interval", 0, 0, INVALID, 0, "Rewrite the file periodically");
+                    libcli_register_param(&file_name, &interval);
+                    {
+                        static param_t interval_sec;
+                        init_param(&interval_sec, LEAF, 0, instance_config_handler, 0, INT, "interval-sec", "Interval in sec, 0 to write once");
+                        libcli_register_param(&interval, &interval_sec);
+                        set_param_cmd_code(&interval_sec, CMDCODE_CONFIG_INSTANCE_METRICS_EXPORT);
+                    }
+                }
+            }
+        }
+        {
+            /*config instance [no] flood-sim*/
+            static param_t flood_sim;
+            init_param(&flood_sim, CMD, "flood-sim", instance_config_handler, 0, INVALID, 0, "Flood LSPs through the discrete event simulator");
+            libcli_register_param(&config_instance, &flood_sim);
+            set_param_cmd_code(&flood_sim, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM);
+            {
+                /*config instance flood-sim spf-delay-model <model-name>*/
+                static param_t spf_delay_model;
+                init_param(&spf_delay_model, CMD, "spf-delay-model", 0, 0, INVALID, 0, "Virtual duration of SPF runs");
+                libcli_register_param(&flood_sim, &spf_delay_model);
+                {
+                    static param_t model_name;
+                    init_param(&model_name, LEAF, 0, instance_config_handler, 0, STRING, "model-name", "constant | linear | nlogn | measured");
+                    libcli_register_param(&spf_delay_model, &model_name);
+                    set_param_cmd_code(&model_name, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_MODEL);
+                }
+            }
+            {
+                /*config instance flood-sim spf-delay-params <base-usec> <per-node-usec>*/
+                static param_t spf_delay;
+                init_param(&spf_delay, CMD, "spf-delay-params", 0, 0, INVALID, 0, "SPF delay model parameters");
+                libcli_register_param(&flood_sim, &spf_delay);
+                {
+                    static param_t base_usec;
+                    init_param(&base_usec, LEAF, 0, 0, 0, INT, "base-usec", "Fixed cost of an SPF run in usec");
+                    libcli_register_param(&spf_delay, &base_usec);
+                    {
+                        static param_t per_node_usec;
+                        init_param(&per_node_usec, LEAF, 0, instance_config_handler, 0, INT, "per-node-usec", "Cost per node in usec");
+                        libcli_register_param(&base_usec, &per_node_usec);
+                        set_param_cmd_code(&per_node_usec, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_SPF_DELAY_PARAMS);
+                    }
+                }
+            }
+            {
+                /*config instance flood-sim lsp-proc-delay <proc-usec>*/
+                static param_t lsp_proc_delay;
+                init_param(&lsp_proc_delay, CMD, "lsp-proc-delay", 0, 0, INVALID, 0, "Time a router takes to process one LSP");
+                libcli_register_param(&flood_sim, &lsp_proc_delay);
+                {
+                    static param_t proc_usec;
+                    init_param(&proc_usec, LEAF, 0, instance_config_handler, 0, INT, "proc-usec", "Delay in usec");
+                    libcli_register_param(&lsp_proc_delay, &proc_usec);
+                    set_param_cmd_code(&proc_usec, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_PROC_DELAY);
+                }
+            }
+            {
+                /*config instance flood-sim lsp-size <lsp-size>*/
+                static param_t lsp_size;
+                init_param(&lsp_size, CMD, "lsp-size", 0, 0, INVALID, 0, "LSP size, sets the link serialization delay");
+                libcli_register_param(&flood_sim, &lsp_size);
+                {
+                    static param_t lsp_size_val;
+                    init_param(&lsp_size_val, LEAF, 0, instance_config_handler, 0, INT, "lsp-size", "Size in bytes");
+                    libcli_register_param(&lsp_size, &lsp_size_val);
+                    set_param_cmd_code(&lsp_size_val, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_LSP_SIZE);
+                }
+            }
+            {
+                /*config instance flood-sim fib-delay <per-route-usec>*/
+                static param_t fib_delay;
+                init_param(&fib_delay, CMD, "fib-delay", 0, 0, INVALID, 0, "FIB update time after SPF");
+                libcli_register_param(&flood_sim, &fib_delay);
+                {
+                    static param_t per_route_usec;
+                    init_param(&per_route_usec, LEAF, 0, instance_config_handler, 0, INT, "per-route-usec", "Cost per route in usec");
+                    libcli_register_param(&fib_delay, &per_route_usec);
+                    set_param_cmd_code(&per_route_usec, CMDCODE_CONFIG_INSTANCE_FLOOD_SIM_FIB_DELAY);
+                }
+            }
+        }
     
         /*config node <node-name> [no] interface <slot-name> enable*/
         static param_t config_node;
@@ -1573,6 +1889,49 @@ spf_init_dcm(){
                 libcli_register_param(&backup_spf_options, &use_spring_backups);
                 set_param_cmd_code(&use_spring_backups, CMDCODE_CONFIG_NODE_SPRING_BACKUPS);
             }
+            {
+                /*config node <node-name> backup-spf-options tilfa-lazy*/
+                static param_t tilfa_lazy;
+                init_param(&tilfa_lazy, CMD, "tilfa-lazy", tilfa_config_handler, 0, INVALID, 0, "Compute TILFA backups in background");
+                libcli_register_param(&backup_spf_options, &tilfa_lazy);
+                set_param_cmd_code(&tilfa_lazy, CMDCODE_CONFIG_NODE_TILFA_LAZY);
+                {
+                    /*config node <node-name> backup-spf-options tilfa-lazy time-budget <msec>*/
+                    static param_t time_budget;
+                    init_param(&time_budget, CMD, "time-budget", 0, 0, INVALID, 0, "Time budget per background slice");
+                    libcli_register_param(&tilfa_lazy, &time_budget);
+                    {
+                        static param_t time_budget_val;
+                        init_param(&time_budget_val, LEAF, 0, tilfa_config_handler, 0, INT, "time-budget", "Time budget in msec");
+                        libcli_register_param(&time_budget, &time_budget_val);
+                        set_param_cmd_code(&time_budget_val, CMDCODE_CONFIG_NODE_TILFA_LAZY_TIME_BUDGET);
+                    }
+                }
+            }
+            {
+                /*config node <node-name> backup-spf-options tilfa-priority <high | medium | low>*/
+                static param_t tilfa_priority;
+                init_param(&tilfa_priority, CMD, "tilfa-priority", 0, 0, INVALID, 0, "Priority of node as TILFA destination");
+                libcli_register_param(&backup_spf_options, &tilfa_priority);
+                {
+                    static param_t tilfa_priority_val;
+                    init_param(&tilfa_priority_val, LEAF, 0, tilfa_config_handler, 0, STRING, "tilfa-priority", "high | medium | low");
+                    libcli_register_param(&tilfa_priority, &tilfa_priority_val);
+                    set_param_cmd_code(&tilfa_priority_val, CMDCODE_CONFIG_NODE_TILFA_DEST_PRIORITY);
+                }
+            }
+            {
+                /*config node <node-name> backup-spf-options tilfa-remote-spf-cache <mem-cap>*/
+                static param_t remote_spf_cache;
+                init_param(&remote_spf_cache, CMD, "tilfa-remote-spf-cache", 0, 0, INVALID, 0, "Memory cap of the TILFA remote SPF result cache");
+                libcli_register_param(&backup_spf_options, &remote_spf_cache);
+                {
+                    static param_t mem_cap;
+                    init_param(&mem_cap, LEAF, 0, tilfa_config_handler, 0, INT, "mem-cap", "Bytes per level and direction, no to size from the topology");
+                    libcli_register_param(&remote_spf_cache, &mem_cap);
+                    set_param_cmd_code(&mem_cap, CMDCODE_CONFIG_NODE_TILFA_REMOTE_SPF_CACHE);
+                }
+            }
         }
 
         /*SPRING config Commands*/
@@ -1753,6 +2112,13 @@ spf_init_dcm(){
             init_param(&link_protection, CMD, "link-protection", lfa_rlfa_config_handler, 0, INVALID, 0, "local link protection");
             libcli_register_param(&config_node_node_name_slot_slotname, &link_protection);
             set_param_cmd_code(&link_protection, CMDCODE_CONFIG_INTF_LINK_PROTECTION);
+            {
+                /*config node <node-name> [no] interface <slot-no> link-protection srlg*/
+                static param_t srlg_protection;
+                init_param(&srlg_protection, CMD, "srlg", lfa_rlfa_config_handler, 0, INVALID, 0, "protect against failure of all links sharing SRLG with this link");
+                libcli_register_param(&link_protection, &srlg_protection);
+                set_param_cmd_code(&srlg_protection, CMDCODE_CONFIG_INTF_SRLG_PROTECTION);
+            }
         }
 
         /*config node <node-name> [no] interface <slot-no> node-link-protection*/
@@ -1763,6 +2129,32 @@ spf_init_dcm(){
             set_param_cmd_code(&node_link_protection, CMDCODE_CONFIG_INTF_NODE_LINK_PROTECTION);
         }
 
+        /*config node <node-name> [no] interface <slot-no> srlg <srlg-id>*/
+        {
+            static param_t srlg;
+            init_param(&srlg, CMD, "srlg", 0, 0, INVALID, 0, "Shared Risk Link Group");
+            libcli_register_param(&config_node_node_name_slot_slotname, &srlg);
+            {
+                static param_t srlg_id;
+                init_param(&srlg_id, LEAF, 0, node_slot_config_handler, 0, INT, "srlg-id", "SRLG value");
+                libcli_register_param(&srlg, &srlg_id);
+                set_param_cmd_code(&srlg_id, CMDCODE_CONFIG_NODE_SLOT_SRLG);
+            }
+        }
+
+        /*config node <node-name> [no] interface <slot-no> delay <delay-usec>*/
+        {
+            static param_t delay;
+            init_param(&delay, CMD, "delay", 0, 0, INVALID, 0, "Link propagation delay");
+            libcli_register_param(&config_node_node_name_slot_slotname, &delay);
+            {
+                static param_t delay_usec;
+                init_param(&delay_usec, LEAF, 0, node_slot_config_handler, 0, INT, "delay-usec", "One way delay in usec");
+                libcli_register_param(&delay, &delay_usec);
+                set_param_cmd_code(&delay_usec, CMDCODE_CONFIG_NODE_SLOT_DELAY);
+            }
+        }
+
         /*config node <node-name> [no] interface <slot-no> no-eligible-backup*/
         {
             static param_t no_eligible_backup;
@@ -1848,7 +2240,7 @@ spf_init_dcm(){
         {
             /*config node <node-name> [no] interface <slot-no> level <level-no> metric <metric_val>*/
             static param_t metric_val;
-            init_param(&metric_val, LEAF, 0, node_slot_config_handler, validate_metric_value, INT, "metric", "metric value [0 - 4294967295]");
+            init_param(&metric_val, LEAF, 0, instance_node_config_handler, validate_metric_value, INT, "metric-val", "metric value [0 - 4294967295]");
             libcli_register_param(&metric, &metric_val);
             set_param_cmd_code(&metric_val, CMDCODE_CONFIG_NODE_EXPORT_PREFIX);
         }
@@ -1991,6 +2383,52 @@ spf_init_dcm(){
         set_param_cmd_code(&debug_file, CMDCODE_DEBUG_LOG_FILE_ENABLE_DISABLE); 
     }
 
+    /*debug log enable ring*/
+    {
+        static param_t debug_ring;
+        init_param(&debug_ring, CMD, "ring", debug_log_enable_disable_handler, 0, INVALID, 0, "Enable|Disable binary trace ring logging");
+        libcli_register_param(&debug_log_enable_disable, &debug_ring);
+        set_param_cmd_code(&debug_ring, CMDCODE_DEBUG_LOG_RING_ENABLE_DISABLE); 
+    }
+
+    /*debug log dump <file-name>*/
+    {
+        static param_t debug_log_dump;
+        init_param(&debug_log_dump, CMD, "dump", 0, 0, INVALID, 0, "Dump binary trace rings");
+        libcli_register_param(&debug_log, &debug_log_dump);
+        {
+            static param_t debug_log_dump_file;
+            init_param(&debug_log_dump_file, LEAF, 0, debug_log_enable_disable_handler, 0, STRING, "file-name", "Dump file name");
+            libcli_register_param(&debug_log_dump, &debug_log_dump_file);
+            set_param_cmd_code(&debug_log_dump_file, CMDCODE_DEBUG_LOG_RING_DUMP);
+        }
+    }
+
+    /*debug mem-usage*/
+    {
+        static param_t mem_usage;
+        init_param(&mem_usage, CMD, "mem-usage", 0, 0, INVALID, 0, "Memory Manager instrumentation");
+        libcli_register_param(debug, &mem_usage);
+        {
+            /*debug mem-usage snapshot*/
+            static param_t snapshot;
+            init_param(&snapshot, CMD, "snapshot", display_mem_usage, 0, INVALID, 0, "Snapshot memory usage for leak report");
+            libcli_register_param(&mem_usage, &snapshot);
+            set_param_cmd_code(&snapshot, CMDCODE_DEBUG_MEMORY_USAGE_SNAPSHOT);
+        }
+        {
+            /*debug mem-usage call-sites <enable | disable>*/
+            static param_t call_sites;
+            init_param(&call_sites, CMD, "call-sites", 0, 0, INVALID, 0, "Per call site allocation accounting");
+            libcli_register_param(&mem_usage, &call_sites);
+
+            static param_t tracking_status;
+            init_param(&tracking_status, LEAF, 0, display_mem_usage, validate_debug_log_enable_disable, STRING, "tracking-status", "enable | disable");
+            libcli_register_param(&call_sites, &tracking_status);
+            set_param_cmd_code(&tracking_status, CMDCODE_DEBUG_MEMORY_USAGE_CALL_SITE_TRACKING);
+        }
+    }
+
     /* debug instance node <node-name> route-tree*/
     {
         static param_t instance;
@@ -2054,6 +2492,27 @@ spf_init_dcm(){
                     set_param_cmd_code(&struct_name, CMDCODE_DEBUG_SHOW_MEMORY_USAGE_DETAIL);
                 }
             }
+            {
+                /*debug show mem-usage stats*/
+                static param_t stats;
+                init_param(&stats, CMD, "stats", display_mem_usage, 0, INVALID, 0, "Per structure allocation statistics");
+                libcli_register_param(&mem_usage, &stats);
+                set_param_cmd_code(&stats, CMDCODE_DEBUG_SHOW_MEMORY_USAGE_STATS);
+            }
+            {
+                /*debug show mem-usage call-sites*/
+                static param_t call_sites;
+                init_param(&call_sites, CMD, "call-sites", display_mem_usage, 0, INVALID, 0, "Allocations per XCALLOC call site");
+                libcli_register_param(&mem_usage, &call_sites);
+                set_param_cmd_code(&call_sites, CMDCODE_DEBUG_SHOW_MEMORY_USAGE_CALL_SITES);
+            }
+            {
+                /*debug show mem-usage leaks*/
+                static param_t leaks;
+                init_param(&leaks, CMD, "leaks", display_mem_usage, 0, INVALID, 0, "Memory growth since last snapshot");
+                libcli_register_param(&mem_usage, &leaks);
+                set_param_cmd_code(&leaks, CMDCODE_DEBUG_SHOW_MEMORY_USAGE_LEAKS);
+            }
         }
         /*debug show log-status*/
         {
@@ -2167,6 +2626,7 @@ spf_init_dcm(){
      * do not extend any negation supported commands*/
 
     support_cmd_negation(&config_node_node_name);
+    support_cmd_negation(&config_instance);
     support_cmd_negation(config);
 }
 
@@ -2251,6 +2711,13 @@ dump_node_info(node_t *node){
 
         printf("\n          L1 metric = %u, L2 metric = %u, edge level = %s, edge_status = %s\n", 
         edge->metric[LEVEL1], edge->metric[LEVEL2], get_str_level(edge->level), edge->status ? "UP" : "DOWN");
+        if(edge->n_srlg){
+            unsigned int j = 0;
+            printf("          SRLGs :");
+            for(j = 0; j < edge->n_srlg; j++)
+                printf(" %u", edge->srlg[j]);
+            printf("\n");
+        }
         printf("\n");
     }
 
@@ -2258,12 +2725,11 @@ dump_node_info(node_t *node){
     for(level = LEVEL2; level >= LEVEL1; level--){
 
         printf("%s prefixes:\n", get_str_level(level));
-        ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level), list_node){
+        ITERATE_HASH_VECTOR_BEGIN(GET_NODE_PREFIX_LIST(node, level), prefix){
             count++;
-            prefix = (prefix_t *)list_node->data;        
             printf("%s/%u%s(%s)     ", prefix->prefix, prefix->mask, IS_BIT_SET(prefix->prefix_flags, PREFIX_DOWNBIT_FLAG) ? "*": "", prefix->hosting_node->node_name);
             if(count % 5 == 0) printf("\n");
-        }ITERATE_LIST_END;
+        }ITERATE_HASH_VECTOR_END;
         printf("\n"); 
     }
 
@@ -0,0 +1,274 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsched.c
+ *
+ *    Description:  SPF scheduler : hold-down, exponential backoff and trigger coalescing
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 17:02:45  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#include <stdio.h>
+#include "instance.h"
+#include "spfsched.h"
+#include "spftrace.h"
+#include "spfutil.h"
+#include "floodsim.h"
+#include "spfstats.h"
+
+extern instance_t *instance;
+
+char *
+get_str_spf_trigger(spf_trigger_t trigger){
+
+    switch(trigger){
+        case SPF_TRIGGER_TOPOLOGY:
+            return "topology";
+        case SPF_TRIGGER_PREFIX:
+            return "prefix";
+        case SPF_TRIGGER_OVERLOAD:
+            return "overload";
+        default:
+            assert(0);
+    }
+    return NULL;
+}
+
+/*While the flood simulator runs, SPF is scheduled in its virtual time*/
+static uint64_t
+spf_sched_now_msec(){
+
+    if(flood_sim_is_running())
+        return flood_sim_now_usec() / 1000;
+    return ev_dis_get_monotonic_msec();
+}
+
+static int
+spf_sched_prefix_key_comparison_fn(void *_key1, void *_key2){
+
+    common_pfx_key_t *key1 = _key1,
+                     *key2 = _key2;
+
+    return strncmp(key1->u.prefix.prefix, key2->u.prefix.prefix, PREFIX_LEN) == 0 &&
+           key1->u.prefix.mask == key2->u.prefix.mask;
+}
+
+static void
+spf_sched_flush_prc_prefixes(spf_sched_t *spf_sched){
+
+    common_pfx_key_t *pfx_key = NULL;
+
+    ITERATE_HASH_VECTOR_BEGIN(&spf_sched->prc_prefixes, pfx_key){
+        XFREE(pfx_key);
+    } ITERATE_HASH_VECTOR_END;
+    hash_vector_clear(&spf_sched->prc_prefixes);
+    spf_sched->prc_all_prefixes = FALSE;
+}
+
+void
+spf_sched_run(spf_sched_t *spf_sched){
+
+    node_t *node = spf_sched->node;
+    LEVEL level = spf_sched->level;
+
+    spf_sched->running = TRUE;
+    if(spf_sched->full_run_pending){
+        spf_sched->n_full_runs++;
+        trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : %s scheduled FULL_RUN",
+            node->node_name, get_str_level(level));
+        spf_computation(node, &node->spf_info, level, FULL_RUN, NULL, NULL);
+    }
+    else if(spf_sched->prc_run_pending){
+        spf_sched->n_prc_runs++;
+        if(spf_sched->prc_all_prefixes){
+            spf_sched->n_prc_table_runs++;
+            trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : %s scheduled PRC_RUN",
+                node->node_name, get_str_level(level));
+            partial_spf_run(node, level);
+        }
+        else{
+            trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : %s scheduled PRC_RUN for %u prefixes",
+                node->node_name, get_str_level(level), HASH_VECTOR_COUNT(&spf_sched->prc_prefixes));
+            if(partial_spf_run_prefixes(node, level, &spf_sched->prc_prefixes))
+                spf_sched->n_prc_prefixes += HASH_VECTOR_COUNT(&spf_sched->prc_prefixes);
+            else
+                spf_sched->n_prc_table_runs++;
+        }
+    }
+
+    spf_sched_flush_prc_prefixes(spf_sched);
+    spf_sched->full_run_pending = FALSE;
+    spf_sched->prc_run_pending = FALSE;
+    spf_sched->run_scheduled = FALSE;
+    spf_sched->running = FALSE;
+    spf_sched->run_triggers = 0;
+    spf_sched->run_n_triggers = 0;
+    spf_sched->has_run = TRUE;
+    spf_sched->last_run_msec = spf_sched_now_msec();
+}
+
+static void
+spf_sched_hold_timer_expiry(void *arg, uint32_t arg_size){
+
+    spf_sched_run((spf_sched_t *)arg);
+}
+
+void
+spf_sched_init(spf_sched_t *spf_sched, node_t *node, LEVEL level){
+
+    memset(spf_sched, 0, sizeof(spf_sched_t));
+    spf_sched->node = node;
+    spf_sched->level = level;
+    /*Same domain as CLI, runs never race with config changes*/
+    ev_dis_timer_init(&spf_sched->hold_timer, spf_sched_hold_timer_expiry,
+        (void *)spf_sched, TASK_PRIORITY_MEDIUM, NULL);
+    hash_vector_set_comparison_fn(&spf_sched->prc_prefixes,
+        spf_sched_prefix_key_comparison_fn);
+    hash_vector_set_hash_fns(&spf_sched->prc_prefixes,
+        get_prefix_key_hash_fn(), get_prefix_key_hash_fn());
+}
+
+static void
+spf_sched_trigger(spf_sched_t *spf_sched, spf_trigger_t trigger){
+
+    uint64_t now;
+    unsigned int wait_msec;
+    node_t *node = spf_sched->node;
+    LEVEL level = spf_sched->level;
+
+    spf_sched->n_triggers[trigger]++;
+    spf_metrics_count_trigger(level, trigger);
+    spf_sched->run_triggers |= (1 << trigger);
+    spf_sched->run_n_triggers++;
+
+    if(trigger == SPF_TRIGGER_PREFIX)
+        spf_sched->prc_run_pending = TRUE;
+    else
+        spf_sched->full_run_pending = TRUE;
+
+    if(spf_sched->run_scheduled){
+        spf_sched->n_coalesced++;
+        return;
+    }
+
+    if(!instance->spf_max_wait_msec){
+        if(flood_sim_is_running()){
+            spf_sched->run_scheduled = TRUE;
+            flood_sim_schedule_spf(spf_sched, 0);
+        }
+        else{
+            spf_sched_run(spf_sched);
+        }
+        return;
+    }
+
+    now = spf_sched_now_msec();
+
+    if(!spf_sched->has_run ||
+        now - spf_sched->last_run_msec >= instance->spf_max_wait_msec){
+        /*Quiet period is over, start afresh*/
+        wait_msec = instance->spf_initial_wait_msec;
+        spf_sched->next_wait_msec = instance->spf_second_wait_msec;
+    }
+    else{
+        wait_msec = spf_sched->next_wait_msec;
+        spf_sched->next_wait_msec *= 2;
+        if(spf_sched->next_wait_msec > instance->spf_max_wait_msec)
+            spf_sched->next_wait_msec = instance->spf_max_wait_msec;
+    }
+
+    trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : %s SPF trigger %s, run in %u msec",
+        node->node_name, get_str_level(level), get_str_spf_trigger(trigger), wait_msec);
+
+    spf_sched->run_scheduled = TRUE;
+    if(flood_sim_is_running())
+        flood_sim_schedule_spf(spf_sched, wait_msec);
+    else
+        ev_dis_timer_arm(&spf_sched->hold_timer, wait_msec, 0);
+}
+
+void
+spf_schedule(node_t *node, LEVEL level, spf_trigger_t trigger){
+
+    spf_sched_t *spf_sched = &node->spf_info.spf_level_info[level].spf_sched;
+
+    if(trigger == SPF_TRIGGER_PREFIX)
+        spf_sched->prc_all_prefixes = TRUE;
+    spf_sched_trigger(spf_sched, trigger);
+}
+
+void
+spf_schedule_prefix(node_t *node, LEVEL level, char *prefix, char mask){
+
+    common_pfx_key_t pfx_key;
+    spf_sched_t *spf_sched = &node->spf_info.spf_level_info[level].spf_sched;
+
+    if(!prefix ||
+        HASH_VECTOR_COUNT(&spf_sched->prc_prefixes) >= SPF_SCHED_MAX_PRC_PREFIXES){
+        spf_sched->prc_all_prefixes = TRUE;
+    }
+    else if(!spf_sched->prc_all_prefixes){
+        init_prefix_key(&pfx_key, prefix, mask);
+        if(!hash_vector_search_by_key(&spf_sched->prc_prefixes, &pfx_key)){
+            common_pfx_key_t *new_key = XCALLOC(1, common_pfx_key_t);
+            *new_key = pfx_key;
+            hash_vector_add(&spf_sched->prc_prefixes, new_key);
+        }
+    }
+    spf_sched_trigger(spf_sched, SPF_TRIGGER_PREFIX);
+}
+
+void
+spf_sched_show_stats(spf_sched_t *spf_sched){
+
+    spf_trigger_t trigger;
+    unsigned int n_triggers = 0;
+
+    if(instance->spf_max_wait_msec){
+        printf("SPF interval : max-wait %u msec, initial-wait %u msec, second-wait %u msec\n",
+            instance->spf_max_wait_msec, instance->spf_initial_wait_msec,
+            instance->spf_second_wait_msec);
+    }
+    else{
+        printf("SPF interval : not set, triggers run at once\n");
+    }
+
+    printf("Triggers :");
+    for(trigger = 0; trigger < SPF_TRIGGER_MAX; trigger++){
+        printf(" %s %u", get_str_spf_trigger(trigger), spf_sched->n_triggers[trigger]);
+        n_triggers += spf_sched->n_triggers[trigger];
+    }
+    printf(", total %u\n", n_triggers);
+    printf("Scheduled runs : full %u, prc %u, coalesced triggers %u\n",
+        spf_sched->n_full_runs, spf_sched->n_prc_runs, spf_sched->n_coalesced);
+    printf("PRC runs : whole table %u, prefixes recomputed %u\n",
+        spf_sched->n_prc_table_runs, spf_sched->n_prc_prefixes);
+    if(ev_dis_timer_is_armed(&spf_sched->hold_timer)){
+        printf("Run pending : %s in %u msec\n",
+            spf_sched->full_run_pending ? "FULL_RUN" : "PRC_RUN",
+            ev_dis_timer_remaining_msec(&spf_sched->hold_timer));
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsched.h
+ *
+ *    Description:  SPF scheduler : hold-down, exponential backoff and trigger coalescing
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 17:02:45  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#ifndef __SPFSCHED__
+#define __SPFSCHED__
+
+#include <stdint.h>
+#include "instanceconst.h"
+#include "LinkedListApi.h"
+#include "EventDispatcher/event_dispatcher.h"
+#include "hash_vector.h"
+
+typedef struct _node_t node_t;
+
+/*What an LSP carried, decides the cheapest run which covers it*/
+typedef enum{
+
+    SPF_TRIGGER_TOPOLOGY,   /*TLV2, needs a full run*/
+    SPF_TRIGGER_PREFIX,     /*TLV128, a PRC run is enough*/
+    SPF_TRIGGER_OVERLOAD,   /*needs a full run*/
+    SPF_TRIGGER_MAX
+} spf_trigger_t;
+
+/* Per node per level SPF scheduler, in the manner of IS-IS spf-interval :
+ * The first trigger after a quiet period of max-wait is run after
+ * initial-wait. Triggers arriving while a run is held down are coalesced
+ * into it, and each run in a busy period doubles the hold down, starting
+ * from second-wait, up to max-wait. Pending triggers are executed as one
+ * run of the cheapest sufficient type, full if any trigger needs it, else
+ * PRC. With max-wait 0 (the default) triggers run at once.
+ *
+ * A PRC rebuilds the routes of the changed prefixes only. It falls back to
+ * rebuild the whole routing table when a prefix trigger does not tell the
+ * prefix, or too many prefixes change within one hold down.*/
+typedef struct spf_sched_{
+
+    node_t *node;
+    LEVEL level;
+    bool_t full_run_pending;
+    bool_t prc_run_pending;
+    bool_t run_scheduled;           /*hold_timer, or a flood simulator event, is due*/
+    bool_t has_run;
+    unsigned int next_wait_msec;    /*Hold down applied to the next run in a busy period*/
+    uint64_t last_run_msec;
+    ev_dis_timer_t hold_timer;
+    hash_vector_t prc_prefixes;     /*common_pfx_key_t of the prefixes changed since last run*/
+    bool_t prc_all_prefixes;        /*PRC must rebuild the whole routing table*/
+    bool_t running;                 /*Within spf_sched_run()*/
+    unsigned int run_triggers;      /*Bitmask of spf_trigger_t behind the pending run*/
+    unsigned int run_n_triggers;    /*Triggers behind the pending run*/
+
+    /*Statistics*/
+    unsigned int n_triggers[SPF_TRIGGER_MAX];
+    unsigned int n_coalesced;       /*Triggers absorbed in an already scheduled run*/
+    unsigned int n_full_runs;
+    unsigned int n_prc_runs;
+    unsigned int n_prc_table_runs;  /*PRC runs which rebuilt the whole routing table*/
+    unsigned int n_prc_prefixes;    /*Prefixes recomputed by the other PRC runs*/
+} spf_sched_t;
+
+/*Beyond this many changed prefixes, a PRC rebuilds the whole routing table*/
+#define SPF_SCHED_MAX_PRC_PREFIXES  64
+
+void
+spf_sched_init(spf_sched_t *spf_sched, node_t *node, LEVEL level);
+
+void
+spf_schedule(node_t *node, LEVEL level, spf_trigger_t trigger);
+
+/*SPF_TRIGGER_PREFIX for the prefix/mask, NULL prefix if not known*/
+void
+spf_schedule_prefix(node_t *node, LEVEL level, char *prefix, char mask);
+
+/*Executes the pending run, called on hold down expiry*/
+void
+spf_sched_run(spf_sched_t *spf_sched);
+
+char *
+get_str_spf_trigger(spf_trigger_t trigger);
+
+void
+spf_sched_show_stats(spf_sched_t *spf_sched);
+
+#endif /* __SPFSCHED__ */
@@ -0,0 +1,399 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfstats.c
+ *
+ *    Description:  Per node per level SPF run statistics : phase timings, counters and spf-log
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 18:40:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "instance.h"
+#include "spfstats.h"
+#include "spfutil.h"
+#include "metrics.h"
+
+static uint64_t
+spf_stats_now_usec(){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+static char *
+get_str_spf_type(spf_type_t spf_type){
+
+    switch(spf_type){
+        case FULL_RUN:
+            return "FULL";
+        case PRC_RUN:
+            return "PRC";
+        case FORWARD_RUN:
+            return "FORWARD";
+        case REVERSE_SPF_RUN:
+            return "REVERSE";
+        case TILFA_RUN:
+            return "TILFA";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+/*Metrics are per level, summed over all the roots*/
+static metric_t *spf_runs_metric[MAX_LEVEL][TILFA_RUN + 1];
+static metric_t *spf_run_duration_metric[MAX_LEVEL];
+static metric_t *spf_phase_duration_metric[MAX_LEVEL][SPF_PHASE_MAX];
+static metric_t *spf_nodes_popped_metric[MAX_LEVEL];
+static metric_t *spf_relaxations_metric[MAX_LEVEL];
+static metric_t *spf_decrease_keys_metric[MAX_LEVEL];
+static metric_t *spf_ecmp_merges_metric[MAX_LEVEL];
+static metric_t *spf_triggers_metric[MAX_LEVEL][SPF_TRIGGER_MAX];
+
+void
+spf_metrics_init(){
+
+    LEVEL level_it;
+    spf_phase_t phase;
+    spf_trigger_t trigger;
+    spf_type_t spf_types[] = {FULL_RUN, PRC_RUN};
+    unsigned int i = 0;
+    char labels[METRIC_LABELS_LEN];
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(i = 0; i < sizeof(spf_types)/sizeof(spf_types[0]); i++){
+            snprintf(labels, sizeof(labels), "level=\"%u\",type=\"%s\"",
+                level_it, get_str_spf_type(spf_types[i]));
+            spf_runs_metric[level_it][spf_types[i]] = metrics_register(METRIC_COUNTER,
+                "spf_runs_total", "SPF runs", labels);
+        }
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(trigger = 0; trigger < SPF_TRIGGER_MAX; trigger++){
+            snprintf(labels, sizeof(labels), "level=\"%u\",trigger=\"%s\"",
+                level_it, get_str_spf_trigger(trigger));
+            spf_triggers_metric[level_it][trigger] = metrics_register(METRIC_COUNTER,
+                "spf_triggers_total", "Events which asked the scheduler for an SPF run", labels);
+        }
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        snprintf(labels, sizeof(labels), "level=\"%u\"", level_it);
+        spf_run_duration_metric[level_it] = metrics_register_histogram(
+            "spf_run_duration_usec", "Duration of SPF runs", labels,
+            metrics_usec_bounds, metrics_n_usec_bounds);
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(phase = 0; phase < SPF_PHASE_MAX; phase++){
+            snprintf(labels, sizeof(labels), "level=\"%u\",phase=\"%s\"",
+                level_it, get_str_spf_phase(phase));
+            spf_phase_duration_metric[level_it][phase] = metrics_register_histogram(
+                "spf_phase_duration_usec", "Time spent in a phase of SPF runs", labels,
+                metrics_usec_bounds, metrics_n_usec_bounds);
+        }
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        snprintf(labels, sizeof(labels), "level=\"%u\"", level_it);
+        spf_nodes_popped_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "spf_nodes_popped_total", "Nodes taken off the candidate tree by full runs", labels);
+        spf_relaxations_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "spf_relaxations_total", "Better metrics found for a node by full runs", labels);
+        spf_decrease_keys_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "spf_decrease_keys_total", "Relaxations of nodes already on the candidate tree", labels);
+        spf_ecmp_merges_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "spf_ecmp_merges_total", "Equal cost paths merged into a node", labels);
+    }
+}
+
+void
+spf_metrics_count_trigger(LEVEL level, spf_trigger_t trigger){
+
+    metric_counter_inc(spf_triggers_metric[level][trigger]);
+}
+
+static void
+spf_metrics_account_run(LEVEL level, spf_stats_t *spf_stats){
+
+    spf_phase_t phase;
+    spf_run_counters_t *counters = &spf_stats->current.counters;
+
+    metric_counter_inc(spf_runs_metric[level][spf_stats->current.spf_type]);
+    metric_histogram_observe(spf_run_duration_metric[level],
+        spf_stats->current.duration_usec);
+    for(phase = 0; phase < SPF_PHASE_MAX; phase++){
+        if(IS_BIT_SET(spf_stats->phases_entered, phase))
+            metric_histogram_observe(spf_phase_duration_metric[level][phase],
+                spf_stats->phase_usec[phase]);
+    }
+    metric_counter_add(spf_nodes_popped_metric[level], counters->nodes_popped);
+    metric_counter_add(spf_relaxations_metric[level], counters->relaxations);
+    metric_counter_add(spf_decrease_keys_metric[level], counters->decrease_keys);
+    metric_counter_add(spf_ecmp_merges_metric[level], counters->ecmp_merges);
+}
+
+static spf_stats_t *
+spf_stats_get(node_t *spf_root, LEVEL level){
+
+    return spf_root->spf_info.spf_level_info[level].spf_stats;
+}
+
+static void
+spf_duration_stats_add(spf_duration_stats_t *dstats, uint32_t usec){
+
+    if(!dstats->n_samples || usec < dstats->min_usec)
+        dstats->min_usec = usec;
+    if(usec > dstats->max_usec)
+        dstats->max_usec = usec;
+    dstats->last_usec = usec;
+    dstats->total_usec += usec;
+    dstats->samples[dstats->n_samples % SPF_STATS_SAMPLES] = usec;
+    dstats->n_samples++;
+}
+
+static int
+spf_stats_usec_cmp(const void *a, const void *b){
+
+    uint32_t usec1 = *(const uint32_t *)a,
+             usec2 = *(const uint32_t *)b;
+
+    return usec1 < usec2 ? -1 : usec1 > usec2 ? 1 : 0;
+}
+
+/*p99 of the samples still held in the ring*/
+static uint32_t
+spf_duration_stats_p99(spf_duration_stats_t *dstats){
+
+    uint32_t sorted[SPF_STATS_SAMPLES];
+    unsigned int n = dstats->n_samples < SPF_STATS_SAMPLES ?
+                     dstats->n_samples : SPF_STATS_SAMPLES;
+
+    if(!n) return 0;
+    memcpy(sorted, dstats->samples, n * sizeof(uint32_t));
+    qsort(sorted, n, sizeof(uint32_t), spf_stats_usec_cmp);
+    return sorted[(n * 99 + 99) / 100 - 1];
+}
+
+static void
+spf_run_counters_add(spf_run_counters_t *dst, spf_run_counters_t *src){
+
+    dst->nodes_popped   += src->nodes_popped;
+    dst->relaxations    += src->relaxations;
+    dst->decrease_keys  += src->decrease_keys;
+    dst->ecmp_merges    += src->ecmp_merges;
+    dst->routes_added   += src->routes_added;
+    dst->routes_changed += src->routes_changed;
+    dst->routes_deleted += src->routes_deleted;
+}
+
+void
+spf_stats_run_begin(node_t *spf_root, LEVEL level, spf_type_t spf_type){
+
+    spf_level_info_t *spf_level_info = &spf_root->spf_info.spf_level_info[level];
+    spf_sched_t *spf_sched = &spf_level_info->spf_sched;
+    spf_stats_t *spf_stats = spf_level_info->spf_stats;
+
+    if(!spf_stats){
+        spf_stats = XCALLOC(1, spf_stats_t);
+        spf_level_info->spf_stats = spf_stats;
+    }
+
+    if(spf_stats->run_depth++)
+        return;
+
+    memset(spf_stats->phase_usec, 0, sizeof(spf_stats->phase_usec));
+    spf_stats->phases_entered = 0;
+    memset(&spf_stats->current, 0, sizeof(spf_log_entry_t));
+    gettimeofday(&spf_stats->current.timestamp, NULL);
+    spf_stats->current.spf_type = spf_type;
+    if(spf_sched->running){
+        spf_stats->current.triggers = spf_sched->run_triggers;
+        spf_stats->current.n_triggers = spf_sched->run_n_triggers;
+    }
+    spf_stats->run_start_usec = spf_stats_now_usec();
+}
+
+void
+spf_stats_run_end(node_t *spf_root, LEVEL level){
+
+    spf_phase_t phase;
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+
+    if(!spf_stats || !spf_stats->run_depth)
+        return;
+
+    if(--spf_stats->run_depth)
+        return;
+
+    spf_stats->current.duration_usec =
+        (uint32_t)(spf_stats_now_usec() - spf_stats->run_start_usec);
+    spf_stats->current.version = spf_root->spf_info.spf_level_info[level].version;
+
+    for(phase = 0; phase < SPF_PHASE_MAX; phase++){
+        if(IS_BIT_SET(spf_stats->phases_entered, phase))
+            spf_duration_stats_add(&spf_stats->phase[phase], spf_stats->phase_usec[phase]);
+    }
+    spf_duration_stats_add(&spf_stats->run, spf_stats->current.duration_usec);
+    spf_run_counters_add(&spf_stats->total, &spf_stats->current.counters);
+    spf_stats->n_runs[spf_stats->current.spf_type]++;
+    spf_metrics_account_run(level, spf_stats);
+
+    spf_stats->log[spf_stats->log_next] = spf_stats->current;
+    spf_stats->log_next = (spf_stats->log_next + 1) % SPF_LOG_SIZE;
+    if(spf_stats->log_count < SPF_LOG_SIZE)
+        spf_stats->log_count++;
+}
+
+void
+spf_stats_phase_begin(node_t *spf_root, LEVEL level, spf_phase_t phase){
+
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+
+    if(!spf_stats || !spf_stats->run_depth)
+        return;
+    spf_stats->phase_start_usec[phase] = spf_stats_now_usec();
+}
+
+void
+spf_stats_phase_end(node_t *spf_root, LEVEL level, spf_phase_t phase){
+
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+
+    if(!spf_stats || !spf_stats->run_depth)
+        return;
+    spf_stats->phase_usec[phase] +=
+        (uint32_t)(spf_stats_now_usec() - spf_stats->phase_start_usec[phase]);
+    SET_BIT(spf_stats->phases_entered, phase);
+}
+
+void
+spf_stats_add_counters(node_t *spf_root, LEVEL level,
+                       spf_run_counters_t *counters){
+
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+
+    if(!spf_stats || !spf_stats->run_depth)
+        return;
+    spf_run_counters_add(&spf_stats->current.counters, counters);
+}
+
+static void
+spf_stats_show_duration(const char *name, spf_duration_stats_t *dstats){
+
+    printf("%-22s %8u %10u %10u %10llu %10u %10u\n",
+        name, dstats->n_samples, dstats->last_usec, dstats->min_usec,
+        dstats->n_samples ? (unsigned long long)(dstats->total_usec / dstats->n_samples) : 0ULL,
+        dstats->max_usec, spf_duration_stats_p99(dstats));
+}
+
+void
+spf_stats_show(node_t *spf_root, LEVEL level){
+
+    spf_phase_t phase;
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+
+    if(!spf_stats){
+        printf("No SPF run recorded\n");
+        return;
+    }
+
+    printf("Runs : full %u, prc %u\n",
+        spf_stats->n_runs[FULL_RUN], spf_stats->n_runs[PRC_RUN]);
+    printf("%-22s %8s %10s %10s %10s %10s %10s\n",
+        "Phase (usec)", "Runs", "Last", "Min", "Avg", "Max", "P99");
+    for(phase = 0; phase < SPF_PHASE_MAX; phase++){
+        spf_stats_show_duration(get_str_spf_phase(phase), &spf_stats->phase[phase]);
+    }
+    spf_stats_show_duration("total", &spf_stats->run);
+    printf("p99 over the last %u runs of each phase\n", SPF_STATS_SAMPLES);
+    printf("Dijkstra : nodes popped %u, relaxations %u, decrease-keys %u, ECMP merges %u\n",
+        spf_stats->total.nodes_popped, spf_stats->total.relaxations,
+        spf_stats->total.decrease_keys, spf_stats->total.ecmp_merges);
+    printf("Unicast routes : added %u, changed %u, deleted %u\n",
+        spf_stats->total.routes_added, spf_stats->total.routes_changed,
+        spf_stats->total.routes_deleted);
+}
+
+static char *
+spf_stats_str_triggers(spf_log_entry_t *log_entry, char *buf, size_t size){
+
+    spf_trigger_t trigger;
+    int len = 0;
+
+    if(!log_entry->triggers){
+        snprintf(buf, size, "direct");
+        return buf;
+    }
+
+    buf[0] = '\0';
+    for(trigger = 0; trigger < SPF_TRIGGER_MAX; trigger++){
+        if(!IS_BIT_SET(log_entry->triggers, trigger))
+            continue;
+        len += snprintf(buf + len, size - len, "%s%s", len ? "," : "",
+                get_str_spf_trigger(trigger));
+    }
+    snprintf(buf + len, size - len, " (%u)", log_entry->n_triggers);
+    return buf;
+}
+
+void
+spf_stats_show_log(node_t *spf_root, LEVEL level){
+
+    unsigned int i = 0;
+    spf_log_entry_t *log_entry = NULL;
+    spf_stats_t *spf_stats = spf_stats_get(spf_root, level);
+    struct tm tm;
+    char timestamp[32];
+    char triggers[64];
+
+    printf("SPF log - root : %s, LEVEL%u\n", spf_root->node_name, level);
+    if(!spf_stats || !spf_stats->log_count){
+        printf("No SPF run recorded\n");
+        return;
+    }
+
+    printf("%-12s %7s %-5s %10s %7s %7s %7s %6s %6s %6s %6s  %s\n",
+        "Start", "Version", "Type", "Duration", "Popped", "Relax", "DecKey",
+        "ECMP", "Added", "Chngd", "Deltd", "Triggers");
+
+    /*Most recent first*/
+    for(i = 0; i < spf_stats->log_count; i++){
+
+        log_entry = &spf_stats->log[(spf_stats->log_next + SPF_LOG_SIZE - 1 - i) % SPF_LOG_SIZE];
+        localtime_r(&log_entry->timestamp.tv_sec, &tm);
+        snprintf(timestamp, sizeof(timestamp), "%02d:%02d:%02d.%03d",
+            tm.tm_hour, tm.tm_min, tm.tm_sec, (int)(log_entry->timestamp.tv_usec / 1000));
+
+        printf("%-12s %7u %-5s %10u %7u %7u %7u %6u %6u %6u %6u  %s\n",
+            timestamp, log_entry->version, get_str_spf_type(log_entry->spf_type),
+            log_entry->duration_usec, log_entry->counters.nodes_popped,
+            log_entry->counters.relaxations, log_entry->counters.decrease_keys,
+            log_entry->counters.ecmp_merges, log_entry->counters.routes_added,
+            log_entry->counters.routes_changed, log_entry->counters.routes_deleted,
+            spf_stats_str_triggers(log_entry, triggers, sizeof(triggers)));
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfstats.h
+ *
+ *    Description:  Per node per level SPF run statistics : phase timings, counters and spf-log
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 18:40:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __SPFSTATS__
+#define __SPFSTATS__
+
+#include <stdint.h>
+#include <sys/time.h>
+#include "instanceconst.h"
+#include "spfcomputation.h"
+
+/*Durations kept per phase to compute p99 from*/
+#define SPF_STATS_SAMPLES   128
+/*Runs kept in spf-log*/
+#define SPF_LOG_SIZE        32
+
+typedef struct spf_duration_stats_{
+
+    unsigned int n_samples;     /*All samples, may exceed SPF_STATS_SAMPLES*/
+    uint32_t last_usec;
+    uint32_t min_usec;
+    uint32_t max_usec;
+    uint64_t total_usec;
+    uint32_t samples[SPF_STATS_SAMPLES];    /*Ring of the last samples*/
+} spf_duration_stats_t;
+
+/*Work done by a run. Dijkstra counters cover the main SPF only, not the
+ * FORWARD_RUN and TILFA_RUN computations done for backups. Route counters
+ * are of unicast routes, a route is changed if its metric or any of its
+ * primary or backup nexthops differ from what was installed last*/
+typedef struct spf_run_counters_{
+
+    unsigned int nodes_popped;
+    unsigned int relaxations;       /*Better metric found for a node*/
+    unsigned int decrease_keys;     /*Relaxations of a node already on candidate tree*/
+    unsigned int ecmp_merges;       /*Equal cost paths merged into a node*/
+    unsigned int routes_added;
+    unsigned int routes_changed;
+    unsigned int routes_deleted;
+} spf_run_counters_t;
+
+typedef struct spf_log_entry_{
+
+    struct timeval timestamp;       /*Start of the run, wall clock*/
+    unsigned int version;
+    spf_type_t spf_type;
+    unsigned int triggers;          /*Bitmask of spf_trigger_t, 0 if not run by the scheduler*/
+    unsigned int n_triggers;
+    uint32_t duration_usec;
+    spf_run_counters_t counters;
+} spf_log_entry_t;
+
+typedef struct spf_stats_{
+
+    /*Run in progress*/
+    unsigned int run_depth;         /*Runs may nest, PRC falls back to FULL_RUN*/
+    uint64_t run_start_usec;
+    uint64_t phase_start_usec[SPF_PHASE_MAX];
+    uint32_t phase_usec[SPF_PHASE_MAX];    /*Summed over all entries of the phase in the run*/
+    unsigned int phases_entered;    /*Bitmask of spf_phase_t*/
+    spf_log_entry_t current;
+
+    spf_duration_stats_t phase[SPF_PHASE_MAX];
+    spf_duration_stats_t run;
+    spf_run_counters_t total;
+    unsigned int n_runs[TILFA_RUN + 1];    /*By spf_type_t*/
+
+    /*spf-log, last SPF_LOG_SIZE runs*/
+    spf_log_entry_t log[SPF_LOG_SIZE];
+    unsigned int log_next;
+    unsigned int log_count;
+} spf_stats_t;
+
+/*A run is everything done between these two calls, phases and counters
+ * reported outside a run are ignored*/
+void
+spf_stats_run_begin(node_t *spf_root, LEVEL level, spf_type_t spf_type);
+
+void
+spf_stats_run_end(node_t *spf_root, LEVEL level);
+
+void
+spf_stats_add_counters(node_t *spf_root, LEVEL level,
+                       spf_run_counters_t *counters);
+
+/*Counts an event handed to the SPF scheduler in the metrics*/
+void
+spf_metrics_count_trigger(LEVEL level, spf_trigger_t trigger);
+
+void
+spf_stats_show(node_t *spf_root, LEVEL level);
+
+void
+spf_stats_show_log(node_t *spf_root, LEVEL level);
+
+#endif /* __SPFSTATS__ */
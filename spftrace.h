@@ -75,5 +75,7 @@ is_spf_trace_enabled(instance_t *instance, spf_trace_t spf_trace);
 void
 spf_display_trace_options();
 
+#ifndef TR_COMPILED_OUT
 #define __ENABLE_TRACE__
+#endif
 #endif /* __SPF_TRACE__ */
@@ -198,32 +198,24 @@ void
 spf_determine_multi_area_attachment(spf_info_t *spf_info,
                                     node_t *spf_root){
 
-    singly_ll_node_t *list_node = NULL;
     spf_result_t *res = NULL;
     AREA myarea = spf_root->area;
     
     spf_info->spff_multi_area = 0;
        
-    ITERATE_LIST_BEGIN(spf_root->spf_run_result[LEVEL2], list_node){
+    ITERATE_HASH_VECTOR_BEGIN(spf_root->spf_run_result[LEVEL2], res){
         
-        res = (spf_result_t *)list_node->data;
         if(res->node->area != myarea && 
                 is_two_way_nbrship(res->node, spf_root, LEVEL2)){
             spf_info->spff_multi_area = 1;
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "spf_root : %s is L2 Attached with remote Area node : %s", 
-                            spf_root->node_name, res->node->node_name); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+            trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "spf_root : %s is L2 Attached with remote Area node : %s", 
+                            spf_root->node_name, res->node->node_name);
             break;   
         }
-    }ITERATE_LIST_END;
+    }ITERATE_HASH_VECTOR_END;
 
     if(spf_info->spff_multi_area == 0){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "spf_root : %s is not L2 Attached with remote Area", spf_root->node_name);
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
-#endif
+        trace_log(instance->traceopts, ROUTE_CALCULATION_BIT, "spf_root : %s is not L2 Attached with remote Area", spf_root->node_name);
     }
 }
 
@@ -331,17 +323,11 @@ print_nh_list2(internal_nh_t *nh_list){
 
     unsigned int i = 0;
 
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "printing next hop list"); 
-    trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
+    trace_log(instance->traceopts, DIJKSTRA_BIT, "printing next hop list");
     for(; i < MAX_NXT_HOPS; i++){
         if(is_nh_list_empty2(&nh_list[i])) return;
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "oif = %s, NH =  %s , Level = %s, gw_prefix = %s", 
+        trace_log(instance->traceopts, DIJKSTRA_BIT, "oif = %s, NH =  %s , Level = %s, gw_prefix = %s", 
             nh_list[i].oif->intf_name, nh_list[i].node->node_name, get_str_level(nh_list[i].level), nh_list[i].gw_prefix);
-        trace(instance->traceopts, DIJKSTRA_BIT);
-#endif
     }
 }
 
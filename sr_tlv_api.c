@@ -228,6 +228,8 @@ update_prefix_sid(node_t *node, prefix_t *prefix,
         return trigger_conflict_res;
     }
 
+    prefix_sid = glthread_to_prefix_sid(prefix->psid_thread_ptr);
+
     if(prefix_sid_value != PREFIX_SID_INDEX(prefix)){
         trigger_conflict_res = TRUE;
         mark_srgb_index_in_use(node->srgb, prefix_sid_value);
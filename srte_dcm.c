@@ -53,7 +53,7 @@ srte_policy_config_handler(param_t *param, ser_buff_t *tlv_buf,
             node_name = tlv->value;
     } TLV_LOOP_END;
 
-    node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+    node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name);
 
     switch(cmd_code){
         case CMDCODE_CONFIG_SRTE_SEG_LST:
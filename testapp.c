@@ -33,6 +33,7 @@
 #include "instance.h"
 #include <stdio.h>
 #include "libcli.h"
+#include "metrics.h"
 
 /*import from spfdcm.c*/
 extern void
@@ -71,12 +72,24 @@ instance_t *instance = NULL;
 int
 main(int argc, char **argv){
 
+    /* Every task of the application runs in the default domain of the
+     * dispatcher. Routers are not given domains of their own : SPF of one
+     * root reads and writes the nodes of other roots (their SPF results,
+     * backup nexthops, post-convergence results) and traceopts is global*/
     event_dispatcher_init();
     event_dispatcher_run();
 
     /* Lib cli initialization */
     spf_init_dcm();
 
+    /* Metrics registered by the modules*/
+    metrics_init();
+    spf_metrics_init();
+    routes_metrics_init();
+    data_plane_metrics_init();
+    tilfa_metrics_init();
+    mm_metrics_init();
+
     /* Topology Initialization*/
     //instance = build_linear_topo();
     //instance = pseudonode_ecmp_topo();
@@ -40,9 +40,30 @@
 #include "spfutil.h"
 #include "spftrace.h"
 #include "routes.h"
+#include "EventDispatcher/event_dispatcher.h"
+#include "metrics.h"
 #include <stdint.h>
+#include <stddef.h>
+#include <time.h>
 
 extern instance_t *instance;
+
+/* TILFA SID lists intern table, shared by all PLRs*/
+static tilfa_segment_list_intern_table_t tilfa_seglist_intern_table = {
+    .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+static metric_t *tilfa_computations_metric[MAX_LEVEL];
+static metric_t *tilfa_post_convergence_spf_runs_metric[MAX_LEVEL];
+/*Indexed by reverse_spf*/
+static metric_t *tilfa_remote_spf_hits_metric[MAX_LEVEL][2];
+static metric_t *tilfa_remote_spf_misses_metric[MAX_LEVEL][2];
+static metric_t *tilfa_remote_spf_evictions_metric[MAX_LEVEL][2];
+static metric_t *tilfa_remote_spf_entries_metric[MAX_LEVEL][2];
+static metric_t *tilfa_lazy_slices_metric;
+static metric_t *tilfa_interned_seglists_metric;
+static metric_t *tilfa_interned_seglist_refs_metric;
+
 typedef struct fn_ptr_arg_{
 
     tilfa_info_t *tilfa_info;
@@ -50,35 +71,35 @@ typedef struct fn_ptr_arg_{
     LEVEL level;
 } fn_ptr_arg_t;
 
-static ll_t *
+static hash_vector_t *
 tilfa_get_post_convergence_spf_result_list(
         tilfa_info_t *tilfa_info, LEVEL level){
 
     return tilfa_info->tilfa_post_convergence_spf_results[level];
 }
 
-static ll_t *
+static hash_vector_t *
 tilfa_get_pre_convergence_spf_result_list(
         tilfa_info_t *tilfa_info, LEVEL level){
 
     return tilfa_info->tilfa_pre_convergence_spf_results[level];
 }
 
-glthread_t *
-tilfa_get_post_convergence_spf_path_head(
+spf_path_dag_t **
+tilfa_get_post_convergence_spf_path_dag(
         tilfa_info_t *tilfa_info, LEVEL level){
  
-    return &tilfa_info->post_convergence_spf_path[level];
+    return &tilfa_info->post_convergence_spf_path_dag[level];
 }
 
 static internal_nh_t *
 tilfa_lookup_pre_convergence_primary_nexthops
             (tilfa_info_t *tilfa_info, node_t *node, LEVEL level){
 
-    ll_t *lst = tilfa_get_pre_convergence_spf_result_list(
+    hash_vector_t *lst = tilfa_get_pre_convergence_spf_result_list(
                 tilfa_info, level);    
 
-    spf_result_t *res = singly_ll_search_by_key(lst, (void *)node);
+    spf_result_t *res = hash_vector_search_by_key(lst, (void *)node);
     if(!res) return NULL;
 
     return res->next_hop[IPNH];
@@ -90,10 +111,10 @@ tilfa_lookup_post_convergence_primary_nexthops
             node_t *node, 
             LEVEL level, nh_type_t nh){
 
-    ll_t *lst = tilfa_get_post_convergence_spf_result_list(
+    hash_vector_t *lst = tilfa_get_post_convergence_spf_result_list(
                 tilfa_info, level);    
 
-    spf_result_t *res = singly_ll_search_by_key(lst, (void *)node);
+    spf_result_t *res = hash_vector_search_by_key(lst, (void *)node);
     if(!res) return NULL;
 
     return res->next_hop[nh];
@@ -103,107 +124,226 @@ static uint32_t
 tilfa_dist_from_self(tilfa_info_t *tilfa_info, 
                 node_t *node, LEVEL level){
 
-    ll_t *lst = tilfa_get_pre_convergence_spf_result_list(
+    hash_vector_t *lst = tilfa_get_pre_convergence_spf_result_list(
                 tilfa_info, level);    
 
-    spf_result_t *res = singly_ll_search_by_key(lst, (void *)node);
+    spf_result_t *res = hash_vector_search_by_key(lst, (void *)node);
 
     if(!res) return INFINITE_METRIC;
 
     return (uint32_t)res->spf_metric;
 }
 
-static ll_t *
-tilfa_get_remote_spf_result_lst(tilfa_info_t *tilfa_info, 
-                             node_t *node, LEVEL level,
-                             boolean flush_old_lst,
-                             boolean reverse_spf){
+static tilfa_remote_spf_db_t *
+tilfa_get_remote_spf_db(tilfa_info_t *tilfa_info, 
+                        LEVEL level, boolean reverse_spf){
+
+    return reverse_spf ? 
+        &tilfa_info->pre_convergence_remote_reverse_spf_db[level] : 
+        &tilfa_info->pre_convergence_remote_forward_spf_db[level];
+}
+
+static void
+tilfa_remote_spf_db_init(tilfa_remote_spf_db_t *rem_spf_db){
+
+    memset(rem_spf_db, 0, sizeof(tilfa_remote_spf_db_t));
+    init_glthread(&rem_spf_db->lru_head);
+    rem_spf_db->lru_tail = NULL;
+}
+
+/* Default cap scales with the topology, a dense result costs
+ * n_nodes distances and a fixed cap would thrash on large topologies*/
+static uint32_t
+tilfa_remote_spf_db_mem_cap(tilfa_info_t *tilfa_info){
+
+    uint64_t mem_cap = 0;
+
+    if(tilfa_info->tilfa_gl_var.remote_spf_db_mem_cap)
+        return tilfa_info->tilfa_gl_var.remote_spf_db_mem_cap;
+
+    mem_cap = (uint64_t)instance->n_nodes * sizeof(uint32_t) *
+                TILFA_REMOTE_SPF_DB_MIN_ENTRIES;
+    if(mem_cap < TILFA_REMOTE_SPF_DB_MEM_CAP)
+        return TILFA_REMOTE_SPF_DB_MEM_CAP;
+    return mem_cap > UINT32_MAX ? UINT32_MAX : (uint32_t)mem_cap;
+}
+
+static void
+tilfa_remote_spf_db_lru_unlink(tilfa_remote_spf_db_t *rem_spf_db,
+                               tilfa_remote_spf_result_t *tilfa_rem_spf_result){
 
-    singly_ll_node_t *curr = NULL, *prev = NULL;
-    singly_ll_node_t *curr1 = NULL, *prev1 = NULL;
+    glthread_t *lru_glue = &tilfa_rem_spf_result->lru_glue;
+
+    if(rem_spf_db->lru_tail == lru_glue){
+        rem_spf_db->lru_tail = (lru_glue->left == &rem_spf_db->lru_head) ?
+            NULL : lru_glue->left;
+    }
+    remove_glthread(lru_glue);
+}
+
+static void
+tilfa_remote_spf_db_lru_push_front(tilfa_remote_spf_db_t *rem_spf_db,
+                                   tilfa_remote_spf_result_t *tilfa_rem_spf_result){
+
+    glthread_add_next(&rem_spf_db->lru_head, &tilfa_rem_spf_result->lru_glue);
+    if(!rem_spf_db->lru_tail)
+        rem_spf_db->lru_tail = &tilfa_rem_spf_result->lru_glue;
+}
+
+static uint32_t
+tilfa_remote_spf_result_mem_size(tilfa_remote_spf_result_t *tilfa_rem_spf_result){
+
+    return (uint32_t)(sizeof(tilfa_remote_spf_result_t) + 
+            (tilfa_rem_spf_result->n_dist * sizeof(uint32_t)));
+}
+
+static void
+tilfa_remote_spf_db_remove(tilfa_remote_spf_db_t *rem_spf_db,
+                           tilfa_remote_spf_result_t *tilfa_rem_spf_result){
+
+    tilfa_remote_spf_result_t **pp = 
+        &rem_spf_db->bucket[TILFA_REMOTE_SPF_DB_HASH(tilfa_rem_spf_result->node)];
+
+    while(*pp != tilfa_rem_spf_result){
+        assert(*pp);
+        pp = &((*pp)->hash_next);
+    }
+    *pp = tilfa_rem_spf_result->hash_next;
+
+    tilfa_remote_spf_db_lru_unlink(rem_spf_db, tilfa_rem_spf_result);
+    rem_spf_db->n_entries--;
+    rem_spf_db->mem_in_use -= 
+        tilfa_remote_spf_result_mem_size(tilfa_rem_spf_result);
+
+    if(tilfa_rem_spf_result->dist)
+        XFREE(tilfa_rem_spf_result->dist);
+    XFREE(tilfa_rem_spf_result);
+}
+
+/* Evict least recently used entries until 'required' more
+ * bytes fit in the memory cap of the db*/
+static void
+tilfa_remote_spf_db_make_room(tilfa_remote_spf_db_t *rem_spf_db,
+                              uint32_t mem_cap,
+                              uint32_t required){
+
+    while(rem_spf_db->n_entries && 
+          rem_spf_db->mem_in_use + required > mem_cap){
+
+        assert(rem_spf_db->lru_tail);
+        tilfa_remote_spf_db_remove(rem_spf_db, 
+            lru_glue_to_tilfa_remote_spf_result(rem_spf_db->lru_tail));
+        rem_spf_db->evictions++;
+    }
+}
+
+/* Return the distance array of SPF run triggered on remote node.
+ * SPF is run on a miss, and the result is compacted to a dense array
+ * indexed by node->node_index*/
+static tilfa_remote_spf_result_t *
+tilfa_get_remote_spf_result(tilfa_info_t *tilfa_info, 
+                            node_t *node, LEVEL level,
+                            boolean reverse_spf){
 
     spf_result_t *spf_res = NULL;
     tilfa_remote_spf_result_t *tilfa_rem_spf_result = NULL;
+    uint32_t i = 0;
+
+    tilfa_remote_spf_db_t *rem_spf_db = 
+        tilfa_get_remote_spf_db(tilfa_info, level, reverse_spf);
 
-    ll_t *inner_lst = NULL;
-    
-    ll_t *outer_lst = reverse_spf ? 
-        tilfa_info->pre_convergence_remote_reverse_spf_results[level] : 
-        tilfa_info->pre_convergence_remote_forward_spf_results[level]; 
-    
     assert(node);
 
-    ITERATE_LIST_BEGIN2(outer_lst, curr, prev){
+    for(tilfa_rem_spf_result = 
+            rem_spf_db->bucket[TILFA_REMOTE_SPF_DB_HASH(node)];
+        tilfa_rem_spf_result; 
+        tilfa_rem_spf_result = tilfa_rem_spf_result->hash_next){
 
-        tilfa_rem_spf_result = curr->data;
-        if(tilfa_rem_spf_result->node == node){
-            inner_lst = tilfa_rem_spf_result->rem_spf_result_lst;
-            
-            if(!flush_old_lst) return inner_lst;
-
-            ITERATE_LIST_BEGIN2(inner_lst, curr1, prev1){    
-                spf_res = curr1->data;
-                XFREE(spf_res);
-            }ITERATE_LIST_END2(inner_lst, curr1, prev1);
-            delete_singly_ll(inner_lst);
-            return inner_lst;
-        }
-    } ITERATE_LIST_END2(outer_lst, curr, prev);
+        if(tilfa_rem_spf_result->node != node) continue;
+
+        rem_spf_db->hits++;
+        tilfa_remote_spf_db_lru_unlink(rem_spf_db, tilfa_rem_spf_result);
+        tilfa_remote_spf_db_lru_push_front(rem_spf_db, tilfa_rem_spf_result);
+        return tilfa_rem_spf_result;
+    }
+
+    rem_spf_db->misses++;
+
+    hash_vector_t *spf_result_lst = init_spf_run_result_list();
+
+    if(reverse_spf){
+        inverse_topology(instance, level);
+        spf_computation(node, &node->spf_info, level, 
+            TILFA_RUN, spf_result_lst, &tilfa_info->remote_spf_arena);
+        inverse_topology(instance, level);
+    }
+    else{
+        spf_computation(node, &node->spf_info, level, 
+            TILFA_RUN, spf_result_lst, &tilfa_info->remote_spf_arena);
+    }
 
     tilfa_rem_spf_result = XCALLOC(1, tilfa_remote_spf_result_t);
     tilfa_rem_spf_result->node = node;
-    tilfa_rem_spf_result->rem_spf_result_lst = init_singly_ll();
+    tilfa_rem_spf_result->n_dist = instance->n_nodes;
+    init_glthread(&tilfa_rem_spf_result->lru_glue);
 
-    singly_ll_set_comparison_fn(
-            tilfa_rem_spf_result->rem_spf_result_lst,
-            spf_run_result_comparison_fn);
+    tilfa_remote_spf_db_make_room(rem_spf_db, 
+        tilfa_remote_spf_db_mem_cap(tilfa_info),
+        tilfa_remote_spf_result_mem_size(tilfa_rem_spf_result));
+
+    tilfa_rem_spf_result->dist = XCALLOC(tilfa_rem_spf_result->n_dist, uint32_t);
+    
+    for(i = 0; i < tilfa_rem_spf_result->n_dist; i++){
+        tilfa_rem_spf_result->dist[i] = INFINITE_METRIC;
+    }
 
-    singly_ll_add_node_by_val(outer_lst, (void *)tilfa_rem_spf_result);
-    return tilfa_rem_spf_result->rem_spf_result_lst;
+    ITERATE_HASH_VECTOR_BEGIN(spf_result_lst, spf_res){
+        assert(spf_res->node->node_index < tilfa_rem_spf_result->n_dist);
+        tilfa_rem_spf_result->dist[spf_res->node->node_index] = 
+            spf_res->spf_metric;
+    }ITERATE_HASH_VECTOR_END;
+    delete_hash_vector(spf_result_lst);
+    XFREE(spf_result_lst);
+    mm_arena_reset(&tilfa_info->remote_spf_arena);
+
+    tilfa_rem_spf_result->hash_next = 
+        rem_spf_db->bucket[TILFA_REMOTE_SPF_DB_HASH(node)];
+    rem_spf_db->bucket[TILFA_REMOTE_SPF_DB_HASH(node)] = tilfa_rem_spf_result;
+    tilfa_remote_spf_db_lru_push_front(rem_spf_db, tilfa_rem_spf_result);
+    rem_spf_db->n_entries++;
+    rem_spf_db->mem_in_use += 
+        tilfa_remote_spf_result_mem_size(tilfa_rem_spf_result);
+    return tilfa_rem_spf_result;
 }
 
+static inline uint32_t
+tilfa_remote_spf_result_dist(tilfa_remote_spf_result_t *tilfa_rem_spf_result,
+                             node_t *node){
+
+    if(node->node_index >= tilfa_rem_spf_result->n_dist)
+        return INFINITE_METRIC;
+    return tilfa_rem_spf_result->dist[node->node_index];
+}
 
 static uint32_t
 tilfa_dist_from_x_to_y(tilfa_info_t *tilfa_info,
                 node_t *x, node_t *y, LEVEL level){
 
     /*Get spf result of remote node X*/
-    ll_t *x_spf_result_lst = 
-        tilfa_get_remote_spf_result_lst(tilfa_info, x, level, FALSE, FALSE);
-
-    if(is_singly_ll_empty(x_spf_result_lst)){
-        spf_computation(x, &x->spf_info, level, 
-            TILFA_RUN, x_spf_result_lst);
-    }
+    tilfa_remote_spf_result_t *x_spf_result = 
+        tilfa_get_remote_spf_result(tilfa_info, x, level, FALSE);
 
-    spf_result_t *y_res = singly_ll_search_by_key(
-                x_spf_result_lst, (void *)y); 
-
-    if(!y_res) return INFINITE_METRIC;
-
-    return (uint32_t)y_res->spf_metric;
+    return tilfa_remote_spf_result_dist(x_spf_result, y);
 }
 
 static uint32_t
 tilfa_dist_from_x_to_y_reverse_spf(tilfa_info_t *tilfa_info,
                 node_t *x, node_t *y, LEVEL level){
 
-    ll_t *y_spf_result_lst = 
-        tilfa_get_remote_spf_result_lst(tilfa_info, y, level, FALSE, TRUE);
-
-    if(is_singly_ll_empty(y_spf_result_lst)){
-        inverse_topology(instance, level);
-        spf_computation(y, &y->spf_info, level, 
-            TILFA_RUN, y_spf_result_lst);
-        inverse_topology(instance, level);
-    }
-
-    spf_result_t *x_res = singly_ll_search_by_key(
-                y_spf_result_lst, (void *)x); 
-
-    if(!x_res) return INFINITE_METRIC;
+    tilfa_remote_spf_result_t *y_spf_result = 
+        tilfa_get_remote_spf_result(tilfa_info, y, level, TRUE);
 
-    return (uint32_t)x_res->spf_metric;
+    return tilfa_remote_spf_result_dist(y_spf_result, x);
 }
 
 void
@@ -212,45 +352,79 @@ init_tilfa(node_t *node){
     assert(node->tilfa_info == NULL);
 
     LEVEL level_it;
+    tilfa_dest_priority_t priority;
    
     node->tilfa_info = XCALLOC(1, tilfa_info_t);
     
     node->tilfa_info->tilfa_gl_var.max_segments_allowed = TILFA_MAX_SEGMENTS;
+    node->tilfa_info->tilfa_gl_var.remote_spf_db_mem_cap = 0;
+    node->tilfa_info->tilfa_gl_var.lazy = FALSE;
+    node->tilfa_info->tilfa_gl_var.lazy_time_budget_msec = TILFA_LAZY_TIME_BUDGET_MSEC;
+    node->tilfa_info->dest_priority = TILFA_DEST_PRIORITY_MEDIUM;
     init_glthread(&node->tilfa_info->tilfa_lcl_config_head);
     node->tilfa_info->current_resource_pruned = NULL;
+    mm_arena_init(&node->tilfa_info->remote_spf_arena);
     
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
         
         node->tilfa_info->tilfa_pre_convergence_spf_results[level_it] = 
-            init_singly_ll();
-        singly_ll_set_comparison_fn(node->tilfa_info->
-            tilfa_pre_convergence_spf_results[level_it], 
-            spf_run_result_comparison_fn);
+            init_spf_run_result_list();
 
-        node->tilfa_info->tilfa_post_convergence_spf_results[level_it] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->tilfa_info->\
-            tilfa_post_convergence_spf_results[level_it], spf_run_result_comparison_fn);
+        node->tilfa_info->tilfa_post_convergence_spf_results[level_it] = 
+            init_spf_run_result_list();
 
-        node->tilfa_info->pre_convergence_remote_reverse_spf_results[level_it] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->tilfa_info->\
-            pre_convergence_remote_reverse_spf_results[level_it], 
-            spf_run_result_comparison_fn);
+        mm_arena_init(&node->tilfa_info->pre_convergence_spf_arena[level_it]);
+        mm_arena_init(&node->tilfa_info->post_convergence_spf_arena[level_it]);
 
-        init_glthread(&(node->tilfa_info->post_convergence_spf_path[level_it]));
+        tilfa_remote_spf_db_init(&node->tilfa_info->
+            pre_convergence_remote_reverse_spf_db[level_it]);
 
-        node->tilfa_info->pre_convergence_remote_forward_spf_results[level_it] = init_singly_ll();
+        node->tilfa_info->post_convergence_spf_path_dag[level_it] = NULL;
+
+        tilfa_remote_spf_db_init(&node->tilfa_info->
+            pre_convergence_remote_forward_spf_db[level_it]);
     
         init_glthread(&node->tilfa_info->tilfa_segment_list_head[level_it]);
+        for(priority = TILFA_DEST_PRIORITY_HIGH; 
+                priority < TILFA_DEST_PRIORITY_MAX; priority++){
+            init_glthread(&node->tilfa_info->tilfa_lazy_work_queue[level_it][priority].head);
+            node->tilfa_info->tilfa_lazy_work_queue[level_it][priority].tail = NULL;
+        }
+        node->tilfa_info->lazy_pr_res[level_it] = NULL;
     }
+    node->tilfa_info->lazy_task = NULL;
 
     node->tilfa_info->is_tilfa_pruned = FALSE;
 }
 
+boolean
+tilfa_is_srlg_protection_enabled(node_t *plr_node, char *protected_link){
+
+    glthread_t *curr;
+    tilfa_lcl_config_t *tilfa_lcl_config = NULL;
+
+    if(!plr_node->tilfa_info) return FALSE;
+
+    ITERATE_GLTHREAD_BEGIN(&plr_node->tilfa_info->tilfa_lcl_config_head, curr){
+
+        tilfa_lcl_config = 
+            tilfa_lcl_config_to_config_glue(curr);
+
+        if(strncmp(tilfa_lcl_config->protected_link, 
+                    protected_link, IF_NAME_SIZE)){
+            continue;
+        }
+        return tilfa_lcl_config->srlg_protection;
+    } ITERATE_GLTHREAD_END(&plr_node->tilfa_info->tilfa_lcl_config_head, curr);
+    return FALSE;
+}
+
 boolean
 tilfa_update_config(node_t *plr_node,
                      char *protected_link,
                      boolean link_protection,
-                     boolean node_protection){
+                     boolean node_protection,
+                     boolean srlg_protection){
 
     glthread_t *curr;
     boolean found = FALSE;
@@ -271,6 +445,8 @@ tilfa_update_config(node_t *plr_node,
         break;
     } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_lcl_config_head, curr);
 
+    if(!found) tilfa_lcl_config = NULL;
+
     if(found){
         if(link_protection == TRUE || link_protection == FALSE) {
             if(link_protection != tilfa_lcl_config->link_protection){
@@ -284,6 +460,12 @@ tilfa_update_config(node_t *plr_node,
                 config_change = TRUE;
             } 
         }
+        if(srlg_protection == TRUE || srlg_protection == FALSE) {
+            if(srlg_protection != tilfa_lcl_config->srlg_protection){
+                tilfa_lcl_config->srlg_protection = srlg_protection;
+                config_change = TRUE;
+            } 
+        }
     }
     else if(link_protection != DONT_KNOW || 
             node_protection != DONT_KNOW){
@@ -294,11 +476,15 @@ tilfa_update_config(node_t *plr_node,
             tilfa_lcl_config->link_protection = link_protection;
         if(node_protection == TRUE || node_protection == FALSE)
             tilfa_lcl_config->node_protection = node_protection;
+        if(srlg_protection == TRUE || srlg_protection == FALSE)
+            tilfa_lcl_config->srlg_protection = srlg_protection;
         init_glthread(&tilfa_lcl_config->config_glue);
         glthread_add_next(&tilfa_info->tilfa_lcl_config_head, 
                 &tilfa_lcl_config->config_glue);
         config_change = TRUE;
     }
+    if(!tilfa_lcl_config) return config_change;
+
     if(tilfa_lcl_config->node_protection == FALSE &&
             tilfa_lcl_config->link_protection == FALSE){
 
@@ -309,10 +495,99 @@ tilfa_update_config(node_t *plr_node,
     return config_change;
 }
 
+/*Remote SPF dbs and lazy slices are per PLR, summed over all nodes*/
+static void
+tilfa_metrics_collect(){
+
+    node_t *node = NULL;
+    LEVEL level_it;
+    int reverse_spf;
+    tilfa_remote_spf_db_t *rem_spf_db = NULL;
+    uint64_t hits[MAX_LEVEL][2], misses[MAX_LEVEL][2],
+             evictions[MAX_LEVEL][2], entries[MAX_LEVEL][2];
+    uint64_t lazy_slices = 0;
+
+    if(!instance) return;
+
+    memset(hits, 0, sizeof(hits));
+    memset(misses, 0, sizeof(misses));
+    memset(evictions, 0, sizeof(evictions));
+    memset(entries, 0, sizeof(entries));
+
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+        if(!node->tilfa_info) continue;
+        lazy_slices += node->tilfa_info->lazy_slices;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            for(reverse_spf = 0; reverse_spf < 2; reverse_spf++){
+                rem_spf_db = tilfa_get_remote_spf_db(node->tilfa_info,
+                                level_it, reverse_spf);
+                hits[level_it][reverse_spf] += rem_spf_db->hits;
+                misses[level_it][reverse_spf] += rem_spf_db->misses;
+                evictions[level_it][reverse_spf] += rem_spf_db->evictions;
+                entries[level_it][reverse_spf] += rem_spf_db->n_entries;
+            }
+        }
+    } ITERATE_HASH_VECTOR_END;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(reverse_spf = 0; reverse_spf < 2; reverse_spf++){
+            metric_set(tilfa_remote_spf_hits_metric[level_it][reverse_spf],
+                hits[level_it][reverse_spf]);
+            metric_set(tilfa_remote_spf_misses_metric[level_it][reverse_spf],
+                misses[level_it][reverse_spf]);
+            metric_set(tilfa_remote_spf_evictions_metric[level_it][reverse_spf],
+                evictions[level_it][reverse_spf]);
+            metric_set(tilfa_remote_spf_entries_metric[level_it][reverse_spf],
+                entries[level_it][reverse_spf]);
+        }
+    }
+    metric_set(tilfa_lazy_slices_metric, lazy_slices);
+    metric_set(tilfa_interned_seglists_metric, tilfa_seglist_intern_table.n_entries);
+    metric_set(tilfa_interned_seglist_refs_metric, tilfa_seglist_intern_table.n_refs);
+}
+
+void
+tilfa_metrics_init(){
+
+    LEVEL level_it;
+    int reverse_spf;
+    char labels[METRIC_LABELS_LEN];
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        snprintf(labels, sizeof(labels), "level=\"%u\"", level_it);
+        tilfa_computations_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "tilfa_computations_total", "TI-LFA backup computations of a PLR", labels);
+        tilfa_post_convergence_spf_runs_metric[level_it] = metrics_register(METRIC_COUNTER,
+            "tilfa_post_convergence_spf_runs_total", "SPF runs with a protected resource pruned", labels);
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(reverse_spf = 0; reverse_spf < 2; reverse_spf++){
+            snprintf(labels, sizeof(labels), "level=\"%u\",direction=\"%s\"",
+                level_it, reverse_spf ? "reverse" : "forward");
+            tilfa_remote_spf_hits_metric[level_it][reverse_spf] = metrics_register(METRIC_COUNTER,
+                "tilfa_remote_spf_cache_hits_total", "Remote SPF results found in the db", labels);
+            tilfa_remote_spf_misses_metric[level_it][reverse_spf] = metrics_register(METRIC_COUNTER,
+                "tilfa_remote_spf_cache_misses_total", "Remote SPF runs done on a miss", labels);
+            tilfa_remote_spf_evictions_metric[level_it][reverse_spf] = metrics_register(METRIC_COUNTER,
+                "tilfa_remote_spf_cache_evictions_total", "Remote SPF results evicted to stay in the memory cap", labels);
+            tilfa_remote_spf_entries_metric[level_it][reverse_spf] = metrics_register(METRIC_GAUGE,
+                "tilfa_remote_spf_cache_entries", "Remote SPF results held", labels);
+        }
+    }
+    tilfa_lazy_slices_metric = metrics_register(METRIC_COUNTER,
+        "tilfa_lazy_slices_total", "Time slices run by lazy TI-LFA computation", NULL);
+    tilfa_interned_seglists_metric = metrics_register(METRIC_GAUGE,
+        "tilfa_interned_seglists", "Unique interned SID lists", NULL);
+    tilfa_interned_seglist_refs_metric = metrics_register(METRIC_GAUGE,
+        "tilfa_interned_seglist_refs", "References to interned SID lists", NULL);
+    metrics_register_collector(tilfa_metrics_collect);
+}
+
 void
 show_tilfa_database(node_t *node){
 
     int i = 0;
+    tilfa_dest_priority_t priority;
     glthread_t *curr = NULL;
     tilfa_lcl_config_t *tilfa_lcl_config = NULL;
     tilfa_segment_list_t *tilfa_segment_list = NULL;
@@ -336,15 +611,72 @@ show_tilfa_database(node_t *node){
         tilfa_lcl_config =
             tilfa_lcl_config_to_config_glue(curr);
 
-        printf("\t\t link protected : %s LP : %sset : NP : %sset\n",
+        printf("\t\t link protected : %s LP : %sset : NP : %sset%s\n",
                 tilfa_lcl_config->protected_link,
                 tilfa_lcl_config->link_protection ? "" : "un",
-                tilfa_lcl_config->node_protection ? "" : "un");
+                tilfa_lcl_config->node_protection ? "" : "un",
+                tilfa_lcl_config->srlg_protection ? " : SRLG : set" : "");
     } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_lcl_config_head, curr);
     
+    printf("\tRemote SPF db (mem cap = %u bytes%s) :\n",
+        tilfa_remote_spf_db_mem_cap(tilfa_info),
+        tilfa_info->tilfa_gl_var.remote_spf_db_mem_cap ? "" : ", auto");
+
+    LEVEL level_it;
+    tilfa_remote_spf_db_t *rem_spf_db = NULL;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        rem_spf_db = &tilfa_info->pre_convergence_remote_forward_spf_db[level_it];
+        printf("\t\t%s forward : entries = %u, mem = %u, hits = %llu, "
+                "misses = %llu, evictions = %llu\n", get_str_level(level_it),
+                rem_spf_db->n_entries, rem_spf_db->mem_in_use,
+                (unsigned long long)rem_spf_db->hits, 
+                (unsigned long long)rem_spf_db->misses,
+                (unsigned long long)rem_spf_db->evictions);
+
+        rem_spf_db = &tilfa_info->pre_convergence_remote_reverse_spf_db[level_it];
+        printf("\t\t%s reverse : entries = %u, mem = %u, hits = %llu, "
+                "misses = %llu, evictions = %llu\n", get_str_level(level_it),
+                rem_spf_db->n_entries, rem_spf_db->mem_in_use,
+                (unsigned long long)rem_spf_db->hits, 
+                (unsigned long long)rem_spf_db->misses,
+                (unsigned long long)rem_spf_db->evictions);
+    }
+
+    printf("\tSID lists interned : unique = %u, references = %u\n",
+        tilfa_seglist_intern_table.n_entries,
+        tilfa_seglist_intern_table.n_refs);
+
+    printf("\tLazy computation : %s, time budget = %u msec, slices run = %u\n",
+        tilfa_info->tilfa_gl_var.lazy ? "Enabled" : "Disabled",
+        tilfa_info->tilfa_gl_var.lazy_time_budget_msec,
+        tilfa_info->lazy_slices);
+    printf("\tDestination priority : %s\n", 
+        tilfa_get_str_dest_priority(tilfa_info->dest_priority));
+    printf("\tDestinations pending protection :\n");
+
+    tilfa_lazy_work_t *work = NULL;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        for(priority = TILFA_DEST_PRIORITY_HIGH; 
+                priority < TILFA_DEST_PRIORITY_MAX; priority++){
+
+            ITERATE_GLTHREAD_BEGIN(&tilfa_info->tilfa_lazy_work_queue[level_it][priority].head, curr){
+
+                work = work_glue_to_tilfa_lazy_work(curr);
+                printf("\t\t%s, Dest : %s, Protected Resource : (%s)%s, priority : %s\n",
+                    get_str_level(level_it), work->dest->node_name,
+                    work->pr_res->plr_node->node_name,
+                    work->pr_res->protected_link->intf_name,
+                    tilfa_get_str_dest_priority(work->priority));
+            } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_lazy_work_queue[level_it][priority].head, curr);
+        }
+    }
+
     printf("\tTilfa Results:\n");
     
-    LEVEL level_it;
     for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
         
         ITERATE_GLTHREAD_BEGIN(&tilfa_info->tilfa_segment_list_head[level_it], curr){
@@ -357,41 +689,125 @@ show_tilfa_database(node_t *node){
             printf("\t\tProtection type : LP : %sset   NP : %sset\n",
                     tilfa_segment_list->pr_res->link_protection ? "" : "un",
                     tilfa_segment_list->pr_res->node_protection ? "" : "un");
+            if(tilfa_segment_list->pr_res->srlg_protection){
+                printf("\t\tSRLG protected : %u (%u member links)\n",
+                    tilfa_segment_list->pr_res->srlg,
+                    GET_NODE_COUNT_SINGLY_LL(tilfa_segment_list->pr_res->srlg_members));
+            }
             printf("\t\t%s, n_segment_list = %d\n", 
                 get_str_level(level_it), tilfa_segment_list->n_segment_list);
 
             for(i = 0 ; i < tilfa_segment_list->n_segment_list; i++){
                 printf("%s\n", tilfa_print_one_liner_segment_list
-                    (&tilfa_segment_list->gen_segment_list[i], TRUE, TRUE));
+                    (tilfa_segment_list->gen_segment_list[i], TRUE, TRUE));
             }
         } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_segment_list_head[level_it], curr);
     }
 }
 
+static uint32_t
+tilfa_gen_segment_list_hash(gen_segment_list_t *gen_segment_list){
+
+    /*FNV-1a over the raw bytes, consistent with memcmp identity*/
+    uint32_t i = 0;
+    uint32_t hash = 2166136261U;
+    unsigned char *byte = (unsigned char *)gen_segment_list;
+
+    for( ; i < sizeof(gen_segment_list_t); i++){
+        hash ^= byte[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/* Return the interned copy of gen_segment_list with a reference
+ * taken on it. gen_segment_list must be zero-initialized before being
+ * filled so that padding bytes do not defeat the memcmp identity*/
+gen_segment_list_t *
+tilfa_intern_gen_segment_list(gen_segment_list_t *gen_segment_list){
+
+    tilfa_interned_segment_list_t *interned = NULL;
+    uint32_t hash = tilfa_gen_segment_list_hash(gen_segment_list);
+    uint32_t bucket = hash % TILFA_SEGMENT_LIST_INTERN_HASH_SIZE;
+
+    pthread_mutex_lock(&tilfa_seglist_intern_table.lock);
+    for(interned = tilfa_seglist_intern_table.bucket[bucket]; 
+        interned;
+        interned = interned->hash_next){
+
+        if(interned->hash != hash) continue;
+        if(memcmp(&interned->gen_segment_list, gen_segment_list,
+                    sizeof(gen_segment_list_t))) continue;
+        
+        interned->ref_count++;
+        tilfa_seglist_intern_table.n_refs++;
+        pthread_mutex_unlock(&tilfa_seglist_intern_table.lock);
+        return &interned->gen_segment_list;
+    }
+
+    interned = XCALLOC(1, tilfa_interned_segment_list_t);
+    memcpy(&interned->gen_segment_list, gen_segment_list, 
+            sizeof(gen_segment_list_t));
+    interned->hash = hash;
+    interned->ref_count = 1;
+    interned->hash_next = tilfa_seglist_intern_table.bucket[bucket];
+    tilfa_seglist_intern_table.bucket[bucket] = interned;
+    tilfa_seglist_intern_table.n_entries++;
+    tilfa_seglist_intern_table.n_refs++;
+    pthread_mutex_unlock(&tilfa_seglist_intern_table.lock);
+    return &interned->gen_segment_list;
+}
+
+static inline void
+tilfa_lock_interned_gen_segment_list(gen_segment_list_t *gen_segment_list){
+
+    pthread_mutex_lock(&tilfa_seglist_intern_table.lock);
+    ((tilfa_interned_segment_list_t *)gen_segment_list)->ref_count++;
+    tilfa_seglist_intern_table.n_refs++;
+    pthread_mutex_unlock(&tilfa_seglist_intern_table.lock);
+}
+
 void
-tilfa_clear_post_convergence_spf_path(
-        glthread_t *post_convergence_spf_path_head){
+tilfa_unintern_gen_segment_list(gen_segment_list_t *gen_segment_list){
 
-    glthread_t *curr = NULL, *curr1= NULL;
-    spf_path_result_t *spf_path_result = NULL;
-    pred_info_t *pred_info = NULL;
+    tilfa_interned_segment_list_t **pp = NULL;
+    tilfa_interned_segment_list_t *interned = 
+        (tilfa_interned_segment_list_t *)gen_segment_list;
 
-        ITERATE_GLTHREAD_BEGIN(post_convergence_spf_path_head, curr){
+    pthread_mutex_lock(&tilfa_seglist_intern_table.lock);
+    assert(interned->ref_count);
+    interned->ref_count--;
+    tilfa_seglist_intern_table.n_refs--;
 
-            spf_path_result = glthread_to_spf_path_result(curr);
+    if(interned->ref_count){
+        pthread_mutex_unlock(&tilfa_seglist_intern_table.lock);
+        return;
+    }
 
-            ITERATE_GLTHREAD_BEGIN(&spf_path_result->pred_db, curr1){
+    pp = &tilfa_seglist_intern_table.bucket[
+            interned->hash % TILFA_SEGMENT_LIST_INTERN_HASH_SIZE];
 
-                pred_info = glthread_to_pred_info(curr1);
-                remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
-            } ITERATE_GLTHREAD_END(&spf_path_result->pred_db, curr1);
+    while(*pp != interned){
+        assert(*pp);
+        pp = &((*pp)->hash_next);
+    }
+    *pp = interned->hash_next;
+    tilfa_seglist_intern_table.n_entries--;
+    pthread_mutex_unlock(&tilfa_seglist_intern_table.lock);
+    XFREE(interned);
+}
 
-            remove_glthread(&spf_path_result->glue);
-            XFREE(spf_path_result);
-        } ITERATE_GLTHREAD_END(post_convergence_spf_path_head, curr);
+static void
+tilfa_free_segment_list(tilfa_segment_list_t *tilfa_segment_list){
 
-        init_glthread(post_convergence_spf_path_head);
+    int i = 0;
+
+    for( ; i < tilfa_segment_list->n_segment_list; i++){
+        tilfa_unintern_gen_segment_list(tilfa_segment_list->gen_segment_list[i]);
+    }
+    if(tilfa_segment_list->pr_res)
+        tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
+    XFREE(tilfa_segment_list);
 }
 
 static void
@@ -408,16 +824,14 @@ tilfa_clear_segments_list(
         
         if(!pr_res){
             remove_glthread(&tilfa_segment_list->gen_segment_list_glue);
-            tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-            XFREE(tilfa_segment_list);
+            tilfa_free_segment_list(tilfa_segment_list);
             tilfa_segment_list = NULL;
             continue;
         }
         else if(tlfa_protected_resource_equal(tilfa_segment_list->pr_res,
                     pr_res)){
             remove_glthread(&tilfa_segment_list->gen_segment_list_glue);
-            tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-            XFREE(tilfa_segment_list);
+            tilfa_free_segment_list(tilfa_segment_list);
             tilfa_segment_list = NULL;
             return;
         }
@@ -431,18 +845,8 @@ tilfa_clear_all_pre_convergence_results(node_t *node, LEVEL level){
     
    if(!tilfa_info) return;
     
-   singly_ll_node_t *list_node = NULL;
-
-   spf_result_t *result = NULL;
-
-   ITERATE_LIST_BEGIN(tilfa_info->tilfa_pre_convergence_spf_results[level], list_node){
-
-       result = list_node->data;
-       XFREE(result);
-       result = NULL;
-   }ITERATE_LIST_END;
-   
-   delete_singly_ll(tilfa_info->tilfa_pre_convergence_spf_results[level]);
+   hash_vector_clear(tilfa_info->tilfa_pre_convergence_spf_results[level]);
+   mm_arena_reset(&tilfa_info->pre_convergence_spf_arena[level]);
 
    tilfa_clear_preconvergence_remote_spf_results(tilfa_info, 0, level, FALSE);
    
@@ -452,28 +856,28 @@ tilfa_clear_all_pre_convergence_results(node_t *node, LEVEL level){
 }
 
 static void
-tilfa_clear_all_post_convergence_results(node_t *spf_root, LEVEL level, 
-        protected_resource_t *pr_res){
+tilfa_clear_post_convergence_spf_results(node_t *spf_root, LEVEL level){
 
     tilfa_info_t *tilfa_info = spf_root->tilfa_info;
 
     if(!tilfa_info) return;
 
-    singly_ll_node_t *list_node = NULL;
+    hash_vector_clear(tilfa_info->tilfa_post_convergence_spf_results[level]);
+    mm_arena_reset(&tilfa_info->post_convergence_spf_arena[level]);
 
-    spf_result_t *result = NULL;
+    spf_path_dag_free(tilfa_get_post_convergence_spf_path_dag(
+            spf_root->tilfa_info, level));
+}
 
-    ITERATE_LIST_BEGIN(tilfa_info->tilfa_post_convergence_spf_results[level], list_node){
+static void
+tilfa_clear_all_post_convergence_results(node_t *spf_root, LEVEL level, 
+        protected_resource_t *pr_res){
 
-        result = list_node->data;
-        XFREE(result);
-        result = NULL;
-    }ITERATE_LIST_END;
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
 
-    delete_singly_ll(tilfa_info->tilfa_post_convergence_spf_results[level]);
+    if(!tilfa_info) return;
 
-    tilfa_clear_post_convergence_spf_path(
-            tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level));
+    tilfa_clear_post_convergence_spf_results(spf_root, level);
 
     tilfa_clear_segments_list(&(tilfa_info->tilfa_segment_list_head[level]), pr_res);
 }
@@ -488,6 +892,12 @@ tilfa_topology_prune_protected_resource(node_t *node,
     if(pr_res->link_protection){
         link->is_tilfa_pruned = TRUE;
     }
+    if(pr_res->srlg_protection){
+        singly_ll_node_t *list_node = NULL;
+        ITERATE_LIST_BEGIN(pr_res->srlg_members, list_node){
+            ((edge_t *)list_node->data)->is_tilfa_pruned = TRUE;
+        } ITERATE_LIST_END;
+    }
     if(pr_res->node_protection){
         node_t *nbr_node = link->to.node;
         nbr_node->tilfa_info->is_tilfa_pruned = TRUE;
@@ -503,6 +913,12 @@ tilfa_topology_unprune_protected_resource(node_t *node,
     assert(pr_res->plr_node == node);
     edge_t *link = GET_EGDE_PTR_FROM_FROM_EDGE_END(pr_res->protected_link);
     link->is_tilfa_pruned = FALSE;
+    if(pr_res->srlg_protection){
+        singly_ll_node_t *list_node = NULL;
+        ITERATE_LIST_BEGIN(pr_res->srlg_members, list_node){
+            ((edge_t *)list_node->data)->is_tilfa_pruned = FALSE;
+        } ITERATE_LIST_END;
+    }
     node_t *nbr_node = link->to.node;
     nbr_node->tilfa_info->is_tilfa_pruned = FALSE;
 }
@@ -510,35 +926,22 @@ tilfa_topology_unprune_protected_resource(node_t *node,
 static void
 compute_tilfa_post_convergence_spf_primary_nexthops(node_t *spf_root, LEVEL level){
 
-    assert(is_singly_ll_empty(tilfa_get_post_convergence_spf_result_list
+    assert(IS_HASH_VECTOR_EMPTY(tilfa_get_post_convergence_spf_result_list
         (spf_root->tilfa_info, level)));
+    metric_counter_inc(tilfa_post_convergence_spf_runs_metric[level]);
     spf_computation(spf_root, &spf_root->spf_info, level, 
-        TILFA_RUN, tilfa_get_post_convergence_spf_result_list(spf_root->tilfa_info, level));
+        TILFA_RUN, tilfa_get_post_convergence_spf_result_list(spf_root->tilfa_info, level),
+        &spf_root->tilfa_info->post_convergence_spf_arena[level]);
 }
 
 static void
 compute_tilfa_pre_convergence_spf_primary_nexthops(node_t *spf_root, LEVEL level){
 
-    assert(is_singly_ll_empty(tilfa_get_pre_convergence_spf_result_list(
+    assert(IS_HASH_VECTOR_EMPTY(tilfa_get_pre_convergence_spf_result_list(
         spf_root->tilfa_info, level)));
     spf_computation(spf_root, &spf_root->spf_info, level, 
-        TILFA_RUN, tilfa_get_pre_convergence_spf_result_list(spf_root->tilfa_info, level));
-}
-
-spf_path_result_t *
-tilfa_lookup_spf_path_result(node_t *node, node_t *candidate_node, 
-                             LEVEL level){
-
-    glthread_t *curr = NULL;
-
-    ITERATE_GLTHREAD_BEGIN(&node->tilfa_info->post_convergence_spf_path[level], curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-        if(spf_path_result->node == candidate_node){
-            return spf_path_result;
-        }
-    } ITERATE_GLTHREAD_END(&node->tilfa_info->post_convergence_spf_path[level], curr);
-    return NULL;    
+        TILFA_RUN, tilfa_get_pre_convergence_spf_result_list(spf_root->tilfa_info, level),
+        &spf_root->tilfa_info->pre_convergence_spf_arena[level]);
 }
 
 static void
@@ -569,6 +972,343 @@ tilfa_fill_protected_resource_from_config(node_t *plr_node,
     tilfa_lock_protected_resource(*pr_res);
 }
 
+/* SRLG protected resource : all links of the topology which are member
+ * of srlg are collected once here, so that they are pruned together
+ * and protected by one post-convergence SPF run*/
+static void
+tilfa_fill_srlg_protected_resource(node_t *plr_node,
+            protected_resource_t **pr_res,
+            tilfa_lcl_config_t *tilfa_lcl_config,
+            unsigned int srlg){
+
+    unsigned int i = 0;
+    node_t *node = NULL;
+    edge_t *edge = NULL;
+    edge_end_t *edge_end = NULL;
+    singly_ll_node_t *list_node = NULL;
+
+    tilfa_fill_protected_resource_from_config(plr_node, 
+            pr_res, tilfa_lcl_config);
+
+    if(!(*pr_res) || !(*pr_res)->protected_link)
+        return;
+
+    (*pr_res)->srlg_protection = TRUE;
+    (*pr_res)->srlg = srlg;
+    (*pr_res)->srlg_members = init_singly_ll();
+
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+
+        for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+            edge_end = node->edges[i];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING) continue;
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            if(is_edge_srlg_member(edge, srlg))
+                singly_ll_add_node_by_val((*pr_res)->srlg_members, edge);
+        }
+    } ITERATE_HASH_VECTOR_END;
+}
+
+/* Lazy TILFA computation. compute_tilfa() only queues the impacted
+ * destinations, SID lists are then computed by a background job on the
+ * EventDispatcher, highest priority destinations first, in slices bounded
+ * by lazy_time_budget_msec. Routes are re-installed with TILFA backups once
+ * the queue drains*/
+
+static void
+tilfa_lazy_compute_job(void *arg, uint32_t arg_size);
+
+static boolean
+tilfa_is_destination_impacted(tilfa_info_t *tilfa_info, 
+                              node_t *dest, LEVEL level,
+                              protected_resource_t *pr_res);
+
+static void
+tilfa_compute_segment_lists_per_destination(
+                        node_t *spf_root, 
+                        LEVEL level,
+                        protected_resource_t *pr_res,
+                        node_t *dst_node);
+
+static void
+tilfa_lazy_work_enqueue(tilfa_info_t *tilfa_info, LEVEL level,
+                        tilfa_lazy_work_t *work){
+
+    tilfa_lazy_queue_t *queue = 
+        &tilfa_info->tilfa_lazy_work_queue[level][work->priority];
+
+    init_glthread(&work->work_glue);
+    glthread_add_next(queue->tail ? queue->tail : &queue->head, 
+        &work->work_glue);
+    queue->tail = &work->work_glue;
+}
+
+/*Highest priority first, in the order queued within a priority*/
+static tilfa_lazy_work_t *
+tilfa_lazy_work_dequeue(tilfa_info_t *tilfa_info, LEVEL level){
+
+    tilfa_dest_priority_t priority;
+    tilfa_lazy_queue_t *queue = NULL;
+    glthread_t *curr = NULL;
+
+    for(priority = TILFA_DEST_PRIORITY_HIGH; 
+            priority < TILFA_DEST_PRIORITY_MAX; priority++){
+
+        queue = &tilfa_info->tilfa_lazy_work_queue[level][priority];
+        curr = dequeue_glthread_first(&queue->head);
+        if(!curr) continue;
+        if(queue->tail == curr)
+            queue->tail = NULL;
+        return work_glue_to_tilfa_lazy_work(curr);
+    }
+    return NULL;
+}
+
+static boolean
+tilfa_lazy_work_pending(tilfa_info_t *tilfa_info, LEVEL level){
+
+    tilfa_dest_priority_t priority;
+
+    for(priority = TILFA_DEST_PRIORITY_HIGH; 
+            priority < TILFA_DEST_PRIORITY_MAX; priority++){
+        if(!IS_GLTHREAD_LIST_EMPTY(
+            &tilfa_info->tilfa_lazy_work_queue[level][priority].head))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+tilfa_lazy_release_post_convergence_results(node_t *spf_root, LEVEL level){
+
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    if(!tilfa_info->lazy_pr_res[level]) return;
+
+    tilfa_clear_post_convergence_spf_results(spf_root, level);
+    tilfa_unlock_protected_resource(tilfa_info->lazy_pr_res[level]);
+    tilfa_info->lazy_pr_res[level] = NULL;
+}
+
+/* Bring post-convergence results of pr_res in place, if they
+ * are not already*/
+static void
+tilfa_lazy_materialize_post_convergence_results(node_t *spf_root, 
+                LEVEL level, protected_resource_t *pr_res){
+
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    if(tilfa_info->lazy_pr_res[level] == pr_res) return;
+
+    tilfa_lazy_release_post_convergence_results(spf_root, level);
+    
+    tilfa_topology_prune_protected_resource(spf_root, pr_res);
+    compute_tilfa_post_convergence_spf_primary_nexthops(spf_root, level);
+    compute_spf_paths(spf_root, level, TILFA_RUN);
+    tilfa_topology_unprune_protected_resource(spf_root, pr_res);
+
+    tilfa_info->lazy_pr_res[level] = pr_res;
+    tilfa_lock_protected_resource(pr_res);
+}
+
+static void
+tilfa_lazy_flush_work(node_t *spf_root, LEVEL level){
+
+    tilfa_lazy_work_t *work = NULL;
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    while((work = tilfa_lazy_work_dequeue(tilfa_info, level))){
+        tilfa_unlock_protected_resource(work->pr_res);
+        XFREE(work);
+    }
+
+    tilfa_lazy_release_post_convergence_results(spf_root, level);
+}
+
+static void
+tilfa_lazy_enqueue_impacted_destinations(node_t *spf_root, LEVEL level,
+                                         protected_resource_t *pr_res){
+
+    spf_result_t *result = NULL;
+    singly_ll_node_t *curr = NULL;
+    tilfa_lazy_work_t *work = NULL;
+    node_t *dst_node = NULL;
+
+    ITERATE_HASH_VECTOR_BEGIN(tilfa_get_pre_convergence_spf_result_list(
+                spf_root->tilfa_info, level), result){
+
+        dst_node = result->node;
+
+        if(dst_node->node_type[level] == PSEUDONODE)
+            continue;
+
+        if(!tilfa_is_destination_impacted(spf_root->tilfa_info,
+            dst_node, level, pr_res)){
+            continue;
+        }
+
+        work = XCALLOC(1, tilfa_lazy_work_t);
+        work->dest = dst_node;
+        work->pr_res = pr_res;
+        tilfa_lock_protected_resource(pr_res);
+        work->priority = dst_node->tilfa_info ? 
+            dst_node->tilfa_info->dest_priority : TILFA_DEST_PRIORITY_MEDIUM;
+
+        tilfa_lazy_work_enqueue(spf_root->tilfa_info, level, work);
+    } ITERATE_HASH_VECTOR_END;
+}
+
+static void
+tilfa_lazy_schedule(node_t *spf_root){
+
+    LEVEL level_it;
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    if(tilfa_info->lazy_task) return;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(tilfa_lazy_work_pending(tilfa_info, level_it))
+            break;
+    }
+    if(level_it == MAX_LEVEL) return;
+
+    /*Background work, must not delay CLI and SPF jobs. Default domain,
+     * the work reads the SPF results and topology shared by all roots*/
+    tilfa_info->lazy_task = (void *)task_create_new_job_in_domain(
+            (void *)spf_root, tilfa_lazy_compute_job, TASK_ONE_SHOT,
+            TASK_PRIORITY_LOW, NULL);
+}
+
+static uint32_t
+tilfa_lazy_elapsed_msec(struct timespec *start){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((now.tv_sec - start->tv_sec) * 1000) + 
+            ((now.tv_nsec - start->tv_nsec) / 1000000));
+}
+
+static void
+tilfa_lazy_compute_job(void *arg, uint32_t arg_size){
+
+    LEVEL level_it;
+    tilfa_lazy_work_t *work = NULL;
+    struct timespec start;
+    
+    node_t *spf_root = (node_t *)arg;
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tilfa_info->lazy_slices++;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        while((work = tilfa_lazy_work_dequeue(tilfa_info, level_it))){
+
+            tilfa_lazy_materialize_post_convergence_results(
+                spf_root, level_it, work->pr_res);
+
+            tilfa_compute_segment_lists_per_destination(
+                spf_root, level_it, work->pr_res, work->dest);
+
+            tilfa_unlock_protected_resource(work->pr_res);
+            XFREE(work);
+
+            if(!tilfa_lazy_work_pending(tilfa_info, level_it)){
+                
+                trace_log(instance->traceopts, TILFA_BIT, "Node : %s : %s : Lazy TILFA "
+                    "computation complete, re-installing routes", 
+                    spf_root->node_name, get_str_level(level_it));
+
+                tilfa_lazy_release_post_convergence_results(spf_root, level_it);
+                spf_reinstall_routes(spf_root, level_it);
+                break;
+            }
+
+            if(tilfa_lazy_elapsed_msec(&start) >= 
+                    tilfa_info->tilfa_gl_var.lazy_time_budget_msec){
+                /*Yield, resume in next slice*/
+                task_schedule_again(NULL);
+                return;
+            }
+        }
+    }
+    tilfa_info->lazy_task = NULL;
+}
+
+static void
+tilfa_protect_resource(node_t *spf_root, LEVEL level, 
+                       protected_resource_t *pr_res){
+
+    if(spf_root->tilfa_info->tilfa_gl_var.lazy){
+        tilfa_lazy_enqueue_impacted_destinations(spf_root, level, pr_res);
+        return;
+    }
+    tilfa_run_post_convergence_spf(spf_root, level, pr_res);
+}
+
+/* Protect every SRLG the configured link is member of. SRLGs already
+ * protected through other local links in this run are skipped, so that
+ * there is one post-convergence SPF run per SRLG, not per link.
+ * Link without any SRLG falls back to plain link protection*/
+static void
+tilfa_protect_srlgs(node_t *spf_root, LEVEL level,
+                    tilfa_lcl_config_t *tilfa_lcl_config,
+                    unsigned int *srlg_done,
+                    unsigned int *n_srlg_done){
+
+    unsigned int i = 0, j = 0;
+    tilfa_info_t *tilfa_info = spf_root->tilfa_info;
+
+    edge_end_t *interface = get_interface_from_intf_name(spf_root,
+                                tilfa_lcl_config->protected_link);
+    if(!interface) return;
+
+    edge_t *edge = GET_EGDE_PTR_FROM_EDGE_END(interface);
+
+    if(!edge->n_srlg){
+        tilfa_fill_protected_resource_from_config(spf_root,
+                &tilfa_info->current_resource_pruned,
+                tilfa_lcl_config);
+        if(tilfa_info->current_resource_pruned){
+            tilfa_protect_resource(spf_root, level, 
+                tilfa_info->current_resource_pruned);
+        }
+        return;
+    }
+
+    for(i = 0; i < edge->n_srlg; i++){
+
+        for(j = 0; j < *n_srlg_done; j++){
+            if(srlg_done[j] == edge->srlg[i])
+                break;
+        }
+        if(j < *n_srlg_done){
+            trace_log(instance->traceopts, TILFA_BIT, "Node : %s : level %s, SRLG %u "
+                "of link %s is already protected", spf_root->node_name, 
+                get_str_level(level), edge->srlg[i], interface->intf_name);
+            continue;
+        }
+        srlg_done[(*n_srlg_done)++] = edge->srlg[i];
+
+        tilfa_fill_srlg_protected_resource(spf_root,
+                &tilfa_info->current_resource_pruned,
+                tilfa_lcl_config, edge->srlg[i]);
+
+        if(!tilfa_info->current_resource_pruned)
+            continue;
+
+        trace_log(instance->traceopts, TILFA_BIT, "Node : %s : level %s, SRLG %u : "
+            "%u member links pruned", spf_root->node_name, get_str_level(level),
+            edge->srlg[i], GET_NODE_COUNT_SINGLY_LL(
+            tilfa_info->current_resource_pruned->srlg_members));
+
+        tilfa_protect_resource(spf_root, level, 
+            tilfa_info->current_resource_pruned);
+    }
+}
+
 void
 compute_tilfa(node_t *spf_root, LEVEL level){
 
@@ -582,30 +1322,44 @@ compute_tilfa(node_t *spf_root, LEVEL level){
 #endif
     glthread_t *curr;
     tilfa_lcl_config_t *tilfa_lcl_config = NULL;
+    unsigned int srlg_done[MAX_NODE_INTF_SLOTS * MAX_SRLG_PER_LINK];
+    unsigned int n_srlg_done = 0;
 
-    sprintf(instance->traceopts->b, "Node : %s : %s() triggered, level %s",
+    trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : %s() triggered, level %s",
         spf_root->node_name, __FUNCTION__, get_str_level(level));
-    trace(instance->traceopts, SPF_EVENTS_BIT);
 
     tilfa_clear_all_pre_convergence_results(spf_root, level);
+    tilfa_lazy_flush_work(spf_root, level);
 
     if(IS_GLTHREAD_LIST_EMPTY(&tilfa_info->tilfa_lcl_config_head))
         return;
 
+    metric_counter_inc(tilfa_computations_metric[level]);
     compute_tilfa_pre_convergence_spf_primary_nexthops(spf_root, level);
 
     ITERATE_GLTHREAD_BEGIN(&tilfa_info->tilfa_lcl_config_head, curr){
         
         tilfa_lcl_config = tilfa_lcl_config_to_config_glue(curr);
+
+        if(tilfa_lcl_config->srlg_protection){
+            tilfa_protect_srlgs(spf_root, level, tilfa_lcl_config, 
+                    srlg_done, &n_srlg_done);
+            continue;
+        }
+
         tilfa_fill_protected_resource_from_config(spf_root,
             &tilfa_info->current_resource_pruned,
             tilfa_lcl_config);
         if(tilfa_info->current_resource_pruned && 
             tilfa_info->current_resource_pruned->protected_link){
-            tilfa_run_post_convergence_spf(spf_root, level, 
+
+            tilfa_protect_resource(spf_root, level, 
                     tilfa_info->current_resource_pruned);
         }
     } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_lcl_config_head, curr);
+
+    if(tilfa_info->tilfa_gl_var.lazy)
+        tilfa_lazy_schedule(spf_root);
 }
 
 /* Pass node as NULL to clear remote spf results of all
@@ -616,67 +1370,38 @@ tilfa_clear_preconvergence_remote_spf_results(tilfa_info_t *tilfa_info,
                             node_t *node, LEVEL level, 
                             boolean reverse_spf){
 
-    singly_ll_node_t *curr = NULL, *prev = NULL;
-    singly_ll_node_t *curr1 = NULL, *prev1 = NULL;
-
-    spf_result_t *spf_res = NULL;
-    tilfa_remote_spf_result_t *tilfa_rem_spf_result = NULL;
-
-    ll_t *inner_lst = NULL;
-    ll_t *outer_lst = reverse_spf ? 
-        tilfa_info->pre_convergence_remote_reverse_spf_results[level]:
-        tilfa_info->pre_convergence_remote_forward_spf_results[level];
+    uint32_t i = 0;
+    tilfa_remote_spf_result_t *tilfa_rem_spf_result = NULL,
+                              *next_rem_spf_result = NULL;
 
-    ITERATE_LIST_BEGIN2(outer_lst, curr, prev){
+    tilfa_remote_spf_db_t *rem_spf_db = 
+        tilfa_get_remote_spf_db(tilfa_info, level, reverse_spf);
 
-        tilfa_rem_spf_result = curr->data;
-        if(node && tilfa_rem_spf_result->node != node){
-            ITERATE_LIST_CONTINUE2(outer_lst, curr, prev);
-        }
+    for(i = 0; i < TILFA_REMOTE_SPF_DB_HASH_SIZE; i++){
 
-        inner_lst = tilfa_rem_spf_result->rem_spf_result_lst;
+        if(node && i != TILFA_REMOTE_SPF_DB_HASH(node))
+            continue;
 
-        ITERATE_LIST_BEGIN2(inner_lst, curr1, prev1){
+        for(tilfa_rem_spf_result = rem_spf_db->bucket[i];
+            tilfa_rem_spf_result;
+            tilfa_rem_spf_result = next_rem_spf_result){
 
-            spf_res = curr1->data;
-            XFREE(spf_res);
-            curr1->data = NULL; 
-        } ITERATE_LIST_END2(inner_lst, curr1, prev1);
-        
-        delete_singly_ll(inner_lst);
-        XFREE(inner_lst);
-        tilfa_rem_spf_result->rem_spf_result_lst = NULL;
+            next_rem_spf_result = tilfa_rem_spf_result->hash_next;
 
-        XFREE(tilfa_rem_spf_result);
-        ITERATIVE_LIST_NODE_DELETE2(outer_lst, curr, prev);
-        
-        if(node) return;
+            if(node && tilfa_rem_spf_result->node != node)
+                continue;
 
-    } ITERATE_LIST_END2(outer_lst, curr, prev);
+            tilfa_remote_spf_db_remove(rem_spf_db, tilfa_rem_spf_result);
+            if(node) return;
+        }
+    }
 
     if(!node){
-        assert(is_singly_ll_empty(outer_lst));
+        assert(rem_spf_db->n_entries == 0);
+        assert(IS_GLTHREAD_LIST_EMPTY(&rem_spf_db->lru_head));
     }
 }
 
-spf_path_result_t *
-TILFA_GET_SPF_PATH_RESULT(node_t *spf_root, node_t *node, LEVEL level){
-
-    glthread_t *curr = NULL;
-    glthread_t *spf_path_head = 
-        tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level); 
-
-    ITERATE_GLTHREAD_BEGIN(spf_path_head, curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-
-        if(spf_path_result->node == node){
-            return spf_path_result;
-        }
-    } ITERATE_GLTHREAD_END(spf_path_head, curr);
-    return NULL;
-}
-
 /*Tilfa CLI handlers*/
 int
 show_tilfa_handler(param_t *param, 
@@ -699,7 +1424,7 @@ show_tilfa_handler(param_t *param,
 
     cmdcode = EXTRACT_CMD_CODE(tlv_buf);
     
-    node = (node_t *)singly_ll_search_by_key(
+    node = (node_t *)hash_vector_search_by_key(
             instance->instance_node_list, node_name);
 
     switch(cmdcode){
@@ -713,6 +1438,86 @@ show_tilfa_handler(param_t *param,
     return 0;
 }
 
+int
+tilfa_config_handler(param_t *param, 
+                     ser_buff_t *tlv_buf, 
+                     op_mode enable_or_disable){
+
+    int cmdcode = -1;
+    node_t *node = NULL;
+    char *node_name = NULL;
+    char *priority = NULL;
+    uint32_t time_budget = 0;
+    uint32_t mem_cap = 0;
+
+    tlv_struct_t *tlv = NULL;
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+
+        if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "time-budget", strlen("time-budget")) ==0)
+            time_budget = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "tilfa-priority", strlen("tilfa-priority")) ==0)
+            priority = tlv->value;
+        else if(strncmp(tlv->leaf_id, "mem-cap", strlen("mem-cap")) ==0)
+            mem_cap = (uint32_t)strtoul(tlv->value, NULL, 10);
+        else
+            assert(0);
+    }TLV_LOOP_END
+
+    cmdcode = EXTRACT_CMD_CODE(tlv_buf);
+    
+    node = (node_t *)hash_vector_search_by_key(
+            instance->instance_node_list, node_name);
+
+    tilfa_info_t *tilfa_info = node->tilfa_info;
+
+    switch(cmdcode){
+
+        case CMDCODE_CONFIG_NODE_TILFA_LAZY:
+            tilfa_info->tilfa_gl_var.lazy = 
+                (enable_or_disable == CONFIG_ENABLE) ? TRUE : FALSE;
+            break;
+        case CMDCODE_CONFIG_NODE_TILFA_LAZY_TIME_BUDGET:
+            if(enable_or_disable == CONFIG_ENABLE){
+                tilfa_info->tilfa_gl_var.lazy = TRUE;
+                tilfa_info->tilfa_gl_var.lazy_time_budget_msec = time_budget;
+            }
+            else{
+                tilfa_info->tilfa_gl_var.lazy_time_budget_msec = 
+                    TILFA_LAZY_TIME_BUDGET_MSEC;
+            }
+            break;
+        case CMDCODE_CONFIG_NODE_TILFA_DEST_PRIORITY:
+            if(enable_or_disable == CONFIG_DISABLE){
+                tilfa_info->dest_priority = TILFA_DEST_PRIORITY_MEDIUM;
+            }
+            else if(strncmp(priority, "high", strlen("high")) == 0){
+                tilfa_info->dest_priority = TILFA_DEST_PRIORITY_HIGH;
+            }
+            else if(strncmp(priority, "medium", strlen("medium")) == 0){
+                tilfa_info->dest_priority = TILFA_DEST_PRIORITY_MEDIUM;
+            }
+            else if(strncmp(priority, "low", strlen("low")) == 0){
+                tilfa_info->dest_priority = TILFA_DEST_PRIORITY_LOW;
+            }
+            else{
+                printf("Error : Invalid priority %s\n", priority);
+                return -1;
+            }
+            break;
+        case CMDCODE_CONFIG_NODE_TILFA_REMOTE_SPF_CACHE:
+            /*Takes effect on the next insert, which evicts down to the cap*/
+            tilfa_info->tilfa_gl_var.remote_spf_db_mem_cap = 
+                (enable_or_disable == CONFIG_ENABLE) ? mem_cap : 0;
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
 boolean
 tilfa_is_link_pruned(edge_t *edge){
 
@@ -878,6 +1683,38 @@ tilfa_compute_first_hop_segments(node_t *spf_root,
    return n;
 }
 
+/* With SRLG protection, pre-convergence shortest path(s) from x to y
+ * must not traverse any member link A->B of the SRLG, i.e for every
+ * member : dist(x,y) < dist(x,A) + metric(A->B) + dist(B,y)*/
+static boolean
+tilfa_is_srlg_disjoint_path(tilfa_info_t *tilfa_info,
+                            node_t *x, node_t *y,
+                            protected_resource_t *pr_res,
+                            LEVEL level){
+
+    edge_t *edge = NULL;
+    singly_ll_node_t *list_node = NULL;
+
+    uint32_t dist_x_y = tilfa_dist_from_x_to_y(tilfa_info, x, y, level);
+
+    if(dist_x_y >= INFINITE_METRIC)
+        return FALSE;
+
+    ITERATE_LIST_BEGIN(pr_res->srlg_members, list_node){
+
+        edge = list_node->data;
+
+        uint64_t dist_via_member = 
+            (uint64_t)tilfa_dist_from_x_to_y(tilfa_info, x, edge->from.node, level) +
+            edge->metric[level] +
+            tilfa_dist_from_x_to_y(tilfa_info, edge->to.node, y, level);
+
+        if(!(dist_x_y < dist_via_member))
+            return FALSE;
+    } ITERATE_LIST_END;
+    return TRUE;
+}
+
 static boolean
 tilfa_p_node_qualification_test_wrt_root(
                 node_t *spf_root,
@@ -897,11 +1734,10 @@ tilfa_p_node_qualification_test_wrt_root(
     if(!dst_pre_convergence_nhps || 
         is_nh_list_empty2(dst_pre_convergence_nhps)){
 
-        sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+        trace_log(instance->traceopts, TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
         "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
-        node_to_test->node_name, dst_node->node_name, get_str_level(level), 
+        node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
         "FAILED. Reason : No Pre-convergence Primary Nexthops for Destination");
-        trace(instance->traceopts, TILFA_BIT);
         return FALSE;
     }
 
@@ -916,6 +1752,17 @@ tilfa_p_node_qualification_test_wrt_root(
                  first_hop_segments, level) != 0);
     }
 
+    if(pr_res->srlg_protection &&
+        !tilfa_is_srlg_disjoint_path(tilfa_info, first_hop_node,
+            node_to_test, pr_res, level)){
+
+        trace_log(instance->traceopts, TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+        "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
+        node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
+        "FAILED. Reason : Path to p-node traverses SRLG");
+        return FALSE;
+    }
+
     edge_t *edge = GET_EGDE_PTR_FROM_EDGE_END(
                         pr_res->protected_link);
     
@@ -932,11 +1779,10 @@ tilfa_p_node_qualification_test_wrt_root(
     /*loop XFREE wrt Source*/
     if(!(dist_nbr_to_pnode < dist_nbr_to_S + dist_S_to_pnode)){
         
-        sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+        trace_log(instance->traceopts, TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
         "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
         node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
         "FAILED. Reason : No Loop free wrt Source");
-        trace(instance->traceopts, TILFA_BIT);
         return FALSE;
     }
 
@@ -960,11 +1806,10 @@ tilfa_p_node_qualification_test_wrt_root(
                     first_hop_segments, level) != 0);
         }
         else{
-            sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+            trace_log(instance->traceopts, TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
                     "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
                     node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
                     "FAILED. Reason : Node Protection not provided");
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
@@ -981,11 +1826,10 @@ tilfa_p_node_qualification_test_wrt_root(
         }
         else{
 
-            sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+            trace_log(instance->traceopts, TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
                     "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
                     node_to_test->node_name, dst_node->node_name, get_str_level(level), 
                     first_hop_node->node_name, "FAILED. Reason : Link Protection not provided");
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
@@ -1019,6 +1863,12 @@ tilfa_q_node_qualification_test_wrt_destination(
     if(dist_q_to_d == INFINITE_METRIC)
         return FALSE;
 
+    if(pr_res->srlg_protection &&
+        !tilfa_is_srlg_disjoint_path(tilfa_info, node_to_test, 
+            destination, pr_res, level)){
+        return FALSE;
+    }
+
     assert(pr_res->plr_node == spf_root);
 
     edge_t *edge = GET_EGDE_PTR_FROM_EDGE_END(
@@ -1085,6 +1935,11 @@ tilfa_is_destination_impacted(tilfa_info_t *tilfa_info,
         if(pr_res->protected_link == pre_convergence_nhps[i].oif)
             return TRUE;
 
+        if(pr_res->srlg_protection && pre_convergence_nhps[i].oif &&
+            is_edge_srlg_member(GET_EGDE_PTR_FROM_EDGE_END(
+                pre_convergence_nhps[i].oif), pr_res->srlg))
+            return TRUE;
+
     }
     return FALSE;
 }
@@ -1098,34 +1953,29 @@ print_raw_tilfa_path(node_t *spf_root,
                  int q_distance, 
                  int pq_distance){
 
-    sprintf(instance->traceopts->b, "%s()\nPLR node = %s, DEST = %s", 
+    trace_log(instance->traceopts, TILFA_BIT, "%s()\nPLR node = %s, DEST = %s", 
         __FUNCTION__, spf_root->node_name, dest->node_name);
-    trace(instance->traceopts, TILFA_BIT);
 
     if(!nexthops){
-        sprintf(instance->traceopts->b, "Nexthop Array : NULL"); 
-        trace(instance->traceopts, TILFA_BIT);
+        trace_log(instance->traceopts, TILFA_BIT, "Nexthop Array : NULL");
     }
     else if(!nexthops[0]){
-        sprintf(instance->traceopts->b, "Nexthop Array : Empty");
-        trace(instance->traceopts, TILFA_BIT);
+        trace_log(instance->traceopts, TILFA_BIT, "Nexthop Array : Empty");
     }
     else{
         int i = 0;
         for( ; nexthops[i]; i++){
-            sprintf(instance->traceopts->b, "oif = %s, gw = %s", 
+            trace_log(instance->traceopts, TILFA_BIT, "oif = %s, gw = %s", 
                 nexthops[i]->oif->intf_name, 
                 nexthops[i]->gw_prefix);
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
-    sprintf(instance->traceopts->b, "p_node = %s(%d), q_node = %s(%d)", 
+    trace_log(instance->traceopts, TILFA_BIT, "p_node = %s(%d), q_node = %s(%d)", 
             p_node ? p_node->node_name : "Nil" ,
             pq_distance,
             q_node ? q_node->node_name : "Nil",
             q_distance);
-    trace(instance->traceopts, TILFA_BIT);
 }
 
 void
@@ -1204,6 +2054,12 @@ tilfa_attempt_connect_p_q_by_prefix_sid(node_t *spf_root,
     if(!(dist_pnode_to_qnode < dist_pnode_to_S + dist_S_to_qnode))
         return FALSE;
 
+    if(pr_res->srlg_protection &&
+        !tilfa_is_srlg_disjoint_path(tilfa_info, p_node, 
+            q_node, pr_res, level)){
+        return FALSE;
+    }
+
     /*I think downstream criteria is automatically met since the
      * curr_node lies on post-convergence path*/
 
@@ -1663,7 +2519,7 @@ tilfa_compute_segment_list_from_tilfa_raw_results
 
 static boolean
 tilfa_is_fhs_overlap(
-        tilfa_segment_list_t *tilfa_segment_list,
+        gen_segment_list_t **gen_segment_list_arr,
         int count,
         gen_segment_list_t *gen_segment_list){
 
@@ -1673,29 +2529,27 @@ tilfa_is_fhs_overlap(
     for(i = 0; i < count; i++){
 
         if(gen_segment_list->oif == 
-                tilfa_segment_list->gen_segment_list[i].oif)
+                gen_segment_list_arr[i]->oif)
             return TRUE;
     }
     return FALSE;;
 }
 
-static boolean
+/* SID lists are interned, so identical SID lists are
+ * the same object*/
+static inline boolean
 tilfa_is_identical_gen_segment_list(
     gen_segment_list_t *gen_segment_list1,
     gen_segment_list_t *gen_segment_list2){
 
-        if(memcmp(gen_segment_list1, 
-                  gen_segment_list2, 
-                  sizeof(gen_segment_list_t)) == 0)
-            return TRUE;
-        return FALSE;
+    return gen_segment_list1 == gen_segment_list2 ? TRUE : FALSE;
 }
 
 /* Function to check if gen_segment_list already exists in
- * tilfa_segment_list which contains "n_seglist" SID lists*/
+ * the array of "n_seglist" SID lists*/
 static boolean
 tilfa_is_segment_already_exists(
-        tilfa_segment_list_t *tilfa_segment_list,
+        gen_segment_list_t **gen_segment_list_arr,
         gen_segment_list_t *gen_segment_list,
         int n_seglist){
 
@@ -1703,7 +2557,7 @@ tilfa_is_segment_already_exists(
     for( ; i < n_seglist ; i++){
 
         if(tilfa_is_identical_gen_segment_list(
-            &tilfa_segment_list->gen_segment_list[i], 
+            gen_segment_list_arr[i], 
             gen_segment_list)){
     
             return TRUE;
@@ -1718,84 +2572,59 @@ tilfa_merge_tilfa_segment_lists_by_destination(
         tilfa_segment_list_t *src){
 
     int i = 0,
-        j = 0;
+        j = 0,
+        k = 0,
+        pass = 0;
 
-    tilfa_segment_list_t temp;
-    memset(&temp, 0, sizeof(tilfa_segment_list_t));
+    gen_segment_list_t *temp[MAX_NXT_HOPS];
+    gen_segment_list_t *gen_segment_list = NULL;
 
     tilfa_segment_list_t *array[] = {dst, src};
     
-    int k = 0; 
-    /*copy all RSVP LSP FHS from dst and src into temp*/
-    for( ; k < 2; k++){
-        for( i = 0; i < array[k]->n_segment_list; i++){
+    /* First pass copies all RSVP LSP FHS from dst and src into temp,
+     * second pass copies all IP FHS from dst and src into temp*/
+    for( ; pass < 2; pass++){
+        for( k = 0; k < 2; k++){
+            for( i = 0; i < array[k]->n_segment_list; i++){
 
-            if(!array[k]->gen_segment_list[i].is_fhs_rsvp_lsp)
-                continue;
-            
-            if( k == 1){
-                if(tilfa_is_fhs_overlap(&temp, j, 
-                        &array[k]->gen_segment_list[i]))
-                    continue;
+                gen_segment_list = array[k]->gen_segment_list[i];
 
-                /* Before adding the final the Generic SID list into the
-                 * collection of final results, check of the identical 
-                 * SID list already exists. It might be possible that
-                 * two different ECMP tilfa paths may reduce to same SID 
-                 * list*/
-                if(tilfa_is_segment_already_exists(&temp,
-                        &array[k]->gen_segment_list[i], j))
+                if(pass == 0 && !gen_segment_list->is_fhs_rsvp_lsp)
                     continue;
-            }
-            memcpy(&temp.gen_segment_list[j], &array[k]->gen_segment_list[i], 
-                    sizeof(gen_segment_list_t));
-            j++;
-
-            if(j == MAX_NXT_HOPS){
-                memcpy(array[k]->gen_segment_list, temp.gen_segment_list,
-                        sizeof(temp.gen_segment_list));
-                array[k]->n_segment_list = MAX_NXT_HOPS;
-                return;
+                if(pass == 1 && gen_segment_list->is_fhs_rsvp_lsp)
+                    continue;
+
+                if( k == 1){
+                    if(tilfa_is_fhs_overlap(temp, j, gen_segment_list))
+                        continue;
+
+                    /* Before adding the final the Generic SID list into the
+                     * collection of final results, check of the identical 
+                     * SID list already exists. It might be possible that
+                     * two different ECMP tilfa paths may reduce to same SID 
+                     * list*/
+                    if(tilfa_is_segment_already_exists(temp,
+                                gen_segment_list, j))
+                        continue;
+                }
+                temp[j++] = gen_segment_list;
+                if(j == MAX_NXT_HOPS) goto MERGE_DONE;
             }
         }
     }
 
-    /*Now copy all IP FHS from src and dst into temp*/
-    for( k = 0; k < 2; k++){
-        for( i = 0; i < array[k]->n_segment_list; i++){
-
-            if(array[k]->gen_segment_list[i].is_fhs_rsvp_lsp)
-                continue;
-
-            if(k == 1){
-                if(tilfa_is_fhs_overlap(&temp, j, 
-                            &array[k]->gen_segment_list[i]))
-                    continue;
-                
-                /* Before adding the final the Generic SID list into the
-                 * collection of final results, check of the identical 
-                 * SID list already exists. It might be possible that
-                 * two different ECMP tilfa paths may reduce to same SID 
-                 * list*/
-                if(tilfa_is_segment_already_exists(&temp,
-                            &array[k]->gen_segment_list[i], j))
-                    continue;
-            }
-
-            memcpy(&temp.gen_segment_list[j], &array[k]->gen_segment_list[i], 
-                    sizeof(gen_segment_list_t));
-            j++;
-
-            if(j == MAX_NXT_HOPS){
-                memcpy(array[k]->gen_segment_list, temp.gen_segment_list,
-                        sizeof(temp.gen_segment_list));
-                array[k]->n_segment_list = MAX_NXT_HOPS;
-                return;
-            }
+    MERGE_DONE:
+    /*Take references on merged SID lists before releasing old ones*/
+    for(i = 0; i < j; i++){
+        tilfa_lock_interned_gen_segment_list(temp[i]);
+    }
+    for(k = 0; k < 2; k++){
+        for(i = 0; i < array[k]->n_segment_list; i++){
+            tilfa_unintern_gen_segment_list(array[k]->gen_segment_list[i]);
         }
     }
-    memcpy(dst->gen_segment_list, temp.gen_segment_list,
-        sizeof(temp.gen_segment_list));
+    src->n_segment_list = 0;
+    memcpy(dst->gen_segment_list, temp, j * sizeof(gen_segment_list_t *));
     dst->n_segment_list = j;
 }
 
@@ -1820,8 +2649,7 @@ tilfa_record_segment_list(node_t *spf_root,
         tilfa_merge_tilfa_segment_lists_by_destination(
                 tilfa_segment_list_ptr, 
                 tilfa_segment_list);
-        tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-        XFREE(tilfa_segment_list);
+        tilfa_free_segment_list(tilfa_segment_list);
         return;
     } ITERATE_GLTHREAD_END(&spf_root->tilfa_info->tilfa_segment_list_head[level], curr);
 
@@ -2108,16 +2936,21 @@ tilfa_examine_tilfa_path_for_segment_list(
         q_node ? GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node): 0, 
         dst_node, q_distance, pq_distance);
     
-    tilfa_segment_list_t *tilfa_segment_list = 
-        XCALLOC(1, tilfa_segment_list_t);
+    int i = 0;
+    uint8_t n_segment_list = 0;
+    tilfa_segment_list_t *tilfa_segment_list = NULL;
+
+    /* SID lists are computed in scratch space, and then interned*/
+    gen_segment_list_t gen_segment_list[MAX_NXT_HOPS];
+    memset(gen_segment_list, 0, sizeof(gen_segment_list));
 
     if(pq_distance == 0){
-        tilfa_segment_list->n_segment_list = 
+        n_segment_list = 
             tilfa_compute_segment_list_from_tilfa_raw_results(
                     spf_root, GET_PRED_INFO_NODE_FROM_GLTHREAD(p_node),
                     GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node),
                     dst_node, level,
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     first_hop_segments);
     }
@@ -2128,35 +2961,41 @@ tilfa_examine_tilfa_path_for_segment_list(
                     p_node,
                     q_node,
                     dst_node, level,
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     pr_res);
 
         if(!segment_list_len_from_p_to_q){
-            XFREE(tilfa_segment_list);
             return;
         }
 
         /* Now analyze the segment list against first hop segments
          * and populate segment lists for inet3 and mpls0*/
 
-        tilfa_segment_list->n_segment_list = 
+        n_segment_list = 
             tilfa_compute_segment_list_from_tilfa_raw_results(
                     spf_root, GET_PRED_INFO_NODE_FROM_GLTHREAD(p_node),
                     GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node),
                     dst_node, level,
                     /*In this case, the segment list at index 0 is input
                      * which will be copied to remaining other indexes*/
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     first_hop_segments);
     }
 
-    if(tilfa_segment_list->n_segment_list == 0){
-        XFREE(tilfa_segment_list);
+    if(n_segment_list == 0){
         return;
     }
 
+    tilfa_segment_list = XCALLOC(1, tilfa_segment_list_t);
+    tilfa_segment_list->n_segment_list = n_segment_list;
+
+    for(i = 0; i < n_segment_list; i++){
+        tilfa_segment_list->gen_segment_list[i] = 
+            tilfa_intern_gen_segment_list(&gen_segment_list[i]);
+    }
+
     tilfa_segment_list->pr_res = pr_res;
     tilfa_lock_protected_resource(pr_res);
 
@@ -2176,10 +3015,9 @@ tilfa_compute_segment_lists_per_destination(
     fn_ptr_arg.pr_res = pr_res;
     fn_ptr_arg.level = level;
 
-    sprintf(instance->traceopts->b, "Node : %s : %s : "
+    trace_log(instance->traceopts, TILFA_BIT, "Node : %s : %s : "
             "Examining post-C to Dest %s", spf_root->node_name,
             get_str_level(level), dst_node->node_name);
-    trace(instance->traceopts, TILFA_BIT);
     trace_spf_path_to_destination_node(spf_root, 
                     dst_node, level, 
                     tilfa_examine_tilfa_path_for_segment_list,
@@ -2196,23 +3034,21 @@ tilfa_compute_segment_lists(node_t *spf_root, LEVEL level,
     spf_result_t *result = NULL;
     singly_ll_node_t *curr = NULL;
     
-    ll_t *pre_convergence_spf_result_lst = 
+    hash_vector_t *pre_convergence_spf_result_lst = 
         tilfa_get_pre_convergence_spf_result_list(
             spf_root->tilfa_info, level);
 
     node_t *dst_node = NULL;
 
-    sprintf(instance->traceopts->b, "Node : %s : level %s, Segment List "
+    trace_log(instance->traceopts, SPF_EVENTS_BIT, "Node : %s : level %s, Segment List "
             "Computation for Protected Res : %s, LP : %sset : NP : %sset",
         spf_root->node_name, get_str_level(level), 
         pr_res->protected_link->intf_name,
         pr_res->link_protection ? "" : "un", 
         pr_res->node_protection ? "" : "un");
-    trace(instance->traceopts, SPF_EVENTS_BIT);
 
-    ITERATE_LIST_BEGIN(pre_convergence_spf_result_lst, curr){
+    ITERATE_HASH_VECTOR_BEGIN(pre_convergence_spf_result_lst, result){
 
-        result = curr->data;
         dst_node = result->node;
 
         if(dst_node->node_type[level] == PSEUDONODE)
@@ -2220,16 +3056,15 @@ tilfa_compute_segment_lists(node_t *spf_root, LEVEL level,
 
         if(!tilfa_is_destination_impacted(spf_root->tilfa_info,
             dst_node, level, pr_res)){
-            sprintf(instance->traceopts->b, "Node : %s : level %s, Dest Node %s is not impacted",
+            trace_log(instance->traceopts, TILFA_BIT, "Node : %s : level %s, Dest Node %s is not impacted",
                 spf_root->node_name, get_str_level(level), dst_node->node_name);
-            trace(instance->traceopts, TILFA_BIT);
             continue;
         }
 
         tilfa_compute_segment_lists_per_destination
             (spf_root, level, pr_res, dst_node);
 
-    } ITERATE_LIST_END;
+    } ITERATE_HASH_VECTOR_END;
 }
 
 void
@@ -2577,7 +3412,7 @@ route_fetch_tilfa_backups(node_t *spf_root,
             for( i = 0; i < tilfa_segment_list->n_segment_list; i++){
                 
                 if(tilfa_fill_nxthop_from_segment_lst(route, &tilfa_bck_up_lcl, 
-                                  &tilfa_segment_list->gen_segment_list[i],
+                                  tilfa_segment_list->gen_segment_list[i],
                                   tilfa_segment_list->pr_res, inet3, mpls0)){
                     
                     tilfa_bck_up = XCALLOC(1, internal_nh_t);
@@ -32,6 +32,7 @@
 #define __TILFA__
 
 #include <stdint.h>
+#include <pthread.h>
 #include "instance.h"
 #include "data_plane.h"
 #include "complete_spf_path.h"
@@ -189,6 +190,11 @@ typedef struct protected_resource_{
     interface_t *protected_link;
     boolean link_protection;
     boolean node_protection;
+    /* SRLG protection : all links of the topology which are member of
+     * srlg are pruned together, protected_link is one of them*/
+    boolean srlg_protection;
+    unsigned int srlg;
+    ll_t *srlg_members; /*edge_t *, both directions of every member link*/
     int ref_count;
 } protected_resource_t;
 
@@ -197,8 +203,12 @@ static inline void tilfa_unlock_protected_resource(
 
     pr_res->ref_count--;
     assert(pr_res->ref_count >= 0);
-    if(!pr_res->ref_count)
-        XFREE(pr_res);
+    if(pr_res->ref_count) return;
+    if(pr_res->srlg_members){
+        delete_singly_ll(pr_res->srlg_members);
+        XFREE(pr_res->srlg_members);
+    }
+    XFREE(pr_res);
 }
 
 static inline void tilfa_lock_protected_resource(
@@ -216,19 +226,51 @@ tlfa_protected_resource_equal(protected_resource_t *pr_res1,
     if(pr_res1->plr_node == pr_res2->plr_node &&
        pr_res1->protected_link == pr_res2->protected_link &&
        pr_res1->link_protection == pr_res2->link_protection &&
-       pr_res1->node_protection == pr_res2->node_protection){
+       pr_res1->node_protection == pr_res2->node_protection &&
+       pr_res1->srlg_protection == pr_res2->srlg_protection &&
+       pr_res1->srlg == pr_res2->srlg){
 
         return TRUE;
     }
     return FALSE;
 }
 
+/* Hash-consed, immutable copy of gen_segment_list_t. Identical
+ * SID lists computed for different destinations/protected resources
+ * share one such object, so two interned SID lists are identical
+ * iff their pointers are equal. gen_segment_list must remain the first
+ * member, interned objects are handed out as gen_segment_list_t pointers*/
+typedef struct tilfa_interned_segment_list_{
+
+    gen_segment_list_t gen_segment_list;
+    uint32_t hash;
+    uint32_t ref_count;
+    struct tilfa_interned_segment_list_ *hash_next;
+} tilfa_interned_segment_list_t;
+
+#define TILFA_SEGMENT_LIST_INTERN_HASH_SIZE 256
+
+typedef struct tilfa_segment_list_intern_table_{
+
+    tilfa_interned_segment_list_t *bucket[TILFA_SEGMENT_LIST_INTERN_HASH_SIZE];
+    uint32_t n_entries;     /*Unique SID lists*/
+    uint32_t n_refs;        /*Total references to SID lists*/
+    /*PLRs of different nodes may compute in different threads*/
+    pthread_mutex_t lock;
+} tilfa_segment_list_intern_table_t;
+
+gen_segment_list_t *
+tilfa_intern_gen_segment_list(gen_segment_list_t *gen_segment_list);
+
+void
+tilfa_unintern_gen_segment_list(gen_segment_list_t *gen_segment_list);
+
 typedef struct tilfa_segment_list_{
 
     node_t *dest;
     protected_resource_t *pr_res;
     uint8_t n_segment_list;
-    gen_segment_list_t gen_segment_list[MAX_NXT_HOPS];
+    gen_segment_list_t *gen_segment_list[MAX_NXT_HOPS]; /*interned*/
     glthread_t gen_segment_list_glue;
 } tilfa_segment_list_t;
 GLTHREAD_TO_STRUCT(tilfa_segment_list_to_gensegment_list, 
@@ -239,6 +281,7 @@ typedef struct tilfa_lcl_config_{
   char protected_link[IF_NAME_SIZE]; /*key*/
   boolean link_protection;
   boolean node_protection;
+  boolean srlg_protection;
   glthread_t config_glue;
 } tilfa_lcl_config_t;
 GLTHREAD_TO_STRUCT(tilfa_lcl_config_to_config_glue, 
@@ -248,13 +291,87 @@ typedef struct tilfa_cfg_globals_{
     
     boolean is_enabled;
     uint8_t max_segments_allowed;
+    uint32_t remote_spf_db_mem_cap; /*Bytes, per remote spf db, 0 to size from the topology*/
+    /* Lazy mode : Primary routes are installed first, TILFA SID lists
+     * are computed later in background in slices of lazy_time_budget_msec*/
+    boolean lazy;
+    uint32_t lazy_time_budget_msec;
 } tilfa_cfg_globals_t;
 
+/*Priority of a node when it is a destination to be protected*/
+typedef enum{
+
+    TILFA_DEST_PRIORITY_HIGH,
+    TILFA_DEST_PRIORITY_MEDIUM,
+    TILFA_DEST_PRIORITY_LOW,
+    TILFA_DEST_PRIORITY_MAX
+} tilfa_dest_priority_t;
+
+static inline char *
+tilfa_get_str_dest_priority(tilfa_dest_priority_t priority){
+
+    switch(priority){
+        case TILFA_DEST_PRIORITY_HIGH:
+            return "high";
+        case TILFA_DEST_PRIORITY_MEDIUM:
+            return "medium";
+        case TILFA_DEST_PRIORITY_LOW:
+            return "low";
+        default:
+            ;
+    }
+    return NULL;
+}
+
+/* Destination pending TILFA SID list computation in lazy mode*/
+typedef struct tilfa_lazy_work_{
+
+    node_t *dest;
+    protected_resource_t *pr_res;
+    tilfa_dest_priority_t priority;
+    glthread_t work_glue;
+} tilfa_lazy_work_t;
+GLTHREAD_TO_STRUCT(work_glue_to_tilfa_lazy_work,
+        tilfa_lazy_work_t, work_glue);
+
+/* FIFO of tilfa_lazy_work_t of one priority. Work is queued one protected
+ * resource at a time, so the work of a resource stays contiguous*/
+typedef struct tilfa_lazy_queue_{
+
+    glthread_t head;
+    glthread_t *tail;
+} tilfa_lazy_queue_t;
+
+/* SPF result of a remote node, kept as a dense array of
+ * distances indexed by node->node_index. So, distance between
+ * root and any other node is one array load*/
 typedef struct tilfa_remote_spf_result_{
 
-    node_t *node; /*root of rev spf result*/
-    ll_t *rem_spf_result_lst;
+    node_t *node; /*root of spf run, hash key*/
+    uint32_t n_dist;
+    uint32_t *dist;
+    struct tilfa_remote_spf_result_ *hash_next;
+    glthread_t lru_glue;
 } tilfa_remote_spf_result_t;
+GLTHREAD_TO_STRUCT(lru_glue_to_tilfa_remote_spf_result,
+        tilfa_remote_spf_result_t, lru_glue);
+
+#define TILFA_REMOTE_SPF_DB_HASH_SIZE   32
+
+#define TILFA_REMOTE_SPF_DB_HASH(node_ptr)  \
+    ((node_ptr)->node_index % TILFA_REMOTE_SPF_DB_HASH_SIZE)
+
+typedef struct tilfa_remote_spf_db_{
+
+    tilfa_remote_spf_result_t *bucket[TILFA_REMOTE_SPF_DB_HASH_SIZE];
+    glthread_t lru_head; /*Most recently used entry first*/
+    glthread_t *lru_tail; /*Least recently used entry, evicted first*/
+    uint32_t n_entries;
+    uint32_t mem_in_use;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} tilfa_remote_spf_db_t;
 
 typedef struct tilfa_info_ {
 
@@ -263,23 +380,39 @@ typedef struct tilfa_info_ {
 
     protected_resource_t *current_resource_pruned;
 
-    ll_t *tilfa_pre_convergence_spf_results[MAX_LEVEL];
+    hash_vector_t *tilfa_pre_convergence_spf_results[MAX_LEVEL];
+    mm_arena_t pre_convergence_spf_arena[MAX_LEVEL];
 
     /* SPF results after pruning of reources*/
-    ll_t *tilfa_post_convergence_spf_results[MAX_LEVEL];
+    hash_vector_t *tilfa_post_convergence_spf_results[MAX_LEVEL];
+    mm_arena_t post_convergence_spf_arena[MAX_LEVEL];
     
-    /*SPF Results of FORWARD run without Pruning of Resources*/
-    glthread_t post_convergence_spf_path[MAX_LEVEL];
+    /*Shortest path DAG of post-convergence spf run*/
+    spf_path_dag_t *post_convergence_spf_path_dag[MAX_LEVEL];
 
     /* SPF Results triggered on a remote node.
      * Required for PQ node evaluation*/
-    ll_t *pre_convergence_remote_forward_spf_results[MAX_LEVEL];
+    tilfa_remote_spf_db_t pre_convergence_remote_forward_spf_db[MAX_LEVEL];
 
-    ll_t *pre_convergence_remote_reverse_spf_results[MAX_LEVEL];
+    tilfa_remote_spf_db_t pre_convergence_remote_reverse_spf_db[MAX_LEVEL];
+
+    /* Scratch for remote spf runs, only the distances
+     * are retained in the remote spf db*/
+    mm_arena_t remote_spf_arena;
 
     glthread_t tilfa_segment_list_head[MAX_LEVEL];
 
     boolean is_tilfa_pruned;
+
+    /*Priority of this node as destination*/
+    tilfa_dest_priority_t dest_priority;
+
+    /* Lazy mode : queues of tilfa_lazy_work_t per priority, and the
+     * protected resource whose post-convergence results are present*/
+    tilfa_lazy_queue_t tilfa_lazy_work_queue[MAX_LEVEL][TILFA_DEST_PRIORITY_MAX];
+    protected_resource_t *lazy_pr_res[MAX_LEVEL];
+    void *lazy_task;
+    uint32_t lazy_slices;
 } tilfa_info_t;
 
 gen_segment_list_t *
@@ -296,7 +429,12 @@ boolean
 tilfa_update_config(node_t *plr_node,
                     char *protected_link,
                     boolean link_protection,
-                    boolean node_protection);
+                    boolean node_protection,
+                    boolean srlg_protection);
+
+/*LFA and RLFA honour the SRLG protection of TILFA config*/
+boolean
+tilfa_is_srlg_protection_enabled(node_t *plr_node, char *protected_link);
 
 boolean
 tilfa_topology_prune_protected_resource(node_t *node,
@@ -310,10 +448,6 @@ void
 tilfa_run_post_convergence_spf(node_t *spf_root, LEVEL level,
                                protected_resource_t *pr_res);
 
-spf_path_result_t *
-tilfa_lookup_spf_path_result(node_t *node, node_t *candidate_node,
-                             LEVEL level);
-
 void
 compute_tilfa(node_t *spf_root, LEVEL level);
 
@@ -322,9 +456,6 @@ tilfa_clear_preconvergence_remote_spf_results(tilfa_info_t *tilfa_info,
                             node_t *node, LEVEL level,
                             boolean reverse_spf);
 
-spf_path_result_t *
-TILFA_GET_SPF_PATH_RESULT(node_t *spf_root, node_t *node, LEVEL level);
-
 int
 tilfa_copy_gensegment_list_stacks(gen_segment_list_t *src, 
                                   gen_segment_list_t *dst,
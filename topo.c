@@ -36,6 +36,9 @@
 #include "spfcmdcodes.h"
 #include "spfclihandler.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "topogen.h"
+#include "topofile.h"
+#include <time.h>
 
 extern instance_t *instance;
 
@@ -1812,14 +1815,14 @@ config_dynamic_topology(param_t *param,
         case TOPO_CREATE_NODE:
         {
            node_t *node = create_new_node(instance, node_name1, AREA1, ZERO_IP) ;
-           if(GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list) == 1)
+           if(HASH_VECTOR_COUNT(instance->instance_node_list) == 1)
                set_instance_root(instance, node);
         }
         break;
 
         case TOPO_NODE_ASSIGN_LOOPBACK_IP:
         {
-            node_t *node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name1);
+            node_t *node = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name1);
             deattach_prefix_on_node(node, node->router_id, 32, LEVEL1); 
             deattach_prefix_on_node(node, node->router_id, 32, LEVEL2);
             memset(node->router_id, 0, PREFIX_LEN);
@@ -1831,8 +1834,8 @@ config_dynamic_topology(param_t *param,
 
         case TOPO_NODE_INSERT_LINK:
         {
-            node_t *node1 = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name1);
-            node_t *node2= (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name2);
+            node_t *node1 = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name1);
+            node_t *node2= (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name2);
             if(!node1){
                 printf("Node %s do not exist. Please create this node first\n", node_name1);
                 return 0;
@@ -1853,7 +1856,7 @@ config_dynamic_topology(param_t *param,
 
         case TOPO_NODE_INTF_ASSIGN_IP_ADDRESS:
         {
-            node_t *node1 = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name1);
+            node_t *node1 = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name1);
             edge_t *inv_edge = NULL;
 
             if(!node1){
@@ -1927,7 +1930,7 @@ config_dynamic_topology(param_t *param,
         break;
         case TOPO_NODE_INTF_ASSIGN_MAC_ADDRESS:
         {
-            node_t *node1 = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name1);
+            node_t *node1 = (node_t *)hash_vector_search_by_key(instance->instance_node_list, node_name1);
             edge_t *inv_edge = NULL;
 
             if(!node1){
@@ -1968,6 +1971,213 @@ config_dynamic_topology(param_t *param,
     return 0;   
 }
 
+static int
+config_topology_file(param_t *param, 
+                     ser_buff_t *tlv_buf, 
+                     op_mode enable_or_disable){
+
+    int cmd_code = -1;
+    char *file_name = NULL;
+    topofile_stats_t stats;
+    struct timespec start, end;
+    instance_t *new_instance = NULL;
+    tlv_struct_t *tlv = NULL;
+
+    cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+
+        if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    switch(cmd_code){
+
+        case TOPO_LOAD:
+            new_instance = topofile_load(file_name, &stats);
+            if(!new_instance)
+                return 0;
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            /*Same as config topo generate, config topo no brings back the 
+             * topology we started with*/
+            if(!old_instance)
+                old_instance = instance;
+            instance = new_instance;
+
+            printf("Loaded %s : %u nodes, %u links, %u prefixes, %u records (%s) in %ld msec, root %s\n",
+                    file_name, stats.n_nodes, stats.n_links, stats.n_prefixes, stats.n_recs,
+                    topofile_format_str(stats.format),
+                    (long)((end.tv_sec - start.tv_sec) * 1000 + 
+                        (end.tv_nsec - start.tv_nsec) / 1000000),
+                    instance->instance_root->node_name);
+            break;
+        case TOPO_SAVE:
+        case TOPO_SAVE_BINARY:
+            if(topofile_save(instance, file_name, 
+                    cmd_code == TOPO_SAVE_BINARY ? TOPOFILE_BINARY : TOPOFILE_TEXT, &stats) < 0)
+                return 0;
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            printf("Saved %s : %u nodes, %u links, %u prefixes, %u records (%s) in %ld msec\n",
+                    file_name, stats.n_nodes, stats.n_links, stats.n_prefixes, stats.n_recs,
+                    topofile_format_str(stats.format),
+                    (long)((end.tv_sec - start.tv_sec) * 1000 + 
+                        (end.tv_nsec - start.tv_nsec) / 1000000));
+            if(stats.n_skipped)
+                printf("Warning : %u one way links or adjacencies could not be saved\n", 
+                    stats.n_skipped);
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+static topogen_params_t topogen_params;
+static boolean topogen_params_initialized = FALSE;
+
+static int
+config_topology_generator(param_t *param, 
+                          ser_buff_t *tlv_buf, 
+                          op_mode enable_or_disable){
+
+    int cmd_code = -1;
+    char *topo_type = NULL,
+         *protection = NULL;
+    unsigned int value = 0,
+                 metric_min = 0, 
+                 metric_max = 0;
+    topogen_type_t type;
+    topogen_stats_t stats;
+    struct timespec start, end;
+    instance_t *new_instance = NULL;
+    tlv_struct_t *tlv = NULL;
+
+    if(!topogen_params_initialized){
+        topogen_init_params(&topogen_params);
+        topogen_params_initialized = TRUE;
+    }
+
+    cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+
+        if(strncmp(tlv->leaf_id, "topo-type", strlen("topo-type")) ==0)
+            topo_type = tlv->value;
+        else if(strncmp(tlv->leaf_id, "protection-type", strlen("protection-type")) ==0)
+            protection = tlv->value;
+        else if(strncmp(tlv->leaf_id, "metric-min", strlen("metric-min")) ==0)
+            metric_min = strtoul(tlv->value, NULL, 10);
+        else if(strncmp(tlv->leaf_id, "metric-max", strlen("metric-max")) ==0)
+            metric_max = strtoul(tlv->value, NULL, 10);
+        else if(strncmp(tlv->leaf_id, "node-count", strlen("node-count")) ==0 ||
+                strncmp(tlv->leaf_id, "ecmp-width", strlen("ecmp-width")) ==0 ||
+                strncmp(tlv->leaf_id, "prefix-count", strlen("prefix-count")) ==0 ||
+                strncmp(tlv->leaf_id, "area-count", strlen("area-count")) ==0 ||
+                strncmp(tlv->leaf_id, "seed", strlen("seed")) ==0)
+            value = strtoul(tlv->value, NULL, 10);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+
+        case TOPO_GENERATE:
+        {
+            type = topogen_type_from_str(topo_type);
+            if(type == TOPOGEN_TYPE_MAX){
+                printf("Error : Unknown topology type %s, supported : "
+                        "clos, spine-leaf, isp, waxman, barabasi-albert, ring-of-rings\n", topo_type);
+                return 0;
+            }
+            if(value == 0){
+                printf("Error : node count must be non zero\n");
+                return 0;
+            }
+            topogen_params.type = type;
+            topogen_params.n_nodes = value;
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            new_instance = topogen_build(&topogen_params, &stats);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            /*config topo no brings back the topology we started with. A
+             * previously generated one is dropped, Memory Leak, sorry!*/
+            if(!old_instance)
+                old_instance = instance;
+            instance = new_instance;
+
+            printf("Generated %s : %u nodes, %u links, %u prefixes in %ld msec, root %s\n",
+                    topogen_type_str(type), stats.n_nodes, stats.n_links, stats.n_prefixes,
+                    (long)((end.tv_sec - start.tv_sec) * 1000 + 
+                        (end.tv_nsec - start.tv_nsec) / 1000000),
+                    instance->instance_root->node_name);
+            topogen_print_params(&topogen_params);
+        }
+        break;
+        case TOPO_GENERATOR_ECMP_WIDTH:
+            if(value < 1 || value > MAX_NXT_HOPS){
+                printf("Error : ecmp-width must be in [1, %u]\n", MAX_NXT_HOPS);
+                return 0;
+            }
+            topogen_params.ecmp_width = enable_or_disable == CONFIG_ENABLE ?
+                value : TOPOGEN_DEFAULT_ECMP_WIDTH;
+            break;
+        case TOPO_GENERATOR_METRIC:
+            if(enable_or_disable == CONFIG_DISABLE){
+                topogen_params.metric_min = LINK_DEFAULT_METRIC;
+                topogen_params.metric_max = LINK_DEFAULT_METRIC;
+                break;
+            }
+            if(metric_min < 1 || metric_max < metric_min){
+                printf("Error : metric range must satisfy 1 <= metric-min <= metric-max\n");
+                return 0;
+            }
+            topogen_params.metric_min = metric_min;
+            topogen_params.metric_max = metric_max;
+            break;
+        case TOPO_GENERATOR_PREFIXES:
+            topogen_params.prefixes_per_node = enable_or_disable == CONFIG_ENABLE ?
+                value : 0;
+            break;
+        case TOPO_GENERATOR_AREAS:
+            if(value < 1 || value > TOPOGEN_MAX_AREAS){
+                printf("Error : areas must be in [1, %u]\n", TOPOGEN_MAX_AREAS);
+                return 0;
+            }
+            topogen_params.n_areas = enable_or_disable == CONFIG_ENABLE ?
+                value : TOPOGEN_DEFAULT_AREAS;
+            break;
+        case TOPO_GENERATOR_SEED:
+            topogen_params.seed = enable_or_disable == CONFIG_ENABLE ?
+                value : 1;
+            break;
+        case TOPO_GENERATOR_SEGMENT_ROUTING:
+            topogen_params.segment_routing = enable_or_disable == CONFIG_ENABLE ?
+                TRUE : FALSE;
+            break;
+        case TOPO_GENERATOR_PROTECTION:
+            if(enable_or_disable == CONFIG_DISABLE){
+                topogen_params.protection = TOPOGEN_PROTECTION_NONE;
+                break;
+            }
+            if(topogen_protection_from_str(protection) == TOPOGEN_PROTECTION_MAX){
+                printf("Error : Unknown protection %s, supported : none, lfa, rlfa, tilfa\n", protection);
+                return 0;
+            }
+            topogen_params.protection = topogen_protection_from_str(protection);
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
+
 void
 config_topology_commands(param_t *config_hook){
 
@@ -2083,5 +2293,143 @@ config_topology_commands(param_t *config_hook){
                 }
             }
         }
+        /*config topo generate <topo-type> <node-count>*/
+        {
+            static param_t generate;
+            init_param(&generate, CMD, "generate", 0, 0, INVALID, 0, "Generate a synthetic topology");
+            libcli_register_param(&topo, &generate);
+            {
+                static param_t topo_type;
+                init_param(&topo_type, LEAF, 0, 0, 0, STRING, "topo-type", 
+                        "clos | spine-leaf | isp | waxman | barabasi-albert | ring-of-rings");
+                libcli_register_param(&generate, &topo_type);
+                {
+                    static param_t node_count;
+                    init_param(&node_count, LEAF, 0, config_topology_generator, 0, INT, "node-count", "Number of routers");
+                    libcli_register_param(&topo_type, &node_count);
+                    set_param_cmd_code(&node_count, TOPO_GENERATE);
+                }
+            }
+        }
+        /*config topo generator ...*/
+        {
+            static param_t generator;
+            init_param(&generator, CMD, "generator", 0, 0, INVALID, 0, "Synthetic topology generator parameters");
+            libcli_register_param(&topo, &generator);
+            {
+                /*config topo generator ecmp-width <ecmp-width>*/
+                static param_t ecmp_width;
+                init_param(&ecmp_width, CMD, "ecmp-width", 0, 0, INVALID, 0, "Parallel paths / uplinks per router");
+                libcli_register_param(&generator, &ecmp_width);
+                {
+                    static param_t ecmp_width_val;
+                    init_param(&ecmp_width_val, LEAF, 0, config_topology_generator, 0, INT, "ecmp-width", "ECMP width");
+                    libcli_register_param(&ecmp_width, &ecmp_width_val);
+                    set_param_cmd_code(&ecmp_width_val, TOPO_GENERATOR_ECMP_WIDTH);
+                }
+            }
+            {
+                /*config topo generator metric <metric-min> <metric-max>*/
+                static param_t metric;
+                init_param(&metric, CMD, "metric", 0, 0, INVALID, 0, "Link metrics, uniform in [min, max]");
+                libcli_register_param(&generator, &metric);
+                {
+                    static param_t metric_min;
+                    init_param(&metric_min, LEAF, 0, 0, 0, INT, "metric-min", "Min link metric");
+                    libcli_register_param(&metric, &metric_min);
+                    {
+                        static param_t metric_max;
+                        init_param(&metric_max, LEAF, 0, config_topology_generator, 0, INT, "metric-max", "Max link metric");
+                        libcli_register_param(&metric_min, &metric_max);
+                        set_param_cmd_code(&metric_max, TOPO_GENERATOR_METRIC);
+                    }
+                }
+            }
+            {
+                /*config topo generator prefixes <prefix-count>*/
+                static param_t prefixes;
+                init_param(&prefixes, CMD, "prefixes", 0, 0, INVALID, 0, "Extra prefixes advertised per router");
+                libcli_register_param(&generator, &prefixes);
+                {
+                    static param_t prefix_count;
+                    init_param(&prefix_count, LEAF, 0, config_topology_generator, 0, INT, "prefix-count", "Prefixes per router");
+                    libcli_register_param(&prefixes, &prefix_count);
+                    set_param_cmd_code(&prefix_count, TOPO_GENERATOR_PREFIXES);
+                }
+            }
+            {
+                /*config topo generator areas <area-count>*/
+                static param_t areas;
+                init_param(&areas, CMD, "areas", 0, 0, INVALID, 0, "L1 areas of isp topology");
+                libcli_register_param(&generator, &areas);
+                {
+                    static param_t area_count;
+                    init_param(&area_count, LEAF, 0, config_topology_generator, 0, INT, "area-count", "Number of L1 areas");
+                    libcli_register_param(&areas, &area_count);
+                    set_param_cmd_code(&area_count, TOPO_GENERATOR_AREAS);
+                }
+            }
+            {
+                /*config topo generator seed <seed>*/
+                static param_t seed;
+                init_param(&seed, CMD, "seed", 0, 0, INVALID, 0, "Random seed");
+                libcli_register_param(&generator, &seed);
+                {
+                    static param_t seed_val;
+                    init_param(&seed_val, LEAF, 0, config_topology_generator, 0, INT, "seed", "Seed value");
+                    libcli_register_param(&seed, &seed_val);
+                    set_param_cmd_code(&seed_val, TOPO_GENERATOR_SEED);
+                }
+            }
+            {
+                /*config topo generator segment-routing*/
+                static param_t segment_routing;
+                init_param(&segment_routing, CMD, "segment-routing", config_topology_generator, 0, INVALID, 0, "Enable SPRING with node SIDs on all routers");
+                libcli_register_param(&generator, &segment_routing);
+                set_param_cmd_code(&segment_routing, TOPO_GENERATOR_SEGMENT_ROUTING);
+            }
+            {
+                /*config topo generator protection <protection-type>*/
+                static param_t protection;
+                init_param(&protection, CMD, "protection", 0, 0, INVALID, 0, "Protect all links of all routers");
+                libcli_register_param(&generator, &protection);
+                {
+                    static param_t protection_type;
+                    init_param(&protection_type, LEAF, 0, config_topology_generator, 0, STRING, "protection-type", "none | lfa | rlfa | tilfa");
+                    libcli_register_param(&protection, &protection_type);
+                    set_param_cmd_code(&protection_type, TOPO_GENERATOR_PROTECTION);
+                }
+            }
+        }
+        /*config topo load <file-name>*/
+        {
+            static param_t load;
+            init_param(&load, CMD, "load", 0, 0, INVALID, 0, "Load a topology file");
+            libcli_register_param(&topo, &load);
+            {
+                static param_t file_name;
+                init_param(&file_name, LEAF, 0, config_topology_file, 0, STRING, "file-name", "Text or binary topology file");
+                libcli_register_param(&load, &file_name);
+                set_param_cmd_code(&file_name, TOPO_LOAD);
+            }
+        }
+        /*config topo save <file-name> [binary]*/
+        {
+            static param_t save;
+            init_param(&save, CMD, "save", 0, 0, INVALID, 0, "Save the topology to a file");
+            libcli_register_param(&topo, &save);
+            {
+                static param_t file_name;
+                init_param(&file_name, LEAF, 0, config_topology_file, 0, STRING, "file-name", "Topology file, text form");
+                libcli_register_param(&save, &file_name);
+                set_param_cmd_code(&file_name, TOPO_SAVE);
+                {
+                    static param_t binary;
+                    init_param(&binary, CMD, "binary", config_topology_file, 0, INVALID, 0, "Binary form, faster to load");
+                    libcli_register_param(&file_name, &binary);
+                    set_param_cmd_code(&binary, TOPO_SAVE_BINARY);
+                }
+            }
+        }
     }         
 }
@@ -0,0 +1,1745 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topofile.c
+ *
+ *    Description:  Topology files : text and mmap-able binary forms, bulk loader and exporter
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 23:05:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include "instance.h"
+#include "topofile.h"
+#include "rlfa.h"
+#include "spfutil.h"
+#include "tilfa.h"
+#include "igp_sr_ext.h"
+#include "sr_tlv_api.h"
+#include "spring_adjsid.h"
+#include "spfclihandler.h"
+#include "spfcmdcodes.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+
+#define TOPOFILE_MAX_LINE       512
+#define TOPOFILE_MAX_TOKENS     16
+#define TOPOFILE_DEFAULT_NODES  1024
+
+static const char *topofile_rec_names[TOPOFILE_REC_MAX] = {
+
+    "node",
+    "root",
+    "link",
+    "pseudonode",
+    "overload",
+    "spring",
+    "ldp",
+    "rsvp",
+    "backup",
+    "delay",
+    "srlg",
+    "protect",
+    "tilfa",
+    "prefix",
+    "prefix-sid",
+    "adj-sid",
+    "lsp"
+};
+
+/*Number of arguments each statement takes in the text form, keyword excluded*/
+static const unsigned int topofile_rec_min_args[TOPOFILE_REC_MAX] = {
+    3, 1, 9, 2, 2, 3, 1, 1, 2, 3, 3, 3, 3, 5, 5, 5, 7
+};
+
+static const unsigned int topofile_rec_max_args[TOPOFILE_REC_MAX] = {
+    3, 1, 10, 2, 2, 3, 1, 1, 2, 3, 3, 3, 3, 6, 5, 6, 7
+};
+
+static const char *topofile_backup_names[TOPOFILE_BACKUP_MAX] = {
+
+    "lfa",
+    "rlfa",
+    "node-link-degradation",
+    "spring"
+};
+
+static const char *topofile_protect_names[TOPOFILE_PROTECT_MAX] = {
+
+    "link",
+    "node-link",
+    "node-only",
+    "no-eligible-backup"
+};
+
+/*edge_config_flags bit of every topofile_protect_t*/
+static const unsigned int topofile_protect_bits[TOPOFILE_PROTECT_MAX] = {
+
+    LINK_PROTECTION,
+    LINK_NODE_PROTECTION,
+    ONLY_NODE_PROTECTION,
+    NO_ELIGIBLE_BACK_UP
+};
+
+static const char *topofile_tilfa_names[TOPOFILE_TILFA_MAX] = {
+
+    "link",
+    "node",
+    "srlg"
+};
+
+static const char *topofile_format_names[TOPOFILE_FORMAT_MAX] = {
+
+    "text",
+    "binary"
+};
+
+const char *
+topofile_format_str(topofile_format_t format){
+
+    assert(format < TOPOFILE_FORMAT_MAX);
+    return topofile_format_names[format];
+}
+
+/*Loader state*/
+typedef struct topofile_ctx_{
+
+    const char *file_name;
+    instance_t *instance;
+    node_t **nodes;             /*By position among the node statements*/
+    unsigned int n_nodes;
+    unsigned int max_nodes;
+    node_t *root;
+    const char *strtab;         /*The line being parsed for the text form*/
+    uint32_t strtab_size;
+    unsigned int stmt_no;       /*Line no for the text form, record no for binary*/
+    topofile_stats_t stats;
+} topofile_ctx_t;
+
+static void
+topofile_error(topofile_ctx_t *ctx, const char *fmt, ...){
+
+    va_list ap;
+
+    printf("Error : %s:%u : ", ctx->file_name, ctx->stmt_no);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+}
+
+static char *
+topofile_ip_str(uint32_t ip, char *ip_str){
+
+    snprintf(ip_str, PREFIX_LEN + 1, "%u.%u.%u.%u", 
+        (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+    return ip_str;
+}
+
+/*Returns 0 if ip_str is not a dotted quad*/
+static uint32_t
+topofile_ip_from_str(const char *ip_str){
+
+    struct in_addr addr;
+
+    if(inet_pton(AF_INET, ip_str, &addr) != 1)
+        return 0;
+    return ntohl(addr.s_addr);
+}
+
+static const char *
+topofile_level_str(LEVEL level){
+
+    switch(level){
+        case LEVEL1:
+            return "1";
+        case LEVEL2:
+            return "2";
+        case LEVEL12:
+            return "12";
+        default:
+            return "?";
+    }
+}
+
+/*Loader*/
+
+static const char *
+topofile_str(topofile_ctx_t *ctx, uint32_t offset, unsigned int max_len, boolean allow_empty){
+
+    const char *str = NULL;
+
+    if(offset >= ctx->strtab_size){
+        topofile_error(ctx, "string offset %u is past the string table", offset);
+        return NULL;
+    }
+    str = ctx->strtab + offset;
+    if(*str == '\0' && !allow_empty){
+        topofile_error(ctx, "empty name");
+        return NULL;
+    }
+    if(strnlen(str, max_len) == max_len){
+        topofile_error(ctx, "%.*s... is longer than %u chars", max_len, str, max_len - 1);
+        return NULL;
+    }
+    return str;
+}
+
+static node_t *
+topofile_node(topofile_ctx_t *ctx, uint32_t index){
+
+    if(index >= ctx->n_nodes){
+        topofile_error(ctx, "node #%u is not defined", index);
+        return NULL;
+    }
+    return ctx->nodes[index];
+}
+
+static boolean
+topofile_level_ok(topofile_ctx_t *ctx, topofile_rec_t *rec, boolean allow_level12){
+
+    if(rec->level == LEVEL1 || rec->level == LEVEL2 ||
+        (allow_level12 && rec->level == LEVEL12))
+        return TRUE;
+    topofile_error(ctx, "invalid level %u for %s", 
+        rec->level, topofile_rec_names[rec->type]);
+    return FALSE;
+}
+
+static edge_end_t *
+topofile_interface(topofile_ctx_t *ctx, node_t *node, uint32_t ifname){
+
+    const char *intf_name = topofile_str(ctx, ifname, IF_NAME_SIZE, FALSE);
+    edge_end_t *interface = NULL;
+
+    if(!intf_name)
+        return NULL;
+    interface = get_interface_from_intf_name(node, (char *)intf_name);
+    if(!interface)
+        topofile_error(ctx, "node %s has no interface %s", node->node_name, intf_name);
+    return interface;
+}
+
+/*A link takes an outgoing and an incoming slot on either end*/
+static boolean
+topofile_has_free_slots(topofile_ctx_t *ctx, node_t *node){
+
+    if(!node->edges[MAX_NODE_INTF_SLOTS - 2])
+        return TRUE;
+    topofile_error(ctx, "node %s is out of interface slots, max %u", 
+        node->node_name, MAX_NODE_INTF_SLOTS);
+    return FALSE;
+}
+
+static int
+topofile_load_node(topofile_ctx_t *ctx, topofile_rec_t *rec){
+
+    char router_id[PREFIX_LEN + 1];
+    const char *node_name = topofile_str(ctx, rec->u.node.name, NODE_NAME_SIZE, FALSE);
+    node_t *node = NULL;
+
+    if(!node_name)
+        return -1;
+    if(rec->u.node.area > AREA6){
+        topofile_error(ctx, "invalid area %u for node %s", rec->u.node.area + 1, node_name);
+        return -1;
+    }
+    if(hash_vector_search_by_key(ctx->instance->instance_node_list, (void *)node_name)){
+        topofile_error(ctx, "node %s is defined twice", node_name);
+        return -1;
+    }
+
+    if(ctx->n_nodes == ctx->max_nodes){
+        ctx->max_nodes = ctx->max_nodes ? ctx->max_nodes * 2 : TOPOFILE_DEFAULT_NODES;
+        ctx->nodes = realloc(ctx->nodes, ctx->max_nodes * sizeof(node_t *));
+        assert(ctx->nodes);
+    }
+
+    node = create_new_node(ctx->instance, (char *)node_name, rec->u.node.area, 
+            topofile_ip_str(rec->u.node.router_id, router_id));
+    assert(node);
+    ctx->nodes[ctx->n_nodes++] = node;
+    return 0;
+}
+
+static int
+topofile_load_link(topofile_ctx_t *ctx, topofile_rec_t *rec){
+
+    char ip[PREFIX_LEN + 1];
+    LEVEL level_it;
+    const char *if_name = NULL, *peer_if_name = NULL;
+    prefix_t *prefix = NULL, *peer_prefix = NULL;
+    node_t *node = topofile_node(ctx, rec->node),
+           *peer = topofile_node(ctx, rec->u.link.peer);
+    edge_t *edge = NULL;
+
+    if(!node || !peer || !topofile_level_ok(ctx, rec, TRUE))
+        return -1;
+    if(node == peer){
+        topofile_error(ctx, "link from node %s to itself", node->node_name);
+        return -1;
+    }
+    if(rec->u.link.mask > 32){
+        topofile_error(ctx, "invalid mask %u", rec->u.link.mask);
+        return -1;
+    }
+    /*Pseudonode interfaces have no name. Like the topo CLI, interface names
+     * need not be unique, interface statements refer to the first match*/
+    if(!(if_name = topofile_str(ctx, rec->u.link.ifname, IF_NAME_SIZE, TRUE)) ||
+        !(peer_if_name = topofile_str(ctx, rec->u.link.peer_ifname, IF_NAME_SIZE, TRUE)))
+        return -1;
+    if(!topofile_has_free_slots(ctx, node) || !topofile_has_free_slots(ctx, peer))
+        return -1;
+
+    if(rec->u.link.ip)
+        prefix = create_new_prefix(topofile_ip_str(rec->u.link.ip, ip), 
+                    rec->u.link.mask, rec->level);
+    if(rec->u.link.peer_ip)
+        peer_prefix = create_new_prefix(topofile_ip_str(rec->u.link.peer_ip, ip), 
+                    rec->u.link.mask, rec->level);
+
+    edge = create_new_edge((char *)if_name, (char *)peer_if_name, 0, 
+                prefix, peer_prefix, rec->level);
+    insert_edge_between_2_nodes(edge, node, peer, BIDIRECTIONAL);
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(!IS_LEVEL_SET(rec->level, level_it))
+            continue;
+        edge->metric[level_it] = rec->u.link.metric[level_it - LEVEL1];
+        edge->inv_edge->metric[level_it] = rec->u.link.peer_metric[level_it - LEVEL1];
+    }
+    ctx->stats.n_links++;
+    return 0;
+}
+
+static int
+topofile_load_spring(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    if(node->spring_enabled){
+        topofile_error(ctx, "SPRING is enabled on node %s already", node->node_name);
+        return -1;
+    }
+    if(!rec->u.cfg.range){
+        topofile_error(ctx, "SRGB range of node %s is empty", node->node_name);
+        return -1;
+    }
+    node->spring_enabled = TRUE;
+    node->srgb = XCALLOC(1, srgb_t);
+    init_srgb_defaults(node->srgb);
+    node->srgb->first_sid.sid = rec->u.cfg.value;
+    if(node->srgb->range != rec->u.cfg.range)
+        resize_srgb(node->srgb, rec->u.cfg.range);
+    return 0;
+}
+
+static int
+topofile_load_backup(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    switch(rec->u.cfg.value){
+        case TOPOFILE_BACKUP_LFA:
+            SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED);
+            break;
+        case TOPOFILE_BACKUP_RLFA:
+            SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_REMOTE_BACKUP_CALCULATION);
+            break;
+        case TOPOFILE_BACKUP_NODE_LINK_DEG:
+            SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_NODE_LINK_DEG);
+            break;
+        case TOPOFILE_BACKUP_SPRING:
+            if(!node->spring_enabled){
+                topofile_error(ctx, "SPRING is not enabled on node %s", node->node_name);
+                return -1;
+            }
+            node->use_spring_backups = TRUE;
+            break;
+        default:
+            topofile_error(ctx, "invalid backup option %u", rec->u.cfg.value);
+            return -1;
+    }
+    return 0;
+}
+
+static int
+topofile_load_intf(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    edge_end_t *interface = NULL;
+    const char *intf_name = NULL;
+    uint32_t value = rec->u.intf.value;
+
+    /*TILFA config is keyed by the interface name alone*/
+    if(rec->type == TOPOFILE_REC_TILFA){
+        if(!(intf_name = topofile_str(ctx, rec->u.intf.ifname, IF_NAME_SIZE, FALSE)))
+            return -1;
+        if(value >= TOPOFILE_TILFA_MAX){
+            topofile_error(ctx, "invalid tilfa protection %u", value);
+            return -1;
+        }
+        tilfa_update_config(node, (char *)intf_name,
+            value == TOPOFILE_TILFA_LINK ? TRUE : DONT_KNOW,
+            value == TOPOFILE_TILFA_NODE ? TRUE : DONT_KNOW,
+            value == TOPOFILE_TILFA_SRLG ? TRUE : DONT_KNOW);
+        return 0;
+    }
+
+    if(!(interface = topofile_interface(ctx, node, rec->u.intf.ifname)))
+        return -1;
+
+    switch(rec->type){
+        case TOPOFILE_REC_DELAY:
+            GET_EGDE_PTR_FROM_EDGE_END(interface)->prop_delay_usec = value;
+            break;
+        case TOPOFILE_REC_SRLG:
+            edge_add_srlg(GET_EGDE_PTR_FROM_EDGE_END(interface), value);
+            break;
+        case TOPOFILE_REC_PROTECT:
+            if(value >= TOPOFILE_PROTECT_MAX){
+                topofile_error(ctx, "invalid protection %u", value);
+                return -1;
+            }
+            SET_BIT(interface->edge_config_flags, topofile_protect_bits[value]);
+            break;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+static int
+topofile_load_prefix(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    char prefix_str[PREFIX_LEN + 1];
+    LEVEL level_it;
+    prefix_t *prefix = NULL;
+
+    if(!topofile_level_ok(ctx, rec, TRUE))
+        return -1;
+    if(rec->u.prefix.mask > 32){
+        topofile_error(ctx, "invalid mask %u", rec->u.prefix.mask);
+        return -1;
+    }
+    topofile_ip_str(rec->u.prefix.prefix, prefix_str);
+
+    if(rec->type == TOPOFILE_REC_PREFIX_SID){
+        if(!node->spring_enabled){
+            topofile_error(ctx, "SPRING is not enabled on node %s", node->node_name);
+            return -1;
+        }
+        if(rec->u.prefix.value >= node->srgb->range){
+            topofile_error(ctx, "SID index %u is out of the SRGB of node %s", 
+                rec->u.prefix.value, node->node_name);
+            return -1;
+        }
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        if(!IS_LEVEL_SET(rec->level, level_it))
+            continue;
+
+        prefix = node_local_prefix_search(node, level_it, prefix_str, rec->u.prefix.mask);
+
+        if(rec->type == TOPOFILE_REC_PREFIX){
+            if(prefix){
+                topofile_error(ctx, "node %s has prefix %s/%u at level %u already", 
+                    node->node_name, prefix_str, rec->u.prefix.mask, level_it);
+                return -1;
+            }
+            attach_prefix_on_node(node, prefix_str, rec->u.prefix.mask, level_it, 
+                rec->u.prefix.value, rec->u.prefix.flags);
+            continue;
+        }
+
+        if(!prefix){
+            topofile_error(ctx, "node %s has no prefix %s/%u at level %u", 
+                node->node_name, prefix_str, rec->u.prefix.mask, level_it);
+            return -1;
+        }
+        update_prefix_sid(node, prefix, rec->u.prefix.value, level_it);
+    }
+
+    if(rec->type == TOPOFILE_REC_PREFIX)
+        ctx->stats.n_prefixes++;
+    return 0;
+}
+
+static int
+topofile_load_adj_sid(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    char lan_nbr[PREFIX_LEN + 1];
+    int cmd_code = 0;
+    edge_end_t *interface = NULL;
+
+    if(!topofile_level_ok(ctx, rec, FALSE))
+        return -1;
+    if(!(interface = topofile_interface(ctx, node, rec->u.adj_sid.ifname)))
+        return -1;
+    if(is_static_adj_sid_in_use(node, rec->u.adj_sid.label)){
+        topofile_error(ctx, "adjacency SID %u is in use on node %s already", 
+            rec->u.adj_sid.label, node->node_name);
+        return -1;
+    }
+
+    if(rec->u.adj_sid.lan_nbr)
+        cmd_code = rec->u.adj_sid.protected ? CMDCODE_CONFIG_NODE_INTF_LAN_ADJ_SID_PROTECTED :
+            CMDCODE_CONFIG_NODE_INTF_LAN_ADJ_SID_UNPROTECTED;
+    else
+        cmd_code = rec->u.adj_sid.protected ? CMDCODE_CONFIG_NODE_INTF_P2P_ADJ_SID_PROTECTED :
+            CMDCODE_CONFIG_NODE_INTF_P2P_ADJ_SID_UNPROTECTED;
+
+    set_adj_sid(node, interface->intf_name, rec->level, rec->u.adj_sid.label,
+        topofile_ip_str(rec->u.adj_sid.lan_nbr, lan_nbr), cmd_code);
+    return 0;
+}
+
+/*Same as the rsvp tunnel and lsp config pair, except that the tunnel path
+ * is the given first hop rather than the IGP route to the egress LSR*/
+static int
+topofile_load_lsp(topofile_ctx_t *ctx, node_t *node, topofile_rec_t *rec){
+
+    LEVEL level_it;
+    const char *lsp_name = NULL;
+    node_t *egress = NULL;
+    edge_end_t *oif = NULL;
+    edge_t *oif_edge = NULL;
+    rsvp_tunnel_t *rsvp_tunnel = NULL;
+
+    if(!topofile_level_ok(ctx, rec, FALSE))
+        return -1;
+    /*The lsp name is the name of the forwarding adjacency interface too*/
+    if(!(lsp_name = topofile_str(ctx, rec->u.lsp.name, IF_NAME_SIZE, FALSE)))
+        return -1;
+    if(!(egress = topofile_node(ctx, rec->u.lsp.egress)))
+        return -1;
+    if(!(oif = topofile_interface(ctx, node, rec->u.lsp.ifname)))
+        return -1;
+    if(look_up_rsvp_tunnel(node, (char *)lsp_name) || 
+        get_interface_from_intf_name(node, (char *)lsp_name)){
+        topofile_error(ctx, "node %s has lsp or interface %s already", node->node_name, lsp_name);
+        return -1;
+    }
+    if(!topofile_has_free_slots(ctx, node))
+        return -1;
+
+    rsvp_tunnel = XCALLOC(1, rsvp_tunnel_t);
+    strncpy(rsvp_tunnel->lsp_name, lsp_name, RSVP_LSP_NAME_SIZE);
+    rsvp_tunnel->lsp_name[RSVP_LSP_NAME_SIZE - 1] = '\0';
+    rsvp_tunnel->physical_oif = oif;
+    rsvp_tunnel->egress_lsr = egress;
+    rsvp_tunnel->rsvp_label = rec->u.lsp.label;
+
+    oif_edge = GET_EGDE_PTR_FROM_EDGE_END(oif);
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(!oif_edge->to.prefix[level_it])
+            continue;
+        strncpy(rsvp_tunnel->gateway, oif_edge->to.prefix[level_it]->prefix, PREFIX_LEN);
+        rsvp_tunnel->gateway[PREFIX_LEN] = '\0';
+        break;
+    }
+
+    add_new_rsvp_tunnel(node, rsvp_tunnel);
+    insert_lsp_as_forward_adjacency(node, (char *)lsp_name, rec->u.lsp.metric, 
+            egress->router_id, rec->level);
+    return 0;
+}
+
+static int
+topofile_load_rec(topofile_ctx_t *ctx, topofile_rec_t *rec){
+
+    node_t *node = NULL;
+
+    ctx->stats.n_recs++;
+
+    switch(rec->type){
+        case TOPOFILE_REC_NODE:
+            return topofile_load_node(ctx, rec);
+        case TOPOFILE_REC_LINK:
+            return topofile_load_link(ctx, rec);
+        default:
+            break;
+    }
+
+    if(rec->type >= TOPOFILE_REC_MAX){
+        topofile_error(ctx, "unknown record type %u", rec->type);
+        return -1;
+    }
+    if(!(node = topofile_node(ctx, rec->node)))
+        return -1;
+
+    switch(rec->type){
+        case TOPOFILE_REC_ROOT:
+            ctx->root = node;
+            return 0;
+        case TOPOFILE_REC_PSEUDONODE:
+            if(!topofile_level_ok(ctx, rec, FALSE))
+                return -1;
+            mark_node_pseudonode(node, rec->level);
+            return 0;
+        case TOPOFILE_REC_OVERLOAD:
+            if(!topofile_level_ok(ctx, rec, FALSE))
+                return -1;
+            SET_BIT(node->attributes[rec->level], OVERLOAD_BIT);
+            return 0;
+        case TOPOFILE_REC_SPRING:
+            return topofile_load_spring(ctx, node, rec);
+        case TOPOFILE_REC_LDP:
+            enable_ldp(node);
+            return 0;
+        case TOPOFILE_REC_RSVP:
+            enable_rsvp(node);
+            return 0;
+        case TOPOFILE_REC_BACKUP:
+            return topofile_load_backup(ctx, node, rec);
+        case TOPOFILE_REC_DELAY:
+        case TOPOFILE_REC_SRLG:
+        case TOPOFILE_REC_PROTECT:
+        case TOPOFILE_REC_TILFA:
+            return topofile_load_intf(ctx, node, rec);
+        case TOPOFILE_REC_PREFIX:
+        case TOPOFILE_REC_PREFIX_SID:
+            return topofile_load_prefix(ctx, node, rec);
+        case TOPOFILE_REC_ADJ_SID:
+            return topofile_load_adj_sid(ctx, node, rec);
+        case TOPOFILE_REC_LSP:
+            return topofile_load_lsp(ctx, node, rec);
+        default:
+            assert(0);
+    }
+    return -1;
+}
+
+/*Text form parser, strings are offsets into the line being parsed*/
+
+static boolean
+topofile_parse_uint(topofile_ctx_t *ctx, const char *token, uint32_t *value){
+
+    char *end = NULL;
+    unsigned long val = 0;
+
+    if(*token < '0' || *token > '9'){
+        topofile_error(ctx, "%s is not a number", token);
+        return FALSE;
+    }
+    val = strtoul(token, &end, 10);
+    if(*end != '\0' || val > UINT32_MAX){
+        topofile_error(ctx, "%s is not a number", token);
+        return FALSE;
+    }
+    *value = (uint32_t)val;
+    return TRUE;
+}
+
+static boolean
+topofile_parse_ip(topofile_ctx_t *ctx, const char *token, uint32_t *ip, boolean allow_none){
+
+    if(allow_none && strcmp(token, "-") == 0){
+        *ip = 0;
+        return TRUE;
+    }
+    if(!(*ip = topofile_ip_from_str(token)) && strcmp(token, "0.0.0.0")){
+        topofile_error(ctx, "%s is not an ip address", token);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static boolean
+topofile_parse_level(topofile_ctx_t *ctx, const char *token, uint16_t *level){
+
+    if(strcmp(token, "1") == 0)
+        *level = LEVEL1;
+    else if(strcmp(token, "2") == 0)
+        *level = LEVEL2;
+    else if(strcmp(token, "12") == 0)
+        *level = LEVEL12;
+    else{
+        topofile_error(ctx, "%s is not a level, expected 1, 2 or 12", token);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static boolean
+topofile_parse_node(topofile_ctx_t *ctx, const char *token, uint32_t *index){
+
+    node_t *node = hash_vector_search_by_key(ctx->instance->instance_node_list, 
+                        (void *)token);
+
+    if(!node){
+        topofile_error(ctx, "node %s is not defined", token);
+        return FALSE;
+    }
+    /*Node index of a node of a fresh instance is its position in the file*/
+    *index = node->node_index;
+    return TRUE;
+}
+
+static boolean
+topofile_parse_keyword(topofile_ctx_t *ctx, const char *token, const char *what,
+        const char **names, uint32_t n_names, uint32_t *value){
+
+    uint32_t i = 0;
+
+    for(i = 0; i < n_names; i++){
+        if(strcmp(token, names[i]) == 0){
+            *value = i;
+            return TRUE;
+        }
+    }
+    topofile_error(ctx, "unknown %s %s", what, token);
+    return FALSE;
+}
+
+/*<metric> or <l1-metric>/<l2-metric>*/
+static boolean
+topofile_parse_metric(topofile_ctx_t *ctx, char *token, uint32_t *metric){
+
+    char *slash = strchr(token, '/');
+    boolean rc = FALSE;
+
+    if(!slash){
+        if(!topofile_parse_uint(ctx, token, &metric[0]))
+            return FALSE;
+        metric[1] = metric[0];
+        return TRUE;
+    }
+    *slash = '\0';
+    rc = topofile_parse_uint(ctx, token, &metric[0]) &&
+         topofile_parse_uint(ctx, slash + 1, &metric[1]);
+    *slash = '/';
+    return rc;
+}
+
+#define TOPOFILE_STR_OFFSET(ctx, token)  ((uint32_t)((token) - (ctx)->strtab))
+
+/*Returns 1 if line held a statement, 0 if it was blank, -1 on error*/
+static int
+topofile_parse_line(topofile_ctx_t *ctx, char *line, topofile_rec_t *rec){
+
+    char *tokens[TOPOFILE_MAX_TOKENS];
+    char **arg = NULL;
+    char *curr = line;
+    uint32_t n_tokens = 0, n_args = 0, type = 0, value = 0;
+    boolean rc = TRUE;
+
+    if((curr = strchr(line, '#')))
+        *curr = '\0';
+
+    ctx->strtab = line;
+    ctx->strtab_size = strlen(line) + 1;
+
+    for(curr = strtok(line, " \t\r\n"); curr; curr = strtok(NULL, " \t\r\n")){
+        if(n_tokens == TOPOFILE_MAX_TOKENS){
+            topofile_error(ctx, "too many arguments");
+            return -1;
+        }
+        tokens[n_tokens++] = curr;
+    }
+    if(!n_tokens)
+        return 0;
+
+    if(strcmp(tokens[0], "topology") == 0){
+        if(n_tokens != 2 || !topofile_parse_uint(ctx, tokens[1], &value))
+            return -1;
+        if(value != TOPOFILE_VERSION){
+            topofile_error(ctx, "unsupported version %u, expected %u", 
+                value, TOPOFILE_VERSION);
+            return -1;
+        }
+        return 0;
+    }
+
+    if(!topofile_parse_keyword(ctx, tokens[0], "statement", topofile_rec_names, TOPOFILE_REC_MAX, &type))
+        return -1;
+
+    n_args = n_tokens - 1;
+    if(n_args < topofile_rec_min_args[type] || n_args > topofile_rec_max_args[type]){
+        topofile_error(ctx, "%s takes %u to %u arguments, %u given", tokens[0],
+            topofile_rec_min_args[type], topofile_rec_max_args[type], n_args);
+        return -1;
+    }
+
+    memset(rec, 0, sizeof(topofile_rec_t));
+    rec->type = type;
+    arg = &tokens[1];
+
+    if(type == TOPOFILE_REC_NODE){
+        rec->u.node.name = TOPOFILE_STR_OFFSET(ctx, arg[0]);
+        if(!topofile_parse_ip(ctx, arg[1], &rec->u.node.router_id, FALSE) ||
+            !topofile_parse_uint(ctx, arg[2], &rec->u.node.area))
+            return -1;
+        if(rec->u.node.area < 1 || rec->u.node.area > AREA6 + 1){
+            topofile_error(ctx, "invalid area %s, expected 1 to %u", arg[2], AREA6 + 1);
+            return -1;
+        }
+        rec->u.node.area--;
+        return 1;
+    }
+
+    if(!topofile_parse_node(ctx, arg[0], &rec->node))
+        return -1;
+
+    switch(type){
+        case TOPOFILE_REC_ROOT:
+        case TOPOFILE_REC_LDP:
+        case TOPOFILE_REC_RSVP:
+            break;
+        case TOPOFILE_REC_LINK:
+            if(strcmp(arg[1], "-") == 0)
+                arg[1][0] = '\0';
+            if(strcmp(arg[4], "-") == 0)
+                arg[4][0] = '\0';
+            rec->u.link.ifname = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rec->u.link.peer_ifname = TOPOFILE_STR_OFFSET(ctx, arg[4]);
+            rc = topofile_parse_ip(ctx, arg[2], &rec->u.link.ip, TRUE) &&
+                 topofile_parse_node(ctx, arg[3], &rec->u.link.peer) &&
+                 topofile_parse_ip(ctx, arg[5], &rec->u.link.peer_ip, TRUE) &&
+                 topofile_parse_uint(ctx, arg[6], &rec->u.link.mask) &&
+                 topofile_parse_level(ctx, arg[7], &rec->level) &&
+                 topofile_parse_metric(ctx, arg[8], rec->u.link.metric);
+            if(rc && n_args == 10)
+                rc = topofile_parse_metric(ctx, arg[9], rec->u.link.peer_metric);
+            else if(rc)
+                memcpy(rec->u.link.peer_metric, rec->u.link.metric, sizeof(rec->u.link.metric));
+            break;
+        case TOPOFILE_REC_PSEUDONODE:
+        case TOPOFILE_REC_OVERLOAD:
+            rc = topofile_parse_level(ctx, arg[1], &rec->level);
+            break;
+        case TOPOFILE_REC_SPRING:
+            rc = topofile_parse_uint(ctx, arg[1], &rec->u.cfg.value) &&
+                 topofile_parse_uint(ctx, arg[2], &rec->u.cfg.range);
+            break;
+        case TOPOFILE_REC_BACKUP:
+            rc = topofile_parse_keyword(ctx, arg[1], "backup option", topofile_backup_names, 
+                    TOPOFILE_BACKUP_MAX, &rec->u.cfg.value);
+            break;
+        case TOPOFILE_REC_DELAY:
+        case TOPOFILE_REC_SRLG:
+            rec->u.intf.ifname = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rc = topofile_parse_uint(ctx, arg[2], &rec->u.intf.value);
+            break;
+        case TOPOFILE_REC_PROTECT:
+            rec->u.intf.ifname = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rc = topofile_parse_keyword(ctx, arg[2], "protection", topofile_protect_names, 
+                    TOPOFILE_PROTECT_MAX, &rec->u.intf.value);
+            break;
+        case TOPOFILE_REC_TILFA:
+            rec->u.intf.ifname = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rc = topofile_parse_keyword(ctx, arg[2], "tilfa protection", topofile_tilfa_names, 
+                    TOPOFILE_TILFA_MAX, &rec->u.intf.value);
+            break;
+        case TOPOFILE_REC_PREFIX:
+        case TOPOFILE_REC_PREFIX_SID:
+            rc = topofile_parse_ip(ctx, arg[1], &rec->u.prefix.prefix, FALSE) &&
+                 topofile_parse_uint(ctx, arg[2], &rec->u.prefix.mask) &&
+                 topofile_parse_level(ctx, arg[3], &rec->level) &&
+                 topofile_parse_uint(ctx, arg[4], &rec->u.prefix.value);
+            if(rc && n_args == 6)
+                rc = topofile_parse_uint(ctx, arg[5], &rec->u.prefix.flags);
+            break;
+        case TOPOFILE_REC_ADJ_SID:
+            rec->u.adj_sid.ifname = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rc = topofile_parse_level(ctx, arg[2], &rec->level) &&
+                 topofile_parse_uint(ctx, arg[3], &rec->u.adj_sid.label);
+            if(rc && strcmp(arg[4], "protected") == 0)
+                rec->u.adj_sid.protected = TRUE;
+            else if(rc && strcmp(arg[4], "unprotected")){
+                topofile_error(ctx, "unknown adjacency SID protection %s", arg[4]);
+                rc = FALSE;
+            }
+            if(rc && n_args == 6)
+                rc = topofile_parse_ip(ctx, arg[5], &rec->u.adj_sid.lan_nbr, FALSE);
+            break;
+        case TOPOFILE_REC_LSP:
+            rec->u.lsp.name = TOPOFILE_STR_OFFSET(ctx, arg[1]);
+            rec->u.lsp.ifname = TOPOFILE_STR_OFFSET(ctx, arg[3]);
+            rc = topofile_parse_node(ctx, arg[2], &rec->u.lsp.egress) &&
+                 topofile_parse_level(ctx, arg[4], &rec->level) &&
+                 topofile_parse_uint(ctx, arg[5], &rec->u.lsp.metric) &&
+                 topofile_parse_uint(ctx, arg[6], &rec->u.lsp.label);
+            break;
+        default:
+            assert(0);
+    }
+    return rc ? 1 : -1;
+}
+
+static int
+topofile_load_text(topofile_ctx_t *ctx, FILE *fp){
+
+    char line[TOPOFILE_MAX_LINE];
+    topofile_rec_t rec;
+    int rc = 0;
+    size_t len = 0;
+
+    ctx->stats.format = TOPOFILE_TEXT;
+
+    while(fgets(line, sizeof(line), fp)){
+
+        ctx->stmt_no++;
+        len = strlen(line);
+        if(len == sizeof(line) - 1 && line[len - 1] != '\n' && !feof(fp)){
+            topofile_error(ctx, "line is longer than %u chars", TOPOFILE_MAX_LINE - 2);
+            return -1;
+        }
+        rc = topofile_parse_line(ctx, line, &rec);
+        if(rc < 0)
+            return -1;
+        if(rc == 0)
+            continue;
+        if(topofile_load_rec(ctx, &rec) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int
+topofile_load_binary(topofile_ctx_t *ctx, int fd, size_t file_size){
+
+    char *base = NULL;
+    topofile_bin_hdr_t *hdr = NULL;
+    topofile_rec_t *recs = NULL;
+    uint32_t i = 0;
+    int rc = 0;
+
+    ctx->stats.format = TOPOFILE_BINARY;
+
+    if(file_size < sizeof(topofile_bin_hdr_t)){
+        topofile_error(ctx, "truncated header");
+        return -1;
+    }
+    base = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(base == MAP_FAILED){
+        topofile_error(ctx, "mmap failed");
+        return -1;
+    }
+    madvise(base, file_size, MADV_SEQUENTIAL);
+    hdr = (topofile_bin_hdr_t *)base;
+
+    if(hdr->byte_order != TOPOFILE_BYTE_ORDER)
+        topofile_error(ctx, "written on a host of the other byte order");
+    else if(hdr->version != TOPOFILE_VERSION)
+        topofile_error(ctx, "unsupported version %u, expected %u", hdr->version, TOPOFILE_VERSION);
+    else if(hdr->rec_size != sizeof(topofile_rec_t))
+        topofile_error(ctx, "record size %u, expected %zu", hdr->rec_size, sizeof(topofile_rec_t));
+    else if((uint64_t)sizeof(topofile_bin_hdr_t) + (uint64_t)hdr->n_recs * hdr->rec_size + 
+            hdr->strtab_size != file_size)
+        topofile_error(ctx, "file size %zu does not match the header", file_size);
+    else if(!hdr->strtab_size || base[file_size - 1] != '\0')
+        topofile_error(ctx, "string table is not terminated");
+    else
+        rc = 1;
+
+    if(rc != 1){
+        munmap(base, file_size);
+        return -1;
+    }
+
+    /*Whole node index up front, node statements never grow it*/
+    ctx->max_nodes = hdr->n_nodes;
+    ctx->nodes = calloc(ctx->max_nodes ? ctx->max_nodes : 1, sizeof(node_t *));
+    assert(ctx->nodes);
+
+    recs = (topofile_rec_t *)(base + sizeof(topofile_bin_hdr_t));
+    ctx->strtab = (const char *)(recs + hdr->n_recs);
+    ctx->strtab_size = hdr->strtab_size;
+
+    rc = 0;
+    for(i = 0; i < hdr->n_recs; i++){
+        ctx->stmt_no = i + 1;
+        if(topofile_load_rec(ctx, &recs[i]) < 0){
+            rc = -1;
+            break;
+        }
+    }
+    munmap(base, file_size);
+    return rc;
+}
+
+instance_t *
+topofile_load(const char *file_name, topofile_stats_t *stats){
+
+    char magic[sizeof(((topofile_bin_hdr_t *)0)->magic)];
+    int fd = -1, rc = -1;
+    FILE *fp = NULL;
+    struct stat st;
+    topofile_ctx_t ctx;
+
+    memset(&ctx, 0, sizeof(topofile_ctx_t));
+    ctx.file_name = file_name;
+
+    fd = open(file_name, O_RDONLY);
+    if(fd < 0 || fstat(fd, &st) < 0){
+        printf("Error : Could not open %s\n", file_name);
+        if(fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    ctx.instance = get_new_instance();
+
+    memset(magic, 0, sizeof(magic));
+    if(read(fd, magic, sizeof(magic)) == sizeof(magic) &&
+        memcmp(magic, TOPOFILE_MAGIC, sizeof(magic)) == 0){
+        rc = topofile_load_binary(&ctx, fd, (size_t)st.st_size);
+        close(fd);
+    }
+    else{
+        lseek(fd, 0, SEEK_SET);
+        fp = fdopen(fd, "r");
+        assert(fp);
+        rc = topofile_load_text(&ctx, fp);
+        fclose(fp);
+    }
+
+    if(rc == 0 && !ctx.n_nodes){
+        printf("Error : %s : no nodes\n", file_name);
+        rc = -1;
+    }
+
+    if(rc == 0){
+        set_instance_root(ctx.instance, ctx.root ? ctx.root : ctx.nodes[0]);
+        ctx.stats.n_nodes = ctx.n_nodes;
+        if(stats)
+            *stats = ctx.stats;
+    }
+
+    /*A partially loaded instance is dropped, Memory Leak, sorry!*/
+    free(ctx.nodes);
+    return rc == 0 ? ctx.instance : NULL;
+}
+
+/*Writer, builds the records of the whole instance, then writes them out
+ * in either form*/
+
+typedef struct topofile_writer_{
+
+    topofile_rec_t *recs;
+    uint32_t n_recs;
+    uint32_t max_recs;
+    char *strtab;
+    uint32_t strtab_size;
+    uint32_t max_strtab_size;
+    uint32_t *str_slots;        /*Interned strings, 1 + strtab offset, 0 if slot is free*/
+    uint32_t n_str_slots;       /*Power of 2*/
+    uint32_t n_strs;
+    uint32_t *node_pos;         /*By node_index, 1 + position in file, 0 if not exported*/
+    uint32_t *node_names;       /*By position in file*/
+    node_t **nodes;             /*By position in file*/
+    uint32_t n_nodes;
+    edge_t **links;             /*Saved links, node to peer direction*/
+    uint32_t n_links;
+    uint32_t max_links;
+    topofile_stats_t stats;
+} topofile_writer_t;
+
+static void
+topofile_str_slots_grow(topofile_writer_t *writer){
+
+    uint32_t *old_slots = writer->str_slots,
+             n_old_slots = writer->n_str_slots,
+             i = 0, j = 0;
+
+    writer->n_str_slots = n_old_slots ? n_old_slots * 2 : TOPOFILE_DEFAULT_NODES;
+    writer->str_slots = calloc(writer->n_str_slots, sizeof(uint32_t));
+    assert(writer->str_slots);
+
+    for(i = 0; i < n_old_slots; i++){
+        if(!old_slots[i])
+            continue;
+        j = hash_vector_str_hash(writer->strtab + old_slots[i] - 1, IF_NAME_SIZE + NODE_NAME_SIZE);
+        while(writer->str_slots[j & (writer->n_str_slots - 1)])
+            j++;
+        writer->str_slots[j & (writer->n_str_slots - 1)] = old_slots[i];
+    }
+    free(old_slots);
+}
+
+static uint32_t
+topofile_intern(topofile_writer_t *writer, const char *str){
+
+    uint32_t i = 0, offset = 0, len = strlen(str) + 1;
+
+    if(2 * (writer->n_strs + 1) > writer->n_str_slots)
+        topofile_str_slots_grow(writer);
+
+    i = hash_vector_str_hash(str, IF_NAME_SIZE + NODE_NAME_SIZE);
+    while(writer->str_slots[i & (writer->n_str_slots - 1)]){
+        offset = writer->str_slots[i & (writer->n_str_slots - 1)] - 1;
+        if(strcmp(writer->strtab + offset, str) == 0)
+            return offset;
+        i++;
+    }
+
+    if(writer->strtab_size + len > writer->max_strtab_size){
+        writer->max_strtab_size = writer->max_strtab_size ? 
+            writer->max_strtab_size * 2 : 16 * TOPOFILE_DEFAULT_NODES;
+        writer->strtab = realloc(writer->strtab, writer->max_strtab_size);
+        assert(writer->strtab);
+    }
+    offset = writer->strtab_size;
+    memcpy(writer->strtab + offset, str, len);
+    writer->strtab_size += len;
+    writer->str_slots[i & (writer->n_str_slots - 1)] = offset + 1;
+    writer->n_strs++;
+    return offset;
+}
+
+static topofile_rec_t *
+topofile_new_rec(topofile_writer_t *writer, topofile_rec_type_t type, 
+        node_t *node, LEVEL level){
+
+    topofile_rec_t *rec = NULL;
+
+    if(writer->n_recs == writer->max_recs){
+        writer->max_recs = writer->max_recs ? writer->max_recs * 2 : 4 * TOPOFILE_DEFAULT_NODES;
+        writer->recs = realloc(writer->recs, writer->max_recs * sizeof(topofile_rec_t));
+        assert(writer->recs);
+    }
+    rec = &writer->recs[writer->n_recs++];
+    memset(rec, 0, sizeof(topofile_rec_t));
+    rec->type = type;
+    rec->level = level;
+    if(node)
+        rec->node = writer->node_pos[node->node_index] - 1;
+    writer->stats.n_recs++;
+    return rec;
+}
+
+static LEVEL
+topofile_first_level(LEVEL level){
+
+    return IS_LEVEL_SET(level, LEVEL1) ? LEVEL1 : LEVEL2;
+}
+
+static uint32_t
+topofile_edge_end_ip(edge_end_t *edge_end, LEVEL level){
+
+    prefix_t *prefix = edge_end->prefix[topofile_first_level(level)];
+
+    return prefix ? topofile_ip_from_str(prefix->prefix) : 0;
+}
+
+static void
+topofile_save_link(topofile_writer_t *writer, node_t *node, edge_t *edge){
+
+    topofile_rec_t *rec = NULL;
+    prefix_t *prefix = NULL;
+    LEVEL level_it;
+
+    rec = topofile_new_rec(writer, TOPOFILE_REC_LINK, node, edge->level);
+    rec->u.link.ifname = topofile_intern(writer, edge->from.intf_name);
+    rec->u.link.ip = topofile_edge_end_ip(&edge->from, edge->level);
+    rec->u.link.peer = writer->node_pos[edge->to.node->node_index] - 1;
+    rec->u.link.peer_ifname = topofile_intern(writer, edge->to.intf_name);
+    rec->u.link.peer_ip = topofile_edge_end_ip(&edge->to, edge->level);
+
+    prefix = edge->from.prefix[topofile_first_level(edge->level)];
+    if(!prefix)
+        prefix = edge->to.prefix[topofile_first_level(edge->level)];
+    rec->u.link.mask = prefix ? prefix->mask : 0;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        rec->u.link.metric[level_it - LEVEL1] = edge->metric[level_it];
+        rec->u.link.peer_metric[level_it - LEVEL1] = edge->inv_edge->metric[level_it];
+    }
+    if(writer->n_links == writer->max_links){
+        writer->max_links = writer->max_links ? writer->max_links * 2 : TOPOFILE_DEFAULT_NODES;
+        writer->links = realloc(writer->links, writer->max_links * sizeof(edge_t *));
+        assert(writer->links);
+    }
+    writer->links[writer->n_links++] = edge;
+    writer->stats.n_links++;
+}
+
+/*Nodes, then links, then whatever hangs off them, in the order the loader
+ * needs them*/
+static void
+topofile_save_topology(topofile_writer_t *writer, instance_t *instance){
+
+    uint32_t pos = 0;
+    unsigned int i = 0;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+    topofile_rec_t *rec = NULL;
+
+    for(pos = 0; pos < writer->n_nodes; pos++){
+        node = writer->nodes[pos];
+        rec = topofile_new_rec(writer, TOPOFILE_REC_NODE, NULL, LEVEL_UNKNOWN);
+        rec->u.node.name = writer->node_names[pos];
+        rec->u.node.router_id = topofile_ip_from_str(node->router_id);
+        rec->u.node.area = node->area;
+    }
+
+    if(instance->instance_root)
+        topofile_new_rec(writer, TOPOFILE_REC_ROOT, instance->instance_root, LEVEL_UNKNOWN);
+
+    /*Every link is written once, by the end which comes first in the file*/
+    for(pos = 0; pos < writer->n_nodes; pos++){
+        node = writer->nodes[pos];
+        for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+            edge_end = node->edges[i];
+            if(!edge_end)
+                break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            if(edge->etype != UNICAST)
+                continue;
+            if(!edge->inv_edge){
+                writer->stats.n_skipped++;
+                continue;
+            }
+            if(writer->node_pos[edge->to.node->node_index] - 1 < pos)
+                continue;
+            topofile_save_link(writer, node, edge);
+        }
+    }
+}
+
+static void
+topofile_save_node_config(topofile_writer_t *writer, node_t *node){
+
+    LEVEL level_it;
+    topofile_rec_t *rec = NULL;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(node->node_type[level_it] == PSEUDONODE)
+            topofile_new_rec(writer, TOPOFILE_REC_PSEUDONODE, node, level_it);
+    }
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(IS_BIT_SET(node->attributes[level_it], OVERLOAD_BIT))
+            topofile_new_rec(writer, TOPOFILE_REC_OVERLOAD, node, level_it);
+    }
+    if(node->spring_enabled){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_SPRING, node, LEVEL_UNKNOWN);
+        rec->u.cfg.value = node->srgb->first_sid.sid;
+        rec->u.cfg.range = node->srgb->range;
+    }
+    if(node->ldp_config.is_enabled)
+        topofile_new_rec(writer, TOPOFILE_REC_LDP, node, LEVEL_UNKNOWN);
+    if(node->rsvp_config.is_enabled)
+        topofile_new_rec(writer, TOPOFILE_REC_RSVP, node, LEVEL_UNKNOWN);
+
+    if(IS_BIT_SET(node->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_BACKUP, node, LEVEL_UNKNOWN);
+        rec->u.cfg.value = TOPOFILE_BACKUP_LFA;
+    }
+    if(IS_BIT_SET(node->backup_spf_options, SPF_BACKUP_OPTIONS_REMOTE_BACKUP_CALCULATION)){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_BACKUP, node, LEVEL_UNKNOWN);
+        rec->u.cfg.value = TOPOFILE_BACKUP_RLFA;
+    }
+    if(IS_BIT_SET(node->backup_spf_options, SPF_BACKUP_OPTIONS_NODE_LINK_DEG)){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_BACKUP, node, LEVEL_UNKNOWN);
+        rec->u.cfg.value = TOPOFILE_BACKUP_NODE_LINK_DEG;
+    }
+    if(node->spring_enabled && node->use_spring_backups){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_BACKUP, node, LEVEL_UNKNOWN);
+        rec->u.cfg.value = TOPOFILE_BACKUP_SPRING;
+    }
+}
+
+static tilfa_lcl_config_t *
+topofile_tilfa_config(node_t *node, char *intf_name){
+
+    glthread_t *curr = NULL;
+    tilfa_lcl_config_t *tilfa_lcl_config = NULL;
+
+    if(!node->tilfa_info)
+        return NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&node->tilfa_info->tilfa_lcl_config_head, curr){
+
+        tilfa_lcl_config = tilfa_lcl_config_to_config_glue(curr);
+        if(strncmp(tilfa_lcl_config->protected_link, intf_name, IF_NAME_SIZE) == 0)
+            return tilfa_lcl_config;
+    } ITERATE_GLTHREAD_END(&node->tilfa_info->tilfa_lcl_config_head, curr);
+    return NULL;
+}
+
+static void
+topofile_save_intf_config(topofile_writer_t *writer, node_t *node, 
+        edge_end_t *edge_end, boolean link_owner){
+
+    unsigned int i = 0;
+    topofile_protect_t protect;
+    topofile_rec_t *rec = NULL;
+    tilfa_lcl_config_t *tilfa_lcl_config = NULL;
+    edge_t *edge = NULL;
+    uint32_t ifname = 0;
+
+    /*Pseudonode interfaces have no name to refer to them by*/
+    if(edge_end->intf_name[0] == '\0')
+        return;
+
+    edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+    ifname = topofile_intern(writer, edge_end->intf_name);
+
+    if(edge->prop_delay_usec != DEFAULT_LINK_PROP_DELAY_USEC){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_DELAY, node, LEVEL_UNKNOWN);
+        rec->u.intf.ifname = ifname;
+        rec->u.intf.value = edge->prop_delay_usec;
+    }
+
+    /*SRLGs are shared by both directions, written by the end owning the link*/
+    if(link_owner){
+        for(i = 0; i < edge->n_srlg; i++){
+            rec = topofile_new_rec(writer, TOPOFILE_REC_SRLG, node, LEVEL_UNKNOWN);
+            rec->u.intf.ifname = ifname;
+            rec->u.intf.value = edge->srlg[i];
+        }
+    }
+
+    for(protect = TOPOFILE_PROTECT_LINK; protect < TOPOFILE_PROTECT_MAX; protect++){
+        if(!IS_BIT_SET(edge_end->edge_config_flags, topofile_protect_bits[protect]))
+            continue;
+        rec = topofile_new_rec(writer, TOPOFILE_REC_PROTECT, node, LEVEL_UNKNOWN);
+        rec->u.intf.ifname = ifname;
+        rec->u.intf.value = protect;
+    }
+
+    if(!(tilfa_lcl_config = topofile_tilfa_config(node, edge_end->intf_name)))
+        return;
+
+    if(tilfa_lcl_config->link_protection == TRUE){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_TILFA, node, LEVEL_UNKNOWN);
+        rec->u.intf.ifname = ifname;
+        rec->u.intf.value = TOPOFILE_TILFA_LINK;
+    }
+    if(tilfa_lcl_config->node_protection == TRUE){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_TILFA, node, LEVEL_UNKNOWN);
+        rec->u.intf.ifname = ifname;
+        rec->u.intf.value = TOPOFILE_TILFA_NODE;
+    }
+    if(tilfa_lcl_config->srlg_protection == TRUE){
+        rec = topofile_new_rec(writer, TOPOFILE_REC_TILFA, node, LEVEL_UNKNOWN);
+        rec->u.intf.ifname = ifname;
+        rec->u.intf.value = TOPOFILE_TILFA_SRLG;
+    }
+}
+
+/*Router id and interface prefixes come with the node and link statements*/
+static boolean
+topofile_is_implicit_prefix(node_t *node, prefix_t *prefix, LEVEL level){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+
+    if(prefix->mask == 32 && strncmp(prefix->prefix, node->router_id, PREFIX_LEN) == 0)
+        return TRUE;
+
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end)
+            break;
+        if(edge_end->dirn != OUTGOING || !edge_end->prefix[level])
+            continue;
+        if(edge_end->prefix[level]->mask == prefix->mask &&
+            strncmp(edge_end->prefix[level]->prefix, prefix->prefix, PREFIX_LEN) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+topofile_save_prefixes(topofile_writer_t *writer, node_t *node, boolean sids){
+
+    LEVEL level_it;
+    prefix_t *prefix = NULL;
+    topofile_rec_t *rec = NULL;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        if(!node->local_prefix_list[level_it])
+            continue;
+
+        ITERATE_HASH_VECTOR_BEGIN(node->local_prefix_list[level_it], prefix){
+
+            if(sids && !prefix->psid_thread_ptr)
+                continue;
+            if(!sids && topofile_is_implicit_prefix(node, prefix, level_it))
+                continue;
+
+            rec = topofile_new_rec(writer, sids ? TOPOFILE_REC_PREFIX_SID : 
+                    TOPOFILE_REC_PREFIX, node, level_it);
+            rec->u.prefix.prefix = topofile_ip_from_str(prefix->prefix);
+            rec->u.prefix.mask = prefix->mask;
+            if(sids){
+                rec->u.prefix.value = PREFIX_SID_INDEX(prefix);
+                continue;
+            }
+            rec->u.prefix.value = prefix->metric;
+            rec->u.prefix.flags = (unsigned char)prefix->prefix_flags;
+            writer->stats.n_prefixes++;
+        } ITERATE_HASH_VECTOR_END;
+    }
+}
+
+static glthread_t *
+topofile_glthread_last(glthread_t *head){
+
+    glthread_t *curr = head;
+
+    while(curr->right)
+        curr = curr->right;
+    return curr;
+}
+
+static void
+topofile_save_adj_sids(topofile_writer_t *writer, node_t *node, edge_end_t *edge_end){
+
+    LEVEL level_it;
+    ADJ_SID_PROTECTION_TYPE prot_type;
+    p2p_intf_adj_sid_t *p2p_intf_adj_sid = NULL;
+    lan_intf_adj_sid_t *lan_intf_adj_sid = NULL;
+    glthread_t *head = NULL, *curr = NULL;
+    topofile_rec_t *rec = NULL;
+    uint32_t lan_nbr = 0;
+
+    if(edge_end->intf_name[0] == '\0')
+        return;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        for(prot_type = PROTECTED_ADJ_SID; prot_type < ADJ_SID_PROTECTION_MAX; prot_type++){
+
+            p2p_intf_adj_sid = &edge_end->cfg_p2p_adj_sid_db[level_it][prot_type];
+            if(p2p_intf_adj_sid->sid.sid){
+                rec = topofile_new_rec(writer, TOPOFILE_REC_ADJ_SID, node, level_it);
+                rec->u.adj_sid.ifname = topofile_intern(writer, edge_end->intf_name);
+                rec->u.adj_sid.label = p2p_intf_adj_sid->sid.sid;
+                rec->u.adj_sid.protected = (prot_type == PROTECTED_ADJ_SID);
+            }
+
+            /*LAN adj sids are prepended as they are loaded, walk them backwards
+             * so that a reload keeps their order*/
+            head = &edge_end->cfg_lan_adj_sid_db[level_it][prot_type];
+            for(curr = topofile_glthread_last(head); curr != head; curr = curr->left){
+                lan_intf_adj_sid = glthread_to_cfg_lan_adj_sid(curr);
+                if(!(lan_nbr = topofile_ip_from_str(lan_intf_adj_sid->nbr_system_id))){
+                    writer->stats.n_skipped++;
+                    continue;
+                }
+                rec = topofile_new_rec(writer, TOPOFILE_REC_ADJ_SID, node, level_it);
+                rec->u.adj_sid.ifname = topofile_intern(writer, edge_end->intf_name);
+                rec->u.adj_sid.label = lan_intf_adj_sid->sid.sid;
+                rec->u.adj_sid.protected = (prot_type == PROTECTED_ADJ_SID);
+                rec->u.adj_sid.lan_nbr = lan_nbr;
+            }
+        }
+    }
+}
+
+static void
+topofile_save_lsp(topofile_writer_t *writer, node_t *node, edge_t *edge){
+
+    topofile_rec_t *rec = NULL;
+    rsvp_tunnel_t *rsvp_tunnel = edge->fa;
+
+    if(!rsvp_tunnel || !rsvp_tunnel->physical_oif || !rsvp_tunnel->egress_lsr ||
+        !writer->node_pos[rsvp_tunnel->egress_lsr->node_index] ||
+        (edge->level != LEVEL1 && edge->level != LEVEL2)){
+        writer->stats.n_skipped++;
+        return;
+    }
+    rec = topofile_new_rec(writer, TOPOFILE_REC_LSP, node, edge->level);
+    rec->u.lsp.name = topofile_intern(writer, edge->from.intf_name);
+    rec->u.lsp.egress = writer->node_pos[rsvp_tunnel->egress_lsr->node_index] - 1;
+    rec->u.lsp.ifname = topofile_intern(writer, rsvp_tunnel->physical_oif->intf_name);
+    rec->u.lsp.metric = edge->metric[edge->level];
+    rec->u.lsp.label = rsvp_tunnel->rsvp_label;
+}
+
+/*Interface statements follow the link statements order rather than the
+ * interface slots order, which a reload does not preserve*/
+static void
+topofile_save_config(topofile_writer_t *writer){
+
+    uint32_t pos = 0, i = 0;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    for(pos = 0; pos < writer->n_nodes; pos++)
+        topofile_save_node_config(writer, writer->nodes[pos]);
+
+    for(i = 0; i < writer->n_links; i++){
+        edge = writer->links[i];
+        topofile_save_intf_config(writer, edge->from.node, &edge->from, TRUE);
+        topofile_save_intf_config(writer, edge->to.node, &edge->inv_edge->from, FALSE);
+    }
+
+    for(pos = 0; pos < writer->n_nodes; pos++)
+        topofile_save_prefixes(writer, writer->nodes[pos], FALSE);
+    for(pos = 0; pos < writer->n_nodes; pos++)
+        topofile_save_prefixes(writer, writer->nodes[pos], TRUE);
+
+    for(i = 0; i < writer->n_links; i++){
+        edge = writer->links[i];
+        topofile_save_adj_sids(writer, edge->from.node, &edge->from);
+        topofile_save_adj_sids(writer, edge->to.node, &edge->inv_edge->from);
+    }
+
+    /*Forwarding adjacencies last, their SPRING and RSVP config is in place by then*/
+    for(pos = 0; pos < writer->n_nodes; pos++){
+        node = writer->nodes[pos];
+        for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+            edge_end = node->edges[i];
+            if(!edge_end)
+                break;
+            if(edge_end->dirn == OUTGOING && 
+                GET_EGDE_PTR_FROM_EDGE_END(edge_end)->etype == LSP)
+                topofile_save_lsp(writer, node, GET_EGDE_PTR_FROM_EDGE_END(edge_end));
+        }
+    }
+}
+
+/*Text form printer*/
+
+#define TOPOFILE_REC_STR(writer, offset)     ((writer)->strtab + (offset))
+#define TOPOFILE_NODE_STR(writer, pos)       \
+    TOPOFILE_REC_STR(writer, (writer)->node_names[pos])
+#define TOPOFILE_IFNAME_STR(writer, offset)  \
+    (*TOPOFILE_REC_STR(writer, offset) ? TOPOFILE_REC_STR(writer, offset) : "-")
+
+static void
+topofile_print_metric(FILE *fp, LEVEL level, uint32_t *metric){
+
+    if(level == LEVEL12 && metric[0] != metric[1])
+        fprintf(fp, " %u/%u", metric[0], metric[1]);
+    else
+        fprintf(fp, " %u", metric[topofile_first_level(level) - LEVEL1]);
+}
+
+static boolean
+topofile_metric_equal(LEVEL level, uint32_t *metric1, uint32_t *metric2){
+
+    LEVEL level_it;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(IS_LEVEL_SET(level, level_it) && 
+            metric1[level_it - LEVEL1] != metric2[level_it - LEVEL1])
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+topofile_print_ip(FILE *fp, uint32_t ip, boolean allow_none){
+
+    char ip_str[PREFIX_LEN + 1];
+
+    if(!ip && allow_none)
+        fprintf(fp, " -");
+    else
+        fprintf(fp, " %s", topofile_ip_str(ip, ip_str));
+}
+
+static void
+topofile_print_rec(FILE *fp, topofile_writer_t *writer, topofile_rec_t *rec){
+
+    fprintf(fp, "%s", topofile_rec_names[rec->type]);
+
+    if(rec->type == TOPOFILE_REC_NODE){
+        fprintf(fp, " %s", TOPOFILE_REC_STR(writer, rec->u.node.name));
+        topofile_print_ip(fp, rec->u.node.router_id, FALSE);
+        fprintf(fp, " %u\n", rec->u.node.area + 1);
+        return;
+    }
+
+    fprintf(fp, " %s", TOPOFILE_NODE_STR(writer, rec->node));
+
+    switch(rec->type){
+        case TOPOFILE_REC_ROOT:
+        case TOPOFILE_REC_LDP:
+        case TOPOFILE_REC_RSVP:
+            break;
+        case TOPOFILE_REC_LINK:
+            fprintf(fp, " %s", TOPOFILE_IFNAME_STR(writer, rec->u.link.ifname));
+            topofile_print_ip(fp, rec->u.link.ip, TRUE);
+            fprintf(fp, " %s %s", TOPOFILE_NODE_STR(writer, rec->u.link.peer),
+                TOPOFILE_IFNAME_STR(writer, rec->u.link.peer_ifname));
+            topofile_print_ip(fp, rec->u.link.peer_ip, TRUE);
+            fprintf(fp, " %u %s", rec->u.link.mask, topofile_level_str(rec->level));
+            topofile_print_metric(fp, rec->level, rec->u.link.metric);
+            if(!topofile_metric_equal(rec->level, rec->u.link.metric, rec->u.link.peer_metric))
+                topofile_print_metric(fp, rec->level, rec->u.link.peer_metric);
+            break;
+        case TOPOFILE_REC_PSEUDONODE:
+        case TOPOFILE_REC_OVERLOAD:
+            fprintf(fp, " %s", topofile_level_str(rec->level));
+            break;
+        case TOPOFILE_REC_SPRING:
+            fprintf(fp, " %u %u", rec->u.cfg.value, rec->u.cfg.range);
+            break;
+        case TOPOFILE_REC_BACKUP:
+            fprintf(fp, " %s", topofile_backup_names[rec->u.cfg.value]);
+            break;
+        case TOPOFILE_REC_DELAY:
+        case TOPOFILE_REC_SRLG:
+            fprintf(fp, " %s %u", TOPOFILE_REC_STR(writer, rec->u.intf.ifname), 
+                rec->u.intf.value);
+            break;
+        case TOPOFILE_REC_PROTECT:
+            fprintf(fp, " %s %s", TOPOFILE_REC_STR(writer, rec->u.intf.ifname), 
+                topofile_protect_names[rec->u.intf.value]);
+            break;
+        case TOPOFILE_REC_TILFA:
+            fprintf(fp, " %s %s", TOPOFILE_REC_STR(writer, rec->u.intf.ifname), 
+                topofile_tilfa_names[rec->u.intf.value]);
+            break;
+        case TOPOFILE_REC_PREFIX:
+        case TOPOFILE_REC_PREFIX_SID:
+            topofile_print_ip(fp, rec->u.prefix.prefix, FALSE);
+            fprintf(fp, " %u %s %u", rec->u.prefix.mask, 
+                topofile_level_str(rec->level), rec->u.prefix.value);
+            if(rec->u.prefix.flags)
+                fprintf(fp, " %u", rec->u.prefix.flags);
+            break;
+        case TOPOFILE_REC_ADJ_SID:
+            fprintf(fp, " %s %s %u %s", TOPOFILE_REC_STR(writer, rec->u.adj_sid.ifname),
+                topofile_level_str(rec->level), rec->u.adj_sid.label,
+                rec->u.adj_sid.protected ? "protected" : "unprotected");
+            if(rec->u.adj_sid.lan_nbr)
+                topofile_print_ip(fp, rec->u.adj_sid.lan_nbr, FALSE);
+            break;
+        case TOPOFILE_REC_LSP:
+            fprintf(fp, " %s %s %s %s %u %u", TOPOFILE_REC_STR(writer, rec->u.lsp.name),
+                TOPOFILE_NODE_STR(writer, rec->u.lsp.egress),
+                TOPOFILE_REC_STR(writer, rec->u.lsp.ifname),
+                topofile_level_str(rec->level), rec->u.lsp.metric, rec->u.lsp.label);
+            break;
+        default:
+            assert(0);
+    }
+    fprintf(fp, "\n");
+}
+
+static int
+topofile_write_text(FILE *fp, topofile_writer_t *writer){
+
+    uint32_t i = 0;
+
+    fprintf(fp, "# SPFComputation topology, %u nodes, %u links, %u prefixes\n",
+        writer->n_nodes, writer->stats.n_links, writer->stats.n_prefixes);
+    fprintf(fp, "topology %u\n", TOPOFILE_VERSION);
+
+    for(i = 0; i < writer->n_recs; i++)
+        topofile_print_rec(fp, writer, &writer->recs[i]);
+    return ferror(fp) ? -1 : 0;
+}
+
+static int
+topofile_write_binary(FILE *fp, topofile_writer_t *writer){
+
+    topofile_bin_hdr_t hdr;
+
+    memset(&hdr, 0, sizeof(topofile_bin_hdr_t));
+    memcpy(hdr.magic, TOPOFILE_MAGIC, sizeof(TOPOFILE_MAGIC));
+    hdr.byte_order = TOPOFILE_BYTE_ORDER;
+    hdr.version = TOPOFILE_VERSION;
+    hdr.rec_size = sizeof(topofile_rec_t);
+    hdr.n_recs = writer->n_recs;
+    hdr.n_nodes = writer->n_nodes;
+    hdr.strtab_size = writer->strtab_size;
+
+    if(fwrite(&hdr, sizeof(topofile_bin_hdr_t), 1, fp) != 1)
+        return -1;
+    if(writer->n_recs && 
+        fwrite(writer->recs, sizeof(topofile_rec_t), writer->n_recs, fp) != writer->n_recs)
+        return -1;
+    if(fwrite(writer->strtab, 1, writer->strtab_size, fp) != writer->strtab_size)
+        return -1;
+    return 0;
+}
+
+int
+topofile_save(instance_t *instance, const char *file_name,
+              topofile_format_t format, topofile_stats_t *stats){
+
+    node_t *node = NULL;
+    uint32_t max_node_index = 0;
+    int rc = 0;
+    FILE *fp = NULL;
+    topofile_writer_t writer;
+
+    assert(format < TOPOFILE_FORMAT_MAX);
+    memset(&writer, 0, sizeof(topofile_writer_t));
+    writer.stats.format = format;
+
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+        if(node->node_index >= max_node_index)
+            max_node_index = node->node_index + 1;
+    } ITERATE_HASH_VECTOR_END;
+
+    writer.node_pos = calloc(max_node_index + 1, sizeof(uint32_t));
+    writer.node_names = calloc(HASH_VECTOR_COUNT(instance->instance_node_list) + 1, sizeof(uint32_t));
+    writer.nodes = calloc(HASH_VECTOR_COUNT(instance->instance_node_list) + 1, sizeof(node_t *));
+    assert(writer.node_pos && writer.node_names && writer.nodes);
+
+    ITERATE_HASH_VECTOR_BEGIN(instance->instance_node_list, node){
+        writer.nodes[writer.n_nodes] = node;
+        writer.node_names[writer.n_nodes] = topofile_intern(&writer, node->node_name);
+        writer.node_pos[node->node_index] = ++writer.n_nodes;
+    } ITERATE_HASH_VECTOR_END;
+
+    topofile_save_topology(&writer, instance);
+    topofile_save_config(&writer);
+    writer.stats.n_nodes = writer.n_nodes;
+
+    if(!(fp = fopen(file_name, format == TOPOFILE_BINARY ? "wb" : "w"))){
+        printf("Error : Could not open %s for writing\n", file_name);
+        rc = -1;
+    }
+    else{
+        rc = format == TOPOFILE_BINARY ? topofile_write_binary(fp, &writer) :
+             topofile_write_text(fp, &writer);
+        if(fclose(fp) != 0)
+            rc = -1;
+        if(rc < 0)
+            printf("Error : Could not write %s\n", file_name);
+    }
+
+    if(rc == 0 && stats)
+        *stats = writer.stats;
+
+    free(writer.recs);
+    free(writer.strtab);
+    free(writer.str_slots);
+    free(writer.node_pos);
+    free(writer.node_names);
+    free(writer.nodes);
+    free(writer.links);
+    return rc;
+}
@@ -0,0 +1,228 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topofile.h
+ *
+ *    Description:  Topology files : text and mmap-able binary forms, bulk loader and exporter
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 23:05:12  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#ifndef __TOPOFILE__
+#define __TOPOFILE__
+
+#include <stdint.h>
+
+/* A topology file is a sequence of statements, one per line in the text
+ * form, '#' starts a comment. A statement may only refer to nodes, interfaces
+ * and prefixes created by the statements before it, which is the order the
+ * exporter writes them in :
+ *
+ *  topology <version>
+ *  node       <name> <router-id> <area-no>
+ *  root       <node>
+ *  link       <node> <ifname> <ip> <peer> <peer-ifname> <peer-ip> <mask> <level-no> <metric> [<peer-metric>]
+ *  pseudonode <node> <level-no>
+ *  overload   <node> <level-no>
+ *  spring     <node> <srgb-first-label> <srgb-range>
+ *  ldp        <node>
+ *  rsvp       <node>
+ *  backup     <node> lfa | rlfa | node-link-degradation | spring
+ *  delay      <node> <ifname> <usec>
+ *  srlg       <node> <ifname> <srlg-id>
+ *  protect    <node> <ifname> link | node-link | node-only | no-eligible-backup
+ *  tilfa      <node> <ifname> link | node | srlg
+ *  prefix     <node> <prefix> <mask> <level-no> <metric> [<flags>]
+ *  prefix-sid <node> <prefix> <mask> <level-no> <sid-index>
+ *  adj-sid    <node> <ifname> <level-no> <label> protected | unprotected [<lan-nbr-router-id>]
+ *  lsp        <node> <lsp-name> <egress-node> <ifname> <level-no> <metric> <label>
+ *
+ * area-no is 1 to 6, level-no is 1, 2 or 12 where the statement applies to
+ * both levels. A link is bidirectional, metrics are either one value or
+ * <l1-metric>/<l2-metric>, peer-metric defaults to metric, an ip of '-'
+ * leaves the link end unnumbered and an ifname of '-' unnamed (pseudonode
+ * ends). Interface names need not be unique, interface statements refer to
+ * the first interface of the name. An lsp is an RSVP tunnel
+ * exported into the IGP as a forwarding adjacency, ifname being its first hop.
+ *
+ * The binary form holds the very same statements as fixed size records,
+ * followed by a string table, and is loaded straight off an mmap of the
+ * file. Both forms go through one loader, which keeps an index of nodes by
+ * position and only ever scans the interfaces of a single node, hence loads
+ * in O(V + E + prefixes).*/
+
+#define TOPOFILE_VERSION        1
+#define TOPOFILE_MAGIC          "SPFTOPO"
+#define TOPOFILE_BYTE_ORDER     0x01020304
+
+typedef struct instance_ instance_t;
+
+typedef enum{
+
+    TOPOFILE_TEXT,
+    TOPOFILE_BINARY,
+    TOPOFILE_FORMAT_MAX
+} topofile_format_t;
+
+typedef enum{
+
+    TOPOFILE_REC_NODE,
+    TOPOFILE_REC_ROOT,
+    TOPOFILE_REC_LINK,
+    TOPOFILE_REC_PSEUDONODE,
+    TOPOFILE_REC_OVERLOAD,
+    TOPOFILE_REC_SPRING,
+    TOPOFILE_REC_LDP,
+    TOPOFILE_REC_RSVP,
+    TOPOFILE_REC_BACKUP,
+    TOPOFILE_REC_DELAY,
+    TOPOFILE_REC_SRLG,
+    TOPOFILE_REC_PROTECT,
+    TOPOFILE_REC_TILFA,
+    TOPOFILE_REC_PREFIX,
+    TOPOFILE_REC_PREFIX_SID,
+    TOPOFILE_REC_ADJ_SID,
+    TOPOFILE_REC_LSP,
+    TOPOFILE_REC_MAX
+} topofile_rec_type_t;
+
+typedef enum{
+
+    TOPOFILE_BACKUP_LFA,
+    TOPOFILE_BACKUP_RLFA,
+    TOPOFILE_BACKUP_NODE_LINK_DEG,
+    TOPOFILE_BACKUP_SPRING,
+    TOPOFILE_BACKUP_MAX
+} topofile_backup_t;
+
+typedef enum{
+
+    TOPOFILE_PROTECT_LINK,
+    TOPOFILE_PROTECT_NODE_LINK,
+    TOPOFILE_PROTECT_NODE_ONLY,
+    TOPOFILE_PROTECT_NO_ELIGIBLE_BACKUP,
+    TOPOFILE_PROTECT_MAX
+} topofile_protect_t;
+
+typedef enum{
+
+    TOPOFILE_TILFA_LINK,
+    TOPOFILE_TILFA_NODE,
+    TOPOFILE_TILFA_SRLG,
+    TOPOFILE_TILFA_MAX
+} topofile_tilfa_t;
+
+/*One statement. Strings are offsets in the string table, ip addresses
+ * are in host byte order, nodes are referred to by their position among
+ * the node statements*/
+typedef struct topofile_rec_{
+
+    uint16_t type;                  /*topofile_rec_type_t*/
+    uint16_t level;                 /*LEVEL1, LEVEL2 or LEVEL12*/
+    uint32_t node;                  /*Node the statement is about, unused by TOPOFILE_REC_NODE*/
+    union{
+        struct{
+            uint32_t name;
+            uint32_t router_id;
+            uint32_t area;
+        } node;
+        struct{
+            uint32_t ifname;
+            uint32_t ip;            /*0 if unnumbered*/
+            uint32_t peer;
+            uint32_t peer_ifname;
+            uint32_t peer_ip;
+            uint32_t mask;
+            uint32_t metric[2];     /*L1, L2 metric from node to peer*/
+            uint32_t peer_metric[2];/*L1, L2 metric from peer to node*/
+        } link;
+        struct{
+            uint32_t value;         /*topofile_backup_t, SRGB first label*/
+            uint32_t range;         /*SRGB range*/
+        } cfg;
+        struct{
+            uint32_t ifname;
+            uint32_t value;         /*usec, srlg id, topofile_protect_t, topofile_tilfa_t*/
+        } intf;
+        struct{
+            uint32_t prefix;
+            uint32_t mask;
+            uint32_t value;         /*Metric, SID index for TOPOFILE_REC_PREFIX_SID*/
+            uint32_t flags;
+        } prefix;
+        struct{
+            uint32_t ifname;
+            uint32_t label;
+            uint32_t protected;
+            uint32_t lan_nbr;       /*Router id of the LAN nbr, 0 for p2p adjacencies*/
+        } adj_sid;
+        struct{
+            uint32_t name;
+            uint32_t egress;
+            uint32_t ifname;
+            uint32_t metric;
+            uint32_t label;
+        } lsp;
+    } u;
+} topofile_rec_t;
+
+/*Binary form : header, n_recs records, strtab_size bytes of '\0'
+ * terminated strings*/
+typedef struct topofile_bin_hdr_{
+
+    char magic[8];                  /*TOPOFILE_MAGIC*/
+    uint32_t byte_order;            /*TOPOFILE_BYTE_ORDER as stored by the writer*/
+    uint32_t version;
+    uint32_t rec_size;              /*sizeof(topofile_rec_t)*/
+    uint32_t n_recs;
+    uint32_t n_nodes;               /*TOPOFILE_REC_NODE records, sizes the node index up front*/
+    uint32_t strtab_size;
+} topofile_bin_hdr_t;
+
+typedef struct topofile_stats_{
+
+    topofile_format_t format;
+    unsigned int n_recs;
+    unsigned int n_nodes;
+    unsigned int n_links;
+    unsigned int n_prefixes;        /*prefix statements*/
+    unsigned int n_skipped;         /*Exporter only, one way links the format cannot express*/
+} topofile_stats_t;
+
+/*Format is told from the file contents. Returns NULL, after printing
+ * the offending statement, if the file could not be loaded. stats may be NULL*/
+instance_t *
+topofile_load(const char *file_name, topofile_stats_t *stats);
+
+/*Returns 0 on success, -1 if the file could not be written*/
+int
+topofile_save(instance_t *instance, const char *file_name, 
+              topofile_format_t format, topofile_stats_t *stats);
+
+const char *
+topofile_format_str(topofile_format_t format);
+
+#endif /* __TOPOFILE__ */
@@ -0,0 +1,779 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topogen.c
+ *
+ *    Description:  Parameterised synthetic topology generators for scale testing
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 21:14:08  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "instance.h"
+#include "topogen.h"
+#include "rlfa.h"
+#include "spfutil.h"
+#include "tilfa.h"
+#include "igp_sr_ext.h"
+#include "sr_tlv_api.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+
+#define TOPOGEN_LOOPBACK_OCTET      100
+#define TOPOGEN_LINK_OCTET          10
+#define TOPOGEN_PREFIX_OCTET        20
+#define TOPOGEN_LINK_MASK           30
+#define TOPOGEN_PREFIX_MASK         24
+#define TOPOGEN_MAX_LINKS           (1 << 22)   /*10.0.0.0/8 carved into /30s*/
+#define TOPOGEN_MAX_PREFIXES        ((TOPOGEN_LOOPBACK_OCTET - TOPOGEN_PREFIX_OCTET) << 16)
+
+/*Waxman link probability is exp(-d/(alpha * sqrt(2))), d being the euclidean
+ * distance between the two routers placed in the unit square*/
+#define TOPOGEN_WAXMAN_ALPHA        0.15
+#define TOPOGEN_MAX_ATTEMPTS        64          /*Per link a generator wants to add*/
+
+typedef struct topogen_ctx_{
+
+    instance_t *instance;
+    topogen_params_t *params;
+    topogen_node_t *nodes;
+    unsigned int n_nodes;
+    unsigned int max_nodes;
+    unsigned int n_links;
+    unsigned int n_prefixes;
+    boolean capped;
+    uint32_t rand_state;
+} topogen_ctx_t;
+
+static const char *topogen_type_names[TOPOGEN_TYPE_MAX] = {
+
+    "clos",
+    "spine-leaf",
+    "isp",
+    "waxman",
+    "barabasi-albert",
+    "ring-of-rings"
+};
+
+static const char *topogen_protection_names[TOPOGEN_PROTECTION_MAX] = {
+
+    "none",
+    "lfa",
+    "rlfa",
+    "tilfa"
+};
+
+const char *
+topogen_type_str(topogen_type_t type){
+
+    if(type >= TOPOGEN_TYPE_MAX)
+        return "unknown";
+    return topogen_type_names[type];
+}
+
+topogen_type_t
+topogen_type_from_str(char *type_str){
+
+    topogen_type_t type;
+
+    for(type = TOPOGEN_CLOS; type < TOPOGEN_TYPE_MAX; type++){
+        if(strcmp(type_str, topogen_type_names[type]) == 0)
+            return type;
+    }
+    return TOPOGEN_TYPE_MAX;
+}
+
+const char *
+topogen_protection_str(topogen_protection_t protection){
+
+    if(protection >= TOPOGEN_PROTECTION_MAX)
+        return "unknown";
+    return topogen_protection_names[protection];
+}
+
+topogen_protection_t
+topogen_protection_from_str(char *protection_str){
+
+    topogen_protection_t protection;
+
+    for(protection = TOPOGEN_PROTECTION_NONE; 
+            protection < TOPOGEN_PROTECTION_MAX; protection++){
+        if(strcmp(protection_str, topogen_protection_names[protection]) == 0)
+            return protection;
+    }
+    return TOPOGEN_PROTECTION_MAX;
+}
+
+void
+topogen_init_params(topogen_params_t *params){
+
+    memset(params, 0, sizeof(topogen_params_t));
+    params->type = TOPOGEN_CLOS;
+    params->n_nodes = 0;
+    params->ecmp_width = TOPOGEN_DEFAULT_ECMP_WIDTH;
+    params->metric_min = LINK_DEFAULT_METRIC;
+    params->metric_max = LINK_DEFAULT_METRIC;
+    params->prefixes_per_node = 0;
+    params->n_areas = TOPOGEN_DEFAULT_AREAS;
+    params->seed = 1;
+    params->segment_routing = FALSE;
+    params->protection = TOPOGEN_PROTECTION_NONE;
+}
+
+void
+topogen_print_params(topogen_params_t *params){
+
+    printf("Topology generator :\n");
+    printf("\tecmp-width : %u\n", params->ecmp_width);
+    if(params->metric_min == params->metric_max)
+        printf("\tmetric : %u\n", params->metric_min);
+    else
+        printf("\tmetric : uniform [%u, %u]\n", params->metric_min, params->metric_max);
+    printf("\tprefixes per node : %u\n", params->prefixes_per_node);
+    printf("\tareas (isp) : %u\n", params->n_areas);
+    printf("\tseed : %u\n", params->seed);
+    printf("\tsegment-routing : %s\n", params->segment_routing ? "ENABLED" : "DISABLED");
+    printf("\tprotection : %s\n", topogen_protection_str(params->protection));
+}
+
+/*xorshift32, deterministic for a given seed on every platform*/
+static uint32_t
+topogen_rand(topogen_ctx_t *ctx){
+
+    uint32_t x = ctx->rand_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ctx->rand_state = x;
+    return x;
+}
+
+static unsigned int
+topogen_rand_range(topogen_ctx_t *ctx, unsigned int n){
+
+    return n ? topogen_rand(ctx) % n : 0;
+}
+
+static double
+topogen_rand_unit(topogen_ctx_t *ctx){
+
+    return (double)topogen_rand(ctx) / 4294967296.0;
+}
+
+static unsigned int
+topogen_rand_metric(topogen_ctx_t *ctx){
+
+    topogen_params_t *params = ctx->params;
+
+    if(params->metric_max <= params->metric_min)
+        return params->metric_min;
+    return params->metric_min + 
+        topogen_rand_range(ctx, params->metric_max - params->metric_min + 1);
+}
+
+static unsigned int
+topogen_isqrt(unsigned int n){
+
+    unsigned int r = (unsigned int)sqrt((double)n);
+
+    while(r * r > n) r--;
+    while((r + 1) * (r + 1) <= n) r++;
+    return r;
+}
+
+static void
+topogen_cap(topogen_ctx_t *ctx, unsigned int n_nodes){
+
+    ctx->capped = TRUE;
+    printf("Info : %s capped at %u nodes, no router may have more than %u links\n",
+        topogen_type_str(ctx->params->type), n_nodes, TOPOGEN_MAX_NODE_LINKS);
+}
+
+/*Extra prefixes are advertised at every level the router takes part in*/
+static unsigned int
+topogen_add_node(topogen_ctx_t *ctx, AREA area, LEVEL level){
+
+    char node_name[NODE_NAME_SIZE];
+    char router_id[PREFIX_LEN + 1];
+    char prefix[PREFIX_LEN + 1];
+    unsigned int index = ctx->n_nodes, i = 0, p = 0;
+    topogen_node_t *tnode = NULL;
+
+    assert(index < ctx->max_nodes);
+
+    snprintf(node_name, NODE_NAME_SIZE, "R%u", index);
+    snprintf(router_id, PREFIX_LEN + 1, "%u.%u.%u.%u", TOPOGEN_LOOPBACK_OCTET,
+        ((index + 1) >> 16) & 0xFF, ((index + 1) >> 8) & 0xFF, (index + 1) & 0xFF);
+
+    tnode = &ctx->nodes[index];
+    tnode->node = create_new_node(ctx->instance, node_name, area, router_id);
+    assert(tnode->node);
+    tnode->n_links = 0;
+    ctx->n_nodes++;
+
+    for(i = 0; i < ctx->params->prefixes_per_node; i++){
+
+        if(ctx->n_prefixes == TOPOGEN_MAX_PREFIXES)
+            break;
+        p = ctx->n_prefixes++;
+        snprintf(prefix, PREFIX_LEN + 1, "%u.%u.%u.0", 
+            TOPOGEN_PREFIX_OCTET + (p >> 16), (p >> 8) & 0xFF, p & 0xFF);
+
+        if(IS_LEVEL_SET(level, LEVEL1))
+            attach_prefix_on_node(tnode->node, prefix, TOPOGEN_PREFIX_MASK, LEVEL1, 0, 0);
+        if(IS_LEVEL_SET(level, LEVEL2))
+            attach_prefix_on_node(tnode->node, prefix, TOPOGEN_PREFIX_MASK, LEVEL2, 0, 0);
+    }
+    return index;
+}
+
+static boolean
+topogen_is_adjacent(topogen_ctx_t *ctx, unsigned int n1, unsigned int n2){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+    node_t *node1 = ctx->nodes[n1].node,
+           *node2 = ctx->nodes[n2].node;
+
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node1->edges[i];
+        if(!edge_end) break;
+        if(edge_end->dirn != OUTGOING)
+            continue;
+        if((GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end))->to.node == node2)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*Returns FALSE if either router is out of interface slots*/
+static boolean
+topogen_add_link(topogen_ctx_t *ctx, unsigned int n1, unsigned int n2, LEVEL level){
+
+    char if_name1[IF_NAME_SIZE], if_name2[IF_NAME_SIZE];
+    char ip1[PREFIX_LEN + 1], ip2[PREFIX_LEN + 1];
+    topogen_node_t *tnode1 = &ctx->nodes[n1],
+                   *tnode2 = &ctx->nodes[n2];
+    uint32_t base = 0;
+    edge_t *edge = NULL;
+
+    if(n1 == n2)
+        return FALSE;
+
+    if(tnode1->n_links >= TOPOGEN_MAX_NODE_LINKS ||
+       tnode2->n_links >= TOPOGEN_MAX_NODE_LINKS)
+        return FALSE;
+
+    assert(ctx->n_links < TOPOGEN_MAX_LINKS);
+    base = ctx->n_links++ << 2;
+
+    snprintf(if_name1, IF_NAME_SIZE, "eth0/%u", tnode1->n_links++);
+    snprintf(if_name2, IF_NAME_SIZE, "eth0/%u", tnode2->n_links++);
+    snprintf(ip1, PREFIX_LEN + 1, "%u.%u.%u.%u", TOPOGEN_LINK_OCTET,
+        (base >> 16) & 0xFF, (base >> 8) & 0xFF, (base & 0xFF) + 1);
+    snprintf(ip2, PREFIX_LEN + 1, "%u.%u.%u.%u", TOPOGEN_LINK_OCTET,
+        (base >> 16) & 0xFF, (base >> 8) & 0xFF, (base & 0xFF) + 2);
+
+    edge = create_new_edge(if_name1, if_name2, topogen_rand_metric(ctx),
+            create_new_prefix(ip1, TOPOGEN_LINK_MASK, level),
+            create_new_prefix(ip2, TOPOGEN_LINK_MASK, level), level);
+    insert_edge_between_2_nodes(edge, tnode1->node, tnode2->node, BIDIRECTIONAL);
+    return TRUE;
+}
+
+/* Leaves of a pod connect to all ecmp-width spines of the pod, spine i of
+ * every pod connects to all ecmp-width super spines of plane i.
+ * Leaf degree : w, spine : leaves per pod + w, super spine : pods*/
+static void
+topogen_build_clos(topogen_ctx_t *ctx){
+
+    unsigned int w = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 n_leaves = 0, n_pods = 0, n_super = 0,
+                 pod = 0, i = 0, j = 0, 
+                 pod_base = 0, super_base = 0;
+
+    if(w > TOPOGEN_MAX_NODE_LINKS / 2)
+        w = TOPOGEN_MAX_NODE_LINKS / 2;
+    n_super = w * w;
+    n = n > n_super + w + 1 ? n - n_super : w + 1;
+
+    /*Square-ish : as many pods as leaves per pod*/
+    n_leaves = (topogen_isqrt(w * w + 4 * n) - w) / 2;
+    if(n_leaves < 1) n_leaves = 1;
+    if(n_leaves > TOPOGEN_MAX_NODE_LINKS - w)
+        n_leaves = TOPOGEN_MAX_NODE_LINKS - w;
+
+    n_pods = (n + n_leaves + w - 1) / (n_leaves + w);
+    if(n_pods > TOPOGEN_MAX_NODE_LINKS){
+        n_pods = TOPOGEN_MAX_NODE_LINKS;
+        topogen_cap(ctx, n_pods * (n_leaves + w) + n_super);
+    }
+
+    for(pod = 0; pod < n_pods; pod++){
+
+        pod_base = ctx->n_nodes;
+        for(i = 0; i < n_leaves + w; i++)
+            topogen_add_node(ctx, AREA1, LEVEL1);
+
+        for(i = 0; i < n_leaves; i++){
+            for(j = 0; j < w; j++)
+                topogen_add_link(ctx, pod_base + i, pod_base + n_leaves + j, LEVEL1);
+        }
+    }
+
+    super_base = ctx->n_nodes;
+    for(i = 0; i < n_super; i++)
+        topogen_add_node(ctx, AREA1, LEVEL1);
+
+    for(pod = 0; pod < n_pods; pod++){
+        pod_base = pod * (n_leaves + w);
+        for(i = 0; i < w; i++){
+            for(j = 0; j < w; j++)
+                topogen_add_link(ctx, pod_base + n_leaves + i, 
+                    super_base + i * w + j, LEVEL1);
+        }
+    }
+}
+
+/* Every leaf has one uplink into each of the ecmp-width planes, landing on
+ * spine (leaf mod S) of the plane. The S spines of a plane are meshed.
+ * Leaf degree : w, spine : S - 1 + leaves/S*/
+static void
+topogen_build_spine_leaf(topogen_ctx_t *ctx){
+
+    unsigned int w = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 n_spines = 0, n_leaves = 0, 
+                 plane = 0, i = 0, j = 0, spine_base = 0,
+                 max_leaves = 0, best_spines = 1;
+
+    /*Fewest spines per plane which still fit all leaves*/
+    for(n_spines = 1; n_spines <= TOPOGEN_MAX_NODE_LINKS; n_spines++){
+
+        n_leaves = n > w * n_spines ? n - w * n_spines : 1;
+        if(n_spines * (TOPOGEN_MAX_NODE_LINKS - n_spines + 1) >= n_leaves)
+            break;
+        if(n_spines * (TOPOGEN_MAX_NODE_LINKS - n_spines + 1) > max_leaves){
+            max_leaves = n_spines * (TOPOGEN_MAX_NODE_LINKS - n_spines + 1);
+            best_spines = n_spines;
+        }
+    }
+
+    if(n_spines > TOPOGEN_MAX_NODE_LINKS){
+        n_spines = best_spines;
+        n_leaves = max_leaves;
+        topogen_cap(ctx, n_leaves + w * n_spines);
+    }
+
+    for(i = 0; i < n_leaves; i++)
+        topogen_add_node(ctx, AREA1, LEVEL1);
+
+    for(plane = 0; plane < w; plane++){
+
+        spine_base = ctx->n_nodes;
+        for(i = 0; i < n_spines; i++)
+            topogen_add_node(ctx, AREA1, LEVEL1);
+
+        for(i = 0; i < n_spines; i++){
+            for(j = i + 1; j < n_spines; j++)
+                topogen_add_link(ctx, spine_base + i, spine_base + j, LEVEL1);
+        }
+
+        for(i = 0; i < n_leaves; i++)
+            topogen_add_link(ctx, i, spine_base + (i % n_spines), LEVEL1);
+    }
+}
+
+static void
+topogen_build_ring(topogen_ctx_t *ctx, unsigned int base, 
+                   unsigned int n, LEVEL level){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < n; i++){
+        if(n == 2 && i == 1) break;
+        topogen_add_link(ctx, base + i, base + (i + 1) % n, level);
+    }
+}
+
+/*Ring of n routers from base, chords of length ~sqrt(n) keep the diameter
+ * down to O(sqrt(n)) hops*/
+static void
+topogen_build_chordal_ring(topogen_ctx_t *ctx, unsigned int base, 
+                           unsigned int n, LEVEL level){
+
+    unsigned int i = 0,
+                 stride = topogen_isqrt(n);
+
+    topogen_build_ring(ctx, base, n, level);
+
+    if(stride < 3 || stride >= n - 1) return;
+
+    for(i = 0; i < n; i += 2){
+        if(!topogen_is_adjacent(ctx, base + i, base + (i + stride) % n))
+            topogen_add_link(ctx, base + i, base + (i + stride) % n, level);
+    }
+}
+
+/* n_areas L1 areas, each a chordal ring with ecmp-width L1L2 routers spread
+ * evenly on it, every L1L2 router dual-homed onto the L2 backbone, itself
+ * a chordal ring. Areas take AREA1 onwards, the backbone is AREA6*/
+static void
+topogen_build_isp(topogen_ctx_t *ctx){
+
+    unsigned int w = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 n_areas = ctx->params->n_areas,
+                 n_core = 0, area_size = 0, 
+                 area = 0, i = 0, k = 0, core = 0,
+                 core_base = 0, area_base = 0;
+    unsigned int *abr_index = NULL;
+
+    if(n_areas < 1) n_areas = 1;
+    if(n_areas > TOPOGEN_MAX_AREAS) n_areas = TOPOGEN_MAX_AREAS;
+
+    n_core = n / 10;
+    if(n_core < 3) n_core = 3;
+    area_size = n > n_core ? (n - n_core) / n_areas : 0;
+    if(area_size < w + 1) area_size = w + 1;
+
+    abr_index = XCALLOC(n_areas * w, uint32_t);
+
+    for(area = 0; area < n_areas; area++){
+
+        area_base = ctx->n_nodes;
+        k = 0;
+        for(i = 0; i < area_size; i++){
+            /*L1L2 routers at i = k * area_size / w*/
+            if(k < w && i == k * area_size / w){
+                abr_index[area * w + k] = topogen_add_node(ctx, AREA1 + area, LEVEL12);
+                k++;
+                continue;
+            }
+            topogen_add_node(ctx, AREA1 + area, LEVEL1);
+        }
+        topogen_build_chordal_ring(ctx, area_base, area_size, LEVEL1);
+    }
+
+    core_base = ctx->n_nodes;
+    for(i = 0; i < n_core; i++)
+        topogen_add_node(ctx, AREA6, LEVEL2);
+    topogen_build_chordal_ring(ctx, core_base, n_core, LEVEL2);
+
+    for(i = 0; i < n_areas * w; i++){
+        core = (uint32_t)(((uint64_t)i * n_core) / (n_areas * w));
+        topogen_add_link(ctx, abr_index[i], core_base + core, LEVEL2);
+        topogen_add_link(ctx, abr_index[i], core_base + (core + 1) % n_core, LEVEL2);
+    }
+
+    XFREE(abr_index);
+}
+
+/* Incremental Waxman : routers are dropped in the unit square one by one,
+ * each new router links to ecmp-width earlier routers picked with the
+ * Waxman probability. The first link always lands on the nearest of the
+ * candidates seen, so the graph is connected*/
+static void
+topogen_build_waxman(topogen_ctx_t *ctx){
+
+    unsigned int w = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 i = 0, j = 0, attempts = 0, links = 0, 
+                 nearest = 0;
+    double d = 0, nearest_d = 0, 
+           scale = TOPOGEN_WAXMAN_ALPHA * sqrt(2.0);
+    topogen_node_t *tnode = NULL;
+
+    if(n < 2) n = 2;
+
+    for(i = 0; i < n; i++){
+
+        topogen_add_node(ctx, AREA1, LEVEL1);
+        tnode = &ctx->nodes[i];
+        tnode->x = topogen_rand_unit(ctx);
+        tnode->y = topogen_rand_unit(ctx);
+
+        if(i == 0) continue;
+
+        links = 0;
+        nearest = i;
+        nearest_d = 2.0;
+
+        for(attempts = 0; attempts < TOPOGEN_MAX_ATTEMPTS * w && links < w; attempts++){
+
+            j = topogen_rand_range(ctx, i);
+            if(ctx->nodes[j].n_links >= TOPOGEN_MAX_NODE_LINKS)
+                continue;
+            d = hypot(tnode->x - ctx->nodes[j].x, tnode->y - ctx->nodes[j].y);
+            if(d < nearest_d){
+                nearest_d = d;
+                nearest = j;
+            }
+            if(topogen_rand_unit(ctx) >= exp(-d / scale))
+                continue;
+            if(topogen_is_adjacent(ctx, i, j))
+                continue;
+            if(topogen_add_link(ctx, i, j, LEVEL1))
+                links++;
+        }
+
+        if(!links && nearest != i)
+            topogen_add_link(ctx, i, nearest, LEVEL1);
+    }
+}
+
+/* Barabasi-Albert : a clique of ecmp-width + 1 routers, then every new
+ * router links to ecmp-width distinct routers picked with probability
+ * proportional to their degree. Hubs stop attracting links once out of
+ * interface slots, which clips the tail of the degree distribution*/
+static void
+topogen_build_barabasi_albert(topogen_ctx_t *ctx){
+
+    unsigned int m = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 i = 0, j = 0, attempts = 0, links = 0,
+                 n_ends = 0, max_ends = 0;
+    uint32_t *ends = NULL;  /*Both ends of every link so far*/
+
+    if(m + 1 > TOPOGEN_MAX_NODE_LINKS)
+        m = TOPOGEN_MAX_NODE_LINKS - 1;
+    if(n < m + 1) n = m + 1;
+
+    max_ends = 2 * (m * (m + 1) / 2 + (n - m - 1) * m);
+    ends = XCALLOC(max_ends, uint32_t);
+
+    for(i = 0; i <= m; i++){
+        topogen_add_node(ctx, AREA1, LEVEL1);
+        for(j = 0; j < i; j++){
+            if(topogen_add_link(ctx, i, j, LEVEL1)){
+                ends[n_ends++] = i;
+                ends[n_ends++] = j;
+            }
+        }
+    }
+
+    for(; i < n; i++){
+
+        topogen_add_node(ctx, AREA1, LEVEL1);
+        links = 0;
+
+        for(attempts = 0; attempts < TOPOGEN_MAX_ATTEMPTS * m && links < m; attempts++){
+
+            /*Fall back to uniform picks once preferential ones keep failing*/
+            j = attempts < TOPOGEN_MAX_ATTEMPTS * m / 2 ?
+                ends[topogen_rand_range(ctx, n_ends)] : topogen_rand_range(ctx, i);
+            if(topogen_is_adjacent(ctx, i, j))
+                continue;
+            if(!topogen_add_link(ctx, i, j, LEVEL1))
+                continue;
+            ends[n_ends++] = i;
+            ends[n_ends++] = j;
+            links++;
+        }
+    }
+
+    XFREE(ends);
+}
+
+/* Outer ring of R routers, each hosting an inner ring of S routers. An
+ * inner ring attaches to ecmp-width consecutive outer routers through
+ * gateways spread evenly on it*/
+static void
+topogen_build_ring_of_rings(topogen_ctx_t *ctx){
+
+    unsigned int w = ctx->params->ecmp_width,
+                 n = ctx->params->n_nodes,
+                 n_outer = 0, n_inner = 0,
+                 ring = 0, k = 0, inner_base = 0;
+
+    n_outer = topogen_isqrt(n);
+    if(n_outer < 3) n_outer = 3;
+    n_inner = n > n_outer ? (n - n_outer) / n_outer : 0;
+    if(n_inner < 3) n_inner = 3;
+    if(w > n_inner) w = n_inner;
+    if(w > n_outer) w = n_outer;
+
+    for(k = 0; k < n_outer; k++)
+        topogen_add_node(ctx, AREA1, LEVEL1);
+    topogen_build_ring(ctx, 0, n_outer, LEVEL1);
+
+    for(ring = 0; ring < n_outer; ring++){
+
+        inner_base = ctx->n_nodes;
+        for(k = 0; k < n_inner; k++)
+            topogen_add_node(ctx, AREA1, LEVEL1);
+
+        topogen_build_ring(ctx, inner_base, n_inner, LEVEL1);
+
+        for(k = 0; k < w; k++)
+            topogen_add_link(ctx, inner_base + k * n_inner / w, 
+                (ring + k) % n_outer, LEVEL1);
+    }
+}
+
+/*Upper bound on the routers a generator may create for the params*/
+static unsigned int
+topogen_max_nodes(topogen_params_t *params){
+
+    unsigned int n = params->n_nodes,
+                 w = params->ecmp_width,
+                 s = 0;
+
+    switch(params->type){
+        case TOPOGEN_CLOS:
+            return (TOPOGEN_MAX_NODE_LINKS + 1) * (TOPOGEN_MAX_NODE_LINKS + w) + w * w + n;
+        case TOPOGEN_SPINE_LEAF:
+            return n + w * TOPOGEN_MAX_NODE_LINKS + 
+                TOPOGEN_MAX_NODE_LINKS * TOPOGEN_MAX_NODE_LINKS;
+        case TOPOGEN_ISP:
+            return n + 3 + TOPOGEN_MAX_AREAS * (w + 1);
+        case TOPOGEN_RING_OF_RINGS:
+            s = topogen_isqrt(n) + 3;
+            return n + s * 4 + 9;
+        default:
+            return n + w + 2;
+    }
+}
+
+static void
+topogen_apply_config(topogen_ctx_t *ctx){
+
+    unsigned int index = 0, i = 0;
+    topogen_params_t *params = ctx->params;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    for(index = 0; index < ctx->n_nodes; index++){
+
+        node = ctx->nodes[index].node;
+
+        if(params->segment_routing){
+            node->spring_enabled = TRUE;
+            node->srgb = XCALLOC(1, srgb_t);
+            init_srgb_defaults(node->srgb);
+            /*Node SID indexes run upto the node count*/
+            if(node->srgb->range <= ctx->n_nodes)
+                resize_srgb(node->srgb, ctx->n_nodes + 1);
+            set_node_sid(node, index + 1);
+        }
+
+        switch(params->protection){
+            case TOPOGEN_PROTECTION_RLFA:
+                SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_REMOTE_BACKUP_CALCULATION);
+                /*fall through*/
+            case TOPOGEN_PROTECTION_LFA:
+                SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED);
+                break;
+            default:
+                break;
+        }
+
+        if(params->protection == TOPOGEN_PROTECTION_NONE)
+            continue;
+
+        for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+
+            edge_end = node->edges[i];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+
+            edge = GET_EGDE_PTR_FROM_FROM_EDGE_END(edge_end);
+            SET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
+
+            if(params->protection == TOPOGEN_PROTECTION_TILFA){
+                SET_LINK_PROTECTION_TYPE(edge, LINK_NODE_PROTECTION);
+                tilfa_update_config(node, edge_end->intf_name, 
+                    TRUE, TRUE, DONT_KNOW);
+            }
+        }
+    }
+}
+
+instance_t *
+topogen_build(topogen_params_t *params, topogen_stats_t *stats){
+
+    topogen_ctx_t ctx;
+
+    assert(params->type < TOPOGEN_TYPE_MAX);
+
+    if(params->ecmp_width < 1)
+        params->ecmp_width = 1;
+    if(params->ecmp_width > MAX_NXT_HOPS)
+        params->ecmp_width = MAX_NXT_HOPS;
+    if(params->metric_min < 1)
+        params->metric_min = 1;
+    if(params->metric_max < params->metric_min)
+        params->metric_max = params->metric_min;
+
+    memset(&ctx, 0, sizeof(topogen_ctx_t));
+    ctx.params = params;
+    ctx.rand_state = params->seed ? params->seed : 1;
+    ctx.max_nodes = topogen_max_nodes(params);
+    ctx.nodes = XCALLOC(ctx.max_nodes, topogen_node_t);
+    ctx.instance = get_new_instance();
+
+    switch(params->type){
+        case TOPOGEN_CLOS:
+            topogen_build_clos(&ctx);
+            break;
+        case TOPOGEN_SPINE_LEAF:
+            topogen_build_spine_leaf(&ctx);
+            break;
+        case TOPOGEN_ISP:
+            topogen_build_isp(&ctx);
+            break;
+        case TOPOGEN_WAXMAN:
+            topogen_build_waxman(&ctx);
+            break;
+        case TOPOGEN_BARABASI_ALBERT:
+            topogen_build_barabasi_albert(&ctx);
+            break;
+        case TOPOGEN_RING_OF_RINGS:
+            topogen_build_ring_of_rings(&ctx);
+            break;
+        default:
+            assert(0);
+    }
+
+    topogen_apply_config(&ctx);
+    set_instance_root(ctx.instance, ctx.nodes[0].node);
+
+    if(stats){
+        stats->n_nodes = ctx.n_nodes;
+        stats->n_links = ctx.n_links;
+        stats->n_prefixes = ctx.n_prefixes;
+        stats->capped = ctx.capped;
+    }
+
+    XFREE(ctx.nodes);
+    return ctx.instance;
+}
@@ -0,0 +1,132 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topogen.h
+ *
+ *    Description:  Parameterised synthetic topology generators for scale testing
+ *
+ *        Version:  1.0
+ *        Created:  Monday 19 October 2026 21:14:08  IST
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Networking Developer (AS), sachinites@gmail.com
+ *        Company:  Brocade Communications(Jul 2012- Mar 2016), Current : Juniper Networks(Apr 2017 - Present)
+ *        
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2017 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by  
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but 
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License 
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+
+#ifndef __TOPOGEN__
+#define __TOPOGEN__
+
+#include <stdint.h>
+#include "instanceconst.h"
+
+/* Synthetic topology generators. Every generator builds a fresh instance
+ * of roughly n_nodes routers, named R0, R1 ..., with loopbacks allocated
+ * from 100.0.0.0/8, /30 p2p links from 10.0.0.0/8 and the extra per node
+ * prefixes as /24s from 20.0.0.0. The same params and seed always build
+ * the same topology.
+ *
+ * A bidirectional link takes two interface slots on either end, hence no
+ * router gets more than TOPOGEN_MAX_NODE_LINKS links. Generators whose
+ * shape cannot grow any further under this cap build the largest topology
+ * that fits and say so. */
+
+#define TOPOGEN_MAX_NODE_LINKS      (MAX_NODE_INTF_SLOTS/2)
+#define TOPOGEN_DEFAULT_ECMP_WIDTH  4
+#define TOPOGEN_DEFAULT_AREAS       4
+#define TOPOGEN_MAX_AREAS           (AREA6 - AREA1)     /*AREA6 is the L2 backbone*/
+
+typedef struct instance_ instance_t;
+typedef struct _node_t node_t;
+
+typedef enum{
+
+    TOPOGEN_CLOS,               /*3-tier folded Clos : leaf, pod spine, super spine planes*/
+    TOPOGEN_SPINE_LEAF,         /*2-tier spine-leaf with ecmp-width independent planes*/
+    TOPOGEN_ISP,                /*L2 backbone ring plus L1 areas attached via L1L2 routers*/
+    TOPOGEN_WAXMAN,             /*Random geometric graph, distance biased links*/
+    TOPOGEN_BARABASI_ALBERT,    /*Random scale free graph, preferential attachment*/
+    TOPOGEN_RING_OF_RINGS,      /*Outer ring, each outer router hosting an inner ring*/
+    TOPOGEN_TYPE_MAX
+} topogen_type_t;
+
+typedef enum{
+
+    TOPOGEN_PROTECTION_NONE,
+    TOPOGEN_PROTECTION_LFA,
+    TOPOGEN_PROTECTION_RLFA,
+    TOPOGEN_PROTECTION_TILFA,
+    TOPOGEN_PROTECTION_MAX
+} topogen_protection_t;
+
+typedef struct topogen_params_{
+
+    topogen_type_t type;
+    unsigned int n_nodes;
+    unsigned int ecmp_width;        /*Parallel paths / uplinks per router, shape specific*/
+    unsigned int metric_min;        /*Link metrics are uniform in [metric_min, metric_max]*/
+    unsigned int metric_max;
+    unsigned int prefixes_per_node; /*Extra /24s advertised by every router*/
+    unsigned int n_areas;           /*TOPOGEN_ISP only*/
+    uint32_t seed;
+    boolean segment_routing;        /*SPRING on every router, node SID index = node index + 1*/
+    topogen_protection_t protection;/*Applied to every link of every router*/
+} topogen_params_t;
+
+typedef struct topogen_stats_{
+
+    unsigned int n_nodes;
+    unsigned int n_links;
+    unsigned int n_prefixes;        /*Extra prefixes only, loopbacks and link subnets not counted*/
+    boolean capped;                 /*Shape hit TOPOGEN_MAX_NODE_LINKS before reaching n_nodes*/
+} topogen_stats_t;
+
+void
+topogen_init_params(topogen_params_t *params);
+
+/*Per router scratch state of a generator run*/
+typedef struct topogen_node_{
+
+    node_t *node;
+    unsigned int n_links;
+    double x, y;                    /*TOPOGEN_WAXMAN only*/
+} topogen_node_t;
+
+/*stats may be NULL*/
+instance_t *
+topogen_build(topogen_params_t *params, topogen_stats_t *stats);
+
+const char *
+topogen_type_str(topogen_type_t type);
+
+/*Returns TOPOGEN_TYPE_MAX if type_str is not a known generator*/
+topogen_type_t
+topogen_type_from_str(char *type_str);
+
+const char *
+topogen_protection_str(topogen_protection_t protection);
+
+topogen_protection_t
+topogen_protection_from_str(char *protection_str);
+
+void
+topogen_print_params(topogen_params_t *params);
+
+#endif /* __TOPOGEN__ */